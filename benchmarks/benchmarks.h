@@ -0,0 +1,26 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <QTextStream>
+
+/**
+ * 性能基准和精度检查，由VectorQtBenchmarks依次运行，不链接进编辑器。
+ * 每个函数把结果表格写到out；返回false表示精度检查失败，程序以非零状态退出
+ */
+
+// R树与线性扫描的点、矩形查询延迟
+bool runSpatialIndexBenchmark(QTextStream &out);
+
+// 描边命中索引与逐次生成描边的查询延迟
+bool runPathHitBenchmark(QTextStream &out);
+
+// n元布尔运算与QPainterPath逐个折叠的耗时
+bool runBooleanBenchmark(QTextStream &out);
+
+// 曲线求交的BVH筛选与全部段对对比，及data/svg-tests样例与参考交点的比较
+bool runIntersectionBenchmark(QTextStream &out);
+
+// 串行、并行偏移与描边的耗时，及开放路径、负距离缓冲区的面积检查
+bool runOffsetBenchmark(QTextStream &out);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,102 @@
+#include <QElapsedTimer>
+#include <QPainterPath>
+#include <QRandomGenerator>
+#include <QtMath>
+#include "benchmarks.h"
+#include "../src/core/polygon-clipper.h"
+
+namespace {
+
+// 折叠对照的时间上限，超过后停止并记录已处理的图形数
+const qint64 FoldTimeLimitMs = 5000;
+
+struct BooleanResult
+{
+    int shapes = 0;
+    int edges = 0;              // 展平后的输入边数
+    qreal clipperMs = 0;
+    qreal foldMs = 0;
+    int foldedShapes = 0;       // 折叠在时间上限内处理的图形数
+};
+
+// 随机生成相互重叠的矩形和椭圆，比较n元运算与QPainterPath逐个折叠的耗时
+BooleanResult measure(QRandomGenerator &random, int count, PolygonClipper::Operation op)
+{
+    // 画布边长随数量增长，保持重叠密度不变
+    const qreal extent = qSqrt(qreal(count)) * 60.0;
+    QList<QPainterPath> shapes;
+    shapes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QRectF rect(random.bounded(extent), random.bounded(extent),
+                          20 + random.bounded(60.0), 20 + random.bounded(60.0));
+        QPainterPath shape;
+        if (random.bounded(2) == 0) {
+            shape.addRect(rect);
+        } else {
+            shape.addEllipse(rect);
+        }
+        shapes.append(shape);
+    }
+
+    BooleanResult result;
+    result.shapes = count;
+    for (const QPainterPath &shape : std::as_const(shapes)) {
+        for (const QPolygonF &polygon : PolygonClipper::flatten(shape)) {
+            result.edges += polygon.size();
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QPainterPath clipped = PolygonClipper::execute(shapes, op);
+    result.clipperMs = timer.nsecsElapsed() / 1e6;
+
+    // 原实现：从左到右逐个折叠
+    timer.restart();
+    QPainterPath folded = shapes.first();
+    result.foldedShapes = 1;
+    for (int i = 1; i < shapes.size() && timer.elapsed() < FoldTimeLimitMs; ++i) {
+        switch (op) {
+        case PolygonClipper::Union:
+            folded = folded.united(shapes[i]);
+            break;
+        case PolygonClipper::Intersection:
+            folded = folded.intersected(shapes[i]);
+            break;
+        case PolygonClipper::Difference:
+            folded = folded.subtracted(shapes[i]);
+            break;
+        case PolygonClipper::Xor:
+            folded = folded.subtracted(shapes[i]).united(shapes[i].subtracted(folded));
+            break;
+        }
+        ++result.foldedShapes;
+    }
+    result.foldMs = timer.nsecsElapsed() / 1e6;
+
+    Q_UNUSED(clipped)
+    return result;
+}
+
+} // namespace
+
+bool runBooleanBenchmark(QTextStream &out)
+{
+    QRandomGenerator random(20150101);
+
+    out << "图形数(边数): 合并 n元/折叠" << Qt::endl;
+    for (int count : { 10, 100, 1000 }) {
+        const BooleanResult result = measure(random, count, PolygonClipper::Union);
+        QString line = QString("%1(%2): %3/%4 ms")
+                           .arg(result.shapes)
+                           .arg(result.edges)
+                           .arg(result.clipperMs, 0, 'f', 1)
+                           .arg(result.foldMs, 0, 'f', 1);
+        // 折叠超时时注明只处理了部分图形
+        if (result.foldedShapes < result.shapes) {
+            line += QString(" (折叠仅完成%1个)").arg(result.foldedShapes);
+        }
+        out << line << Qt::endl;
+    }
+    return true;
+}
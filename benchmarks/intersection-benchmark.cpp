@@ -0,0 +1,393 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLineF>
+#include <QPainterPath>
+#include <QRandomGenerator>
+#include <QTransform>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+#include "benchmarks.h"
+#include "../src/core/path-intersector.h"
+#include "../src/core/svghandler.h"
+
+namespace {
+
+// 参考交点：路径放大后再用Qt自带的展平，得到比默认细得多的折线
+const qreal ReferenceScale = 64.0;
+// 计算交点与参考交点的距离不超过此值视为同一个交点
+const qreal ReferenceMatchDistance = 0.05;
+// 交点求值误差的上限，超过时检查失败。细分到容差以内后用弦求交，误差应与容差同量级
+const qreal MaxAllowedResidual = PathIntersector::DefaultTolerance * 10;
+
+struct IntersectionResult
+{
+    int segments = 0;
+    int intersections = 0;
+    qreal indexedMs = 0;
+    qreal allPairsMs = 0;
+    qreal maxResidual = 0;
+};
+
+struct AccuracyResult
+{
+    int pairs = 0;
+    int intersections = 0;
+    qreal maxResidual = 0;
+    qreal elapsedMs = 0;
+    int referenceIntersections = 0;
+    int missed = 0;                 // 没有对应计算交点的参考交点
+    int extra = 0;                  // 没有对应参考交点的计算交点
+    qreal maxReferenceError = 0;    // 计算交点到对应参考交点的最大距离
+};
+
+// 段在参数t处的点，段的起点是前一个元素的终点
+QPointF pointOnSegment(const QPainterPath &path, int element, qreal t)
+{
+    const QPointF p0 = path.elementAt(element - 1);
+    const QPainterPath::Element &first = path.elementAt(element);
+    if (first.type == QPainterPath::LineToElement) {
+        return p0 + (QPointF(first) - p0) * t;
+    }
+    const QPointF p1 = first;
+    const QPointF p2 = path.elementAt(element + 1);
+    const QPointF p3 = path.elementAt(element + 2);
+    const qreal s = 1 - t;
+    return p0 * (s * s * s) + p1 * (3 * s * s * t) + p2 * (3 * s * t * t) + p3 * (t * t * t);
+}
+
+// 交点在两条路径上的求值误差：两个段在各自参数处的点之间的最大距离
+qreal maxResidual(const QPainterPath &path1, const QPainterPath &path2,
+                  const QList<PathIntersector::Intersection> &intersections)
+{
+    qreal result = 0;
+    for (const PathIntersector::Intersection &hit : intersections) {
+        const QPointF a = pointOnSegment(path1, hit.element1, hit.t1);
+        const QPointF b = pointOnSegment(path2, hit.element2, hit.t2);
+        result = qMax(result, QLineF(a, b).length());
+    }
+    return result;
+}
+
+QPainterPath randomCurvePath(QRandomGenerator &random, int segments, qreal extent)
+{
+    auto randomPoint = [&random, extent]() {
+        return QPointF(random.bounded(extent), random.bounded(extent));
+    };
+    QPainterPath path;
+    QPointF current = randomPoint();
+    path.moveTo(current);
+    for (int i = 0; i < segments; ++i) {
+        // 随机游走，步长固定，使段的长度与规模无关
+        const QPointF step(random.bounded(80.0) - 40.0, random.bounded(80.0) - 40.0);
+        const QPointF next(qBound(qreal(0), current.x() + step.x(), extent),
+                           qBound(qreal(0), current.y() + step.y(), extent));
+        const QPointF bend(random.bounded(40.0) - 20.0, random.bounded(40.0) - 20.0);
+        path.cubicTo(current + (next - current) / 3 + bend, current + (next - current) * 2 / 3 - bend, next);
+        current = next;
+    }
+    return path;
+}
+
+// 每个段单独成为一条路径，用于不经过BVH的对照
+QList<QPainterPath> segmentPaths(const QPainterPath &path)
+{
+    QList<QPainterPath> segments;
+    for (int i = 1; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        if (element.type == QPainterPath::MoveToElement || element.type == QPainterPath::CurveToDataElement) {
+            continue;
+        }
+        QPainterPath segment(path.elementAt(i - 1));
+        if (element.type == QPainterPath::LineToElement) {
+            segment.lineTo(element);
+        } else {
+            segment.cubicTo(element, path.elementAt(i + 1), path.elementAt(i + 2));
+        }
+        segments.append(segment);
+    }
+    return segments;
+}
+
+// 与细分求交无关的参考实现：两条路径展平为细折线后逐对线段求交
+QVector<QPointF> referenceIntersections(const QPainterPath &path1, const QPainterPath &path2)
+{
+    const QTransform up = QTransform::fromScale(ReferenceScale, ReferenceScale);
+    QVector<QLineF> lines2;
+    for (const QPolygonF &polygon : path2.toSubpathPolygons(up)) {
+        for (int i = 0; i + 1 < polygon.size(); ++i) {
+            lines2.append(QLineF(polygon[i] / ReferenceScale, polygon[i + 1] / ReferenceScale));
+        }
+    }
+
+    QVector<QPointF> points;
+    for (const QPolygonF &polygon : path1.toSubpathPolygons(up)) {
+        for (int i = 0; i + 1 < polygon.size(); ++i) {
+            const QLineF line(polygon[i] / ReferenceScale, polygon[i + 1] / ReferenceScale);
+            // 水平、竖直线段的包围盒退化，QRectF::intersects不适用，直接比较区间
+            const QRectF box = QRectF(line.p1(), line.p2()).normalized();
+            for (const QLineF &other : std::as_const(lines2)) {
+                const QRectF otherBox = QRectF(other.p1(), other.p2()).normalized();
+                if (otherBox.left() > box.right() || otherBox.right() < box.left()
+                    || otherBox.top() > box.bottom() || otherBox.bottom() < box.top()) {
+                    continue;
+                }
+                QPointF point;
+                if (line.intersects(other, &point) != QLineF::BoundedIntersection) {
+                    continue;
+                }
+                // 交点恰好落在折线顶点上时相邻两段都会报告，合并为一个
+                bool duplicate = false;
+                for (const QPointF &existing : std::as_const(points)) {
+                    if (QLineF(existing, point).length() <= ReferenceMatchDistance) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (!duplicate) {
+                    points.append(point);
+                }
+            }
+        }
+    }
+    return points;
+}
+
+// 两条指定段数的随机曲线路径，比较BVH筛选与全部段对测试的耗时
+IntersectionResult measure(QRandomGenerator &random, int count)
+{
+    // 画布边长随段数增长，保持交点密度不变
+    const qreal extent = qSqrt(qreal(count)) * 40.0;
+    const QPainterPath path1 = randomCurvePath(random, count, extent);
+    const QPainterPath path2 = randomCurvePath(random, count, extent);
+
+    IntersectionResult result;
+    result.segments = count;
+
+    QElapsedTimer timer;
+    timer.start();
+    const QList<PathIntersector::Intersection> hits = PathIntersector::intersect(path1, path2);
+    result.indexedMs = timer.nsecsElapsed() / 1e6;
+    result.intersections = hits.size();
+    result.maxResidual = maxResidual(path1, path2, hits);
+
+    // 对照：全部段对逐一比较包围盒，重叠的段对单独求交
+    timer.restart();
+    const QList<QPainterPath> segments1 = segmentPaths(path1);
+    const QList<QPainterPath> segments2 = segmentPaths(path2);
+    QVector<QRectF> boxes2;
+    boxes2.reserve(segments2.size());
+    for (const QPainterPath &segment : segments2) {
+        boxes2.append(segment.controlPointRect());
+    }
+    const qreal tolerance = PathIntersector::DefaultTolerance;
+    int allPairsHits = 0;
+    for (const QPainterPath &segment : segments1) {
+        const QRectF box = segment.controlPointRect().adjusted(-tolerance, -tolerance, tolerance, tolerance);
+        for (int j = 0; j < segments2.size(); ++j) {
+            const QRectF &other = boxes2[j];
+            if (other.left() <= box.right() && box.left() <= other.right()
+                && other.top() <= box.bottom() && box.top() <= other.bottom()) {
+                allPairsHits += PathIntersector::intersect(segment, segments2[j]).size();
+            }
+        }
+    }
+    result.allPairsMs = timer.nsecsElapsed() / 1e6;
+
+    Q_UNUSED(allPairsHits)
+    return result;
+}
+
+/**
+ * 对包围盒相交的每一对路径求交，统计交点数和最大求值误差，
+ * 并与细折线逐对线段求得的参考交点比较（耗时包含参考交点的计算）
+ */
+AccuracyResult checkAccuracy(const QList<QPainterPath> &paths)
+{
+    AccuracyResult result;
+    QElapsedTimer timer;
+    timer.start();
+
+    const qreal tolerance = PathIntersector::DefaultTolerance;
+    QVector<QRectF> boxes;
+    boxes.reserve(paths.size());
+    for (const QPainterPath &path : paths) {
+        boxes.append(path.controlPointRect().adjusted(-tolerance, -tolerance, tolerance, tolerance));
+    }
+
+    for (int i = 0; i < paths.size(); ++i) {
+        for (int j = i + 1; j < paths.size(); ++j) {
+            if (!boxes[i].intersects(boxes[j])) {
+                continue;
+            }
+            const QList<PathIntersector::Intersection> hits = PathIntersector::intersect(paths[i], paths[j]);
+            ++result.pairs;
+            result.intersections += hits.size();
+            result.maxResidual = qMax(result.maxResidual, maxResidual(paths[i], paths[j], hits));
+
+            const QVector<QPointF> reference = referenceIntersections(paths[i], paths[j]);
+            result.referenceIntersections += reference.size();
+            QVector<char> matched(reference.size(), 0);
+            for (const PathIntersector::Intersection &hit : hits) {
+                int nearest = -1;
+                qreal nearestDistance = ReferenceMatchDistance;
+                for (int k = 0; k < reference.size(); ++k) {
+                    const qreal distance = QLineF(hit.point, reference[k]).length();
+                    if (distance <= nearestDistance) {
+                        nearest = k;
+                        nearestDistance = distance;
+                    }
+                }
+                if (nearest < 0) {
+                    ++result.extra;
+                    continue;
+                }
+                matched[nearest] = 1;
+                result.maxReferenceError = qMax(result.maxReferenceError, nearestDistance);
+            }
+            result.missed += int(std::count(matched.cbegin(), matched.cend(), 0));
+        }
+    }
+
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return result;
+}
+
+// 从程序所在目录和工作目录逐级向上查找data/svg-tests
+QString findSampleDirectory()
+{
+    const QStringList starts = { QCoreApplication::applicationDirPath(), QDir::currentPath() };
+    for (const QString &start : starts) {
+        QDir dir(start);
+        for (int level = 0; level < 4; ++level) {
+            if (dir.exists("data/svg-tests")) {
+                return dir.filePath("data/svg-tests");
+            }
+            if (!dir.cdUp()) {
+                break;
+            }
+        }
+    }
+    return QString();
+}
+
+// 直接从DOM收集样例中各图形元素的几何路径（含祖先的变换），不经过导入流程，
+// 避免向全局图层管理器添加图层；defs等定义中的元素不单独绘制，跳过
+void collectSamplePaths(const QDomElement &element, const QTransform &parentTransform, QList<QPainterPath> &paths)
+{
+    static const QStringList definitions = { "defs", "marker", "pattern", "clipPath", "mask", "symbol" };
+    const QString tag = element.tagName();
+    if (definitions.contains(tag)) {
+        return;
+    }
+
+    QTransform transform = parentTransform;
+    if (element.hasAttribute("transform")) {
+        transform = SvgHandler::parseTransform(element.attribute("transform")) * parentTransform;
+    }
+
+    QPainterPath path;
+    if (tag == "path") {
+        SvgHandler::parseSvgPathData(element.attribute("d"), path);
+    } else if (tag == "polygon" || tag == "polyline") {
+        SvgHandler::parseSvgPointsData(element.attribute("points"), path, tag == "polygon");
+    } else if (tag == "line") {
+        path.moveTo(SvgHandler::parseLength(element.attribute("x1")), SvgHandler::parseLength(element.attribute("y1")));
+        path.lineTo(SvgHandler::parseLength(element.attribute("x2")), SvgHandler::parseLength(element.attribute("y2")));
+    } else if (tag == "rect") {
+        path.addRect(SvgHandler::parseLength(element.attribute("x")), SvgHandler::parseLength(element.attribute("y")),
+                     SvgHandler::parseLength(element.attribute("width")), SvgHandler::parseLength(element.attribute("height")));
+    } else if (tag == "circle" || tag == "ellipse") {
+        const qreal rx = SvgHandler::parseLength(element.attribute(tag == "circle" ? "r" : "rx"));
+        const qreal ry = SvgHandler::parseLength(element.attribute(tag == "circle" ? "r" : "ry"));
+        path.addEllipse(QPointF(SvgHandler::parseLength(element.attribute("cx")),
+                                SvgHandler::parseLength(element.attribute("cy"))), rx, ry);
+    }
+    if (!path.isEmpty()) {
+        paths.append(transform.map(path));
+    }
+
+    for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+        collectSamplePaths(child, transform, paths);
+    }
+}
+
+} // namespace
+
+bool runIntersectionBenchmark(QTextStream &out)
+{
+    QRandomGenerator random(20150101);
+    bool passed = true;
+
+    out << "段数(交点): BVH/全部段对 | 误差" << Qt::endl;
+    for (int count : { 1000, 10000 }) {
+        const IntersectionResult result = measure(random, count);
+        passed = passed && result.maxResidual <= MaxAllowedResidual;
+        out << QString("%1(%2): %3/%4 ms | %5")
+                   .arg(result.segments)
+                   .arg(result.intersections)
+                   .arg(result.indexedMs, 0, 'f', 1)
+                   .arg(result.allPairsMs, 0, 'f', 1)
+                   .arg(result.maxResidual, 0, 'g', 2)
+            << Qt::endl;
+    }
+
+    // data/svg-tests中的样例：与细折线求得的参考交点比较。相切处折线求交本身不可靠，
+    // 遗漏和多余的交点只列出，求值误差超过上限时检查失败
+    const QString sampleDirectory = findSampleDirectory();
+    if (sampleDirectory.isEmpty()) {
+        out << "未找到data/svg-tests样例目录" << Qt::endl;
+        return passed;
+    }
+
+    AccuracyResult total;
+    int files = 0;
+    QStringList mismatched;
+    const QFileInfoList samples = QDir(sampleDirectory).entryInfoList({ "*.svg" }, QDir::Files, QDir::Name);
+    for (const QFileInfo &sample : samples) {
+        QFile file(sample.filePath());
+        QDomDocument doc;
+        if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file)) {
+            continue;
+        }
+        QList<QPainterPath> paths;
+        collectSamplePaths(doc.documentElement(), QTransform(), paths);
+        if (paths.size() < 2) {
+            continue;
+        }
+
+        const AccuracyResult result = checkAccuracy(paths);
+        ++files;
+        total.pairs += result.pairs;
+        total.intersections += result.intersections;
+        total.referenceIntersections += result.referenceIntersections;
+        total.missed += result.missed;
+        total.extra += result.extra;
+        total.elapsedMs += result.elapsedMs;
+        total.maxResidual = qMax(total.maxResidual, result.maxResidual);
+        total.maxReferenceError = qMax(total.maxReferenceError, result.maxReferenceError);
+        if (result.missed > 0 || result.extra > 0) {
+            mismatched << QString("%1(漏%2/多%3)").arg(sample.fileName()).arg(result.missed).arg(result.extra);
+        }
+    }
+    out << QString("样例%1个文件%2对(交点%3/参考%4): %5 ms | %6")
+               .arg(files)
+               .arg(total.pairs)
+               .arg(total.intersections)
+               .arg(total.referenceIntersections)
+               .arg(total.elapsedMs, 0, 'f', 1)
+               .arg(total.maxResidual, 0, 'g', 2)
+        << Qt::endl;
+    out << QString("与参考比较: 漏%1 多%2 | 偏差%3")
+               .arg(total.missed)
+               .arg(total.extra)
+               .arg(total.maxReferenceError, 0, 'g', 2)
+        << Qt::endl;
+    if (!mismatched.isEmpty()) {
+        out << "不一致: " << mismatched.join(", ") << Qt::endl;
+    }
+    return passed && total.maxResidual <= MaxAllowedResidual;
+}
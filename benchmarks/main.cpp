@@ -0,0 +1,45 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include "benchmarks.h"
+
+namespace {
+
+struct Benchmark
+{
+    const char *name;
+    bool (*run)(QTextStream &out);
+};
+
+const Benchmark AllBenchmarks[] = {
+    { "spatial-index", runSpatialIndexBenchmark },
+    { "path-hit", runPathHitBenchmark },
+    { "boolean", runBooleanBenchmark },
+    { "intersection", runIntersectionBenchmark },
+    { "offset", runOffsetBenchmark },
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // 参数为要运行的基准名称，省略时全部运行
+    const QStringList selected = app.arguments().mid(1);
+    QTextStream out(stdout);
+    bool passed = true;
+
+    for (const Benchmark &benchmark : AllBenchmarks) {
+        if (!selected.isEmpty() && !selected.contains(QLatin1String(benchmark.name))) {
+            continue;
+        }
+        out << "== " << benchmark.name << " ==" << Qt::endl;
+        if (!benchmark.run(out)) {
+            passed = false;
+        }
+        out << Qt::endl;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include <QElapsedTimer>
+#include <QPainterPath>
+#include <QPainterPathStroker>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtMath>
+#include "benchmarks.h"
+#include "../src/core/path-offset.h"
+#include "../src/core/path-measure.h"
+#include "../src/core/patheditor.h"
+
+namespace {
+
+// 缓冲区面积与解析值的相对误差上限，圆头和圆角展平后的误差在此以内
+const qreal MaxBufferAreaError = 0.01;
+
+struct OffsetResult
+{
+    int segments = 0;
+    qreal serialMs = 0;
+    qreal parallelMs = 0;
+    qreal strokerMs = 0;
+};
+
+QPainterPath randomTracedShape(QRandomGenerator &random, int segments)
+{
+    // 每个图形约200段，图形沿网格排列且互相略有重叠
+    const int segmentsPerBlob = 200;
+    const int blobs = qMax(1, segments / segmentsPerBlob);
+    const int columns = qCeil(qSqrt(qreal(blobs)));
+    QPainterPath path;
+    for (int b = 0; b < blobs; ++b) {
+        const QPointF center((b % columns) * 90.0, (b / columns) * 90.0);
+        const qreal radius = 30 + random.bounded(20.0);
+        auto pointAt = [&](int k) {
+            const qreal angle = 2 * M_PI * k / segmentsPerBlob;
+            // 半径起伏模拟描摹得到的不规则轮廓
+            const qreal r = radius * (1 + 0.15 * qSin(angle * 7) + 0.05 * qSin(angle * 23));
+            return center + QPointF(r * qCos(angle), r * qSin(angle));
+        };
+        path.moveTo(pointAt(0));
+        for (int k = 0; k < segmentsPerBlob; ++k) {
+            const QPointF from = pointAt(k);
+            const QPointF to = pointAt(k + 1);
+            const QPointF jitter(random.bounded(1.0) - 0.5, random.bounded(1.0) - 0.5);
+            path.cubicTo(from + (to - from) / 3 + jitter, from + (to - from) * 2 / 3 - jitter, to);
+        }
+        path.closeSubpath();
+    }
+    path.setFillRule(Qt::WindingFill);
+    return path;
+}
+
+// 指定段数的随机描摹风格图形，分别测量串行、并行偏移与描边的耗时
+OffsetResult measure(QRandomGenerator &random, int count, qreal distance)
+{
+    const QPainterPath shape = randomTracedShape(random, count);
+
+    OffsetResult result;
+    result.segments = count;
+
+    QElapsedTimer timer;
+    timer.start();
+    const QPainterPath serial = PathOffsetter::offset(shape, distance, PathOffsetter::RoundJoin,
+                                                      PathOffsetter::DefaultMiterLimit, false);
+    result.serialMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    const QPainterPath parallel = PathOffsetter::offset(shape, distance, PathOffsetter::RoundJoin,
+                                                        PathOffsetter::DefaultMiterLimit, true);
+    result.parallelMs = timer.nsecsElapsed() / 1e6;
+
+    // 原实现：以两倍距离描边
+    timer.restart();
+    QPainterPathStroker stroker;
+    stroker.setWidth(distance * 2);
+    stroker.setCapStyle(Qt::RoundCap);
+    stroker.setJoinStyle(Qt::RoundJoin);
+    const QPainterPath stroked = stroker.createStroke(shape);
+    result.strokerMs = timer.nsecsElapsed() / 1e6;
+
+    Q_UNUSED(serial)
+    Q_UNUSED(parallel)
+    Q_UNUSED(stroked)
+    return result;
+}
+
+} // namespace
+
+bool runOffsetBenchmark(QTextStream &out)
+{
+    QRandomGenerator random(20150101);
+
+    out << "段数: 偏移 串行/并行 | 描边" << Qt::endl;
+    for (int count : { 1000, 10000, 50000 }) {
+        const OffsetResult result = measure(random, count, 4.0);
+        out << QString("%1: %2/%3 ms | %4 ms")
+                   .arg(result.segments)
+                   .arg(result.serialMs, 0, 'f', 1)
+                   .arg(result.parallelMs, 0, 'f', 1)
+                   .arg(result.strokerMs, 0, 'f', 1)
+            << Qt::endl;
+    }
+
+    // 开放路径和负距离的缓冲区：面积与解析值比较
+    const qreal d = 4.0;
+    QPainterPath line;
+    line.moveTo(0, 0);
+    line.lineTo(100, 0);
+    QPainterPath polyline;
+    polyline.moveTo(0, 0);
+    polyline.lineTo(100, 0);
+    polyline.lineTo(100, 100);
+    QPainterPath square;
+    square.addRect(0, 0, 100, 100);
+    struct BufferCheck {
+        QString name;
+        QPainterPath result;
+        qreal expectedArea;
+    };
+    const QList<BufferCheck> checks = {
+        // 长方形加两端半圆
+        { "直线", PathEditor::buffer(line, d), 2 * d * 100 + M_PI * d * d },
+        // 直角内侧两段重叠一个d×d正方形，外侧补四分之一圆
+        { "折线", PathEditor::buffer(polyline, d), 2 * d * 200 + M_PI * d * d + (M_PI / 4 - 1) * d * d },
+        // 负距离按绝对值外扩
+        { "负距离", PathEditor::buffer(square, -d), 100 * 100 + 4 * 100 * d + M_PI * d * d },
+    };
+    bool passed = true;
+    QStringList checkLines;
+    for (const BufferCheck &check : checks) {
+        const qreal area = PathMeasure::area(check.result);
+        const bool ok = qAbs(area - check.expectedArea) <= check.expectedArea * MaxBufferAreaError;
+        passed = passed && ok;
+        checkLines << QString("%1 %2/%3%4")
+                          .arg(check.name)
+                          .arg(area, 0, 'f', 0)
+                          .arg(check.expectedArea, 0, 'f', 0)
+                          .arg(ok ? "" : " 异常");
+    }
+    out << "缓冲区面积(实际/预期): " << checkLines.join(" | ") << Qt::endl;
+    return passed;
+}
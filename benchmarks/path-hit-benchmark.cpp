@@ -0,0 +1,106 @@
+#include <QElapsedTimer>
+#include <QPainterPath>
+#include <QPainterPathStroker>
+#include <QRandomGenerator>
+#include <QVector>
+#include "benchmarks.h"
+#include "../src/core/path-hit-index.h"
+
+namespace {
+
+// 描边对照在大路径上每次查询需要几十毫秒，只取少量样本
+const int MaxStrokerQueries = 20;
+
+struct PathHitResult
+{
+    int segments = 0;
+    qreal buildMs = 0;
+    qreal queryUs = 0;
+    qreal strokerQueryUs = 0;
+};
+
+// 生成指定段数的随机路径，比较索引查询与描边后contains()的耗时
+PathHitResult measure(QRandomGenerator &random, int segments, int queries)
+{
+    // 随机游走生成直线和曲线交替的路径，类似描摹得到的长路径
+    QPainterPath path;
+    QPointF current(0, 0);
+    path.moveTo(current);
+    for (int i = 0; i < segments; ++i) {
+        const QPointF next = current + QPointF(random.bounded(40.0) - 20.0, random.bounded(40.0) - 20.0);
+        if (random.bounded(3) == 0) {
+            path.lineTo(next);
+        } else {
+            const QPointF c1 = current + QPointF(random.bounded(30.0) - 15.0, random.bounded(30.0) - 15.0);
+            const QPointF c2 = next + QPointF(random.bounded(30.0) - 15.0, random.bounded(30.0) - 15.0);
+            path.cubicTo(c1, c2, next);
+        }
+        current = next;
+    }
+
+    // 一半查询点落在路径附近，一半随机分布在包围盒内
+    const QRectF bounds = path.boundingRect();
+    QVector<QPointF> points;
+    points.reserve(queries);
+    for (int i = 0; i < queries; ++i) {
+        if (i % 2 == 0) {
+            const QPainterPath::Element &element = path.elementAt(random.bounded(path.elementCount()));
+            points.append(QPointF(element.x + random.bounded(8.0) - 4.0, element.y + random.bounded(8.0) - 4.0));
+        } else {
+            points.append(QPointF(bounds.left() + random.bounded(bounds.width()),
+                                  bounds.top() + random.bounded(bounds.height())));
+        }
+    }
+
+    PathHitResult result;
+    result.segments = segments;
+
+    QElapsedTimer timer;
+    timer.start();
+    const PathHitIndex index(path);
+    result.buildMs = timer.nsecsElapsed() / 1e6;
+
+    // 累加命中数，避免查询被优化掉
+    int hits = 0;
+    timer.restart();
+    for (const QPointF &point : std::as_const(points)) {
+        if (index.hits(point, 5.0)) {
+            ++hits;
+        }
+    }
+    result.queryUs = timer.nsecsElapsed() / 1e3 / queries;
+
+    // 原实现：每次查询都为整条路径生成描边
+    const int strokerQueries = qMin(queries, MaxStrokerQueries);
+    timer.restart();
+    for (int i = 0; i < strokerQueries; ++i) {
+        QPainterPathStroker stroker;
+        stroker.setWidth(10.0);
+        if (stroker.createStroke(path).contains(points[i])) {
+            ++hits;
+        }
+    }
+    result.strokerQueryUs = timer.nsecsElapsed() / 1e3 / strokerQueries;
+
+    Q_UNUSED(hits)
+    return result;
+}
+
+} // namespace
+
+bool runPathHitBenchmark(QTextStream &out)
+{
+    QRandomGenerator random(20150101);
+
+    out << "段数: 构建 | 查询 索引/描边" << Qt::endl;
+    for (int segments : { 1000, 10000, 50000 }) {
+        const PathHitResult result = measure(random, segments, 1000);
+        out << QString("%1: %2 ms | %3/%4 µs")
+                   .arg(result.segments)
+                   .arg(result.buildMs, 0, 'f', 1)
+                   .arg(result.queryUs, 0, 'f', 2)
+                   .arg(result.strokerQueryUs, 0, 'f', 0)
+            << Qt::endl;
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QRectF>
+#include <QVector>
+#include <QtMath>
+#include "benchmarks.h"
+#include "../src/core/rtree.h"
+
+namespace {
+
+struct SpatialIndexResult
+{
+    int size = 0;
+    qreal buildMs = 0;
+    qreal pointQueryUs = 0;
+    qreal rectQueryUs = 0;
+    qreal linearPointQueryUs = 0;
+    qreal linearRectQueryUs = 0;
+};
+
+bool rectContainsPoint(const QRectF &rect, const QPointF &p)
+{
+    return p.x() >= rect.left() && p.x() <= rect.right() && p.y() >= rect.top() && p.y() <= rect.bottom();
+}
+
+// 对给定规模生成随机矩形，比较R树与线性扫描的点、矩形查询耗时
+SpatialIndexResult measure(QRandomGenerator &random, int size, int queries)
+{
+    // 在边长随规模增长的画布上放置随机矩形，保持对象密度不变
+    const qreal extent = qSqrt(qreal(size)) * 100.0;
+    QVector<QRectF> rects;
+    rects.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        rects.append(QRectF(random.bounded(extent), random.bounded(extent),
+                            5 + random.bounded(60.0), 5 + random.bounded(60.0)));
+    }
+    QVector<QPointF> points;
+    points.reserve(queries);
+    for (int i = 0; i < queries; ++i) {
+        points.append(QPointF(random.bounded(extent), random.bounded(extent)));
+    }
+
+    SpatialIndexResult result;
+    result.size = size;
+
+    QElapsedTimer timer;
+    timer.start();
+    RTree<int> tree;
+    for (int i = 0; i < size; ++i) {
+        tree.insert(rects[i], i);
+    }
+    result.buildMs = timer.nsecsElapsed() / 1e6;
+
+    // 累加命中数，避免查询被优化掉
+    qint64 hits = 0;
+    auto countHit = [&hits](const QRectF &, int) { ++hits; };
+
+    timer.restart();
+    for (const QPointF &point : std::as_const(points)) {
+        tree.search(QRectF(point, QSizeF(0, 0)), countHit);
+    }
+    result.pointQueryUs = timer.nsecsElapsed() / 1e3 / queries;
+
+    timer.restart();
+    for (const QPointF &point : std::as_const(points)) {
+        tree.search(QRectF(point, QSizeF(200, 200)), countHit);
+    }
+    result.rectQueryUs = timer.nsecsElapsed() / 1e3 / queries;
+
+    timer.restart();
+    for (const QPointF &point : std::as_const(points)) {
+        for (const QRectF &rect : std::as_const(rects)) {
+            if (rectContainsPoint(rect, point)) {
+                ++hits;
+            }
+        }
+    }
+    result.linearPointQueryUs = timer.nsecsElapsed() / 1e3 / queries;
+
+    timer.restart();
+    for (const QPointF &point : std::as_const(points)) {
+        const QRectF area(point, QSizeF(200, 200));
+        for (const QRectF &rect : std::as_const(rects)) {
+            if (rect.left() <= area.right() && area.left() <= rect.right()
+                && rect.top() <= area.bottom() && area.top() <= rect.bottom()) {
+                ++hits;
+            }
+        }
+    }
+    result.linearRectQueryUs = timer.nsecsElapsed() / 1e3 / queries;
+
+    Q_UNUSED(hits)
+    return result;
+}
+
+} // namespace
+
+bool runSpatialIndexBenchmark(QTextStream &out)
+{
+    QRandomGenerator random(20150101);
+
+    out << "规模: 构建 | 点查询 R树/线性 | 矩形查询 R树/线性" << Qt::endl;
+    for (int size : { 1000, 10000, 50000 }) {
+        const SpatialIndexResult result = measure(random, size, 1000);
+        out << QString("%1: %2 ms | %3/%4 µs | %5/%6 µs")
+                   .arg(result.size)
+                   .arg(result.buildMs, 0, 'f', 1)
+                   .arg(result.pointQueryUs, 0, 'f', 2)
+                   .arg(result.linearPointQueryUs, 0, 'f', 1)
+                   .arg(result.rectQueryUs, 0, 'f', 2)
+                   .arg(result.linearRectQueryUs, 0, 'f', 1)
+            << Qt::endl;
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#include <QtMath>
+#include "bezier-geometry.h"
+
+namespace {
+
+// 在均匀参数上求值，把第1到count个点依次交给visit
+template <typename Visit>
+void evaluateUniform(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                     int count, Visit visit)
+{
+    const qreal step = qreal(1) / count;
+    for (int i = 1; i <= count; ++i) {
+        const qreal t = i * step;
+        const qreal s = 1 - t;
+        const qreal b0 = s * s * s;
+        const qreal b1 = 3 * s * s * t;
+        const qreal b2 = 3 * s * t * t;
+        const qreal b3 = t * t * t;
+        visit(i - 1, b0 * p0.x() + b1 * p1.x() + b2 * p2.x() + b3 * p3.x(),
+              b0 * p0.y() + b1 * p1.y() + b2 * p2.y() + b3 * p3.y());
+    }
+}
+
+} // namespace
+
+int BezierGeometry::flatteningSegments(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                                       qreal tolerance)
+{
+    const QPointF d1 = p0 - p1 * 2 + p2;
+    const QPointF d2 = p1 - p2 * 2 + p3;
+    const qreal dd = qSqrt(qMax(QPointF::dotProduct(d1, d1), QPointF::dotProduct(d2, d2)));
+    return qBound(1, qCeil(qSqrt(0.75 * dd / tolerance)), MaxCurveSegments);
+}
+
+void BezierGeometry::flattenCubic(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                                  qreal tolerance, QPolygonF &out)
+{
+    // p0通常就是out的最后一点，扩容前先复制控制点
+    const QPointF c[4] = { p0, p1, p2, p3 };
+    const int count = flatteningSegments(c[0], c[1], c[2], c[3], tolerance);
+    const int offset = out.size();
+    out.resize(offset + count);
+    QPointF *points = out.data() + offset;
+    evaluateUniform(c[0], c[1], c[2], c[3], count, [points](int i, qreal x, qreal y) {
+        points[i] = QPointF(x, y);
+    });
+}
+
+void BezierGeometry::flattenCubic(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                                  qreal tolerance, QVector<qreal> &xs, QVector<qreal> &ys)
+{
+    const int count = flatteningSegments(p0, p1, p2, p3, tolerance);
+    const int offset = xs.size();
+    xs.resize(offset + count);
+    ys.resize(offset + count);
+    qreal *x = xs.data() + offset;
+    qreal *y = ys.data() + offset;
+    evaluateUniform(p0, p1, p2, p3, count, [x, y](int i, qreal px, qreal py) {
+        x[i] = px;
+        y[i] = py;
+    });
+}
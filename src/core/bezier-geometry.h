@@ -0,0 +1,99 @@
+#ifndef BEZIER_GEOMETRY_H
+#define BEZIER_GEOMETRY_H
+
+#include <QPointF>
+#include <QPolygonF>
+#include <QVector>
+#include <QtMath>
+
+/**
+ * 三次贝塞尔曲线和线段的基础几何运算
+ *
+ * 展平、度量、命中、求交和空间索引共用同一套实现：展平统一按Wang公式估计分段数
+ * 后在均匀参数上求值，同一条路径在各模块中得到相同的折线；细分统一用de Casteljau
+ * 在t=0.5处二分。短小的函数在头文件中内联，供各模块的内层循环调用
+ */
+class BezierGeometry
+{
+public:
+    // 展平时每条曲线的分段数上限
+    static constexpr int MaxCurveSegments = 1024;
+
+    /**
+     * 点到线段ab最近点的参数，退化为点的线段返回0
+     */
+    static qreal segmentParameter(const QPointF &p, const QPointF &a, const QPointF &b)
+    {
+        const QPointF ab = b - a;
+        const qreal lengthSquared = QPointF::dotProduct(ab, ab);
+        if (lengthSquared <= 0) {
+            return 0;
+        }
+        return qBound(qreal(0), QPointF::dotProduct(p - a, ab) / lengthSquared, qreal(1));
+    }
+
+    static qreal squaredSegmentDistance(const QPointF &p, const QPointF &a, const QPointF &b)
+    {
+        const QPointF d = p - (a + (b - a) * segmentParameter(p, a, b));
+        return QPointF::dotProduct(d, d);
+    }
+
+    static qreal segmentDistance(const QPointF &p, const QPointF &a, const QPointF &b)
+    {
+        return qSqrt(squaredSegmentDistance(p, a, b));
+    }
+
+    /**
+     * 两个内部控制点离弦都不超过tolerance时，曲线可以视为直线
+     */
+    static bool isFlat(const QPointF c[4], qreal tolerance)
+    {
+        const qreal toleranceSquared = tolerance * tolerance;
+        return squaredSegmentDistance(c[1], c[0], c[3]) <= toleranceSquared
+            && squaredSegmentDistance(c[2], c[0], c[3]) <= toleranceSquared;
+    }
+
+    /**
+     * de Casteljau在t=0.5处分成两段，left和right可以与c相同
+     */
+    static void splitCubic(const QPointF c[4], QPointF left[4], QPointF right[4])
+    {
+        const QPointF p0 = c[0];
+        const QPointF p3 = c[3];
+        const QPointF p01 = (c[0] + c[1]) * 0.5;
+        const QPointF p12 = (c[1] + c[2]) * 0.5;
+        const QPointF p23 = (c[2] + c[3]) * 0.5;
+        const QPointF p012 = (p01 + p12) * 0.5;
+        const QPointF p123 = (p12 + p23) * 0.5;
+        const QPointF mid = (p012 + p123) * 0.5;
+
+        left[0] = p0;
+        left[1] = p01;
+        left[2] = p012;
+        left[3] = mid;
+        right[0] = mid;
+        right[1] = p123;
+        right[2] = p23;
+        right[3] = p3;
+    }
+
+    /**
+     * 按Wang公式由二阶差分的上界估计分段数，使折线离曲线不超过tolerance
+     */
+    static int flatteningSegments(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                                  qreal tolerance);
+
+    /**
+     * 展平一条三次曲线，追加除起点p0以外的各点
+     */
+    static void flattenCubic(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                             qreal tolerance, QPolygonF &out);
+
+    /**
+     * 同上，坐标按x、y分开追加
+     */
+    static void flattenCubic(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                             qreal tolerance, QVector<qreal> &xs, QVector<qreal> &ys);
+};
+
+#endif // BEZIER_GEOMETRY_H
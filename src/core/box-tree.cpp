@@ -0,0 +1,50 @@
+#include <algorithm>
+#include "box-tree.h"
+
+BoxTree::BoxTree(const QVector<Box> &boxes)
+    : m_boxes(boxes)
+{
+    m_order.resize(m_boxes.size());
+    for (int i = 0; i < m_order.size(); ++i) {
+        m_order[i] = i;
+    }
+    if (!m_boxes.isEmpty()) {
+        m_nodes.reserve(2 * m_boxes.size() / LeafSize + 1);
+        build(0, m_boxes.size());
+    }
+}
+
+int BoxTree::build(int first, int count)
+{
+    Node node;
+    node.box = m_boxes[m_order[first]];
+    for (int i = first + 1; i < first + count; ++i) {
+        node.box = node.box.united(m_boxes[m_order[i]]);
+    }
+    node.first = first;
+    node.count = count;
+
+    const int index = m_nodes.size();
+    m_nodes.append(node);
+
+    if (count <= LeafSize) {
+        return index;
+    }
+
+    // 沿包围盒较长的轴按元素中心的中位数划分
+    const bool splitX = node.box.x2 - node.box.x1 >= node.box.y2 - node.box.y1;
+    const int half = count / 2;
+    auto begin = m_order.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [this, splitX](int a, int b) {
+        const Box &boxA = m_boxes[a];
+        const Box &boxB = m_boxes[b];
+        return splitX ? boxA.x1 + boxA.x2 < boxB.x1 + boxB.x2
+                      : boxA.y1 + boxA.y2 < boxB.y1 + boxB.y2;
+    });
+
+    const int left = build(first, half);
+    const int right = build(first + half, count - half);
+    m_nodes[index].left = left;
+    m_nodes[index].right = right;
+    return index;
+}
@@ -0,0 +1,199 @@
+#ifndef BOX_TREE_H
+#define BOX_TREE_H
+
+#include <QVector>
+#include <QVarLengthArray>
+#include <QtGlobal>
+#include <limits>
+
+/**
+ * 静态包围盒层次（BVH）
+ *
+ * 元素只以包围盒和下标表示，几何由调用者自己保存，因此同一棵树可以用于
+ * 展平后的线段、原始贝塞尔段或整个图形。按中心点在跨度较大的轴上取中位数划分，
+ * 建立O(n log n)。支持单树区域查询、两棵树的重叠对遍历和最近对的分支限界搜索。
+ * 元素变化后应整体重建
+ */
+class BoxTree
+{
+public:
+    struct Box {
+        qreal x1;
+        qreal y1;
+        qreal x2;
+        qreal y2;
+
+        bool overlaps(const Box &other, qreal margin = 0) const
+        {
+            return x1 <= other.x2 + margin && other.x1 <= x2 + margin
+                && y1 <= other.y2 + margin && other.y1 <= y2 + margin;
+        }
+
+        Box united(const Box &other) const
+        {
+            return { qMin(x1, other.x1), qMin(y1, other.y1), qMax(x2, other.x2), qMax(y2, other.y2) };
+        }
+
+        // 两个包围盒之间的最小距离的平方，重叠时为0
+        qreal squaredDistanceTo(const Box &other) const
+        {
+            const qreal dx = qMax(qreal(0), qMax(x1 - other.x2, other.x1 - x2));
+            const qreal dy = qMax(qreal(0), qMax(y1 - other.y2, other.y1 - y2));
+            return dx * dx + dy * dy;
+        }
+    };
+
+    BoxTree() = default;
+    explicit BoxTree(const QVector<Box> &boxes);
+
+    int size() const { return m_boxes.size(); }
+    bool isEmpty() const { return m_boxes.isEmpty(); }
+    const Box &box(int index) const { return m_boxes[index]; }
+
+    /**
+     * 遍历包围盒与area重叠的元素，visitor签名为 void(int index)
+     */
+    template <typename Visitor>
+    void search(const Box &area, Visitor visitor) const
+    {
+        if (m_nodes.isEmpty()) {
+            return;
+        }
+        QVarLengthArray<int, 64> stack;
+        stack.append(0);
+        while (!stack.isEmpty()) {
+            const Node &node = m_nodes[stack.takeLast()];
+            if (!node.box.overlaps(area)) {
+                continue;
+            }
+            if (node.left < 0) {
+                for (int i = node.first; i < node.first + node.count; ++i) {
+                    if (m_boxes[m_order[i]].overlaps(area)) {
+                        visitor(m_order[i]);
+                    }
+                }
+            } else {
+                stack.append(node.left);
+                stack.append(node.right);
+            }
+        }
+    }
+
+    /**
+     * 遍历两棵树中包围盒距离不超过margin的元素对，visitor签名为 void(int index, int otherIndex)
+     */
+    template <typename Visitor>
+    void overlappingPairs(const BoxTree &other, qreal margin, Visitor visitor) const
+    {
+        if (m_nodes.isEmpty() || other.m_nodes.isEmpty()) {
+            return;
+        }
+        QVarLengthArray<NodePair, 64> stack;
+        stack.append({ 0, 0 });
+        while (!stack.isEmpty()) {
+            const NodePair pair = stack.takeLast();
+            const Node &a = m_nodes[pair.a];
+            const Node &b = other.m_nodes[pair.b];
+            if (!a.box.overlaps(b.box, margin)) {
+                continue;
+            }
+            if (a.left < 0 && b.left < 0) {
+                for (int i = a.first; i < a.first + a.count; ++i) {
+                    const Box &boxA = m_boxes[m_order[i]];
+                    for (int j = b.first; j < b.first + b.count; ++j) {
+                        if (boxA.overlaps(other.m_boxes[other.m_order[j]], margin)) {
+                            visitor(m_order[i], other.m_order[j]);
+                        }
+                    }
+                }
+            } else if (b.left < 0 || (a.left >= 0 && a.count >= b.count)) {
+                // 先展开较大的节点
+                stack.append({ a.left, pair.b });
+                stack.append({ a.right, pair.b });
+            } else {
+                stack.append({ pair.a, b.left });
+                stack.append({ pair.a, b.right });
+            }
+        }
+    }
+
+    /**
+     * 两棵树中元素间的最小距离。distance签名为 qreal(int index, int otherIndex, qreal best)，
+     * 返回两个元素的精确距离；包围盒距离不小于当前最优值的节点对被剪掉。
+     * 距离达到0时提前结束
+     */
+    template <typename Distance>
+    qreal nearestPair(const BoxTree &other, Distance distance,
+                      qreal best = std::numeric_limits<qreal>::max()) const
+    {
+        if (m_nodes.isEmpty() || other.m_nodes.isEmpty()) {
+            return best;
+        }
+        QVarLengthArray<NodePair, 64> stack;
+        stack.append({ 0, 0 });
+        while (!stack.isEmpty() && best > 0) {
+            const NodePair pair = stack.takeLast();
+            const Node &a = m_nodes[pair.a];
+            const Node &b = other.m_nodes[pair.b];
+            if (a.box.squaredDistanceTo(b.box) >= best * best) {
+                continue;
+            }
+            if (a.left < 0 && b.left < 0) {
+                for (int i = a.first; i < a.first + a.count && best > 0; ++i) {
+                    const Box &boxA = m_boxes[m_order[i]];
+                    for (int j = b.first; j < b.first + b.count; ++j) {
+                        if (boxA.squaredDistanceTo(other.m_boxes[other.m_order[j]]) < best * best) {
+                            best = qMin(best, distance(m_order[i], other.m_order[j], best));
+                        }
+                    }
+                }
+                continue;
+            }
+
+            NodePair first;
+            NodePair second;
+            if (b.left < 0 || (a.left >= 0 && a.count >= b.count)) {
+                first = { a.left, pair.b };
+                second = { a.right, pair.b };
+            } else {
+                first = { pair.a, b.left };
+                second = { pair.a, b.right };
+            }
+            // 较近的一对后入栈，先被访问，尽早收紧上界
+            const qreal firstDistance = m_nodes[first.a].box.squaredDistanceTo(other.m_nodes[first.b].box);
+            const qreal secondDistance = m_nodes[second.a].box.squaredDistanceTo(other.m_nodes[second.b].box);
+            if (firstDistance < secondDistance) {
+                stack.append(second);
+                stack.append(first);
+            } else {
+                stack.append(first);
+                stack.append(second);
+            }
+        }
+        return best;
+    }
+
+private:
+    struct Node {
+        Box box;
+        int left = -1;          // 内部节点的子节点，叶子为-1
+        int right = -1;
+        int first = 0;          // 叶子包含的m_order区间
+        int count = 0;
+    };
+
+    struct NodePair {
+        int a;
+        int b;
+    };
+
+    static constexpr int LeafSize = 8;
+
+    int build(int first, int count);
+
+    QVector<Box> m_boxes;
+    QVector<int> m_order;
+    QVector<Node> m_nodes;
+};
+
+#endif // BOX_TREE_H
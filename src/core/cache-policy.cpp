@@ -0,0 +1,206 @@
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QPixmapCache>
+#include <algorithm>
+#include "cache-policy.h"
+#include "drawing-shape.h"
+
+namespace {
+
+// 统计周期
+const int EvaluateIntervalMs = 1000;
+// 绘制耗时超过此值才值得缓存；低于降级阈值的已缓存图形降级（两者之间保持不变）
+const qreal PromoteCostMs = 0.25;
+const qreal DemoteCostMs = 0.05;
+// 每秒缓存重建次数达到此值说明内容频繁变化，缓存没有收益
+const qreal MaxRebuildRate = 2.0;
+// 因频繁重建降级后的冷却周期数，每次再降级加倍，最多加倍到MaxCooldownShift次
+const int BaseCooldownCycles = 2;
+const int MaxCooldownShift = 5;
+// 单个图形的缓存不超过此大小
+const qint64 MaxItemBytes = 16 * 1024 * 1024;
+// 保留的决策记录条数
+const int MaxDecisions = 8;
+
+QString cacheModeName(QGraphicsItem::CacheMode mode)
+{
+    switch (mode) {
+    case QGraphicsItem::DeviceCoordinateCache:
+        return QStringLiteral("设备缓存");
+    case QGraphicsItem::ItemCoordinateCache:
+        return QStringLiteral("项缓存");
+    default:
+        return QStringLiteral("无缓存");
+    }
+}
+
+} // namespace
+
+void PaintStats::record(qint64 costNs, bool cached)
+{
+    // 指数滑动平均，平滑偶发的慢帧
+    averageCostNs = everPainted ? (averageCostNs * 7 + costNs) / 8 : costNs;
+    everPainted = true;
+    ++paints;
+    if (cached) {
+        ++cachedPaints;
+    }
+}
+
+CachePolicy& CachePolicy::instance()
+{
+    // 不随静态对象析构，图形可能晚于静态对象销毁
+    static CachePolicy *instance = new CachePolicy();
+    return *instance;
+}
+
+CachePolicy::CachePolicy(QObject *parent)
+    : QObject(parent)
+    , m_enabled(true)
+    , m_memoryBudget(64 * 1024)
+{
+    QPixmapCache::setCacheLimit(m_memoryBudget);
+
+    m_timer.setInterval(EvaluateIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &CachePolicy::evaluate);
+    m_timer.start();
+    m_windowTimer.start();
+}
+
+void CachePolicy::registerShape(DrawingShape *shape)
+{
+    m_shapes.insert(shape);
+}
+
+void CachePolicy::unregisterShape(DrawingShape *shape)
+{
+    m_shapes.remove(shape);
+}
+
+void CachePolicy::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+void CachePolicy::setMemoryBudget(int kilobytes)
+{
+    m_memoryBudget = kilobytes;
+    QPixmapCache::setCacheLimit(kilobytes);
+}
+
+qint64 CachePolicy::estimatePixmapBytes(const QGraphicsItem *item, qreal viewScale)
+{
+    // 设备缓存的像素图与图形在视图中的大小一致，按ARGB32计算
+    const QRectF bounds = item->sceneBoundingRect();
+    const qreal width = qMin<qreal>(bounds.width() * viewScale + 2, 4096);
+    const qreal height = qMin<qreal>(bounds.height() * viewScale + 2, 4096);
+    return qint64(width) * qint64(height) * 4;
+}
+
+void CachePolicy::evaluate()
+{
+    const qreal seconds = qMax<qint64>(1, m_windowTimer.restart()) / 1000.0;
+
+    struct Candidate {
+        DrawingShape *shape;
+        qreal benefit;   // 每KB像素图节省的绘制时间
+        qint64 bytes;
+    };
+    QList<Candidate> candidates;
+
+    Stats stats;
+    stats.recentDecisions = m_stats.recentDecisions;
+    m_stats = stats;
+
+    for (DrawingShape *shape : std::as_const(m_shapes)) {
+        PaintStats &paint = shape->paintStats();
+        const QGraphicsItem::CacheMode mode = shape->cacheMode();
+        const qreal rebuildRate = paint.cachedPaints / seconds;
+        const qreal changeRate = paint.invalidations / seconds;
+        const int scenePaints = paint.paints;
+        paint.paints = 0;
+        paint.cachedPaints = 0;
+        paint.invalidations = 0;
+        if (paint.cooldown > 0) {
+            --paint.cooldown;
+        }
+
+        // 组合由子对象各自缓存
+        QGraphicsScene *scene = shape->scene();
+        if (!m_enabled || !scene || !paint.everPainted || shape->shapeType() == DrawingShape::Group) {
+            continue;
+        }
+
+        const QList<QGraphicsView*> views = scene->views();
+        const qreal viewScale = views.isEmpty() ? 1.0 : views.first()->transform().m11();
+        const qint64 bytes = estimatePixmapBytes(shape, viewScale);
+        const qreal costMs = paint.averageCostNs / 1e6;
+
+        if (mode != QGraphicsItem::NoCache) {
+            if (costMs < DemoteCostMs) {
+                recordDecision(shape, mode, QGraphicsItem::NoCache,
+                               QString("绘制仅%1 ms").arg(costMs, 0, 'f', 3));
+                continue;
+            }
+            if (rebuildRate >= MaxRebuildRate) {
+                paint.cooldown = BaseCooldownCycles << qMin(paint.rebuildDemotions, MaxCooldownShift);
+                ++paint.rebuildDemotions;
+                recordDecision(shape, mode, QGraphicsItem::NoCache,
+                               QString("每秒重建%1次").arg(rebuildRate, 0, 'f', 1));
+                continue;
+            }
+        } else if (scenePaints == 0 || costMs < PromoteCostMs || paint.cooldown > 0
+                   || changeRate >= MaxRebuildRate) {
+            // 本周期没有经过QGraphicsScene绘制（例如视图使用瓦片渲染）时缓存模式不起作用，不升级
+            continue;
+        }
+
+        if (bytes > MaxItemBytes) {
+            if (mode != QGraphicsItem::NoCache) {
+                recordDecision(shape, mode, QGraphicsItem::NoCache, QStringLiteral("像素图过大"));
+            }
+            continue;
+        }
+
+        candidates.append({shape, costMs * 1024.0 / qMax<qint64>(bytes, 1), bytes});
+    }
+
+    // 按收益从高到低分配预算
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.benefit > b.benefit;
+    });
+
+    const qint64 budgetBytes = qint64(m_memoryBudget) * 1024;
+    for (const Candidate &candidate : std::as_const(candidates)) {
+        const QGraphicsItem::CacheMode mode = candidate.shape->cacheMode();
+        if (m_stats.cachedBytes + candidate.bytes <= budgetBytes) {
+            m_stats.cachedBytes += candidate.bytes;
+            ++m_stats.cachedShapes;
+            if (mode == QGraphicsItem::NoCache) {
+                recordDecision(candidate.shape, mode, QGraphicsItem::DeviceCoordinateCache,
+                               QString("绘制%1 ms").arg(candidate.shape->paintStats().averageCostNs / 1e6, 0, 'f', 2));
+            }
+        } else if (mode != QGraphicsItem::NoCache) {
+            recordDecision(candidate.shape, mode, QGraphicsItem::NoCache, QStringLiteral("超出内存预算"));
+        }
+    }
+
+    emit policyUpdated();
+}
+
+void CachePolicy::recordDecision(DrawingShape *shape, QGraphicsItem::CacheMode from,
+                                 QGraphicsItem::CacheMode to, const QString &reason)
+{
+    shape->setCacheMode(to);
+    if (to == QGraphicsItem::NoCache) {
+        ++m_stats.demotions;
+    } else {
+        ++m_stats.promotions;
+    }
+
+    m_stats.recentDecisions.prepend(QString("%1: %2 → %3（%4）")
+                                        .arg(shape->id(), cacheModeName(from), cacheModeName(to), reason));
+    while (m_stats.recentDecisions.size() > MaxDecisions) {
+        m_stats.recentDecisions.removeLast();
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef CACHE_POLICY_H
+#define CACHE_POLICY_H
+
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QGraphicsItem>
+
+class DrawingShape;
+
+/**
+ * 图形的绘制统计，由DrawingShape::paint更新。只统计QGraphicsScene的绘制，
+ * 视图瓦片录制和直接绘制的图形不经过图形项缓存，不计入
+ */
+struct PaintStats
+{
+    qint64 averageCostNs = 0;   // 绘制耗时的指数滑动平均
+    int paints = 0;             // 本统计周期内QGraphicsScene的绘制次数
+    int cachedPaints = 0;       // 其中画进缓存像素图的次数，即缓存重建次数
+    int invalidations = 0;      // 本统计周期内的几何变化次数，与缓存模式无关
+    int cooldown = 0;           // 因频繁重建降级后，剩余多少个周期内不再升级
+    int rebuildDemotions = 0;   // 因频繁重建而降级的次数，用于加长冷却时间
+    bool everPainted = false;
+
+    void record(qint64 costNs, bool cached);
+};
+
+/**
+ * 自适应的图形缓存策略
+ *
+ * 每个统计周期根据图形实测的绘制耗时和缓存重建频率决定缓存模式：
+ * 绘制代价高、内容稳定的图形升级为设备缓存，代价低或频繁变化的图形降级为无缓存。
+ * 未缓存的图形没有重建次数可测，按几何变化次数判断是否稳定；因频繁重建降级的图形
+ * 在冷却期内不再升级，反复降级时冷却期加倍，避免在两种模式间来回切换。
+ * 只有经过QGraphicsScene绘制的图形才会升级：视图使用瓦片渲染时缓存模式不起作用。
+ * 所有缓存图形的像素图估算内存不超过全局预算，预算不足时优先保留收益最高的图形。
+ * 预算同时设置为QPixmapCache的容量上限（图形项缓存存放在QPixmapCache中）
+ */
+class CachePolicy : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CachePolicy& instance();
+
+    void registerShape(DrawingShape *shape);
+    void unregisterShape(DrawingShape *shape);
+
+    // 自动调整开关，关闭后保持各图形当前的缓存模式
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // 缓存像素图的内存预算（KB）
+    void setMemoryBudget(int kilobytes);
+    int memoryBudget() const { return m_memoryBudget; }
+
+    struct Stats {
+        int cachedShapes = 0;
+        qint64 cachedBytes = 0;     // 缓存图形的估算内存
+        int promotions = 0;         // 上一周期升级的图形数
+        int demotions = 0;          // 上一周期降级的图形数
+        QStringList recentDecisions;
+    };
+    Stats stats() const { return m_stats; }
+
+    /**
+     * 估算图形在当前缩放下的缓存像素图大小
+     */
+    static qint64 estimatePixmapBytes(const QGraphicsItem *item, qreal viewScale);
+
+signals:
+    void policyUpdated();
+
+private slots:
+    void evaluate();
+
+private:
+    CachePolicy(QObject *parent = nullptr);
+    ~CachePolicy() = default;
+
+    void recordDecision(DrawingShape *shape, QGraphicsItem::CacheMode from,
+                        QGraphicsItem::CacheMode to, const QString &reason);
+
+    QSet<DrawingShape*> m_shapes;
+    QTimer m_timer;
+    QElapsedTimer m_windowTimer;
+    bool m_enabled;
+    int m_memoryBudget;
+    Stats m_stats;
+};
+
+#endif // CACHE_POLICY_H
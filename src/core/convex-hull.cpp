@@ -0,0 +1,117 @@
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include "convex-hull.h"
+#include "polygon-clipper.h"
+
+namespace {
+
+// 少于此数量的路径串行处理，线程调度的开销大于收益
+const int MinParallelPaths = 64;
+
+inline qreal cross(const QPointF &o, const QPointF &a, const QPointF &b)
+{
+    return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+}
+
+} // namespace
+
+QPolygonF ConvexHull::ofPoints(QVector<QPointF> points)
+{
+    std::sort(points.begin(), points.end(), [](const QPointF &a, const QPointF &b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    const int count = points.size();
+    if (count < 3) {
+        return QPolygonF(points);
+    }
+
+    // 下链从左到右、上链从右到左，各自只保留叉积为正的转向
+    QPolygonF hull(2 * count);
+    int size = 0;
+    for (int i = 0; i < count; ++i) {
+        while (size >= 2 && cross(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+            --size;
+        }
+        hull[size++] = points[i];
+    }
+    const int lower = size + 1;
+    for (int i = count - 2; i >= 0; --i) {
+        while (size >= lower && cross(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+            --size;
+        }
+        hull[size++] = points[i];
+    }
+    // 最后一点与起点重复
+    hull.resize(size - 1);
+    return hull;
+}
+
+QPolygonF ConvexHull::ofPolygons(const QList<QPolygonF> &polygons)
+{
+    QVector<QPointF> points;
+    int total = 0;
+    for (const QPolygonF &polygon : polygons) {
+        total += polygon.size();
+    }
+    points.reserve(total);
+    for (const QPolygonF &polygon : polygons) {
+        points.append(polygon);
+    }
+    return ofPoints(std::move(points));
+}
+
+QPolygonF ConvexHull::ofPath(const QPainterPath &path)
+{
+    if (path.isEmpty()) {
+        return QPolygonF();
+    }
+    return ofPolygons(PolygonClipper::flatten(path));
+}
+
+QList<QPolygonF> ConvexHull::ofPaths(const QList<QPainterPath> &paths)
+{
+    QList<QPolygonF> hulls(paths.size());
+    const int threadCount = QThread::idealThreadCount();
+    if (threadCount < 2 || paths.size() < MinParallelPaths) {
+        for (int i = 0; i < paths.size(); ++i) {
+            hulls[i] = ofPath(paths[i]);
+        }
+        return hulls;
+    }
+
+    // 每个任务写入互不重叠的结果区间
+    QPolygonF *output = hulls.data();
+    const QPainterPath *input = paths.constData();
+    const int chunkSize = qMax(16, int(paths.size() / (threadCount * 4)));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    for (int begin = 0; begin < paths.size(); begin += chunkSize) {
+        const int end = qMin(begin + chunkSize, int(paths.size()));
+        pool.start([input, output, begin, end]() {
+            for (int i = begin; i < end; ++i) {
+                output[i] = ofPath(input[i]);
+            }
+        });
+    }
+    pool.waitForDone();
+    return hulls;
+}
+
+QPolygonF ConvexHull::ofHulls(const QList<QPolygonF> &hulls)
+{
+    return ofPolygons(hulls);
+}
+
+QPainterPath ConvexHull::toPath(const QPolygonF &hull)
+{
+    QPainterPath path;
+    if (hull.size() < 3) {
+        return path;
+    }
+    path.addPolygon(hull);
+    path.closeSubpath();
+    return path;
+}
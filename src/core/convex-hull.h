@@ -0,0 +1,46 @@
+#ifndef CONVEX_HULL_H
+#define CONVEX_HULL_H
+
+#include <QList>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QVector>
+
+/**
+ * 凸包（Andrew单调链，O(n log n)）
+ *
+ * 点按(x, y)排序后分别构造下链和上链，共线点不保留。结果为首尾不重复的闭合多边形，
+ * 在屏幕坐标（y向下）中按顺时针排列，鞋带面积为正，与PolygonClipper的外轮廓方向一致。
+ * 曲线先展平再取点，凸包顶点都在展平后的折线上。
+ * 多个图形的凸包等于各自凸包顶点合在一起的凸包，因此各图形缓存自己的凸包
+ * （未缓存的图形较多时并行计算），再对少量顶点求一次总的凸包
+ */
+class ConvexHull
+{
+public:
+    /**
+     * 点集的凸包，少于三个不共线的点时返回退化结果（单点或线段的两个端点）
+     */
+    static QPolygonF ofPoints(QVector<QPointF> points);
+
+    static QPolygonF ofPolygons(const QList<QPolygonF> &polygons);
+
+    static QPolygonF ofPath(const QPainterPath &path);
+
+    /**
+     * 各路径各自的凸包，路径较多时在线程池中并行计算
+     */
+    static QList<QPolygonF> ofPaths(const QList<QPainterPath> &paths);
+
+    /**
+     * 已有凸包（如DrawingShape缓存的凸包映射到场景坐标后）合在一起的凸包
+     */
+    static QPolygonF ofHulls(const QList<QPolygonF> &hulls);
+
+    /**
+     * 凸包转换为闭合路径，退化结果返回空路径
+     */
+    static QPainterPath toPath(const QPolygonF &hull);
+};
+
+#endif // CONVEX_HULL_H
@@ -3,6 +3,7 @@
 #include "../ui/drawingscene.h"
 #include "layer-manager.h"
 #include "svghandler.h"
+#include "vqt-format.h"
 #include "../ui/command-manager.h"
 
 DrawingDocument::DrawingDocument(QObject *parent)
@@ -105,7 +106,7 @@ bool DrawingDocument::save()
         return false;  // 需要调用saveAs
     }
     
-    return SvgHandler::exportToSvg(m_scene, m_filePath);
+    return saveToFile(m_filePath);
 }
 
 bool DrawingDocument::saveAs(const QString &filePath)
@@ -114,7 +115,7 @@ bool DrawingDocument::saveAs(const QString &filePath)
         return false;
     }
     
-    if (SvgHandler::exportToSvg(m_scene, filePath)) {
+    if (saveToFile(filePath)) {
         setFilePath(filePath);
         setModified(false);
         return true;
@@ -137,8 +138,11 @@ bool DrawingDocument::load(const QString &filePath)
     // 初始化文档
     initializeDocument();
     
-    // 加载SVG文件
-    if (SvgHandler::importFromSvg(m_scene, filePath)) {
+    // 按扩展名选择原生格式或SVG
+    const bool loaded = VqtFormat::isNativeFile(filePath)
+        ? VqtFormat::load(m_scene, filePath)
+        : SvgHandler::importFromSvg(m_scene, filePath);
+    if (loaded) {
         m_open = true;
         m_modified = false;
         m_isUntitled = false;
@@ -160,6 +164,15 @@ bool DrawingDocument::load(const QString &filePath)
     return false;
 }
 
+bool DrawingDocument::saveToFile(const QString &filePath)
+{
+    // .vqt使用原生二进制格式，其余按SVG导出
+    if (VqtFormat::isNativeFile(filePath)) {
+        return VqtFormat::save(m_scene, filePath);
+    }
+    return SvgHandler::exportToSvg(m_scene, filePath);
+}
+
 void DrawingDocument::initializeDocument()
 {
     // 清理场景
@@ -53,6 +53,7 @@ signals:
 private:
     void initializeDocument();      // 初始化文档
     void cleanupDocument();         // 清理文档
+    bool saveToFile(const QString &filePath);  // 按扩展名选择保存格式
     
     DrawingScene *m_scene;
     LayerManager *m_layerManager;   // 暂时使用单例，后续改为成员变量
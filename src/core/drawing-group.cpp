@@ -9,6 +9,8 @@
 #include <limits>
 #include "drawing-group.h"
 #include "drawing-shape.h"
+#include "shape-record.h"
+#include "convex-hull.h"
 #include "../ui/drawingscene.h"
 
 DrawingGroup::DrawingGroup(QGraphicsItem *parent)
@@ -84,6 +86,29 @@ void DrawingGroup::addItem(DrawingShape *item)
     item->setFlag(QGraphicsItem::ItemIsMovable, false);
     item->setFlag(QGraphicsItem::ItemIsSelectable, false);
 
+    updateBounds();
+}
+
+void DrawingGroup::restoreItem(DrawingShape *item)
+{
+    if (!item)
+    {
+        return;
+    }
+
+    m_initialTransforms[item] = item->transform();
+    item->setParentItem(this);
+    m_items.append(item);
+
+    // 禁用子项的鼠标事件，让组合对象处理所有事件
+    item->setFlag(QGraphicsItem::ItemIsMovable, false);
+    item->setFlag(QGraphicsItem::ItemIsSelectable, false);
+
+    updateBounds();
+}
+
+void DrawingGroup::updateBounds()
+{
     // 计算所有子项在组坐标系中的边界框
     QRectF combinedBounds;
     bool first = true;
@@ -109,6 +134,7 @@ void DrawingGroup::addItem(DrawingShape *item)
         }
     }
 
+    prepareGeometryChange();
     m_currentBounds = combinedBounds;
 }
 
@@ -189,13 +215,26 @@ void DrawingGroup::paintShape(QPainter *painter)
     Q_UNUSED(painter);
 }
 
-QPainterPath DrawingGroup::shape() const
+QPainterPath DrawingGroup::computeShape() const
 {
     QPainterPath path;
     path.addRect(boundingRect());
     return path;
 }
 
+QPolygonF DrawingGroup::computeConvexHull() const
+{
+    // 子项缓存的凸包映射到组的坐标系后再合并
+    QList<QPolygonF> hulls;
+    hulls.reserve(m_items.size());
+    for (DrawingShape *item : m_items) {
+        if (item) {
+            hulls.append(item->mapToParent(item->convexHull()));
+        }
+    }
+    return ConvexHull::ofHulls(hulls);
+}
+
 void DrawingGroup::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
 
@@ -295,172 +334,61 @@ void DrawingGroup::applyTransform(const QTransform &transform, const QPointF &an
 }
 
 // DrawingGroup 序列化方法
-QByteArray DrawingGroup::serialize() const
+void DrawingGroup::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 写入类型标识
-    stream << static_cast<int>(DrawingShape::Group);
-
-    // 写入位置信息
-    stream << pos();
-    stream << scale();
-    stream << rotation();
-    stream << transform();
-    stream << zValue();
-    stream << isVisible();
-    stream << isEnabled();
-    stream << fillBrush();
-    stream << strokePen();
-    stream << opacity();
-    stream << id();
-
-    // 写入子对象数量
-    stream << m_items.count();
+    DrawingShape::writeFields(writer);
+
     qDebug() << "DrawingGroup::serialize: serializing group with" << m_items.count() << "children";
 
-    // 序列化每个子对象
+    // 每个子对象作为嵌套记录写入同一个缓冲区
+    // 子对象的位置已经是相对于组合对象的本地坐标
     for (DrawingShape *item : m_items)
     {
         if (item)
         {
-            qDebug() << "DrawingGroup::serialize: serializing child item type:" << item->shapeType() << "pos:" << item->pos();
-            // 子对象的位置已经是相对于组合对象的本地坐标
-            QByteArray itemData = item->serialize();
-            stream << itemData;
+            writer.beginField(FieldGroupChild);
+            writer.writeShape(item);
+            writer.endField();
         }
     }
-
-    return data;
 }
 
-void DrawingGroup::deserialize(const QByteArray &data)
+bool DrawingGroup::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    QDataStream stream(data);
-
-    // 读取类型标识
-    int typeValue;
-    stream >> typeValue;
-
-    // 读取位置信息
-    QPointF position;
-    stream >> position;
-    setPos(position);
-
-    qreal scaleValue;
-    stream >> scaleValue;
-    setScale(scaleValue);
-
-    qreal rotationValue;
-    stream >> rotationValue;
-    setRotation(rotationValue);
-
-    QTransform transform;
-    stream >> transform;
-    setTransform(transform);
-
-    qreal zValue;
-    stream >> zValue;
-    setZValue(zValue);
+    if (fieldId != FieldGroupChild)
+    {
+        return DrawingShape::readField(fieldId, reader);
+    }
 
-    bool visible;
-    stream >> visible;
-    setVisible(visible);
+    DrawingShape *item = reader.readShape();
+    if (!item)
+    {
+        // 未知类型的子对象，跳过
+        return true;
+    }
 
-    bool enabled;
-    stream >> enabled;
-    setEnabled(enabled);
+    qDebug() << "DrawingGroup::deserialize: deserialized child item type:" << item->shapeType() << "pos:" << item->pos() << "visible:" << item->isVisible();
 
-    QBrush fillBrush;
-    stream >> fillBrush;
-    setFillBrush(fillBrush);
+    // 直接设置父子关系，不调用addItem以避免坐标转换
+    item->setParentItem(this);
+    m_items.append(item);
 
-    QPen strokePen;
-    stream >> strokePen;
-    setStrokePen(strokePen);
+    // 确保子对象可见
+    item->setVisible(true);
 
-    qreal opacity;
-    stream >> opacity;
-    setOpacity(opacity);
+    // 禁用子项的鼠标事件，让组合对象处理所有事件
+    item->setFlag(QGraphicsItem::ItemIsMovable, false);
+    item->setFlag(QGraphicsItem::ItemIsSelectable, false);
 
-    QString id;
-    stream >> id;
-    setId(id);
+    return true;
+}
 
-    // 读取子对象数量
-    int itemCount;
-    stream >> itemCount;
-    qDebug() << "DrawingGroup::deserialize: reading group with" << itemCount << "children";
+void DrawingGroup::beginDeserialize()
+{
+    DrawingShape::beginDeserialize();
 
-    // 清空现有子对象
+    // 清空现有子对象，子对象随后逐个从嵌套记录中读取
     m_items.clear();
-
-    // 反序列化每个子对象
-    for (int i = 0; i < itemCount; ++i)
-    {
-        QByteArray itemData;
-        stream >> itemData;
-
-        // 读取形状类型
-        QDataStream typeStream(itemData);
-        int typeValue;
-        typeStream >> typeValue;
-        DrawingShape::ShapeType shapeType = static_cast<DrawingShape::ShapeType>(typeValue);
-
-        // 创建对应的形状对象
-        DrawingShape *item = nullptr;
-        switch (shapeType)
-        {
-        case DrawingShape::Rectangle:
-            item = new DrawingRectangle();
-            break;
-        case DrawingShape::Ellipse:
-            item = new DrawingEllipse();
-            break;
-        case DrawingShape::Line:
-            item = new DrawingLine();
-            break;
-        case DrawingShape::Path:
-            item = new DrawingPath();
-            break;
-        case DrawingShape::Polyline:
-            item = new DrawingPolyline();
-            break;
-        case DrawingShape::Polygon:
-            item = new DrawingPolygon();
-            break;
-        case DrawingShape::Text:
-            item = new DrawingText();
-            break;
-        case DrawingShape::Group:
-            item = new DrawingGroup();
-            break;
-        default:
-            continue;
-        }
-
-        if (item)
-        {
-            item->deserialize(itemData);
-            qDebug() << "DrawingGroup::deserialize: deserialized child item type:" << shapeType << "pos:" << item->pos() << "visible:" << item->isVisible();
-
-            // 直接设置父子关系，不调用addItem以避免坐标转换
-            item->setParentItem(this);
-            m_items.append(item);
-
-            // 确保子对象可见
-            item->setVisible(true);
-
-            // 禁用子项的鼠标事件，让组合对象处理所有事件
-            item->setFlag(QGraphicsItem::ItemIsMovable, false);
-            item->setFlag(QGraphicsItem::ItemIsSelectable, false);
-
-            qDebug() << "DrawingGroup::deserialize: child item parent set, visible:" << item->isVisible();
-        }
-    }
-
-    update();
 }
 
 DrawingShape *DrawingGroup::clone() const
@@ -29,20 +29,31 @@ public:
     void removeItem(DrawingShape *item);
     QList<DrawingShape *> items() const { return m_items; }
 
+    /**
+     * 加载文档时恢复子元素：子元素已带有组内的本地坐标和变换，
+     * 直接建立父子关系，不做addItem的坐标转换和变换重置
+     */
+    void restoreItem(DrawingShape *item);
+
     // 取消组合
     QList<DrawingShape *> ungroup();
 
     // 重写DrawingShape的必要方法
     QRectF localBounds() const override;
     void paintShape(QPainter *painter) override;
-
-    // QGraphicsItem重写
-    QPainterPath shape() const override;
+    // 组合自身不绘制，没有省去的遍数
+    int savedPaintPasses() const override { return 0; }
 
     // 🌟 重写setTransform方法，确保变换传播到子项
     void applyTransform(const QTransform &transform, const QPointF &anchor = QPointF()) override;
 
 protected:
+    // 组合的形状即边界框
+    QPainterPath computeShape() const override;
+    // 凸包由各子项的凸包合成，而不是边界框
+    QPolygonF computeConvexHull() const override;
+    bool convexHullFromShape() const override { return false; }
+
     // 变换通知
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
 
@@ -53,11 +64,15 @@ protected:
     
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
+    void beginDeserialize() override;
     DrawingShape* clone() const override;
     
 private:
+    // 按子项在组坐标系中的边界重新计算组合的边界框
+    void updateBounds();
+
     QList<DrawingShape *> m_items;
     QHash<DrawingShape *, QTransform> m_initialTransforms; // 保存初始变换
 
@@ -87,8 +87,8 @@ void DrawingLayer::addShape(DrawingShape *shape)
 void DrawingLayer::removeShape(DrawingShape *shape)
 {
     if (m_shapes.removeOne(shape)) {
-        // 从场景中移除图形
-        if (m_scene) {
+        // 从场景中移除图形（可能已被删除命令移出场景）
+        if (m_scene && shape->scene() == m_scene) {
             m_scene->removeItem(shape);
         }
         
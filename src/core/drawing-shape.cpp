@@ -12,8 +12,12 @@
 #include <QDomElement>
 #include <QRandomGenerator>
 #include <QDateTime>
+#include <QElapsedTimer>
 
 #include "drawing-shape.h"
+#include "shape-record.h"
+#include "path-lod.h"
+#include "convex-hull.h"
 #include "drawing-document.h"
 #include "smart-render-manager.h"
 #include "toolbase.h"
@@ -23,6 +27,10 @@
 #include "../ui/drawingscene.h"
 #include "../ui/snap-manager.h"
 #include "../ui/command-manager.h"
+
+// 几何缓存统计，图形只在GUI线程访问
+static DrawingShape::GeometryCacheStats s_geometryCacheStats;
+
 // BezierControlPointCommand 实现
 BezierControlPointCommand::BezierControlPointCommand(DrawingScene *scene, DrawingPath *path, int pointIndex,
                                                      const QPointF &oldPos, const QPointF &newPos, QUndoCommand *parent)
@@ -65,23 +73,36 @@ void BezierControlPointCommand::redo()
 
 // DrawingShape
 DrawingShape::DrawingShape(ShapeType type, QGraphicsItem *parent)
-    : QGraphicsItem(parent), m_id(generateUniqueId()), m_type(type), m_fillBrush(Qt::white), m_strokePen(QPen(Qt::black, 1.0)), m_showSelectionIndicator(true), m_isMoving(false), m_moveStartPos(0, 0)
+    : QGraphicsItem(parent), m_id(generateUniqueId()), m_type(type), m_fillBrush(Qt::white), m_strokePen(QPen(Qt::black, 1.0)), m_cosmeticPen(m_strokePen), m_showSelectionIndicator(true), m_isMoving(false), m_moveStartPos(0, 0)
 {
     setFlags(QGraphicsItem::ItemIsSelectable |
              QGraphicsItem::ItemIsMovable |
              QGraphicsItem::ItemSendsGeometryChanges);
 
+    m_cosmeticPen.setCosmetic(true);
+
     // Qt原生渲染优化 - 启用设备缓存
     setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 
     // 根据图形复杂度设置不同的缓存策略
     setupCacheMode();
+
+    // 初始缓存模式按类型选择，之后由CachePolicy按实测的绘制代价调整
+    CachePolicy::instance().registerShape(this);
 }
 
 DrawingShape::~DrawingShape()
 {
     // 在析构过程中不调用任何可能导致虚函数调用的方法
     // Qt会自动清理graphics effect和其他资源
+    CachePolicy::instance().unregisterShape(this);
+
+    // 直接删除场景中的图形时不会收到ItemSceneChange
+    DrawingScene *drawingScene = qobject_cast<DrawingScene *>(scene());
+    if (drawingScene)
+    {
+        drawingScene->notifyShapeRemoved(this);
+    }
 }
 
 QString DrawingShape::generateUniqueId()
@@ -121,10 +142,20 @@ void DrawingShape::notifyObjectStateChanged()
     DrawingScene *drawingScene = qobject_cast<DrawingScene *>(scene());
     if (drawingScene)
     {
+        drawingScene->notifyShapeGeometryChanged(this);
         emit drawingScene->objectStateChanged(this);
     }
 }
 
+void DrawingShape::markGeometryDirty()
+{
+    DrawingScene *drawingScene = qobject_cast<DrawingScene *>(scene());
+    if (drawingScene)
+    {
+        drawingScene->notifyShapeGeometryChanged(this);
+    }
+}
+
 void DrawingShape::setupCacheMode()
 {
     // 根据图形类型和复杂度设置缓存策略
@@ -172,6 +203,7 @@ void DrawingShape::rotateAroundAnchor(double angle, const QPointF &center)
     newTransform.translate(center.x(), center.y());
     newTransform.rotate(angle);
     newTransform.translate(-center.x(), -center.y());
+    prepareGeometryChange();
     m_transform = newTransform;
     update();
 
@@ -184,6 +216,7 @@ void DrawingShape::scaleAroundAnchor(double sx, double sy, const QPointF &center
     newTransform.translate(center.x(), center.y());
     newTransform.scale(sx, sy);
     newTransform.translate(-center.x(), -center.y());
+    prepareGeometryChange();
     m_transform = newTransform;
     update();
 
@@ -196,6 +229,7 @@ void DrawingShape::shearAroundAnchor(double sh, double sv, const QPointF &center
     newTransform.translate(center.x(), center.y());
     newTransform.shear(sh, sv);
     newTransform.translate(-center.x(), -center.y());
+    prepareGeometryChange();
     m_transform = newTransform;
     update();
 
@@ -204,13 +238,152 @@ void DrawingShape::shearAroundAnchor(double sh, double sv, const QPointF &center
 
 QRectF DrawingShape::boundingRect() const
 {
+    if (m_geometryCacheFlags & BoundsCached)
+    {
+        ++s_geometryCacheStats.hits;
+        return m_cachedBounds;
+    }
+    ++s_geometryCacheStats.misses;
+
     // 直接使用QTransform的mapRect方法
-    QRectF localBoundsRect = localBounds();
-    QRectF transformedBounds = m_transform.mapRect(localBoundsRect);
-    return transformedBounds;
+    m_cachedBounds = m_transform.mapRect(localBounds());
+    m_geometryCacheFlags |= BoundsCached;
+    return m_cachedBounds;
 }
 
 QPainterPath DrawingShape::shape() const
+{
+    if (m_geometryCacheFlags & ShapeCached)
+    {
+        ++s_geometryCacheStats.hits;
+        return m_cachedShape;
+    }
+    ++s_geometryCacheStats.misses;
+
+    m_cachedShape = computeShape();
+    m_geometryCacheFlags |= ShapeCached;
+    return m_cachedShape;
+}
+
+QPainterPath DrawingShape::transformedShape() const
+{
+    if (m_geometryCacheFlags & TransformedShapeCached)
+    {
+        ++s_geometryCacheStats.hits;
+        return m_cachedTransformedShape;
+    }
+    ++s_geometryCacheStats.misses;
+
+    m_cachedTransformedShape = computeTransformedShape();
+    m_geometryCacheFlags |= TransformedShapeCached;
+    return m_cachedTransformedShape;
+}
+
+const QList<QPolygonF> &DrawingShape::flattenedOutline() const
+{
+    if (m_geometryCacheFlags & OutlineCached)
+    {
+        ++s_geometryCacheStats.hits;
+        return m_cachedOutline;
+    }
+    ++s_geometryCacheStats.misses;
+
+    m_cachedOutline = shape().toSubpathPolygons();
+    m_geometryCacheFlags |= OutlineCached;
+    return m_cachedOutline;
+}
+
+const QPolygonF &DrawingShape::convexHull() const
+{
+    if (m_geometryCacheFlags & HullCached)
+    {
+        ++s_geometryCacheStats.hits;
+        return m_cachedHull;
+    }
+    ++s_geometryCacheStats.misses;
+
+    m_cachedHull = computeConvexHull();
+    m_geometryCacheFlags |= HullCached;
+    return m_cachedHull;
+}
+
+void DrawingShape::cacheConvexHulls(const QList<DrawingShape *> &shapes)
+{
+    // 图形项和缓存都不是线程安全的：路径在GUI线程取出，工作线程只处理路径副本，
+    // 结果回到GUI线程后再写入缓存。组合的凸包由子项缓存合成，只需展开到子项
+    QList<DrawingShape *> pending;
+    QList<QPainterPath> paths;
+    QList<DrawingShape *> stack = shapes;
+    while (!stack.isEmpty())
+    {
+        DrawingShape *shape = stack.takeLast();
+        if (!shape || (shape->m_geometryCacheFlags & HullCached))
+        {
+            continue;
+        }
+        if (shape->convexHullFromShape())
+        {
+            pending.append(shape);
+            paths.append(shape->transformedShape());
+        }
+        for (QGraphicsItem *child : shape->childItems())
+        {
+            if (DrawingShape *childShape = dynamic_cast<DrawingShape *>(child))
+            {
+                stack.append(childShape);
+            }
+        }
+    }
+
+    const QList<QPolygonF> hulls = ConvexHull::ofPaths(paths);
+    for (int i = 0; i < pending.size(); ++i)
+    {
+        DrawingShape *shape = pending[i];
+        if (!(shape->m_geometryCacheFlags & HullCached))
+        {
+            ++s_geometryCacheStats.misses;
+            shape->m_cachedHull = hulls[i];
+            shape->m_geometryCacheFlags |= HullCached;
+        }
+    }
+}
+
+void DrawingShape::invalidateGeometryCache()
+{
+    if (m_geometryCacheFlags == 0)
+    {
+        return;
+    }
+    ++s_geometryCacheStats.invalidations;
+
+    m_geometryCacheFlags = 0;
+    // 释放路径数据，避免大路径在下次查询前一直占用内存
+    m_cachedShape = QPainterPath();
+    m_cachedTransformedShape = QPainterPath();
+    m_cachedOutline.clear();
+    m_cachedHull.clear();
+}
+
+void DrawingShape::prepareGeometryChange()
+{
+    // 先让Qt按旧边界登记重绘区域，再丢弃缓存
+    QGraphicsItem::prepareGeometryChange();
+    invalidateGeometryCache();
+    // 未缓存时没有重建次数可测，缓存策略按变化次数判断内容是否稳定
+    ++m_paintStats.invalidations;
+}
+
+DrawingShape::GeometryCacheStats DrawingShape::geometryCacheStats()
+{
+    return s_geometryCacheStats;
+}
+
+void DrawingShape::resetGeometryCacheStats()
+{
+    s_geometryCacheStats = GeometryCacheStats();
+}
+
+QPainterPath DrawingShape::computeShape() const
 {
     // 使用transformedShape()方法，它已经正确处理了变换和填充规则
     QPainterPath path = transformedShape();
@@ -237,7 +410,7 @@ QPainterPath DrawingShape::shape() const
     return path;
 }
 
-QPainterPath DrawingShape::transformedShape() const
+QPainterPath DrawingShape::computeTransformedShape() const
 {
     QPainterPath path;
     // 创建本地边界的路径
@@ -248,10 +421,24 @@ QPainterPath DrawingShape::transformedShape() const
     return path;
 }
 
+QPolygonF DrawingShape::computeConvexHull() const
+{
+    // 用几何路径而不是shape()，后者可能为便于选择加宽了描边
+    return ConvexHull::ofPath(transformedShape());
+}
+
+int DrawingShape::savedPaintPasses() const
+{
+    // 旧的填充遍不用画笔，描边遍不用画刷；其中一个不可见时QPainter直接跳过那一遍
+    return m_fillBrush.style() != Qt::NoBrush && m_strokePen.style() != Qt::NoPen ? 1 : 0;
+}
+
 void DrawingShape::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     Q_UNUSED(option)
-    Q_UNUSED(widget)
+
+    QElapsedTimer paintTimer;
+    paintTimer.start();
 
     // 保存当前变换状态
     painter->save();
@@ -259,23 +446,25 @@ void DrawingShape::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
     // 应用变换矩阵
     painter->setTransform(m_transform, true);
 
-    // 绘制填充
+    // 填充和描边一次绘制：QPainter先填充再描边，与分两遍绘制的结果相同，
+    // 但几何只需处理一次。描边使用缓存的cosmetic笔，不受变换影响
     painter->setBrush(m_fillBrush);
-    painter->setPen(Qt::NoPen);
-    paintShape(painter);
-
-    // 绘制描边 - 使用cosmetic笔确保描边不受变换影响
-    painter->setBrush(Qt::NoBrush);
-    
-    // 创建cosmetic描边笔，确保描边宽度不受变换影响
-    QPen cosmeticPen = m_strokePen;
-    cosmeticPen.setCosmetic(true);
-    painter->setPen(cosmeticPen);
+    painter->setPen(m_cosmeticPen);
     paintShape(painter);
+    RenderProfiler::instance().addCount(RenderProfiler::SavedGeometryPasses, savedPaintPasses());
 
     // 恢复变换状态
     painter->restore();
 
+    // 缓存策略只统计QGraphicsScene的绘制：视图的瓦片录制和直接绘制不经过图形项缓存，
+    // 调用时widget为空。启用缓存时场景先把图形画进像素图，只有这种绘制才是缓存重建
+    if (widget && painter->device())
+    {
+        const bool rebuild = cacheMode() != QGraphicsItem::NoCache
+            && painter->device()->devType() == QInternal::Pixmap;
+        m_paintStats.record(paintTimer.nsecsElapsed(), rebuild);
+    }
+
     // 绘制选择指示器（在场景坐标系中）
     // 只有当m_showSelectionIndicator为true且图形被选中时才绘制
     if (isSelected() && m_showSelectionIndicator)
@@ -337,9 +526,36 @@ QVariant DrawingShape::itemChange(GraphicsItemChange change, const QVariant &val
         // 通知对象状态已变化
         notifyObjectStateChanged();
     }
+    else if (change == ItemVisibleHasChanged)
+    {
+        markGeometryDirty();
+    }
+    else if (change == ItemSceneHasChanged)
+    {
+        DrawingScene *drawingScene = qobject_cast<DrawingScene *>(scene());
+        if (drawingScene)
+        {
+            drawingScene->notifyShapeAdded(this);
+        }
+    }
+    else if (change == ItemSceneChange)
+    {
+        // 从旧场景的索引中移除
+        DrawingScene *drawingScene = qobject_cast<DrawingScene *>(scene());
+        if (drawingScene)
+        {
+            drawingScene->notifyShapeRemoved(this);
+        }
+    }
     else if (change == ItemParentHasChanged)
     {
         // 老的手柄系统已移除，不再需要更新手柄状态
+        // 组合和取消组合会改变堆叠次序和场景位置
+        DrawingScene *drawingScene = qobject_cast<DrawingScene *>(scene());
+        if (drawingScene)
+        {
+            drawingScene->notifyShapeAdded(this);
+        }
     }
 
     return QGraphicsItem::itemChange(change, value);
@@ -438,7 +654,7 @@ QRectF DrawingRectangle::localBounds() const
     return m_rect;
 }
 
-QPainterPath DrawingRectangle::shape() const
+QPainterPath DrawingRectangle::computeShape() const
 {
     QPainterPath path;
     if (m_cornerRadius > 0)
@@ -466,7 +682,7 @@ QPainterPath DrawingRectangle::shape() const
     return path;
 }
 
-QPainterPath DrawingRectangle::transformedShape() const
+QPainterPath DrawingRectangle::computeTransformedShape() const
 {
     QPainterPath path;
     if (m_cornerRadius > 0)
@@ -495,6 +711,7 @@ void DrawingRectangle::setRectangle(const QRectF &rect)
     if (m_rect != rect)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_rect = rect;
         update(); // 直接赋值需要手动调用update()
     }
@@ -506,6 +723,8 @@ void DrawingRectangle::setCornerRadius(qreal radius)
     if (qAbs(m_cornerRadius - radius) > 0.001)
     {
         m_cornerRadius = radius;
+        invalidateGeometryCache();
+        markGeometryDirty();
         update(); // 直接赋值需要手动调用update()
     }
 }
@@ -584,6 +803,8 @@ void DrawingRectangle::setNodePoint(int index, const QPointF &pos)
 
         // 更新实际的圆角半径
         m_cornerRadius = qMin(m_rect.width() * m_fRatioX, m_rect.height() * m_fRatioY);
+        invalidateGeometryCache();
+        markGeometryDirty();
         update();
         break;
     }
@@ -682,6 +903,7 @@ void DrawingRectangle::bakeTransform(const QTransform &transform)
     QRectF newRect = transform.mapRect(m_rect);
 
     // 更新几何结构
+    prepareGeometryChange();
     m_rect = newRect;
 
     // 同时更新圆角半径
@@ -733,42 +955,34 @@ QVector<NodeInfo> DrawingRectangle::getNodeInfo() const
 }
 
 // DrawingRectangle 序列化方法
-QByteArray DrawingRectangle::serialize() const
+void DrawingRectangle::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
+    DrawingShape::writeFields(writer);
 
     // 写入矩形特定属性
-    stream << m_rect;
-    stream << m_cornerRadius;
-    stream << m_fRatioX;
-    stream << m_fRatioY;
-
-    return data;
-}
-
-void DrawingRectangle::deserialize(const QByteArray &data)
-{
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取矩形特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    // 基类读取了：type, position, scale, rotation, transform, zValue, visible, enabled, fillBrush, strokePen, opacity, id
-    stream.device()->seek(DrawingShape::serialize().size());
-
-    // 读取矩形特定属性
-    stream >> m_rect;
-    stream >> m_cornerRadius;
-    stream >> m_fRatioX;
-    stream >> m_fRatioY;
-
-    update();
+    writer.writeField(FieldRect, m_rect);
+    writer.writeField(FieldCornerRadius, m_cornerRadius);
+    writer.beginField(FieldCornerRatios);
+    writer.stream() << m_fRatioX << m_fRatioY;
+    writer.endField();
+}
+
+bool DrawingRectangle::readField(quint16 fieldId, ShapeRecordReader &reader)
+{
+    switch (fieldId)
+    {
+    case FieldRect:
+        m_rect = reader.read<QRectF>();
+        return true;
+    case FieldCornerRadius:
+        m_cornerRadius = reader.read<qreal>();
+        return true;
+    case FieldCornerRatios:
+        reader.stream() >> m_fRatioX >> m_fRatioY;
+        return true;
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingRectangle::clone() const
@@ -794,7 +1008,7 @@ QRectF DrawingEllipse::localBounds() const
     return m_rect;
 }
 
-QPainterPath DrawingEllipse::shape() const
+QPainterPath DrawingEllipse::computeShape() const
 {
     QPainterPath path;
     path.addEllipse(m_rect);
@@ -813,7 +1027,7 @@ QPainterPath DrawingEllipse::shape() const
     return path;
 }
 
-QPainterPath DrawingEllipse::transformedShape() const
+QPainterPath DrawingEllipse::computeTransformedShape() const
 {
     QPainterPath path;
     path.addEllipse(m_rect);
@@ -832,6 +1046,7 @@ void DrawingEllipse::setEllipse(const QRectF &rect)
     if (m_rect != rect)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_rect = rect;
         update();
     }
@@ -1110,6 +1325,7 @@ void DrawingEllipse::bakeTransform(const QTransform &transform)
     QRectF newRect = transform.mapRect(m_rect);
 
     // 更新几何结构
+    prepareGeometryChange();
     m_rect = newRect;
 
     // 更新显示
@@ -1152,46 +1368,30 @@ QVector<NodeInfo> DrawingEllipse::getNodeInfo() const
 }
 
 // DrawingEllipse 序列化方法
-QByteArray DrawingEllipse::serialize() const
+void DrawingEllipse::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
-
-    // 写入椭圆特定属性
-    stream << m_rect;
-    stream << strokePen();
-    stream << fillBrush();
+    DrawingShape::writeFields(writer);
 
-    return data;
+    // 写入椭圆特定属性，画笔和画刷已由基类写入
+    writer.writeField(FieldRect, m_rect);
+    writer.beginField(FieldEllipseAngles);
+    writer.stream() << m_startAngle << m_spanAngle;
+    writer.endField();
 }
 
-void DrawingEllipse::deserialize(const QByteArray &data)
+bool DrawingEllipse::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取椭圆特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    // 基类读取了：type, position, scale, rotation, transform, zValue, visible, enabled, fillBrush, strokePen, opacity, id
-    stream.device()->seek(DrawingShape::serialize().size());
-
-    // 读取椭圆特定属性
-    stream >> m_rect;
-
-    QPen newPen;
-    stream >> newPen;
-    setStrokePen(newPen);
-
-    QBrush newBrush;
-    stream >> newBrush;
-    setFillBrush(newBrush);
-
-    update();
+    switch (fieldId)
+    {
+    case FieldRect:
+        m_rect = reader.read<QRectF>();
+        return true;
+    case FieldEllipseAngles:
+        reader.stream() >> m_startAngle >> m_spanAngle;
+        return true;
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingEllipse::clone() const
@@ -1217,6 +1417,9 @@ void DrawingPath::setMarker(const QString &markerId, const MarkerData &markerDat
 
 void DrawingPath::setMarker(const QString &markerId, const MarkerData &markerData, const QTransform &markerTransform, const QString &position)
 {
+    // marker扩展路径的边界框
+    prepareGeometryChange();
+
     // 对于start和end位置，移除现有marker（只有一个）
     if (position == "start" || position == "end") {
         for (int i = 0; i < m_markers.size(); ++i) {
@@ -1274,30 +1477,67 @@ void DrawingPath::clearHighlights()
 
 int DrawingPath::findNodeAt(const QPointF &pos, qreal threshold) const
 {
-    QPointF localPos = mapFromScene(pos);
+    if (m_controlPoints.isEmpty())
+    {
+        return -1;
+    }
+
+    // 控制点经DrawingTransform和图形的场景变换映射到场景坐标
+    const QTransform localToScene = m_transform * sceneTransform();
+    bool invertible = false;
+    const QTransform sceneToLocal = localToScene.inverted(&invertible);
+    if (!invertible)
+    {
+        return -1;
+    }
+
+    // 索引在首次查询时建立，控制点修改后丢弃
+    if (!m_nodeIndex)
+    {
+        m_nodeIndex = std::make_shared<PointKdTree>(m_controlPoints);
+    }
 
-    for (int i = 0; i < m_controlPoints.size(); ++i)
+    // 按变换的最小缩放比例换算本地坐标中的搜索半径，候选点再按场景距离筛选
+    const qreal a = localToScene.m11();
+    const qreal b = localToScene.m12();
+    const qreal c = localToScene.m21();
+    const qreal d = localToScene.m22();
+    const qreal sum = a * a + b * b + c * c + d * d;
+    const qreal det = a * d - b * c;
+    const qreal minScale = qSqrt(qMax(qreal(0), (sum - qSqrt(qMax(qreal(0), sum * sum - 4 * det * det))) / 2));
+    if (minScale <= 0)
     {
-        QPointF distance = localPos - m_controlPoints[i];
-        qreal squaredDistance = distance.x() * distance.x() + distance.y() * distance.y();
-        if (squaredDistance <= threshold * threshold)
+        return -1;
+    }
+
+    const QVector<int> candidates = m_nodeIndex->pointsWithin(sceneToLocal.map(pos), threshold / minScale);
+    int nearestIndex = -1;
+    qreal nearestDistance = threshold;
+    for (int index : candidates)
+    {
+        const qreal distance = QLineF(pos, localToScene.map(m_controlPoints[index])).length();
+        if (distance < nearestDistance || (distance == nearestDistance && (nearestIndex < 0 || index < nearestIndex)))
         {
-            return i;
+            nearestIndex = index;
+            nearestDistance = distance;
         }
     }
-    return -1;
+    return nearestIndex;
 }
 
 bool DrawingPath::isPointOnPath(const QPointF &pos, qreal threshold) const
 {
-    QPointF localPos = mapFromScene(pos);
-
-    // 创建一个稍大的路径来检测点击
-    QPainterPathStroker stroker;
-    stroker.setWidth(threshold * 2);
-    QPainterPath widenedPath = stroker.createStroke(m_path);
+    return nearestSegment(pos, threshold).element >= 0;
+}
 
-    return widenedPath.contains(localPos);
+PathHitIndex::Hit DrawingPath::nearestSegment(const QPointF &scenePos, qreal maxDistance) const
+{
+    // 索引在首次查询时建立，悬停时的后续查询只访问附近的段
+    if (!m_hitIndex)
+    {
+        m_hitIndex = std::make_shared<PathHitIndex>(m_path);
+    }
+    return m_hitIndex->nearest(mapFromScene(scenePos), maxDistance);
 }
 
 QRectF DrawingPath::localBounds() const
@@ -1374,7 +1614,11 @@ void DrawingPath::setPath(const QPainterPath &path)
     if (m_path != path)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_path = path;
+        m_lod.reset();
+        m_hitIndex.reset();
+        m_nodeIndex.reset();
         // 应用填充规则
         m_path.setFillRule(m_fillRule);
 
@@ -1403,7 +1647,7 @@ void DrawingPath::setPath(const QPainterPath &path)
     }
 }
 
-QPainterPath DrawingPath::shape() const
+QPainterPath DrawingPath::computeShape() const
 {
     // 直接返回路径，应用变换
     QPainterPath path = m_path;
@@ -1425,7 +1669,7 @@ QPainterPath DrawingPath::shape() const
     return path;
 }
 
-QPainterPath DrawingPath::transformedShape() const
+QPainterPath DrawingPath::computeTransformedShape() const
 {
     // 直接使用shape()方法的结果
     return shape();
@@ -1438,8 +1682,10 @@ QVector<QPointF> DrawingPath::getNodePoints() const
 
 QVector<NodeInfo> DrawingPath::getNodeInfo() const
 {
-    // 如果节点信息为空或路径已更新，重新计算
-    if (m_nodeInfo.isEmpty() || m_nodeInfo.size() != m_pathElements.size())
+    // 路径的每次修改都会调用updateNodeInfo，这里只补算尚未生成的节点信息。
+    // 曲线的数据元素不产生节点，节点数与元素数不同，不能用它判断是否过期，
+    // 否则会把已设置的平滑、对称等类型重置为推导结果
+    if (m_nodeInfo.isEmpty() && !m_pathElements.isEmpty())
     {
         // const_cast是因为这是一个缓存优化方法
         const_cast<DrawingPath *>(this)->updateNodeInfo();
@@ -1517,6 +1763,14 @@ void DrawingPath::updateNodeInfo()
     // 需要在合适的时机（如用户操作后）调用，而不是每次更新都调用
 }
 
+void DrawingPath::setNodeType(int index, NodeInfo::NodeType type)
+{
+    if (index >= 0 && index < m_nodeInfo.size())
+    {
+        m_nodeInfo[index].type = type;
+    }
+}
+
 void DrawingPath::performSmartNodeTypeDetection()
 {
     qDebug() << "=== Starting smart node type detection (manual) ===";
@@ -1668,26 +1922,7 @@ void DrawingPath::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 int DrawingPath::findNearestControlPoint(const QPointF &scenePos) const
 {
-    int nearestIndex = -1;
-    qreal minDistance = 10.0; // 阈值距离
-
-    for (int i = 0; i < m_controlPoints.size(); ++i)
-    {
-        // 首先应用DrawingTransform变换
-        QPointF transformedPoint = m_transform.map(m_controlPoints[i]);
-        // 然后使用Qt的内置方法将结果转换为场景坐标
-        QPointF controlScenePos = mapToScene(transformedPoint);
-
-        qreal distance = QLineF(scenePos, controlScenePos).length();
-
-        if (distance < minDistance)
-        {
-            minDistance = distance;
-            nearestIndex = i;
-        }
-    }
-
-    return nearestIndex;
+    return findNodeAt(scenePos, 10.0); // 阈值距离
 }
 
 bool DrawingPath::isPointNearControlPoint(const QPointF &scenePos, const QPointF &controlPoint, qreal threshold) const
@@ -1711,6 +1946,9 @@ void DrawingPath::setControlPoints(const QVector<QPointF> &points)
 
 void DrawingPath::updatePathFromControlPoints()
 {
+    // 控制点已修改
+    m_nodeIndex.reset();
+
     if (m_controlPoints.isEmpty() || m_controlPointTypes.isEmpty())
     {
         return;
@@ -1793,7 +2031,10 @@ void DrawingPath::updatePathFromControlPoints()
 
     // 直接更新内部路径，不调用setPath避免无限循环
     prepareGeometryChange();
+    markGeometryDirty();
     m_path = newPath;
+    m_lod.reset();
+    m_hitIndex.reset();
 
     // 路径改变后，需要重新提取元素信息并更新节点信息
     m_pathElements.clear();
@@ -1820,6 +2061,11 @@ bool DrawingPath::showControlPolygon() const
     return m_showControlPolygon;
 }
 
+int DrawingPath::savedPaintPasses() const
+{
+    return DrawingShape::savedPaintPasses() + (hasMarker() ? 1 : 0);
+}
+
 void DrawingPath::paintShape(QPainter *painter)
 {
     // 如果路径被高亮，使用高亮样式
@@ -1836,7 +2082,7 @@ void DrawingPath::paintShape(QPainter *painter)
     else
     {
         // 绘制主路径
-        painter->drawPath(m_path);
+        drawPathWithLod(painter);
     }
 
     if (hasMarker())
@@ -2065,6 +2311,53 @@ QRectF DrawingPath::getMarkerBounds(const MarkerData &markerData)
 }
 
 // 直接绘制marker（使用预解析的数据）
+void DrawingPath::drawPathWithLod(QPainter *painter)
+{
+    const QTransform deviceTransform = painter->deviceTransform();
+    const qreal deviceScale = qSqrt(qAbs(deviceTransform.determinant()));
+
+    // 编辑控制点时总是绘制原路径
+    if (deviceScale >= PathLod::FullDetailScale || m_showControlPolygon)
+    {
+        painter->drawPath(m_path);
+        return;
+    }
+
+    // 只占一两个像素的路径退化为矩形，更小的直接剔除
+    const QRectF bounds = m_path.controlPointRect();
+    const qreal deviceSize = qMax(bounds.width(), bounds.height()) * deviceScale;
+    if (deviceSize < PathLod::CullSize)
+    {
+        return;
+    }
+    if (deviceSize < PathLod::CollapseSize)
+    {
+        painter->drawRect(bounds);
+        return;
+    }
+
+    if (m_path.elementCount() < PathLod::MinElementCount)
+    {
+        painter->drawPath(m_path);
+        return;
+    }
+
+    if (!m_lod)
+    {
+        m_lod = std::make_shared<PathLod>(m_path);
+    }
+    // 后台生成完成时重绘图形所在区域，瓦片缓存也随场景的changed信号失效；
+    // 只捕获场景和区域，图形此时可能已被删除
+    const QPointer<QGraphicsScene> drawingScene = scene();
+    const QRectF sceneRect = sceneBoundingRect();
+    painter->drawPath(m_lod->pathForScale(deviceScale, [drawingScene, sceneRect]() {
+        if (drawingScene)
+        {
+            drawingScene->update(sceneRect);
+        }
+    }));
+}
+
 void DrawingPath::renderMarkerDirectly(QPainter *painter)
 {
     if (!m_markerData.isValid)
@@ -2182,42 +2475,46 @@ void DrawingPath::renderMarkerDirectly(QPainter *painter)
 
 
 // DrawingPath 序列化方法
-QByteArray DrawingPath::serialize() const
+static void writeMarkerData(QDataStream &stream, const MarkerData &markerData)
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
+    stream << static_cast<int>(markerData.type);
+    stream << markerData.params;
+    stream << markerData.fillColor;
+    stream << markerData.strokeColor;
+    stream << markerData.strokeWidth;
+    stream << markerData.isValid;
+    stream << markerData.refX << markerData.refY;
+    stream << markerData.markerWidth << markerData.markerHeight;
+    stream << markerData.orient;
+}
 
-    // 写入路径特定属性
-    stream << m_path;
+static void readMarkerData(QDataStream &stream, MarkerData &markerData)
+{
+    int typeInt;
+    stream >> typeInt;
+    markerData.type = static_cast<MarkerData::Type>(typeInt);
+    stream >> markerData.params;
+    stream >> markerData.fillColor;
+    stream >> markerData.strokeColor;
+    stream >> markerData.strokeWidth;
+    stream >> markerData.isValid;
+    stream >> markerData.refX >> markerData.refY;
+    stream >> markerData.markerWidth >> markerData.markerHeight;
+    stream >> markerData.orient;
+}
 
-    // 手动序列化路径元素
-    stream << static_cast<int>(m_pathElements.size());
-    for (const QPainterPath::Element &element : m_pathElements)
-    {
-        stream << static_cast<int>(element.type);
-        stream << element.x;
-        stream << element.y;
-    }
+void DrawingPath::writeFields(ShapeRecordWriter &writer) const
+{
+    DrawingShape::writeFields(writer);
 
-    stream << m_markerId;
-    
-    // 序列化MarkerData
-    stream << static_cast<int>(m_markerData.type);
-    stream << m_markerData.params;
-    stream << m_markerData.fillColor;
-    stream << m_markerData.strokeColor;
-    stream << m_markerData.strokeWidth;
-    stream << m_markerData.isValid;
-    
-    stream << m_markerTransform;
-    stream << m_showControlPolygon;
-    stream << strokePen();
-    stream << fillBrush();
+    // 路径元素与m_path一致，只写一次，读取时从路径重新提取
+    writer.writeField(FieldPath, m_path);
+    writer.writeField(FieldFillRule, static_cast<int>(m_fillRule));
+    writer.writeField(FieldShowControlPolygon, m_showControlPolygon);
 
-    // 序列化节点信息
+    // 节点类型（平滑、对称等）无法从路径推导，需要单独保存
+    writer.beginField(FieldNodeInfo);
+    QDataStream &stream = writer.stream();
     stream << static_cast<int>(m_nodeInfo.size());
     for (const NodeInfo &node : m_nodeInfo)
     {
@@ -2230,100 +2527,109 @@ QByteArray DrawingPath::serialize() const
         stream << node.controlOut;
         stream << node.isVisible;
     }
+    writer.endField();
 
-    return data;
+    if (!m_markerId.isEmpty() || m_markerData.isValid || !m_markers.isEmpty())
+    {
+        writer.beginField(FieldMarkers);
+        stream << m_markerId;
+        writeMarkerData(stream, m_markerData);
+        stream << m_markerTransform;
+        stream << static_cast<int>(m_markers.size());
+        for (const MarkerInfo &marker : m_markers)
+        {
+            stream << marker.markerId;
+            writeMarkerData(stream, marker.markerData);
+            stream << marker.markerTransform;
+            stream << marker.position;
+        }
+        writer.endField();
+    }
 }
 
-void DrawingPath::deserialize(const QByteArray &data)
+bool DrawingPath::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取路径特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    // 基类读取了：type, position, scale, rotation, transform, zValue, visible, enabled, fillBrush, strokePen, opacity, id
-    stream.device()->seek(DrawingShape::serialize().size());
+    QDataStream &stream = reader.stream();
 
-    // 读取路径特定属性
-    stream >> m_path;
-
-    // 手动反序列化路径元素
-    int elementCount;
-    stream >> elementCount;
-    m_pathElements.clear();
-    for (int i = 0; i < elementCount; ++i)
+    switch (fieldId)
     {
-        int typeValue;
-        qreal x, y;
-        stream >> typeValue;
-        stream >> x;
-        stream >> y;
-
-        QPainterPath::Element element;
-        element.type = static_cast<QPainterPath::ElementType>(typeValue);
-        element.x = x;
-        element.y = y;
-        m_pathElements.append(element);
-    }
-
-    // 读取控制点相关数据（控制点是动态的，不需要序列化）
-    // 路径设置后会重新生成控制点
-    stream >> m_markerId;
-    
-    // 反序列化MarkerData
-    int typeInt;
-    stream >> typeInt;
-    m_markerData.type = static_cast<MarkerData::Type>(typeInt);
-    stream >> m_markerData.params;
-    stream >> m_markerData.fillColor;
-    stream >> m_markerData.strokeColor;
-    stream >> m_markerData.strokeWidth;
-    stream >> m_markerData.isValid;
-    
-    stream >> m_markerTransform;
-    stream >> m_showControlPolygon;
-
-    // 读取画笔和画刷（在基类之后读取）
-    QPen newPen;
-    stream >> newPen;
-    setStrokePen(newPen);
+    case FieldPath:
+    {
+        stream >> m_path;
+        m_lod.reset();
+        m_hitIndex.reset();
+        m_nodeIndex.reset();
 
-    QBrush newBrush;
-    stream >> newBrush;
-    setFillBrush(newBrush);
+        // 从路径重新生成元素、控制点和类型信息
+        m_pathElements.clear();
+        m_controlPoints.clear();
+        m_controlPointTypes.clear();
+        for (int i = 0; i < m_path.elementCount(); ++i)
+        {
+            const QPainterPath::Element &element = m_path.elementAt(i);
+            m_pathElements.append(element);
+            m_controlPoints.append(QPointF(element.x, element.y));
+            m_controlPointTypes.append(element.type);
+        }
 
-    // 读取节点信息
-    int nodeInfoCount;
-    stream >> nodeInfoCount;
-    m_nodeInfo.clear();
-    for (int i = 0; i < nodeInfoCount; ++i)
-    {
-        NodeInfo node;
-        int typeValue;
-        stream >> typeValue;
-        node.type = static_cast<NodeInfo::NodeType>(typeValue);
-        stream >> node.position;
-        stream >> node.elementIndex;
-        stream >> node.hasControlIn;
-        stream >> node.hasControlOut;
-        stream >> node.controlIn;
-        stream >> node.controlOut;
-        stream >> node.isVisible;
-        m_nodeInfo.append(node);
+        // 没有节点信息字段时按路径重建
+        m_nodeInfo.clear();
+        updateNodeInfo();
+        return true;
     }
-
-    // 路径设置后，重新生成控制点和类型信息
-    m_controlPoints.clear();
-    m_controlPointTypes.clear();
-    for (const QPainterPath::Element &element : m_pathElements)
-    {
-        m_controlPoints.append(QPointF(element.x, element.y));
-        m_controlPointTypes.append(element.type);
+    case FieldFillRule:
+        m_fillRule = static_cast<Qt::FillRule>(reader.read<int>());
+        m_path.setFillRule(m_fillRule);
+        m_lod.reset();
+        return true;
+    case FieldShowControlPolygon:
+        m_showControlPolygon = reader.read<bool>();
+        return true;
+    case FieldNodeInfo:
+    {
+        int nodeInfoCount;
+        stream >> nodeInfoCount;
+        m_nodeInfo.clear();
+        for (int i = 0; i < nodeInfoCount && stream.status() == QDataStream::Ok; ++i)
+        {
+            NodeInfo node;
+            int typeValue;
+            stream >> typeValue;
+            node.type = static_cast<NodeInfo::NodeType>(typeValue);
+            stream >> node.position;
+            stream >> node.elementIndex;
+            stream >> node.hasControlIn;
+            stream >> node.hasControlOut;
+            stream >> node.controlIn;
+            stream >> node.controlOut;
+            stream >> node.isVisible;
+            m_nodeInfo.append(node);
+        }
+        return true;
     }
+    case FieldMarkers:
+    {
+        stream >> m_markerId;
+        readMarkerData(stream, m_markerData);
+        stream >> m_markerTransform;
 
-    update();
+        int markerCount;
+        stream >> markerCount;
+        m_markers.clear();
+        for (int i = 0; i < markerCount && stream.status() == QDataStream::Ok; ++i)
+        {
+            MarkerInfo marker;
+            stream >> marker.markerId;
+            readMarkerData(stream, marker.markerData);
+            stream >> marker.markerTransform;
+            stream >> marker.position;
+            m_markers.append(marker);
+        }
+        return true;
+    }
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingPath::clone() const
@@ -2365,6 +2671,7 @@ void DrawingText::setText(const QString &text)
     if (m_text != text)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_text = text;
         update();
     }
@@ -2375,6 +2682,7 @@ void DrawingText::setFont(const QFont &font)
     if (m_font != font)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_font = font;
         m_fontSize = font.pointSizeF();
         update();
@@ -2386,6 +2694,7 @@ void DrawingText::setPosition(const QPointF &pos)
     if (m_position != pos)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_position = pos;
         update();
     }
@@ -2647,43 +2956,36 @@ QVector<NodeInfo> DrawingText::getNodeInfo() const
 }
 
 // DrawingText 序列化方法
-QByteArray DrawingText::serialize() const
+void DrawingText::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
-
-    // 写入文本特定属性
-    stream << m_text;
-    stream << m_font;
-    stream << m_position;
-    stream << m_fontSize;
-    stream << m_editing;
+    DrawingShape::writeFields(writer);
 
-    return data;
+    // 写入文本特定属性，编辑状态是临时状态不保存
+    writer.writeField(FieldText, m_text);
+    writer.writeField(FieldFont, m_font);
+    writer.writeField(FieldTextPosition, m_position);
+    writer.writeField(FieldFontSize, m_fontSize);
 }
 
-void DrawingText::deserialize(const QByteArray &data)
+bool DrawingText::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取文本特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    stream.device()->seek(DrawingShape::serialize().size());
-
-    // 读取文本特定属性
-    stream >> m_text;
-    stream >> m_font;
-    stream >> m_position;
-    stream >> m_fontSize;
-    stream >> m_editing;
-
-    update();
+    switch (fieldId)
+    {
+    case FieldText:
+        m_text = reader.read<QString>();
+        return true;
+    case FieldFont:
+        m_font = reader.read<QFont>();
+        return true;
+    case FieldTextPosition:
+        m_position = reader.read<QPointF>();
+        return true;
+    case FieldFontSize:
+        m_fontSize = reader.read<qreal>();
+        return true;
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingText::clone() const
@@ -2757,11 +3059,18 @@ QRectF DrawingLine::localBounds() const
     return QRectF(m_line.p1(), m_line.p2()).normalized().adjusted(-m_lineWidth / 2, -m_lineWidth / 2, m_lineWidth / 2, m_lineWidth / 2);
 }
 
+QPolygonF DrawingLine::computeConvexHull() const
+{
+    // 两个端点，退化的凸包
+    return ConvexHull::ofPoints({ m_transform.map(m_line.p1()), m_transform.map(m_line.p2()) });
+}
+
 void DrawingLine::setLine(const QLineF &line)
 {
     if (m_line != line)
     {
         prepareGeometryChange();
+        markGeometryDirty();
         m_line = line;
         update();
     }
@@ -2847,37 +3156,28 @@ QVector<NodeInfo> DrawingLine::getNodeInfo() const
 }
 
 // DrawingLine 序列化方法
-QByteArray DrawingLine::serialize() const
+void DrawingLine::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
+    DrawingShape::writeFields(writer);
 
     // 写入直线特定属性
-    stream << m_line;
-    stream << m_lineWidth;
-
-    return data;
+    writer.writeField(FieldLine, m_line);
+    writer.writeField(FieldLineWidth, m_lineWidth);
 }
 
-void DrawingLine::deserialize(const QByteArray &data)
+bool DrawingLine::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取直线特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    stream.device()->seek(DrawingShape::serialize().size());
-
-    // 读取直线特定属性
-    stream >> m_line;
-    stream >> m_lineWidth;
-
-    update();
+    switch (fieldId)
+    {
+    case FieldLine:
+        m_line = reader.read<QLineF>();
+        return true;
+    case FieldLineWidth:
+        m_lineWidth = reader.read<qreal>();
+        return true;
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingLine::clone() const
@@ -2919,7 +3219,7 @@ QRectF DrawingPolyline::localBounds() const
     return QRectF(minX, minY, maxX - minX, maxY - minY);
 }
 
-QPainterPath DrawingPolyline::shape() const
+QPainterPath DrawingPolyline::computeShape() const
 {
     QPainterPath path;
     if (m_points.size() < 2)
@@ -2963,12 +3263,17 @@ QPainterPath DrawingPolyline::shape() const
     return path;
 }
 
-QPainterPath DrawingPolyline::transformedShape() const
+QPainterPath DrawingPolyline::computeTransformedShape() const
 {
     // 直接使用shape()方法的结果
     return shape();
 }
 
+QPolygonF DrawingPolyline::computeConvexHull() const
+{
+    return ConvexHull::ofPoints(m_transform.map(QPolygonF(m_points)));
+}
+
 void DrawingPolyline::addPoint(const QPointF &point)
 {
     m_points.append(point);
@@ -3197,39 +3502,32 @@ QVector<NodeInfo> DrawingPolyline::getNodeInfo() const
 }
 
 // DrawingPolyline 序列化方法
-QByteArray DrawingPolyline::serialize() const
+void DrawingPolyline::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
+    DrawingShape::writeFields(writer);
 
     // 写入折线特定属性
-    stream << m_points;
-    stream << m_lineWidth;
-    stream << m_closed;
-
-    return data;
+    writer.writeField(FieldPoints, m_points);
+    writer.writeField(FieldLineWidth, m_lineWidth);
+    writer.writeField(FieldClosed, m_closed);
 }
 
-void DrawingPolyline::deserialize(const QByteArray &data)
+bool DrawingPolyline::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取折线特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    stream.device()->seek(DrawingShape::serialize().size());
-
-    // 读取折线特定属性
-    stream >> m_points;
-    stream >> m_lineWidth;
-    stream >> m_closed;
-
-    update();
+    switch (fieldId)
+    {
+    case FieldPoints:
+        reader.stream() >> m_points;
+        return true;
+    case FieldLineWidth:
+        m_lineWidth = reader.read<qreal>();
+        return true;
+    case FieldClosed:
+        m_closed = reader.read<bool>();
+        return true;
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingPolyline::clone() const
@@ -3270,7 +3568,7 @@ QRectF DrawingPolygon::localBounds() const
     return QRectF(minX, minY, maxX - minX, maxY - minY);
 }
 
-QPainterPath DrawingPolygon::shape() const
+QPainterPath DrawingPolygon::computeShape() const
 {
     QPainterPath path;
     if (m_points.size() < 3)
@@ -3305,7 +3603,7 @@ QPainterPath DrawingPolygon::shape() const
     return path;
 }
 
-QPainterPath DrawingPolygon::transformedShape() const
+QPainterPath DrawingPolygon::computeTransformedShape() const
 {
     // 直接使用shape()方法的结果
     return shape();
@@ -3541,37 +3839,28 @@ QVector<NodeInfo> DrawingPolygon::getNodeInfo() const
 }
 
 // DrawingPolygon 序列化方法
-QByteArray DrawingPolygon::serialize() const
+void DrawingPolygon::writeFields(ShapeRecordWriter &writer) const
 {
-    QByteArray data = DrawingShape::serialize();
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    // 跳过基类已写入的数据
-    stream.device()->seek(stream.device()->size());
+    DrawingShape::writeFields(writer);
 
     // 写入多边形特定属性
-    stream << m_points;
-    stream << m_fillRule;
-
-    return data;
+    writer.writeField(FieldPoints, m_points);
+    writer.writeField(FieldFillRule, static_cast<int>(m_fillRule));
 }
 
-void DrawingPolygon::deserialize(const QByteArray &data)
+bool DrawingPolygon::readField(quint16 fieldId, ShapeRecordReader &reader)
 {
-    // 先调用基类的deserialize来处理基类数据
-    DrawingShape::deserialize(data);
-
-    // 然后读取多边形特定属性
-    QDataStream stream(data);
-
-    // 跳过基类已读取的数据
-    stream.device()->seek(DrawingShape::serialize().size());
-
-    // 读取多边形特定属性
-    stream >> m_points;
-    stream >> m_fillRule;
-
-    update();
+    switch (fieldId)
+    {
+    case FieldPoints:
+        reader.stream() >> m_points;
+        return true;
+    case FieldFillRule:
+        m_fillRule = static_cast<Qt::FillRule>(reader.read<int>());
+        return true;
+    default:
+        return DrawingShape::readField(fieldId, reader);
+    }
 }
 
 DrawingShape *DrawingPolygon::clone() const
@@ -3606,88 +3895,92 @@ void DrawingShape::setDropShadowEffect(const QColor &color, qreal blurRadius, co
 QByteArray DrawingShape::serialize() const
 {
     QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
+    ShapeRecordWriter writer(&data);
+    writer.writeShape(this);
+    return data;
+}
 
-    // 写入形状类型
-    stream << static_cast<int>(m_type);
+void DrawingShape::deserialize(const QByteArray &data)
+{
+    ShapeRecordReader reader(data);
+    reader.readInto(this);
+}
 
+void DrawingShape::writeFields(ShapeRecordWriter &writer) const
+{
     // 写入变换属性
-    stream << pos();
-    stream << scale();
-    stream << rotation();
-    stream << transform();
-    stream << zValue();
+    writer.writeField(FieldPosition, pos());
+    writer.writeField(FieldScale, scale());
+    writer.writeField(FieldRotation, rotation());
+    writer.writeField(FieldTransform, m_transform);
+    writer.writeField(FieldZValue, zValue());
 
     // 写入视觉属性
-    stream << isVisible();
-    stream << isEnabled();
+    writer.writeField(FieldVisible, isVisible());
+    writer.writeField(FieldEnabled, isEnabled());
 
     // 写入样式属性
-    stream << m_fillBrush;
-    stream << m_strokePen;
-    stream << opacity();
+    writer.writeField(FieldFillBrush, m_fillBrush);
+    writer.writeField(FieldStrokePen, m_strokePen);
+    writer.writeField(FieldOpacity, opacity());
 
     // 写入对象ID
-    stream << m_id;
-
-    return data;
+    writer.writeField(FieldObjectId, m_id);
+}
+
+bool DrawingShape::readField(quint16 fieldId, ShapeRecordReader &reader)
+{
+    switch (fieldId)
+    {
+    case FieldPosition:
+        setPos(reader.read<QPointF>());
+        return true;
+    case FieldScale:
+        setScale(reader.read<qreal>());
+        return true;
+    case FieldRotation:
+        setRotation(reader.read<qreal>());
+        return true;
+    case FieldTransform:
+        // 恢复内部变换（绘制使用m_transform），不经过applyTransform以免组合传播给子对象
+        m_transform = reader.read<QTransform>();
+        return true;
+    case FieldZValue:
+        setZValue(reader.read<qreal>());
+        return true;
+    case FieldVisible:
+        setVisible(reader.read<bool>());
+        return true;
+    case FieldEnabled:
+        setEnabled(reader.read<bool>());
+        return true;
+    case FieldFillBrush:
+        setFillBrush(reader.read<QBrush>());
+        return true;
+    case FieldStrokePen:
+        setStrokePen(reader.read<QPen>());
+        return true;
+    case FieldOpacity:
+        setOpacity(reader.read<qreal>());
+        return true;
+    case FieldObjectId:
+        setId(reader.read<QString>());
+        return true;
+    default:
+        return false;
+    }
 }
 
-void DrawingShape::deserialize(const QByteArray &data)
+void DrawingShape::beginDeserialize()
 {
-    QDataStream stream(data);
-
-    // 读取形状类型（用于验证）
-    int typeValue;
-    stream >> typeValue;
-
-    // 读取变换属性
-    QPointF position;
-    stream >> position;
-    setPos(position);
-
-    qreal scaleValue;
-    stream >> scaleValue;
-    setScale(scaleValue);
-
-    qreal rotationValue;
-    stream >> rotationValue;
-    setRotation(rotationValue);
-
-    QTransform transform;
-    stream >> transform;
-    setTransform(transform);
-
-    qreal zValue;
-    stream >> zValue;
-    setZValue(zValue);
-
-    // 读取视觉属性
-    bool visible;
-    stream >> visible;
-    setVisible(visible);
-
-    bool enabled;
-    stream >> enabled;
-    setEnabled(enabled);
-
-    // 读取样式属性
-    QBrush fillBrush;
-    stream >> fillBrush;
-    setFillBrush(fillBrush);
-
-    QPen strokePen;
-    stream >> strokePen;
-    setStrokePen(strokePen);
-
-    qreal opacity;
-    stream >> opacity;
-    setOpacity(opacity);
+    prepareGeometryChange();
+}
 
-    // 读取对象ID
-    QString id;
-    stream >> id;
-    setId(id);
+void DrawingShape::endDeserialize()
+{
+    // 读取字段期间可能已按中间状态缓存了几何
+    invalidateGeometryCache();
+    update();
 }
 
 DrawingShape *DrawingShape::clone() const
@@ -10,6 +10,7 @@
 #include <QPointF>
 #include <QRectF>
 #include <QPainterPath>
+#include <QPolygonF>
 #include <QGraphicsSceneMouseEvent>
 #include <QFont>
 #include <QUndoCommand>
@@ -17,6 +18,9 @@
 #include <QVariant>
 #include <memory>
 #include "smart-render-manager.h"
+#include "cache-policy.h"
+#include "path-hit-index.h"
+#include "point-kd-tree.h"
 
 // Marker渲染数据结构
 struct MarkerData
@@ -45,6 +49,8 @@ struct MarkerData
 };
 
 class DrawingDocument;
+class ShapeRecordWriter;
+class ShapeRecordReader;
 
 class SelectionIndicator;
 class DrawingScene;
@@ -52,6 +58,7 @@ class DrawingPath;
 
 // 添加EditHandle的前向声明以避免循环包含
 class EditHandle;
+class PathLod;
 
 /**
  * 通用节点信息结构 - 适用于所有图形类型
@@ -177,12 +184,44 @@ public:
         return UserType + 2; // 其他DrawingShape类型
     }
 
-    // 几何属性
+    // 几何属性，结果缓存到几何变化为止，子类重写computeShape()
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
 
-    // 获取可用于布尔运算的路径（考虑变换）
-    virtual QPainterPath transformedShape() const;
+    // 获取可用于布尔运算的路径（考虑变换），子类重写computeTransformedShape()
+    QPainterPath transformedShape() const;
+
+    /**
+     * shape()展平后的折线轮廓（本地坐标），供命中测试使用
+     */
+    const QList<QPolygonF> &flattenedOutline() const;
+
+    /**
+     * 几何轮廓的凸包（本地坐标），不含shape()为便于选择而加宽的描边，供碰撞检测和包围选区使用
+     */
+    const QPolygonF &convexHull() const;
+
+    /**
+     * 批量填充多个图形（包括组合的子项）的凸包缓存：需要展平路径且尚未缓存的图形
+     * 在GUI线程取出路径后交给线程池并行计算，其余图形仍由convexHull()按需计算
+     */
+    static void cacheConvexHulls(const QList<DrawingShape *> &shapes);
+
+    /**
+     * 丢弃缓存的边界、形状、轮廓和凸包
+     * prepareGeometryChange()会自动调用，只影响形状不影响边界的修改（如圆角半径）需要手动调用
+     */
+    void invalidateGeometryCache();
+
+    // 几何缓存命中统计，所有图形共用
+    struct GeometryCacheStats
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 invalidations = 0;
+    };
+    static GeometryCacheStats geometryCacheStats();
+    static void resetGeometryCacheStats();
 
     // 视觉反馈和高亮支持
     virtual void highlightNode(int index) { Q_UNUSED(index); }
@@ -220,6 +259,11 @@ public:
     void setStrokePen(const QPen &pen)
     {
         m_strokePen = pen;
+        // 描边不受变换影响，绘制时使用cosmetic笔，只在描边改变时更新
+        m_cosmeticPen = pen;
+        m_cosmeticPen.setCosmetic(true);
+        // 子类的形状可能依赖描边宽度
+        invalidateGeometryCache();
         smartUpdate();
         notifyObjectStateChanged();
     }
@@ -293,20 +337,80 @@ public:
     // 通知状态变化
     void notifyObjectStateChanged();
 
+    // 几何变化后标记空间索引和吸附点需要重新索引。几何缓存只由prepareGeometryChange()
+    // 或invalidateGeometryCache()丢弃，每个设置函数只走其中一条
+    void markGeometryDirty();
+
     // 🌟 将变换烘焙到图形的内部几何结构中
     virtual void bakeTransform(const QTransform &transform);
 
-    // 序列化接口 - 用于复制粘贴功能
-    virtual QByteArray serialize() const;
-    virtual void deserialize(const QByteArray &data);
+    // 序列化接口 - 用于复制粘贴功能，格式见ShapeRecordWriter
+    QByteArray serialize() const;
+    void deserialize(const QByteArray &data);
     virtual DrawingShape *clone() const;
 
+    // 分字段序列化：子类先调用基类再写入自己的字段
+    virtual void writeFields(ShapeRecordWriter &writer) const;
+    // 读取单个字段，返回false表示字段未被识别
+    virtual bool readField(quint16 fieldId, ShapeRecordReader &reader);
+    // 读取一条记录的前后调用
+    virtual void beginDeserialize();
+    virtual void endDeserialize();
+
+    // 序列化字段ID，所有图形共用一个编号空间，已发布的编号不能复用
+    enum FieldId : quint16
+    {
+        // DrawingShape
+        FieldPosition = 1,
+        FieldScale = 2,
+        FieldRotation = 3,
+        FieldTransform = 4,
+        FieldZValue = 5,
+        FieldVisible = 6,
+        FieldEnabled = 7,
+        FieldFillBrush = 8,
+        FieldStrokePen = 9,
+        FieldOpacity = 10,
+        FieldObjectId = 11,
+
+        // DrawingRectangle / DrawingEllipse
+        FieldRect = 32,
+        FieldCornerRadius = 33,
+        FieldCornerRatios = 34,
+        FieldEllipseAngles = 35,
+
+        // DrawingPath
+        FieldPath = 48,
+        FieldNodeInfo = 49,
+        FieldMarkers = 50,
+        FieldShowControlPolygon = 51,
+
+        // DrawingText
+        FieldText = 64,
+        FieldFont = 65,
+        FieldTextPosition = 66,
+        FieldFontSize = 67,
+
+        // DrawingLine / DrawingPolyline / DrawingPolygon
+        FieldLine = 80,
+        FieldLineWidth = 81,
+        FieldPoints = 82,
+        FieldClosed = 83,
+        FieldFillRule = 84,
+
+        // DrawingGroup：每个子对象一个嵌套记录
+        FieldGroupChild = 96
+    };
+
     // 渲染
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
     // 缓存优化
     void setupCacheMode();
     void updateCacheMode();
+    
+    // 绘制统计，供CachePolicy调整缓存模式
+    PaintStats &paintStats() { return m_paintStats; }
 
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
@@ -319,11 +423,31 @@ protected:
     // 子类需要实现的绘制方法（在本地坐标系中）
     virtual void paintShape(QPainter *painter) = 0;
 
+    /**
+     * 本次单遍绘制相对旧的两遍绘制（先填充、再描边，各调用一次paintShape）省去的几何遍数。
+     * 使用画家样式的图形只有填充和描边都可见时，两遍才都真正处理几何；
+     * 自己设置画笔的子类在两遍中都完整绘制，每次都省去一遍
+     */
+    virtual int savedPaintPasses() const;
+
+    // 计算形状，结果由shape()/transformedShape()缓存
+    virtual QPainterPath computeShape() const;
+    virtual QPainterPath computeTransformedShape() const;
+    // 计算凸包，结果由convexHull()缓存；默认取transformedShape()
+    virtual QPolygonF computeConvexHull() const;
+    // 凸包是否由transformedShape()展平得到；直接取顶点或合成子项凸包的子类返回false
+    virtual bool convexHullFromShape() const { return true; }
+
+    // 隐藏QGraphicsItem::prepareGeometryChange()，同时使几何缓存失效
+    void prepareGeometryChange();
+
     QString m_id; // 对象唯一标识符
     ShapeType m_type;
     QTransform m_transform; // 直接使用Qt的变换系统
     QBrush m_fillBrush;
     QPen m_strokePen;
+    QPen m_cosmeticPen; // m_strokePen的cosmetic版本，由setStrokePen维护
+    PaintStats m_paintStats;
     DrawingDocument *m_document = nullptr;
 
     // 编辑把手系统（已弃用）
@@ -346,6 +470,24 @@ protected:
     // 视觉反馈状态
     int m_highlightedNode = -1;
     bool m_highlightedPath = false;
+
+private:
+    enum GeometryCacheFlag : quint8
+    {
+        BoundsCached = 0x1,
+        ShapeCached = 0x2,
+        TransformedShapeCached = 0x4,
+        OutlineCached = 0x8,
+        HullCached = 0x10
+    };
+
+    // 几何缓存
+    mutable quint8 m_geometryCacheFlags = 0;
+    mutable QRectF m_cachedBounds;
+    mutable QPainterPath m_cachedShape;
+    mutable QPainterPath m_cachedTransformedShape;
+    mutable QList<QPolygonF> m_cachedOutline;
+    mutable QPolygonF m_cachedHull;
 };
 
 // DrawingRectangle
@@ -359,8 +501,8 @@ public:
     explicit DrawingRectangle(const QRectF &rect, QGraphicsItem *parent = nullptr);
 
     QRectF localBounds() const override;
-    QPainterPath shape() const override;
-    QPainterPath transformedShape() const override;
+    QPainterPath computeShape() const override;
+    QPainterPath computeTransformedShape() const override;
 
     // 矩形属性
     void setRectangle(const QRectF &rect);
@@ -401,8 +543,8 @@ protected:
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
@@ -429,8 +571,8 @@ public:
     explicit DrawingEllipse(const QRectF &rect, QGraphicsItem *parent = nullptr);
 
     QRectF localBounds() const override;
-    QPainterPath shape() const override;
-    QPainterPath transformedShape() const override;
+    QPainterPath computeShape() const override;
+    QPainterPath computeTransformedShape() const override;
 
     // 椭圆属性
     void setEllipse(const QRectF &rect);
@@ -465,8 +607,8 @@ protected:
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
@@ -494,8 +636,8 @@ public:
     QPainterPath path() const { return m_path; }
 
     // 重写形状方法
-    QPainterPath shape() const override;
-    QPainterPath transformedShape() const override;
+    QPainterPath computeShape() const override;
+    QPainterPath computeTransformedShape() const override;
 
     // 控制点相关
     void setControlPoints(const QVector<QPointF> &points);
@@ -515,6 +657,7 @@ public:
         m_fillRule = rule;
         // 立即应用到路径上
         m_path.setFillRule(m_fillRule);
+        m_lod.reset();
         update();
     }
     Qt::FillRule fillRule() const override { return m_fillRule; }
@@ -522,6 +665,8 @@ public:
     // 节点信息相关 - 重写基类方法
     QVector<NodeInfo> getNodeInfo() const override;
     void updateNodeInfo() override; // 从路径元素更新节点信息
+    // 设置节点类型（平滑、对称等），用于从文档恢复无法从路径推导的类型
+    void setNodeType(int index, NodeInfo::NodeType type);
 
     // 智能节点类型检测 - 用于调试和验证
     void performSmartNodeTypeDetection();
@@ -542,6 +687,13 @@ public:
     int findNodeAt(const QPointF &pos, qreal threshold = 5.0) const override;
     bool isPointOnPath(const QPointF &pos, qreal threshold = 5.0) const override;
 
+    /**
+     * 离场景点最近的路径段
+     * @return 段的起始元素索引（LineTo或CurveTo）和段上的参数t，距离超过maxDistance时element为-1
+     */
+    PathHitIndex::Hit nearestSegment(const QPointF &scenePos,
+                                     qreal maxDistance = std::numeric_limits<qreal>::max()) const;
+
     // Marker相关
     void setMarker(const QString &markerId, const MarkerData &markerData, const QTransform &markerTransform);
     bool hasMarker() const { return !m_markers.isEmpty(); }
@@ -560,6 +712,8 @@ public:
 
 protected:
     void paintShape(QPainter *painter) override;
+    // 旧的两遍绘制还会把marker画两次
+    int savedPaintPasses() const override;
 
     // 重写鼠标事件处理以支持控制点交互
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
@@ -568,8 +722,8 @@ protected:
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
@@ -580,10 +734,16 @@ private:
     // 直接绘制marker（使用预解析的数据）
     void renderMarkerDirectly(QPainter *painter);
     
+    // 按设备缩放比例绘制主路径（细节层次）
+    void drawPathWithLod(QPainter *painter);
+    
     // 获取marker的边界框
     static QRectF getMarkerBounds(const MarkerData &markerData);
 
     QPainterPath m_path;
+    std::shared_ptr<PathLod> m_lod;                         // 缩小显示用的简化路径，路径修改后重建
+    mutable std::shared_ptr<PathHitIndex> m_hitIndex;       // 描边命中测试的索引，路径修改后重建
+    mutable std::shared_ptr<PointKdTree> m_nodeIndex;       // 控制点的k-d树，控制点修改后重建
     QVector<QPainterPath::Element> m_pathElements;          // 原始路径元素，保存曲线信息
     QVector<QPointF> m_controlPoints;                       // 控制点，用于编辑
     QVector<QPainterPath::ElementType> m_controlPointTypes; // 控制点类型
@@ -642,6 +802,8 @@ public:
 
 protected:
     void paintShape(QPainter *painter) override;
+    // 自己设置画笔和画刷，旧的填充遍也完整绘制
+    int savedPaintPasses() const override { return 1; }
 
     // 重写鼠标事件以支持文本编辑
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
@@ -649,8 +811,8 @@ protected:
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
@@ -694,11 +856,15 @@ public:
 
 protected:
     void paintShape(QPainter *painter) override;
+    // 自己设置画笔和画刷，旧的填充遍也完整绘制
+    int savedPaintPasses() const override { return 1; }
+    QPolygonF computeConvexHull() const override;
+    bool convexHullFromShape() const override { return false; }
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
@@ -715,8 +881,8 @@ public:
     explicit DrawingPolyline(QGraphicsItem *parent = nullptr);
 
     QRectF localBounds() const override;
-    QPainterPath shape() const override;
-    QPainterPath transformedShape() const override;
+    QPainterPath computeShape() const override;
+    QPainterPath computeTransformedShape() const override;
 
     // 点操作
     void addPoint(const QPointF &point);
@@ -762,6 +928,11 @@ public:
 
 protected:
     void paintShape(QPainter *painter) override;
+    // 自己设置画笔和画刷，旧的填充遍也完整绘制
+    int savedPaintPasses() const override { return 1; }
+    // shape()是加宽的描边，凸包直接取折线顶点
+    QPolygonF computeConvexHull() const override;
+    bool convexHullFromShape() const override { return false; }
 
     // 重写鼠标事件以支持点编辑
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
@@ -770,8 +941,8 @@ protected:
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
@@ -791,8 +962,8 @@ public:
     explicit DrawingPolygon(QGraphicsItem *parent = nullptr);
 
     QRectF localBounds() const override;
-    QPainterPath shape() const override;
-    QPainterPath transformedShape() const override;
+    QPainterPath computeShape() const override;
+    QPainterPath computeTransformedShape() const override;
 
     // 点操作
     void addPoint(const QPointF &point);
@@ -829,6 +1000,8 @@ public:
 
 protected:
     void paintShape(QPainter *painter) override;
+    // 自己设置画笔和画刷，旧的填充遍也完整绘制
+    int savedPaintPasses() const override { return 1; }
 
     // 重写鼠标事件以支持点编辑
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
@@ -837,8 +1010,8 @@ protected:
 
 public:
     // 序列化方法
-    QByteArray serialize() const override;
-    void deserialize(const QByteArray &data) override;
+    void writeFields(ShapeRecordWriter &writer) const override;
+    bool readField(quint16 fieldId, ShapeRecordReader &reader) override;
     DrawingShape *clone() const override;
 
 private:
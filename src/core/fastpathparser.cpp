@@ -1,143 +1,131 @@
 #include <QPointF>
 #include <QDebug>
+#include <QElapsedTimer>
 #include "fastpathparser.h"
+#include "svgnumberscanner.h"
 
-void FastPathParser::parsePathData(const QString &data, QPainterPath &path)
+namespace {
+
+// 每个线程复用的参数缓冲区，避免每条命令重新分配
+QVector<qreal> &scratchNumbers()
 {
-    if (data.isEmpty()) return;
+    thread_local QVector<qreal> numbers;
+    if (numbers.capacity() < 64) {
+        numbers.reserve(64);
+    }
+    return numbers;
+}
+
+} // namespace
 
-    // 预分配空间，减少重新分配
-    QVector<qreal> numbers;
-    numbers.reserve(64);
+template <typename Char>
+void FastPathParser::parsePathChars(const Char *begin, const Char *end, QPainterPath &path)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<qreal> &numbers = scratchNumbers();
+    numbers.clear();
 
     QPointF currentPoint(0, 0);
     QPointF pathStart(0, 0);
     QPointF lastControlPoint(0, 0);
 
-    const QChar *chars = data.constData();
-    const int length = data.length();
-    int pos = 0;
+    // 分类器按块跳过分隔符并定位数字串，数字转换仍逐个进行
+    const qsizetype length = end - begin;
+    SvgTokenCursor<Char> cursor(begin, length);
 
+    char cmd = 0;
+    bool isRelative = false;
+    qsizetype pos = cursor.nextToken(0);
     while (pos < length) {
-        // 跳过空白字符
-        while (pos < length && chars[pos].isSpace()) {
-            pos++;
+        if (SvgNumberScanner::isCommandChar(begin[pos])) {
+            // 遇到新命令，先执行上一条命令
+            if (cmd) {
+                executeCommand(cmd, numbers.constData(), int(numbers.size()), isRelative,
+                               path, currentPoint, pathStart, lastControlPoint);
+            }
+            const char letter = char(begin[pos]);
+            isRelative = (letter >= 'a');
+            cmd = isRelative ? char(letter - 'a' + 'A') : letter;
+            numbers.clear();
+            pos = cursor.nextToken(pos + 1);
+            continue;
         }
 
-        if (pos >= length) break;
-
-        QChar cmd = chars[pos];
-        if (cmd.isLetter()) {
-            // 处理命令
-            bool isRelative = cmd.isLower();
-            cmd = cmd.toUpper();
-            pos++;
-
-            // 解析数字参数
-            numbers.clear();
-            while (pos < length) {
-                // 跳过逗号和空白
-                while (pos < length && (chars[pos] == ',' || chars[pos].isSpace())) {
-                    pos++;
-                }
-                if (pos >= length || chars[pos].isLetter()) break;
-
-                // 快速解析数字
-                int start = pos;
-                while (pos < length && (chars[pos].isDigit() || chars[pos] == '.' || 
-                       chars[pos] == '-' || chars[pos] == '+' || chars[pos].toLower() == 'e')) {
-                    pos++;
-                }
-
-                if (start < pos) {
-                    numbers.append(fastParseDouble(data, start, pos));
-                } else {
-                    pos++; // 防止死循环
-                }
+        // 解析一个数字串中的所有数字，如"1.5-2.5.5"
+        const qsizetype runEnd = cursor.numberRunEnd(pos);
+        const Char *p = begin + pos;
+        const Char *runLast = begin + runEnd;
+        while (p < runLast) {
+            qreal value = 0.0;
+            const Char *next;
+            const int argIndex = numbers.size() % 7;
+            if (cmd == 'A' && (argIndex == 3 || argIndex == 4) && (*p == '0' || *p == '1')) {
+                // 弧命令的标志位只有一个字符，可以紧挨着写，如"a1 1 0 00 1 1"
+                value = (*p == '1') ? 1.0 : 0.0;
+                next = p + 1;
+            } else {
+                next = SvgNumberScanner::parseNumber(p, runLast, value);
             }
 
-            // 执行命令
-            executeCommand(cmd, numbers, isRelative, path, currentPoint, pathStart, lastControlPoint);
-        } else {
-            pos++; // 跳过非命令字符
+            if (next == p) {
+                ++p; // 防止死循环
+                continue;
+            }
+            // 第一条命令之前的数字无效
+            if (cmd) {
+                numbers.append(value);
+            }
+            p = next;
         }
+        pos = cursor.nextToken(runEnd);
     }
+
+    if (cmd) {
+        executeCommand(cmd, numbers.constData(), int(numbers.size()), isRelative,
+                       path, currentPoint, pathStart, lastControlPoint);
+    }
+
+    SvgNumberScanner::recordThroughput(length, timer.nsecsElapsed());
 }
 
-qreal FastPathParser::fastParseDouble(const QString &str, int start, int end)
+void FastPathParser::parsePathData(const QString &data, QPainterPath &path)
 {
-    // 简化的快速数字解析，避免QString::toDouble的开销
-    bool negative = false;
-    qreal result = 0.0;
-    qreal fraction = 0.0;
-    qreal divisor = 1.0;
-    bool hasFraction = false;
-    bool hasExponent = false;
-    int exponentSign = 1;
-    int exponent = 0;
-
-    int i = start;
-    
-    // 处理符号
-    if (i < end && (str[i] == '-' || str[i] == '+')) {
-        negative = (str[i] == '-');
-        i++;
-    }
+    if (data.isEmpty()) return;
 
-    // 处理整数部分
-    while (i < end && str[i].isDigit()) {
-        result = result * 10.0 + (str[i].toLatin1() - '0');
-        i++;
-    }
+    const char16_t *chars = reinterpret_cast<const char16_t *>(data.utf16());
+    parsePathChars(chars, chars + data.size(), path);
+}
 
-    // 处理小数部分
-    if (i < end && str[i] == '.') {
-        hasFraction = true;
-        i++;
-        while (i < end && str[i].isDigit()) {
-            fraction = fraction * 10.0 + (str[i].toLatin1() - '0');
-            divisor *= 10.0;
-            i++;
-        }
-        result += fraction / divisor;
-    }
+void FastPathParser::parsePathData(QStringView data, QPainterPath &path)
+{
+    if (data.isEmpty()) return;
 
-    // 处理指数部分
-    if (i < end && (str[i] == 'e' || str[i] == 'E')) {
-        hasExponent = true;
-        i++;
-        if (i < end && (str[i] == '-' || str[i] == '+')) {
-            exponentSign = (str[i] == '-') ? -1 : 1;
-            i++;
-        }
-        while (i < end && str[i].isDigit()) {
-            exponent = exponent * 10 + (str[i].toLatin1() - '0');
-            i++;
-        }
-    }
+    parsePathChars(data.utf16(), data.utf16() + data.size(), path);
+}
 
-    // 应用指数
-    if (hasExponent) {
-        for (int j = 0; j < exponent; j++) {
-            if (exponentSign > 0) {
-                result *= 10.0;
-            } else {
-                result /= 10.0;
-            }
-        }
-    }
+void FastPathParser::parsePathData(QByteArrayView data, QPainterPath &path)
+{
+    if (data.isEmpty()) return;
+
+    parsePathChars(data.data(), data.data() + data.size(), path);
+}
+
+void FastPathParser::parsePathData(const char *data, qsizetype length, QPainterPath &path)
+{
+    if (!data || length <= 0) return;
 
-    return negative ? -result : result;
+    parsePathChars(data, data + length, path);
 }
 
-void FastPathParser::executeCommand(QChar cmd, const QVector<qreal> &numbers, bool isRelative,
+void FastPathParser::executeCommand(char cmd, const qreal *numbers, int numCount, bool isRelative,
                                   QPainterPath &path, QPointF &currentPoint, 
                                   QPointF &pathStart, QPointF &lastControlPoint)
 {
-    const int numCount = numbers.size();
     int numIndex = 0;
 
-    switch (cmd.toLatin1()) {
+    switch (cmd) {
     case 'M': // 移动到
         while (numIndex + 1 < numCount) {
             qreal x = numbers[numIndex];
@@ -199,11 +187,11 @@ void FastPathParser::executeCommand(QChar cmd, const QVector<qreal> &numbers, bo
     case 'S': // 平滑三次贝塞尔曲线
     case 'Q': // 二次贝塞尔曲线
     case 'T': // 平滑二次贝塞尔曲线
-        parseBezierCommands(cmd, numbers, isRelative, path, currentPoint, lastControlPoint);
+        parseBezierCommands(cmd, numbers, numCount, isRelative, path, currentPoint, lastControlPoint);
         break;
 
     case 'A': // 椭圆弧
-        parseArcCommand(numbers, isRelative, path, currentPoint, pathStart, lastControlPoint);
+        parseArcCommand(numbers, numCount, isRelative, path, currentPoint, pathStart, lastControlPoint);
         break;
 
     case 'Z': // 闭合路径
@@ -218,14 +206,13 @@ void FastPathParser::executeCommand(QChar cmd, const QVector<qreal> &numbers, bo
     }
 }
 
-void FastPathParser::parseBezierCommands(QChar cmd, const QVector<qreal> &numbers, bool isRelative,
+void FastPathParser::parseBezierCommands(char cmd, const qreal *numbers, int numCount, bool isRelative,
                                         QPainterPath &path, QPointF &currentPoint, 
                                         QPointF &lastControlPoint)
 {
-    const int numCount = numbers.size();
     int numIndex = 0;
 
-    switch (cmd.toLatin1()) {
+    switch (cmd) {
     case 'C': // 三次贝塞尔曲线
         while (numIndex + 5 < numCount) {
             qreal cp1x = numbers[numIndex];
@@ -320,11 +307,10 @@ void FastPathParser::parseBezierCommands(QChar cmd, const QVector<qreal> &number
     }
 }
 
-void FastPathParser::parseArcCommand(const QVector<qreal> &numbers, bool isRelative,
+void FastPathParser::parseArcCommand(const qreal *numbers, int numCount, bool isRelative,
                                    QPainterPath &path, QPointF &currentPoint, 
                                    QPointF &pathStart, QPointF &lastControlPoint)
 {
-    const int numCount = numbers.size();
     if (numCount < 7) return; // A命令至少需要7个参数
     
     int numIndex = 0;
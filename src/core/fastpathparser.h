@@ -2,12 +2,15 @@
 #define FASTPATHPARSER_H
 
 #include <QString>
+#include <QStringView>
+#include <QByteArrayView>
 #include <QPainterPath>
 #include <QVector>
 
 /**
  * 高性能SVG路径解析器
  * 使用字符级状态机替代正则表达式，提升60-80%的解析性能
+ * 分隔符和数字边界由SvgNumberScanner按块（SSE2/AVX2）批量定位
  */
 class FastPathParser
 {
@@ -19,6 +22,30 @@ public:
      */
     static void parsePathData(const QString &data, QPainterPath &path);
 
+    /**
+     * 解析SVG路径数据视图，不复制字符串
+     * 适用于QXmlStreamReader属性值等UTF-16数据
+     * @param data SVG路径数据视图
+     * @param path 输出的QPainterPath对象
+     */
+    static void parsePathData(QStringView data, QPainterPath &path);
+
+    /**
+     * 直接解析UTF-8/ASCII字节形式的SVG路径数据，无需转换为UTF-16
+     * 结果追加到path中，调用方可以clear()后重复使用同一个path
+     * @param data SVG路径数据字节
+     * @param path 输出的QPainterPath对象
+     */
+    static void parsePathData(QByteArrayView data, QPainterPath &path);
+
+    /**
+     * 直接解析UTF-8/ASCII字节形式的SVG路径数据
+     * @param data 路径数据起始指针
+     * @param length 字节数
+     * @param path 输出的QPainterPath对象
+     */
+    static void parsePathData(const char *data, qsizetype length, QPainterPath &path);
+
 private:
     // 解析状态枚举
     enum class ParseState {
@@ -37,39 +64,38 @@ private:
     };
 
     /**
-     * 快速解析数字，避免QString::toDouble的开销
-     * @param str 字符串
-     * @param start 开始位置
-     * @param end 结束位置
-     * @return 解析的数字值
+     * 按字符类型（char/char16_t）实例化的解析主循环
+     * 参数缓冲区为线程局部变量，跨命令、跨调用复用
      */
-    static qreal fastParseDouble(const QString &str, int start, int end);
+    template <typename Char>
+    static void parsePathChars(const Char *begin, const Char *end, QPainterPath &path);
 
     /**
      * 执行路径命令
-     * @param cmd 命令字符
+     * @param cmd 命令字符（大写）
      * @param numbers 参数数组
+     * @param numCount 参数个数
      * @param isRelative 是否为相对坐标
      * @param path 路径对象
      * @param currentPoint 当前点（引用）
      * @param pathStart 子路径起点（引用）
      * @param lastControlPoint 上一个控制点（引用）
      */
-    static void executeCommand(QChar cmd, const QVector<qreal> &numbers, bool isRelative,
+    static void executeCommand(char cmd, const qreal *numbers, int numCount, bool isRelative,
                               QPainterPath &path, QPointF &currentPoint, 
                               QPointF &pathStart, QPointF &lastControlPoint);
 
     /**
      * 解析贝塞尔曲线命令
      */
-    static void parseBezierCommands(QChar cmd, const QVector<qreal> &numbers, bool isRelative,
+    static void parseBezierCommands(char cmd, const qreal *numbers, int numCount, bool isRelative,
                                    QPainterPath &path, QPointF &currentPoint, 
                                    QPointF &lastControlPoint);
 
     /**
      * 解析椭圆弧命令
      */
-    static void parseArcCommand(const QVector<qreal> &numbers, bool isRelative,
+    static void parseArcCommand(const qreal *numbers, int numCount, bool isRelative,
                               QPainterPath &path, QPointF &currentPoint, 
                               QPointF &pathStart, QPointF &lastControlPoint);
 };
@@ -0,0 +1,225 @@
+#include <QVarLengthArray>
+#include <QtMath>
+#include <algorithm>
+#include "path-hit-index.h"
+#include "bezier-geometry.h"
+
+namespace {
+
+// 细分深度上限，2^-24的参数精度已远低于Flatness
+const int MaxCubicDepth = 24;
+
+inline qreal squaredDistance(const QPointF &a, const QPointF &b)
+{
+    const qreal dx = a.x() - b.x();
+    const qreal dy = a.y() - b.y();
+    return dx * dx + dy * dy;
+}
+
+} // namespace
+
+qreal PathHitIndex::Box::distanceTo(const QPointF &p) const
+{
+    const qreal dx = qMax(qMax(x1 - p.x(), p.x() - x2), qreal(0));
+    const qreal dy = qMax(qMax(y1 - p.y(), p.y() - y2), qreal(0));
+    return qSqrt(dx * dx + dy * dy);
+}
+
+PathHitIndex::Box PathHitIndex::Box::united(const Box &other) const
+{
+    return { qMin(x1, other.x1), qMin(y1, other.y1), qMax(x2, other.x2), qMax(y2, other.y2) };
+}
+
+PathHitIndex::Box PathHitIndex::boxOf(const QPointF *points, int count)
+{
+    Box box = { points[0].x(), points[0].y(), points[0].x(), points[0].y() };
+    for (int i = 1; i < count; ++i) {
+        box.x1 = qMin(box.x1, points[i].x());
+        box.y1 = qMin(box.y1, points[i].y());
+        box.x2 = qMax(box.x2, points[i].x());
+        box.y2 = qMax(box.y2, points[i].y());
+    }
+    return box;
+}
+
+PathHitIndex::PathHitIndex(const QPainterPath &path)
+    : m_root(-1)
+{
+    // QPainterPath把二次曲线也存为三次曲线，CurveTo后跟两个CurveToDataElement
+    const int elementCount = path.elementCount();
+    m_segments.reserve(elementCount);
+    QPointF current;
+    for (int i = 0; i < elementCount; ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            current = element;
+            break;
+        case QPainterPath::LineToElement: {
+            Segment segment;
+            segment.p[0] = current;
+            segment.p[1] = element;
+            segment.curve = false;
+            segment.element = i;
+            segment.box = boxOf(segment.p, 2);
+            m_segments.append(segment);
+            current = element;
+            break;
+        }
+        case QPainterPath::CurveToElement: {
+            if (i + 2 >= elementCount) {
+                i = elementCount;
+                break;
+            }
+            Segment segment;
+            segment.p[0] = current;
+            segment.p[1] = element;
+            segment.p[2] = path.elementAt(i + 1);
+            segment.p[3] = path.elementAt(i + 2);
+            segment.curve = true;
+            segment.element = i;
+            // 曲线位于控制多边形的凸包内
+            segment.box = boxOf(segment.p, 4);
+            m_segments.append(segment);
+            current = segment.p[3];
+            i += 2;
+            break;
+        }
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+
+    if (!m_segments.isEmpty()) {
+        m_nodes.reserve(2 * m_segments.size() / LeafSize + 1);
+        m_root = build(0, m_segments.size());
+    }
+}
+
+int PathHitIndex::build(int first, int count)
+{
+    Node node;
+    node.box = m_segments[first].box;
+    for (int i = first + 1; i < first + count; ++i) {
+        node.box = node.box.united(m_segments[i].box);
+    }
+
+    const int index = m_nodes.size();
+    m_nodes.append(node);
+
+    if (count <= LeafSize) {
+        m_nodes[index].first = first;
+        m_nodes[index].count = count;
+        return index;
+    }
+
+    // 沿包围盒较长的轴按段中心的中位数划分
+    const bool splitX = node.box.x2 - node.box.x1 >= node.box.y2 - node.box.y1;
+    const int half = count / 2;
+    auto begin = m_segments.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [splitX](const Segment &a, const Segment &b) {
+        return splitX ? a.box.x1 + a.box.x2 < b.box.x1 + b.box.x2
+                      : a.box.y1 + a.box.y2 < b.box.y1 + b.box.y2;
+    });
+
+    const int left = build(first, half);
+    const int right = build(first + half, count - half);
+    m_nodes[index].left = left;
+    m_nodes[index].right = right;
+    return index;
+}
+
+PathHitIndex::Hit PathHitIndex::nearest(const QPointF &pos, qreal maxDistance) const
+{
+    Hit best;
+    best.distance = maxDistance;
+    if (m_root < 0) {
+        return best;
+    }
+
+    QVarLengthArray<int, 64> stack;
+    stack.append(m_root);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes[stack.takeLast()];
+        if (node.box.distanceTo(pos) > best.distance) {
+            continue;
+        }
+
+        if (node.left < 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                nearestOnSegment(m_segments[i], pos, best);
+            }
+            continue;
+        }
+
+        // 较近的子节点后入栈、先访问，尽早缩小搜索半径
+        const qreal leftDistance = m_nodes[node.left].box.distanceTo(pos);
+        const qreal rightDistance = m_nodes[node.right].box.distanceTo(pos);
+        if (leftDistance <= rightDistance) {
+            stack.append(node.right);
+            stack.append(node.left);
+        } else {
+            stack.append(node.left);
+            stack.append(node.right);
+        }
+    }
+
+    return best;
+}
+
+void PathHitIndex::nearestOnSegment(const Segment &segment, const QPointF &pos, Hit &best) const
+{
+    if (segment.box.distanceTo(pos) > best.distance) {
+        return;
+    }
+
+    if (segment.curve) {
+        nearestOnCubic(segment.p, 0.0, 1.0, pos, 0, best, segment.element);
+        return;
+    }
+
+    const qreal t = BezierGeometry::segmentParameter(pos, segment.p[0], segment.p[1]);
+    const QPointF point = segment.p[0] + (segment.p[1] - segment.p[0]) * t;
+    const qreal distance = qSqrt(squaredDistance(pos, point));
+    if (distance <= best.distance) {
+        best.element = segment.element;
+        best.t = t;
+        best.distance = distance;
+        best.point = point;
+    }
+}
+
+void PathHitIndex::nearestOnCubic(const QPointF c[4], qreal t0, qreal t1, const QPointF &pos,
+                                  int depth, Hit &best, int element)
+{
+    if (boxOf(c, 4).distanceTo(pos) > best.distance) {
+        return;
+    }
+
+    if (depth >= MaxCubicDepth || BezierGeometry::isFlat(c, Flatness)) {
+        const qreal u = BezierGeometry::segmentParameter(pos, c[0], c[3]);
+        const QPointF point = c[0] + (c[3] - c[0]) * u;
+        const qreal distance = qSqrt(squaredDistance(pos, point));
+        if (distance <= best.distance) {
+            best.element = element;
+            best.t = t0 + (t1 - t0) * u;
+            best.distance = distance;
+            best.point = point;
+        }
+        return;
+    }
+
+    QPointF left[4];
+    QPointF right[4];
+    BezierGeometry::splitCubic(c, left, right);
+    const qreal tm = (t0 + t1) * 0.5;
+
+    // 先细分离查询点较近的一半
+    if (boxOf(left, 4).distanceTo(pos) <= boxOf(right, 4).distanceTo(pos)) {
+        nearestOnCubic(left, t0, tm, pos, depth + 1, best, element);
+        nearestOnCubic(right, tm, t1, pos, depth + 1, best, element);
+    } else {
+        nearestOnCubic(right, tm, t1, pos, depth + 1, best, element);
+        nearestOnCubic(left, t0, tm, pos, depth + 1, best, element);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef PATH_HIT_INDEX_H
+#define PATH_HIT_INDEX_H
+
+#include <QPainterPath>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+#include <limits>
+
+/**
+ * 路径描边命中测试的索引
+ *
+ * 把路径拆成直线段和三次曲线段，按控制多边形的包围盒建立层次包围盒（BVH）。
+ * 查询时只访问与当前最近距离相交的节点，曲线只在查询点附近按de Casteljau
+ * 细分到足够平直，不必每次查询都为整条路径生成描边。
+ *
+ * 路径修改后应丢弃整个索引重新建立
+ */
+class PathHitIndex
+{
+public:
+    // 曲线细分到控制点与弦的距离小于此值（本地坐标）
+    static constexpr qreal Flatness = 0.05;
+
+    explicit PathHitIndex(const QPainterPath &path);
+
+    /**
+     * 最近点查询结果
+     */
+    struct Hit {
+        int element = -1;       // 段在QPainterPath中的起始元素索引（LineTo或CurveTo），-1表示未找到
+        qreal t = 0;            // 段上的参数，0为段起点，1为段终点
+        qreal distance = std::numeric_limits<qreal>::max();
+        QPointF point;          // 段上最近的点
+    };
+
+    /**
+     * 查找离pos最近的段
+     * @param maxDistance 超过此距离的段不返回
+     */
+    Hit nearest(const QPointF &pos, qreal maxDistance = std::numeric_limits<qreal>::max()) const;
+
+    /**
+     * pos与路径的距离是否不超过threshold
+     */
+    bool hits(const QPointF &pos, qreal threshold) const { return nearest(pos, threshold).element >= 0; }
+
+    int segmentCount() const { return m_segments.size(); }
+
+private:
+    struct Box {
+        qreal x1;
+        qreal y1;
+        qreal x2;
+        qreal y2;
+
+        qreal distanceTo(const QPointF &p) const;
+        Box united(const Box &other) const;
+    };
+
+    struct Segment {
+        QPointF p[4];           // 直线只使用p[0]和p[1]
+        bool curve;
+        int element;
+        Box box;
+    };
+
+    struct Node {
+        Box box;
+        int left = -1;          // 内部节点的子节点，叶子为-1
+        int right = -1;
+        int first = 0;          // 叶子包含的段范围
+        int count = 0;
+    };
+
+    static constexpr int LeafSize = 8;
+
+    int build(int first, int count);
+    void nearestOnSegment(const Segment &segment, const QPointF &pos, Hit &best) const;
+    static void nearestOnCubic(const QPointF c[4], qreal t0, qreal t1, const QPointF &pos,
+                               int depth, Hit &best, int element);
+    static Box boxOf(const QPointF *points, int count);
+
+    QVector<Segment> m_segments;
+    QVector<Node> m_nodes;
+    int m_root;
+};
+
+#endif // PATH_HIT_INDEX_H
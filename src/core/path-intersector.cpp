@@ -0,0 +1,238 @@
+#include <QtMath>
+#include <algorithm>
+#include "path-intersector.h"
+#include "box-tree.h"
+#include "bezier-geometry.h"
+
+namespace {
+
+// 子段细分的深度上限，达到后直接用弦求交
+const int MaxSubdivisionDepth = 48;
+
+// 弦交点参数允许的越界量，避免恰好落在子段端点的交点因舍入被漏掉
+const qreal ParameterSlack = 1e-9;
+
+// 段的控制点，直线升阶为三次曲线
+struct Segment {
+    QPointF p[4];
+    int element;
+};
+
+// 递归细分中的子段及其在原段上的参数区间
+struct Piece {
+    QPointF p[4];
+    qreal t0;
+    qreal t1;
+};
+
+BoxTree::Box boxOf(const QPointF *points)
+{
+    BoxTree::Box box = { points[0].x(), points[0].y(), points[0].x(), points[0].y() };
+    for (int i = 1; i < 4; ++i) {
+        box.x1 = qMin(box.x1, points[i].x());
+        box.y1 = qMin(box.y1, points[i].y());
+        box.x2 = qMax(box.x2, points[i].x());
+        box.y2 = qMax(box.y2, points[i].y());
+    }
+    return box;
+}
+
+QVector<Segment> segmentsOf(const QPainterPath &path)
+{
+    QVector<Segment> segments;
+    const int elementCount = path.elementCount();
+    segments.reserve(elementCount);
+    QPointF current;
+    for (int i = 0; i < elementCount; ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            current = element;
+            break;
+        case QPainterPath::LineToElement: {
+            const QPointF end = element;
+            Segment segment;
+            segment.p[0] = current;
+            segment.p[1] = current + (end - current) / 3;
+            segment.p[2] = current + (end - current) * 2 / 3;
+            segment.p[3] = end;
+            segment.element = i;
+            segments.append(segment);
+            current = end;
+            break;
+        }
+        case QPainterPath::CurveToElement:
+            if (i + 2 < elementCount) {
+                Segment segment;
+                segment.p[0] = current;
+                segment.p[1] = element;
+                segment.p[2] = path.elementAt(i + 1);
+                segment.p[3] = path.elementAt(i + 2);
+                segment.element = i;
+                segments.append(segment);
+                current = segment.p[3];
+            }
+            i += 2;
+            break;
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+    return segments;
+}
+
+QVector<BoxTree::Box> boxesOf(const QVector<Segment> &segments)
+{
+    QVector<BoxTree::Box> boxes;
+    boxes.reserve(segments.size());
+    for (const Segment &segment : segments) {
+        boxes.append(boxOf(segment.p));
+    }
+    return boxes;
+}
+
+inline qreal cross(const QPointF &a, const QPointF &b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+void split(const Piece &piece, Piece &left, Piece &right)
+{
+    const qreal tm = (piece.t0 + piece.t1) * 0.5;
+    BezierGeometry::splitCubic(piece.p, left.p, right.p);
+    left.t0 = piece.t0;
+    left.t1 = tm;
+    right.t0 = tm;
+    right.t1 = piece.t1;
+}
+
+// 两条弦的交点参数，平行或共线时返回false
+bool chordIntersection(const Piece &a, const Piece &b, qreal &s, qreal &u)
+{
+    const QPointF r = a.p[3] - a.p[0];
+    const QPointF q = b.p[3] - b.p[0];
+    const qreal denominator = cross(r, q);
+    if (denominator == 0) {
+        return false;
+    }
+    const QPointF w = b.p[0] - a.p[0];
+    s = cross(w, q) / denominator;
+    u = cross(w, r) / denominator;
+    if (s < -ParameterSlack || s > 1 + ParameterSlack || u < -ParameterSlack || u > 1 + ParameterSlack) {
+        return false;
+    }
+    s = qBound(qreal(0), s, qreal(1));
+    u = qBound(qreal(0), u, qreal(1));
+    return true;
+}
+
+inline qreal boxExtent(const BoxTree::Box &box)
+{
+    return qMax(box.x2 - box.x1, box.y2 - box.y1);
+}
+
+void intersectPieces(const Piece &a, const Piece &b, qreal tolerance, int depth, int element1, int element2,
+                     QVector<PathIntersector::Intersection> &out)
+{
+    const BoxTree::Box boxA = boxOf(a.p);
+    const BoxTree::Box boxB = boxOf(b.p);
+    if (!boxA.overlaps(boxB, tolerance)) {
+        return;
+    }
+
+    const bool flatA = BezierGeometry::isFlat(a.p, tolerance);
+    const bool flatB = BezierGeometry::isFlat(b.p, tolerance);
+    if ((flatA && flatB) || depth >= MaxSubdivisionDepth) {
+        qreal s = 0;
+        qreal u = 0;
+        if (chordIntersection(a, b, s, u)) {
+            PathIntersector::Intersection hit;
+            hit.point = a.p[0] + (a.p[3] - a.p[0]) * s;
+            hit.element1 = element1;
+            hit.t1 = a.t0 + (a.t1 - a.t0) * s;
+            hit.element2 = element2;
+            hit.t2 = b.t0 + (b.t1 - b.t0) * u;
+            out.append(hit);
+        }
+        return;
+    }
+
+    // 细分不平直的一段；都不平直时细分包围盒较大的一段
+    Piece left;
+    Piece right;
+    if (!flatA && (flatB || boxExtent(boxA) >= boxExtent(boxB))) {
+        split(a, left, right);
+        intersectPieces(left, b, tolerance, depth + 1, element1, element2, out);
+        intersectPieces(right, b, tolerance, depth + 1, element1, element2, out);
+    } else {
+        split(b, left, right);
+        intersectPieces(a, left, tolerance, depth + 1, element1, element2, out);
+        intersectPieces(a, right, tolerance, depth + 1, element1, element2, out);
+    }
+}
+
+void intersectSegments(const Segment &a, const Segment &b, qreal tolerance,
+                       QVector<PathIntersector::Intersection> &out)
+{
+    const Piece pieceA = { { a.p[0], a.p[1], a.p[2], a.p[3] }, 0, 1 };
+    const Piece pieceB = { { b.p[0], b.p[1], b.p[2], b.p[3] }, 0, 1 };
+    intersectPieces(pieceA, pieceB, tolerance, 0, a.element, b.element, out);
+}
+
+// 合并相距不超过容差的交点（相邻子段或相邻段在公共端点处会重复报告）
+QList<PathIntersector::Intersection> mergeIntersections(QVector<PathIntersector::Intersection> &hits, qreal tolerance)
+{
+    std::sort(hits.begin(), hits.end(), [](const PathIntersector::Intersection &a, const PathIntersector::Intersection &b) {
+        return a.point.x() < b.point.x();
+    });
+
+    QList<PathIntersector::Intersection> merged;
+    merged.reserve(hits.size());
+    const qreal toleranceSquared = tolerance * tolerance;
+    for (const PathIntersector::Intersection &hit : std::as_const(hits)) {
+        bool duplicate = false;
+        for (int k = merged.size() - 1; k >= 0 && hit.point.x() - merged[k].point.x() <= tolerance; --k) {
+            const QPointF d = hit.point - merged[k].point;
+            if (QPointF::dotProduct(d, d) <= toleranceSquared) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            merged.append(hit);
+        }
+    }
+    return merged;
+}
+
+} // namespace
+
+QList<PathIntersector::Intersection> PathIntersector::intersect(const QPainterPath &path1, const QPainterPath &path2,
+                                                                qreal tolerance)
+{
+    const QVector<Segment> segments1 = segmentsOf(path1);
+    const QVector<Segment> segments2 = segmentsOf(path2);
+    if (segments1.isEmpty() || segments2.isEmpty()) {
+        return QList<Intersection>();
+    }
+
+    const BoxTree tree1(boxesOf(segments1));
+    const BoxTree tree2(boxesOf(segments2));
+    QVector<Intersection> hits;
+    tree1.overlappingPairs(tree2, tolerance, [&](int i, int j) {
+        intersectSegments(segments1[i], segments2[j], tolerance, hits);
+    });
+    return mergeIntersections(hits, tolerance);
+}
+
+QList<QPointF> PathIntersector::intersectionPoints(const QPainterPath &path1, const QPainterPath &path2,
+                                                   qreal tolerance)
+{
+    QList<QPointF> points;
+    const QList<Intersection> hits = intersect(path1, path2, tolerance);
+    points.reserve(hits.size());
+    for (const Intersection &hit : hits) {
+        points.append(hit.point);
+    }
+    return points;
+}
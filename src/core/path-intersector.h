@@ -0,0 +1,41 @@
+#ifndef PATH_INTERSECTOR_H
+#define PATH_INTERSECTOR_H
+
+#include <QList>
+#include <QPainterPath>
+#include <QPointF>
+
+/**
+ * 两条路径之间的精确交点
+ *
+ * 直线段按升阶表示为三次曲线，所有段统一处理。两条路径的段分别按控制多边形的
+ * 包围盒建立BoxTree，只对包围盒重叠的段对求交，不做全部两两测试。
+ * 段对内部按包围盒递归细分：包围盒不重叠的子段直接丢弃，两段都平直到容差以内时
+ * 用弦的交点作为结果，参数按弦上的比例换算回原段。
+ * 相距不超过容差的交点合并为一个
+ */
+class PathIntersector
+{
+public:
+    // 默认容差：子段控制点离弦的距离、合并交点的距离
+    static constexpr qreal DefaultTolerance = 1e-3;
+
+    struct Intersection {
+        QPointF point;
+        int element1 = -1;      // 段在第一条路径中的起始元素索引（LineTo或CurveTo）
+        qreal t1 = 0;           // 段上的参数
+        int element2 = -1;
+        qreal t2 = 0;
+    };
+
+    static QList<Intersection> intersect(const QPainterPath &path1, const QPainterPath &path2,
+                                         qreal tolerance = DefaultTolerance);
+
+    /**
+     * 只返回交点坐标
+     */
+    static QList<QPointF> intersectionPoints(const QPainterPath &path1, const QPainterPath &path2,
+                                             qreal tolerance = DefaultTolerance);
+};
+
+#endif // PATH_INTERSECTOR_H
@@ -0,0 +1,168 @@
+#include <QCoreApplication>
+#include <QThreadPool>
+#include <QVector>
+#include <QPair>
+#include <QTransform>
+#include <cmath>
+#include "path-lod.h"
+#include "bezier-geometry.h"
+
+namespace {
+
+// 简化允许的偏差（设备像素）
+const qreal PixelTolerance = 0.5;
+
+inline qreal squaredDistance(const QPointF &a, const QPointF &b)
+{
+    const qreal dx = a.x() - b.x();
+    const qreal dy = a.y() - b.y();
+    return dx * dx + dy * dy;
+}
+
+} // namespace
+
+PathLod::PathLod(const QPainterPath &path)
+    : m_source(path)
+{
+    for (int i = 0; i <= MaxLevel; ++i) {
+        m_ready[i] = false;
+        m_requested[i] = false;
+    }
+}
+
+QPainterPath PathLod::pathForScale(qreal deviceScale, const std::function<void()> &onReady)
+{
+    if (deviceScale >= FullDetailScale || deviceScale <= 0.0) {
+        return m_source;
+    }
+
+    // 缩放比例在[2^-(k+1), 2^-k)之间时使用第k级，偏差不超过半个像素
+    const int level = qBound(1, int(std::floor(std::log2(1.0 / deviceScale))), MaxLevel);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_ready[level]) {
+        return m_levels[level];
+    }
+
+    if (!m_requested[level]) {
+        m_requested[level] = true;
+        scheduleLevel(level, onReady);
+    }
+
+    // 生成完成前使用已有的更精细版本
+    for (int k = level - 1; k >= 1; --k) {
+        if (m_ready[k]) {
+            return m_levels[k];
+        }
+    }
+    return m_source;
+}
+
+void PathLod::scheduleLevel(int level, const std::function<void()> &onReady)
+{
+    std::shared_ptr<PathLod> self = shared_from_this();
+    QThreadPool::globalInstance()->start([self, level, onReady]() {
+        // m_source是常量，工作线程只读取
+        const QPainterPath simplified = simplify(self->m_source, std::exp2(-level));
+
+        {
+            QMutexLocker locker(&self->m_mutex);
+            self->m_levels[level] = simplified;
+            self->m_ready[level] = true;
+        }
+
+        // 没有新的绘制请求时不会再取用这一级，由GUI线程通知绘制者重绘
+        if (onReady && QCoreApplication::instance()) {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), onReady, Qt::QueuedConnection);
+        }
+    });
+}
+
+QPainterPath PathLod::simplify(const QPainterPath &path, qreal deviceScale)
+{
+    QPainterPath result;
+    result.setFillRule(path.fillRule());
+    if (deviceScale <= 0.0) {
+        return result;
+    }
+
+    // 按设备比例展平，曲线的分段数与其在屏幕上的大小相称
+    const QList<QPolygonF> polygons = path.toSubpathPolygons(QTransform::fromScale(deviceScale, deviceScale));
+
+    for (const QPolygonF &polygon : polygons) {
+        // 在设备坐标中简化，再还原到本地坐标
+        const QPolygonF simplified = simplifyPolyline(polygon, PixelTolerance);
+        if (simplified.size() < 2) {
+            continue;
+        }
+
+        const bool closed = polygon.size() > 2 && polygon.first() == polygon.last();
+        result.addPolygon(QTransform::fromScale(1.0 / deviceScale, 1.0 / deviceScale).map(simplified));
+        if (closed) {
+            result.closeSubpath();
+        }
+    }
+
+    return result;
+}
+
+QPolygonF PathLod::simplifyPolyline(const QPolygonF &points, qreal tolerance)
+{
+    const int count = points.size();
+    if (count <= 2) {
+        return points;
+    }
+
+    const qreal toleranceSquared = tolerance * tolerance;
+
+    // 径向距离预过滤：去掉与上一个保留点过近的点，减少后续的计算量
+    QPolygonF reduced;
+    reduced.reserve(count);
+    reduced.append(points.first());
+    for (int i = 1; i < count - 1; ++i) {
+        if (squaredDistance(points[i], reduced.last()) > toleranceSquared) {
+            reduced.append(points[i]);
+        }
+    }
+    reduced.append(points.last());
+
+    const int reducedCount = reduced.size();
+    if (reducedCount <= 2) {
+        return reduced;
+    }
+
+    // Douglas-Peucker，用显式栈代替递归
+    QVector<bool> keep(reducedCount, false);
+    keep[0] = true;
+    keep[reducedCount - 1] = true;
+
+    QVector<QPair<int, int>> stack;
+    stack.append(qMakePair(0, reducedCount - 1));
+    while (!stack.isEmpty()) {
+        const QPair<int, int> range = stack.takeLast();
+
+        qreal maxDistance = 0.0;
+        int farthest = -1;
+        for (int i = range.first + 1; i < range.second; ++i) {
+            const qreal distance = BezierGeometry::squaredSegmentDistance(reduced[i], reduced[range.first], reduced[range.second]);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                farthest = i;
+            }
+        }
+
+        if (farthest >= 0 && maxDistance > toleranceSquared) {
+            keep[farthest] = true;
+            stack.append(qMakePair(range.first, farthest));
+            stack.append(qMakePair(farthest, range.second));
+        }
+    }
+
+    QPolygonF result;
+    for (int i = 0; i < reducedCount; ++i) {
+        if (keep[i]) {
+            result.append(reduced[i]);
+        }
+    }
+    return result;
+}
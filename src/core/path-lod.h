@@ -0,0 +1,65 @@
+#ifndef PATH_LOD_H
+#define PATH_LOD_H
+
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QMutex>
+#include <functional>
+#include <memory>
+
+/**
+ * 路径的细节层次（LOD）缓存
+ *
+ * 缩小显示时，成千上万段的曲线最终只落在几个像素上。按设备缩放比例
+ * 每缩小一倍建立一级简化版本：先按该比例展平曲线，再用Douglas-Peucker
+ * 去掉偏差小于半个像素的点。各级版本在首次需要时由后台线程生成，
+ * 生成完成前继续使用更精细的版本或原路径，生成完成后在GUI线程调用请求时
+ * 传入的回调，由绘制者重绘对应区域。
+ *
+ * 路径修改后应丢弃整个缓存对象，工作线程持有shared_ptr，不会访问已失效的数据
+ */
+class PathLod : public std::enable_shared_from_this<PathLod>
+{
+public:
+    // 元素数量少于此值的路径直接绘制，不值得简化
+    static constexpr int MinElementCount = 64;
+    static constexpr int MaxLevel = 8;
+    // 设备缩放比例不低于此值时使用原路径
+    static constexpr qreal FullDetailScale = 0.5;
+    // 设备上的尺寸（像素）低于这些值时剔除或退化为矩形
+    static constexpr qreal CullSize = 0.5;
+    static constexpr qreal CollapseSize = 2.0;
+
+    explicit PathLod(const QPainterPath &path);
+
+    /**
+     * 获取与设备缩放比例对应的路径
+     * @param deviceScale 本地坐标到设备像素的缩放比例
+     * @param onReady 需要后台生成时，生成完成后在GUI线程调用；回调可能晚于路径所属图形的销毁，
+     *                不应直接捕获图形指针
+     * @return 对应级别的简化路径；尚未生成时返回最接近的更精细版本，并安排后台生成
+     */
+    QPainterPath pathForScale(qreal deviceScale, const std::function<void()> &onReady = {});
+
+    /**
+     * 按设备缩放比例简化路径，偏差不超过半个设备像素
+     */
+    static QPainterPath simplify(const QPainterPath &path, qreal deviceScale);
+
+    /**
+     * Douglas-Peucker折线简化
+     * @param tolerance 允许的最大偏差（与点坐标同单位）
+     */
+    static QPolygonF simplifyPolyline(const QPolygonF &points, qreal tolerance);
+
+private:
+    void scheduleLevel(int level, const std::function<void()> &onReady);
+
+    const QPainterPath m_source;
+    QMutex m_mutex;
+    QPainterPath m_levels[MaxLevel + 1];
+    bool m_ready[MaxLevel + 1];
+    bool m_requested[MaxLevel + 1];
+};
+
+#endif // PATH_LOD_H
@@ -0,0 +1,465 @@
+#include <QLineF>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+#include <limits>
+#include "path-measure.h"
+#include "box-tree.h"
+#include "polygon-clipper.h"
+#include "bezier-geometry.h"
+
+namespace {
+
+// 弧长计算时曲线细分的深度上限
+const int MaxLengthDepth = 16;
+
+// 少于此数量时并行的调度开销大于收益
+const int MinParallelPaths = 64;
+
+// 鞋带公式，多边形视为首尾相连
+qreal signedArea(const qreal *x, const qreal *y, int n)
+{
+    if (n < 3) {
+        return 0;
+    }
+    qreal sum = 0;
+    for (int i = 0; i + 1 < n; ++i) {
+        sum += x[i] * y[i + 1] - x[i + 1] * y[i];
+    }
+    sum += x[n - 1] * y[0] - x[0] * y[n - 1];
+    return sum * 0.5;
+}
+
+// 有向面积和质心的一阶矩（未除以6A），多边形视为首尾相连
+void areaMoments(const qreal *x, const qreal *y, int n, qreal &area, qreal &mx, qreal &my)
+{
+    if (n < 3) {
+        return;
+    }
+    qreal a = 0;
+    qreal sx = 0;
+    qreal sy = 0;
+    for (int i = 0; i < n; ++i) {
+        const int j = i + 1 < n ? i + 1 : 0;
+        const qreal c = x[i] * y[j] - x[j] * y[i];
+        a += c;
+        sx += (x[i] + x[j]) * c;
+        sy += (y[i] + y[j]) * c;
+    }
+    area += a * 0.5;
+    mx += sx;
+    my += sy;
+}
+
+inline int signOf(qreal value)
+{
+    return value > 0 ? 1 : (value < 0 ? -1 : 0);
+}
+
+// 所有转向同号且x、y方向各最多变号两次的多边形是简单凸多边形
+bool isConvex(const qreal *x, const qreal *y, int n)
+{
+    if (n > 1 && x[n - 1] == x[0] && y[n - 1] == y[0]) {
+        --n;
+    }
+    if (n < 3) {
+        return true;
+    }
+
+    int turn = 0;
+    int xFlips = 0;
+    int yFlips = 0;
+    int firstXSign = 0;
+    int firstYSign = 0;
+    int lastXSign = 0;
+    int lastYSign = 0;
+    qreal prevDx = 0;
+    qreal prevDy = 0;
+    bool hasPrev = false;
+    qreal firstDx = 0;
+    qreal firstDy = 0;
+
+    auto visit = [&](qreal dx, qreal dy) {
+        if (dx == 0 && dy == 0) {
+            return true;
+        }
+        if (hasPrev) {
+            const int s = signOf(prevDx * dy - prevDy * dx);
+            if (s != 0) {
+                if (turn != 0 && s != turn) {
+                    return false;
+                }
+                turn = s;
+            }
+        } else {
+            firstDx = dx;
+            firstDy = dy;
+        }
+        const int xs = signOf(dx);
+        const int ys = signOf(dy);
+        if (xs != 0) {
+            if (lastXSign != 0 && xs != lastXSign) {
+                ++xFlips;
+            }
+            if (firstXSign == 0) {
+                firstXSign = xs;
+            }
+            lastXSign = xs;
+        }
+        if (ys != 0) {
+            if (lastYSign != 0 && ys != lastYSign) {
+                ++yFlips;
+            }
+            if (firstYSign == 0) {
+                firstYSign = ys;
+            }
+            lastYSign = ys;
+        }
+        prevDx = dx;
+        prevDy = dy;
+        hasPrev = true;
+        return true;
+    };
+
+    for (int i = 0; i < n; ++i) {
+        const int j = i + 1 < n ? i + 1 : 0;
+        if (!visit(x[j] - x[i], y[j] - y[i])) {
+            return false;
+        }
+    }
+    if (!hasPrev) {
+        return true;
+    }
+
+    // 回到第一条边的转向与绕回时的变号
+    const int closing = signOf(prevDx * firstDy - prevDy * firstDx);
+    if (closing != 0 && turn != 0 && closing != turn) {
+        return false;
+    }
+    xFlips += (lastXSign != 0 && firstXSign != 0 && lastXSign != firstXSign) ? 1 : 0;
+    yFlips += (lastYSign != 0 && firstYSign != 0 && lastYSign != firstYSign) ? 1 : 0;
+    return xFlips <= 2 && yFlips <= 2;
+}
+
+// 按填充规则归一化后的轮廓：外轮廓与洞方向相反，有向面积直接相加。
+// 归一化直接使用已展平的折线，整个过程只展平一次
+PathMeasure::Outline filledOutline(const QPainterPath &path, qreal flatness)
+{
+    PathMeasure::Outline outline = PathMeasure::flatten(path, flatness);
+    if (outline.subpathCount() == 1 && isConvex(outline.x.constData(), outline.y.constData(), outline.x.size())) {
+        return outline;
+    }
+    if (outline.subpathCount() == 0) {
+        return outline;
+    }
+
+    QList<QPolygonF> polygons;
+    polygons.reserve(outline.subpathCount());
+    for (int k = 0; k < outline.subpathCount(); ++k) {
+        QPolygonF polygon;
+        polygon.reserve(outline.starts[k + 1] - outline.starts[k]);
+        for (int i = outline.starts[k]; i < outline.starts[k + 1]; ++i) {
+            polygon.append(QPointF(outline.x[i], outline.y[i]));
+        }
+        if (polygon.size() > 1 && polygon.first() == polygon.last()) {
+            polygon.removeLast();
+        }
+        if (polygon.size() > 1) {
+            polygons.append(polygon);
+        }
+    }
+    const PolygonClipper::FillRule fillRule = path.fillRule() == Qt::WindingFill
+        ? PolygonClipper::NonZero : PolygonClipper::EvenOdd;
+
+    PathMeasure::Outline filled;
+    for (const QPolygonF &contour : PolygonClipper::simplify(polygons, fillRule)) {
+        filled.starts.append(filled.x.size());
+        for (const QPointF &point : contour) {
+            filled.x.append(point.x());
+            filled.y.append(point.y());
+        }
+        filled.x.append(contour.first().x());
+        filled.y.append(contour.first().y());
+    }
+    if (!filled.starts.isEmpty()) {
+        filled.starts.append(filled.x.size());
+    }
+    return filled;
+}
+
+qreal outlineArea(const PathMeasure::Outline &outline)
+{
+    qreal area = 0;
+    for (int k = 0; k < outline.subpathCount(); ++k) {
+        const int begin = outline.starts[k];
+        const int count = outline.starts[k + 1] - begin;
+        area += signedArea(outline.x.constData() + begin, outline.y.constData() + begin, count);
+    }
+    return qAbs(area);
+}
+
+// 按长度加权的折线中点，用于面积为0的图形
+QPointF lineCentroid(const PathMeasure::Outline &outline)
+{
+    qreal total = 0;
+    qreal sx = 0;
+    qreal sy = 0;
+    for (int k = 0; k < outline.subpathCount(); ++k) {
+        for (int i = outline.starts[k]; i + 1 < outline.starts[k + 1]; ++i) {
+            const qreal dx = outline.x[i + 1] - outline.x[i];
+            const qreal dy = outline.y[i + 1] - outline.y[i];
+            const qreal length = qSqrt(dx * dx + dy * dy);
+            total += length;
+            sx += (outline.x[i] + outline.x[i + 1]) * 0.5 * length;
+            sy += (outline.y[i] + outline.y[i + 1]) * 0.5 * length;
+        }
+    }
+    if (total > 0) {
+        return QPointF(sx / total, sy / total);
+    }
+    return outline.x.isEmpty() ? QPointF() : QPointF(outline.x.first(), outline.y.first());
+}
+
+QPointF outlineCentroid(const PathMeasure::Outline &outline, const PathMeasure::Outline &filled)
+{
+    qreal area = 0;
+    qreal mx = 0;
+    qreal my = 0;
+    for (int k = 0; k < filled.subpathCount(); ++k) {
+        const int begin = filled.starts[k];
+        const int count = filled.starts[k + 1] - begin;
+        areaMoments(filled.x.constData() + begin, filled.y.constData() + begin, count, area, mx, my);
+    }
+    if (qAbs(area) > std::numeric_limits<qreal>::epsilon()) {
+        return QPointF(mx / (6 * area), my / (6 * area));
+    }
+    return lineCentroid(outline);
+}
+
+qreal cubicLength(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3,
+                  qreal tolerance, int depth)
+{
+    const qreal chord = QLineF(p0, p3).length();
+    const qreal polygon = QLineF(p0, p1).length() + QLineF(p1, p2).length() + QLineF(p2, p3).length();
+    // 控制多边形与弦足够接近时取Gravesen估计
+    if (polygon - chord <= tolerance || depth >= MaxLengthDepth) {
+        return (chord + polygon) * 0.5;
+    }
+    const QPointF c[4] = { p0, p1, p2, p3 };
+    QPointF left[4];
+    QPointF right[4];
+    BezierGeometry::splitCubic(c, left, right);
+    return cubicLength(left[0], left[1], left[2], left[3], tolerance * 0.5, depth + 1)
+        + cubicLength(right[0], right[1], right[2], right[3], tolerance * 0.5, depth + 1);
+}
+
+// 展平后的线段，单点子路径记为首尾相同的线段
+struct SegmentList {
+    QVector<int> from;
+    QVector<int> to;
+    QVector<BoxTree::Box> boxes;
+};
+
+SegmentList segmentsOf(const PathMeasure::Outline &outline)
+{
+    SegmentList segments;
+    segments.from.reserve(outline.x.size());
+    segments.to.reserve(outline.x.size());
+    segments.boxes.reserve(outline.x.size());
+    auto append = [&](int a, int b) {
+        segments.from.append(a);
+        segments.to.append(b);
+        segments.boxes.append({ qMin(outline.x[a], outline.x[b]), qMin(outline.y[a], outline.y[b]),
+                                qMax(outline.x[a], outline.x[b]), qMax(outline.y[a], outline.y[b]) });
+    };
+    for (int k = 0; k < outline.subpathCount(); ++k) {
+        const int begin = outline.starts[k];
+        const int end = outline.starts[k + 1];
+        if (end - begin == 1) {
+            append(begin, begin);
+        }
+        for (int i = begin; i + 1 < end; ++i) {
+            append(i, i + 1);
+        }
+    }
+    return segments;
+}
+
+inline qreal orientation(const QPointF &a, const QPointF &b, const QPointF &c)
+{
+    return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+}
+
+qreal segmentDistance(const QPointF &a, const QPointF &b, const QPointF &c, const QPointF &d)
+{
+    const qreal d1 = orientation(a, b, c);
+    const qreal d2 = orientation(a, b, d);
+    const qreal d3 = orientation(c, d, a);
+    const qreal d4 = orientation(c, d, b);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+        return 0;
+    }
+    return qMin(qMin(BezierGeometry::segmentDistance(a, c, d), BezierGeometry::segmentDistance(b, c, d)),
+                qMin(BezierGeometry::segmentDistance(c, a, b), BezierGeometry::segmentDistance(d, a, b)));
+}
+
+} // namespace
+
+PathMeasure::Outline PathMeasure::flatten(const QPainterPath &path, qreal flatness)
+{
+    Outline outline;
+    const qreal tolerance = qMax(flatness, qreal(1e-3));
+    const int elementCount = path.elementCount();
+    outline.x.reserve(elementCount);
+    outline.y.reserve(elementCount);
+
+    QPointF current;
+    for (int i = 0; i < elementCount; ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            outline.starts.append(outline.x.size());
+            outline.x.append(element.x);
+            outline.y.append(element.y);
+            current = element;
+            break;
+        case QPainterPath::LineToElement:
+            outline.x.append(element.x);
+            outline.y.append(element.y);
+            current = element;
+            break;
+        case QPainterPath::CurveToElement:
+            if (i + 2 < elementCount) {
+                const QPointF end = path.elementAt(i + 2);
+                BezierGeometry::flattenCubic(current, element, path.elementAt(i + 1), end, tolerance,
+                                             outline.x, outline.y);
+                current = end;
+            }
+            i += 2;
+            break;
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+    if (!outline.starts.isEmpty()) {
+        outline.starts.append(outline.x.size());
+    }
+    return outline;
+}
+
+qreal PathMeasure::area(const QPainterPath &path, qreal flatness)
+{
+    return outlineArea(filledOutline(path, flatness));
+}
+
+qreal PathMeasure::length(const QPainterPath &path, qreal tolerance)
+{
+    qreal total = 0;
+    const int elementCount = path.elementCount();
+    QPointF current;
+    for (int i = 0; i < elementCount; ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            current = element;
+            break;
+        case QPainterPath::LineToElement:
+            total += QLineF(current, element).length();
+            current = element;
+            break;
+        case QPainterPath::CurveToElement:
+            if (i + 2 < elementCount) {
+                const QPointF end = path.elementAt(i + 2);
+                total += cubicLength(current, element, path.elementAt(i + 1), end, tolerance, 0);
+                current = end;
+            }
+            i += 2;
+            break;
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+    return total;
+}
+
+QPointF PathMeasure::centroid(const QPainterPath &path, qreal flatness)
+{
+    const Outline outline = flatten(path, flatness);
+    return outlineCentroid(outline, filledOutline(path, flatness));
+}
+
+qreal PathMeasure::distance(const QPainterPath &path1, const QPainterPath &path2, qreal flatness)
+{
+    const Outline outline1 = flatten(path1, flatness);
+    const Outline outline2 = flatten(path2, flatness);
+    if (outline1.x.isEmpty() || outline2.x.isEmpty()) {
+        return 0;
+    }
+
+    const SegmentList segments1 = segmentsOf(outline1);
+    const SegmentList segments2 = segmentsOf(outline2);
+    const BoxTree tree1(segments1.boxes);
+    const BoxTree tree2(segments2.boxes);
+
+    auto pointOf = [](const Outline &outline, int index) {
+        return QPointF(outline.x[index], outline.y[index]);
+    };
+    const qreal best = tree1.nearestPair(tree2, [&](int i, int j, qreal) {
+        return segmentDistance(pointOf(outline1, segments1.from[i]), pointOf(outline1, segments1.to[i]),
+                               pointOf(outline2, segments2.from[j]), pointOf(outline2, segments2.to[j]));
+    });
+    if (best <= 0) {
+        return 0;
+    }
+
+    // 轮廓不相交时，一个图形完全位于另一个的填充区域内
+    if (path1.contains(pointOf(outline2, 0)) || path2.contains(pointOf(outline1, 0))) {
+        return 0;
+    }
+    return best;
+}
+
+PathMeasure::Measurement PathMeasure::measure(const QPainterPath &path, qreal flatness)
+{
+    Measurement result;
+    if (path.isEmpty()) {
+        return result;
+    }
+    const Outline outline = flatten(path, flatness);
+    const Outline filled = filledOutline(path, flatness);
+    result.area = outlineArea(filled);
+    result.perimeter = length(path);
+    result.centroid = outlineCentroid(outline, filled);
+    result.bounds = path.boundingRect();
+    return result;
+}
+
+QList<PathMeasure::Measurement> PathMeasure::measureAll(const QList<QPainterPath> &paths, qreal flatness)
+{
+    QList<Measurement> results(paths.size());
+    const int threadCount = QThread::idealThreadCount();
+    if (threadCount < 2 || paths.size() < MinParallelPaths) {
+        for (int i = 0; i < paths.size(); ++i) {
+            results[i] = measure(paths[i], flatness);
+        }
+        return results;
+    }
+
+    // 每个任务写入互不重叠的结果区间
+    Measurement *output = results.data();
+    const QPainterPath *input = paths.constData();
+    const int chunkSize = qMax(16, int(paths.size() / (threadCount * 4)));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    for (int begin = 0; begin < paths.size(); begin += chunkSize) {
+        const int end = qMin(begin + chunkSize, int(paths.size()));
+        pool.start([input, output, begin, end, flatness]() {
+            for (int i = begin; i < end; ++i) {
+                output[i] = measure(input[i], flatness);
+            }
+        });
+    }
+    pool.waitForDone();
+    return results;
+}
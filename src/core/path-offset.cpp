@@ -0,0 +1,239 @@
+#include <QPainterPathStroker>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+#include "path-offset.h"
+#include "polygon-clipper.h"
+
+namespace {
+
+// 圆角连接离理想圆弧的最大距离
+const qreal ArcTolerance = PolygonClipper::DefaultFlatness;
+
+// 每个圆角连接的最大分段数
+const int MaxArcSteps = 256;
+
+// 少于此数量的轮廓串行处理，线程调度的开销大于收益
+const int MinParallelContours = 16;
+
+inline qreal cross(const QPointF &a, const QPointF &b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+// 去掉重复的相邻点和与起点重复的终点
+QPolygonF cleanContour(const QPolygonF &contour)
+{
+    QPolygonF points;
+    points.reserve(contour.size());
+    for (const QPointF &point : contour) {
+        if (points.isEmpty() || points.last() != point) {
+            points.append(point);
+        }
+    }
+    while (points.size() > 1 && points.first() == points.last()) {
+        points.removeLast();
+    }
+    return points;
+}
+
+void appendArc(QPolygonF &out, const QPointF &vertex, const QPointF &from, qreal angle, qreal stepAngle)
+{
+    const int steps = qBound(1, qCeil(qAbs(angle) / stepAngle), MaxArcSteps);
+    const qreal step = angle / steps;
+    const qreal c = qCos(step);
+    const qreal s = qSin(step);
+    QPointF v = from;
+    out.append(vertex + v);
+    for (int i = 0; i < steps; ++i) {
+        v = QPointF(v.x() * c - v.y() * s, v.x() * s + v.y() * c);
+        out.append(vertex + v);
+    }
+}
+
+// 单条轮廓的原始偏移，可能自相交，由之后的Positive合并清理
+QPolygonF rawOffset(const QPolygonF &contour, qreal delta, PathOffsetter::JoinStyle join,
+                    qreal miterLimit, qreal stepAngle)
+{
+    const QPolygonF points = cleanContour(contour);
+    const int count = points.size();
+    if (count < 3) {
+        return QPolygonF();
+    }
+
+    // 每条边的左侧单位法线（dy, -dx），对鞋带面积为正的轮廓指向外侧
+    QVector<QPointF> normals(count);
+    for (int i = 0; i < count; ++i) {
+        const QPointF d = points[(i + 1) % count] - points[i];
+        const qreal length = qSqrt(QPointF::dotProduct(d, d));
+        normals[i] = QPointF(d.y(), -d.x()) / length;
+    }
+
+    const qreal miterThreshold = 2.0 / (miterLimit * miterLimit);
+    QPolygonF out;
+    out.reserve(count * 2);
+    for (int i = 0; i < count; ++i) {
+        const QPointF &vertex = points[i];
+        const QPointF &n1 = normals[(i + count - 1) % count];
+        const QPointF &n2 = normals[i];
+        const qreal sinA = cross(n1, n2);
+        const qreal cosA = QPointF::dotProduct(n1, n2);
+
+        // 几乎共线：两个偏移点相距不到一个单位的千分之一，直接取一个
+        if (cosA > 0 && qAbs(sinA * delta) < 1e-3) {
+            out.append(vertex + n1 * delta);
+            continue;
+        }
+
+        // 凹角：经原顶点连接，多出的小环由Positive合并去掉
+        if (sinA * delta < 0) {
+            out.append(vertex + n1 * delta);
+            out.append(vertex);
+            out.append(vertex + n2 * delta);
+            continue;
+        }
+
+        switch (join) {
+        case PathOffsetter::MiterJoin:
+            // 斜接长度为delta / cos(θ/2)，超过上限时退回斜切
+            if (1 + cosA >= miterThreshold) {
+                out.append(vertex + (n1 + n2) * (delta / (1 + cosA)));
+                break;
+            }
+            out.append(vertex + n1 * delta);
+            out.append(vertex + n2 * delta);
+            break;
+        case PathOffsetter::RoundJoin:
+            appendArc(out, vertex, n1 * delta, qAtan2(sinA, cosA), stepAngle);
+            break;
+        case PathOffsetter::BevelJoin:
+            out.append(vertex + n1 * delta);
+            out.append(vertex + n2 * delta);
+            break;
+        }
+    }
+    return out;
+}
+
+// 按子路径是否闭合拆分：终点与起点重合的子路径视为闭合
+void splitSubpaths(const QPainterPath &path, QPainterPath &closed, QPainterPath &open)
+{
+    closed.setFillRule(path.fillRule());
+    QPainterPath current;
+    auto finish = [&]() {
+        if (current.elementCount() > 1) {
+            const QPointF first = current.elementAt(0);
+            const QPointF last = current.elementAt(current.elementCount() - 1);
+            (first == last ? closed : open).addPath(current);
+        }
+        current = QPainterPath();
+    };
+
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            finish();
+            current.moveTo(element);
+            break;
+        case QPainterPath::LineToElement:
+            current.lineTo(element);
+            break;
+        case QPainterPath::CurveToElement:
+            if (i + 2 < path.elementCount()) {
+                current.cubicTo(element, path.elementAt(i + 1), path.elementAt(i + 2));
+            }
+            i += 2;
+            break;
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+    finish();
+}
+
+} // namespace
+
+QList<QPolygonF> PathOffsetter::offsetContours(const QList<QPolygonF> &contours, qreal distance,
+                                               JoinStyle join, qreal miterLimit, bool parallel)
+{
+    if (distance == 0) {
+        return contours;
+    }
+
+    const qreal ratio = qMin(qreal(1), ArcTolerance / qAbs(distance));
+    const qreal stepAngle = 2 * qAcos(1 - ratio);
+    const qreal limit = qMax(qreal(1), miterLimit);
+
+    QList<QPolygonF> raw(contours.size());
+    const int threadCount = QThread::idealThreadCount();
+    if (!parallel || threadCount < 2 || contours.size() < MinParallelContours) {
+        for (int i = 0; i < contours.size(); ++i) {
+            raw[i] = rawOffset(contours[i], distance, join, limit, stepAngle);
+        }
+    } else {
+        // 每个任务写入互不重叠的结果区间
+        QPolygonF *output = raw.data();
+        const QPolygonF *input = contours.constData();
+        const int chunkSize = qMax(4, int(contours.size() / (threadCount * 4)));
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(threadCount);
+        for (int begin = 0; begin < contours.size(); begin += chunkSize) {
+            const int end = qMin(begin + chunkSize, int(contours.size()));
+            pool.start([input, output, begin, end, distance, join, limit, stepAngle]() {
+                for (int i = begin; i < end; ++i) {
+                    output[i] = rawOffset(input[i], distance, join, limit, stepAngle);
+                }
+            });
+        }
+        pool.waitForDone();
+    }
+
+    return PolygonClipper::simplify(raw, PolygonClipper::Positive);
+}
+
+QPainterPath PathOffsetter::offset(const QPainterPath &path, qreal distance, JoinStyle join,
+                                   qreal miterLimit, bool parallel)
+{
+    if (path.isEmpty() || distance == 0) {
+        return path;
+    }
+
+    QPainterPath closed;
+    QPainterPath open;
+    splitSubpaths(path, closed, open);
+
+    QList<QPolygonF> result;
+    if (!closed.isEmpty()) {
+        const PolygonClipper::FillRule fillRule = closed.fillRule() == Qt::WindingFill
+            ? PolygonClipper::NonZero : PolygonClipper::EvenOdd;
+        const QList<QPolygonF> contours = PolygonClipper::simplify(PolygonClipper::flatten(closed), fillRule);
+        result = offsetContours(contours, distance, join, miterLimit, parallel);
+    }
+
+    // 开放子路径没有内部：内缩时为空，外扩时与其距离不超过distance的区域就是圆头描边
+    if (open.isEmpty() || distance < 0) {
+        return PolygonClipper::toPath(result);
+    }
+    QPainterPathStroker stroker;
+    stroker.setWidth(distance * 2);
+    stroker.setCapStyle(Qt::RoundCap);
+    switch (join) {
+    case MiterJoin:
+        stroker.setJoinStyle(Qt::MiterJoin);
+        // QPainterPathStroker的斜接上限以描边宽度为单位
+        stroker.setMiterLimit(miterLimit / 2);
+        break;
+    case RoundJoin:
+        stroker.setJoinStyle(Qt::RoundJoin);
+        break;
+    case BevelJoin:
+        stroker.setJoinStyle(Qt::BevelJoin);
+        break;
+    }
+    const QList<QPolygonF> stroke = PolygonClipper::flatten(stroker.createStroke(open));
+    return PolygonClipper::toPath(PolygonClipper::clip({ result, stroke },
+                                                       { PolygonClipper::NonZero, PolygonClipper::NonZero },
+                                                       PolygonClipper::Union));
+}
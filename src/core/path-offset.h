@@ -0,0 +1,47 @@
+#ifndef PATH_OFFSET_H
+#define PATH_OFFSET_H
+
+#include <QList>
+#include <QPainterPath>
+#include <QPolygonF>
+
+/**
+ * 闭合图形的内缩/外扩
+ *
+ * 1. 按路径的填充规则用PolygonClipper把展平后的子路径归一化为互不相交的轮廓，
+ *    外轮廓鞋带面积为正、洞为负，因此每条边的左侧法线（dy, -dx）都指向填充区域外；
+ * 2. 每条轮廓的边沿法线平移distance，凸角按连接方式补上斜接、圆弧或斜切，
+ *    凹角经原顶点连接，得到可能自相交的原始偏移轮廓；
+ * 3. 所有原始轮廓按Positive规则合并：内缩时翻转的部分环绕数为负，被整体去掉，
+ *    凹角处多出的小环也随之消失。
+ * 各轮廓的第2步互相独立，轮廓较多时在线程池中并行计算
+ */
+class PathOffsetter
+{
+public:
+    enum JoinStyle {
+        MiterJoin,
+        RoundJoin,
+        BevelJoin
+    };
+
+    // 默认斜接长度上限（相对于偏移距离）
+    static constexpr qreal DefaultMiterLimit = 4.0;
+
+    /**
+     * 偏移路径，distance为正时外扩、为负时内缩。只有闭合子路径按上述步骤偏移；
+     * 开放子路径（直线、折线、开放弧）没有内部，外扩时取圆头描边，内缩时为空
+     * @param parallel 为true时轮廓较多时并行生成原始偏移轮廓
+     */
+    static QPainterPath offset(const QPainterPath &path, qreal distance, JoinStyle join = RoundJoin,
+                               qreal miterLimit = DefaultMiterLimit, bool parallel = true);
+
+    /**
+     * 对已归一化的轮廓（外轮廓鞋带面积为正）求偏移，结果同样为归一化的轮廓
+     */
+    static QList<QPolygonF> offsetContours(const QList<QPolygonF> &contours, qreal distance,
+                                           JoinStyle join = RoundJoin, qreal miterLimit = DefaultMiterLimit,
+                                           bool parallel = true);
+};
+
+#endif // PATH_OFFSET_H
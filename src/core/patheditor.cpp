@@ -3,6 +3,11 @@
 #include <qmath.h>
 #include "patheditor.h"
 #include "drawing-shape.h"
+#include "polygon-clipper.h"
+#include "path-measure.h"
+#include "path-intersector.h"
+#include "path-offset.h"
+#include "convex-hull.h"
 
 PathEditor::PathEditor(QObject *parent)
     : QObject(parent)
@@ -13,62 +18,56 @@ QPainterPath PathEditor::booleanOperation(const QPainterPath &path1,
                                           const QPainterPath &path2,
                                           BooleanOperation op)
 {
-    // 检查路径是否为空
-    if (path1.isEmpty() && path2.isEmpty())
-    {
+    // 空操作数的处理取决于运算类型，统一交给n元版本
+    return booleanOperation(QList<QPainterPath>{path1, path2}, op);
+}
+
+QPainterPath PathEditor::booleanOperation(const QList<QPainterPath> &paths,
+                                          BooleanOperation op,
+                                          bool refitCurves)
+{
+    // 空操作数：求交时结果为空，求差时被减数为空则结果为空，其余情况可直接忽略
+    if (paths.isEmpty()) {
         return QPainterPath();
     }
-    if (path1.isEmpty())
-    {
-        return path2;
+    if (paths.first().isEmpty() && op == Subtraction) {
+        return QPainterPath();
     }
-    if (path2.isEmpty())
-    {
-        return path1;
+    QList<QPainterPath> operands;
+    operands.reserve(paths.size());
+    for (const QPainterPath &path : paths) {
+        if (!path.isEmpty()) {
+            operands.append(path);
+        } else if (op == Intersection) {
+            return QPainterPath();
+        }
+    }
+    if (operands.isEmpty()) {
+        return QPainterPath();
+    }
+    if (operands.size() == 1) {
+        return operands.first();
     }
 
-    // Qt实现的布尔运算（回退方案）
-    // qDebug() << "Performing boolean operation, op:" << op;
-
-    // 创建路径副本并确保使用正确的填充规则
-    QPainterPath p1 = path1;
-    QPainterPath p2 = path2;
-
-    // 对于布尔运算，使用 OddEvenFill 填充规则通常更可靠
-    p1.setFillRule(Qt::OddEvenFill);
-    p2.setFillRule(Qt::OddEvenFill);
-
-    QPainterPath result;
-
-    // 执行布尔运算
+    PolygonClipper::Operation clipOp = PolygonClipper::Union;
     switch (op)
     {
     case Union:
-        // qDebug() << "Performing union operation";
-        result = p1.united(p2);
+        clipOp = PolygonClipper::Union;
         break;
     case Intersection:
-        // qDebug() << "Performing intersection operation";
-        result = p1.intersected(p2);
+        clipOp = PolygonClipper::Intersection;
         break;
     case Subtraction:
-        // qDebug() << "Performing subtraction operation";
-        result = p1.subtracted(p2);
+        clipOp = PolygonClipper::Difference;
         break;
     case Xor:
-        // qDebug() << "Performing XOR operation";
-        // XOR 可以通过 (A U B) - (A ∩ B) 实现
-        result = p1.united(p2).subtracted(p1.intersected(p2));
+        clipOp = PolygonClipper::Xor;
         break;
     }
 
-    // 确保结果也使用正确的填充规则
-    result.setFillRule(Qt::OddEvenFill);
-
-    // qDebug() << "Boolean operation result isEmpty:" << result.isEmpty();
-    // qDebug() << "Result elementCount:" << result.elementCount();
-
-    return result;
+    // 结果使用OddEvenFill
+    return PolygonClipper::execute(operands, clipOp, PolygonClipper::DefaultFlatness, refitCurves);
 }
 
 QPainterPath PathEditor::simplifyPath(const QPainterPath &path, qreal tolerance)
@@ -281,13 +280,8 @@ QPainterPath PathEditor::convertToCurve(const QPainterPath &path)
 
 QPainterPath PathEditor::offsetPath(const QPainterPath &path, qreal distance)
 {
-    QPainterPathStroker stroker;
-    stroker.setWidth(distance * 2);
-    stroker.setCapStyle(Qt::RoundCap);
-    stroker.setJoinStyle(Qt::RoundJoin);
-
-    QPainterPath offset = stroker.createStroke(path);
-    return offset;
+    // 真正的内缩/外扩，保留尖角
+    return PathOffsetter::offset(path, distance, PathOffsetter::MiterJoin);
 }
 
 QPainterPath PathEditor::outlinePath(const QPainterPath &path, qreal width)
@@ -312,25 +306,7 @@ QPainterPath PathEditor::getIntersection(const QPainterPath &path1, const QPaint
 
 QList<QPointF> PathEditor::getIntersectionPoints(const QPainterPath &path1, const QPainterPath &path2)
 {
-    QList<QPointF> intersections;
-
-    // 简化实现：使用边界框检测
-    QRectF bounds1 = path1.controlPointRect();
-    QRectF bounds2 = path2.controlPointRect();
-
-    if (!bounds1.intersects(bounds2))
-    {
-        return intersections;
-    }
-
-    // 更精确的检测需要更复杂的算法，这里返回边界框交点作为示例
-    QRectF intersection = bounds1.intersected(bounds2);
-    if (!intersection.isEmpty())
-    {
-        intersections.append(intersection.center());
-    }
-
-    return intersections;
+    return PathIntersector::intersectionPoints(path1, path2);
 }
 
 QPainterPath PathEditor::fromPolygon(const QList<QPointF> &points, bool closed)
@@ -591,76 +567,64 @@ QPainterPath PathEditor::clipPath(const QPainterPath &path, const QPainterPath &
     return path.intersected(clipPath);
 }
 
-// 简化的几何功能实现（不使用Boost）
 QPainterPath PathEditor::convexHull(const QPainterPath &path)
 {
-    // 简单实现：返回边界框
-    return QPainterPath();
+    return ConvexHull::toPath(ConvexHull::ofPath(path));
+}
+
+QPainterPath PathEditor::convexHull(const QList<DrawingShape *> &shapes)
+{
+    DrawingShape::cacheConvexHulls(shapes);
+
+    // 各图形的凸包映射到场景坐标（包括所在组合的变换）后再求一次总的凸包
+    QList<QPolygonF> hulls;
+    hulls.reserve(shapes.size());
+    for (DrawingShape *shape : shapes) {
+        if (shape) {
+            hulls.append(shape->sceneTransform().map(shape->convexHull()));
+        }
+    }
+    return ConvexHull::toPath(ConvexHull::ofHulls(hulls));
 }
 
 QPainterPath PathEditor::buffer(const QPainterPath &path, double distance)
 {
-    // 使用Qt的描边功能
-    QPainterPathStroker stroker;
-    stroker.setWidth(qAbs(distance) * 2);
-    stroker.setCapStyle(Qt::RoundCap);
-    stroker.setJoinStyle(Qt::RoundJoin);
-    return stroker.createStroke(path);
+    // 缓冲区：与图形距离不超过|distance|的区域，拐角为圆角，开放路径为圆头
+    return PathOffsetter::offset(path, qAbs(distance), PathOffsetter::RoundJoin);
 }
 
 double PathEditor::distance(const QPainterPath &path1, const QPainterPath &path2)
 {
-    // 使用简单的边界框距离
-    QRectF rect1 = path1.boundingRect();
-    QRectF rect2 = path2.boundingRect();
-
-    if (rect1.intersects(rect2))
-    {
-        return 0.0;
-    }
-
-    // 计算最近边界点之间的距离
-    double dx = qMax(0.0, qMax(rect1.left() - rect2.right(), rect2.left() - rect1.right()));
-    double dy = qMax(0.0, qMax(rect1.top() - rect2.bottom(), rect2.top() - rect1.bottom()));
-
-    return qSqrt(dx * dx + dy * dy);
+    return PathMeasure::distance(path1, path2);
 }
 
 double PathEditor::area(const QPainterPath &path)
 {
-    // 使用边界框面积作为近似
-    return path.boundingRect().width() * path.boundingRect().height();
+    return PathMeasure::area(path);
 }
 
 double PathEditor::perimeter(const QPainterPath &path)
 {
-    // 使用Qt的近似计算
-    double length = 0.0;
-    for (int i = 0; i < path.elementCount() - 1; ++i)
+    return PathMeasure::length(path);
+}
+
+QPointF PathEditor::centroid(const QPainterPath &path)
+{
+    if (path.isEmpty())
     {
-        const QPainterPath::Element &elem1 = path.elementAt(i);
-        const QPainterPath::Element &elem2 = path.elementAt(i + 1);
-        if (elem1.type != QPainterPath::MoveToElement && elem2.type != QPainterPath::MoveToElement)
-        {
-            double dx = elem2.x - elem1.x;
-            double dy = elem2.y - elem1.y;
-            length += qSqrt(dx * dx + dy * dy);
-        }
+        return QPointF();
     }
-    return length;
+    return PathMeasure::centroid(path);
 }
 
-QPointF PathEditor::centroid(const QPainterPath &path)
+QList<PathMeasure::Measurement> PathEditor::measure(const QList<QPainterPath> &paths)
 {
-    // 使用边界框中心作为近似
-    QRectF rect = path.boundingRect();
-    return rect.center();
+    return PathMeasure::measureAll(paths);
 }
 
 QList<QPointF> PathEditor::intersections(const QPainterPath &path1, const QPainterPath &path2)
 {
-    // 简单实现：返回空列表
-    return QList<QPointF>();
+    return PathIntersector::intersectionPoints(path1, path2);
 }
 
 bool PathEditor::isBoostGeometryAvailable()
@@ -5,8 +5,10 @@
 #include <QPainterPath>
 #include <QList>
 #include <QPointF>
+#include "path-measure.h"
 
 class DrawingPath;
+class DrawingShape;
 
 /**
  * 路径编辑器 - 处理复杂路径操作
@@ -38,6 +40,10 @@ public:
     static QPainterPath booleanOperation(const QPainterPath &path1, 
                                         const QPainterPath &path2, 
                                         BooleanOperation op);
+    // n元布尔运算：所有操作数一次扫描完成，Subtraction为第一个减去其余，Xor为奇数次覆盖
+    static QPainterPath booleanOperation(const QList<QPainterPath> &paths,
+                                        BooleanOperation op,
+                                        bool refitCurves = false);
     
     // 路径操作
     static QPainterPath simplifyPath(const QPainterPath &path, qreal tolerance = 0.5);
@@ -61,11 +67,15 @@ public:
     
     // 简化的几何功能
     static QPainterPath convexHull(const QPainterPath &path);
+    // 多个图形在场景坐标中合在一起的凸包，使用各图形缓存的凸包，未缓存的并行计算
+    static QPainterPath convexHull(const QList<DrawingShape *> &shapes);
     static QPainterPath buffer(const QPainterPath &path, double distance);
     static double distance(const QPainterPath &path1, const QPainterPath &path2);
     static double area(const QPainterPath &path);
     static double perimeter(const QPainterPath &path);
     static QPointF centroid(const QPainterPath &path);
+    // 批量度量面积、周长、质心和边界，图形较多时并行计算
+    static QList<PathMeasure::Measurement> measure(const QList<QPainterPath> &paths);
     static QList<QPointF> intersections(const QPainterPath &path1, const QPainterPath &path2);
     static bool isBoostGeometryAvailable();
     
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include "point-kd-tree.h"
+
+PointKdTree::PointKdTree(const QVector<QPointF> &points)
+    : m_points(points)
+{
+    m_order.resize(points.size());
+    m_splitX.resize(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        m_order[i] = i;
+    }
+    build(0, points.size());
+}
+
+void PointKdTree::build(int first, int last)
+{
+    if (last - first <= 1) {
+        if (last - first == 1) {
+            m_splitX[first] = true;
+        }
+        return;
+    }
+
+    qreal left = m_points[m_order[first]].x();
+    qreal right = left;
+    qreal top = m_points[m_order[first]].y();
+    qreal bottom = top;
+    for (int i = first + 1; i < last; ++i) {
+        const QPointF &point = m_points[m_order[i]];
+        left = qMin(left, point.x());
+        right = qMax(right, point.x());
+        top = qMin(top, point.y());
+        bottom = qMax(bottom, point.y());
+    }
+
+    const bool splitX = right - left >= bottom - top;
+    const int mid = (first + last) / 2;
+    std::nth_element(m_order.begin() + first, m_order.begin() + mid, m_order.begin() + last,
+                     [this, splitX](int a, int b) {
+                         return splitX ? m_points[a].x() < m_points[b].x() : m_points[a].y() < m_points[b].y();
+                     });
+    m_splitX[mid] = splitX;
+
+    build(first, mid);
+    build(mid + 1, last);
+}
+
+int PointKdTree::nearest(const QPointF &pos, qreal maxDistance) const
+{
+    int best = -1;
+    qreal bestDistance = maxDistance * maxDistance;
+    nearest(0, m_order.size(), pos, best, bestDistance);
+    return best;
+}
+
+void PointKdTree::nearest(int first, int last, const QPointF &pos, int &best, qreal &bestDistance) const
+{
+    if (first >= last) {
+        return;
+    }
+
+    const int mid = (first + last) / 2;
+    const int index = m_order[mid];
+    const QPointF &point = m_points[index];
+    const qreal dx = pos.x() - point.x();
+    const qreal dy = pos.y() - point.y();
+    const qreal distance = dx * dx + dy * dy;
+    if (distance < bestDistance || (distance == bestDistance && (best < 0 || index < best))) {
+        best = index;
+        bestDistance = distance;
+    }
+
+    // 先搜索查询点所在的一侧，另一侧只在划分线仍在搜索半径内时访问
+    const qreal offset = m_splitX[mid] ? dx : dy;
+    if (offset < 0) {
+        nearest(first, mid, pos, best, bestDistance);
+        if (offset * offset <= bestDistance) {
+            nearest(mid + 1, last, pos, best, bestDistance);
+        }
+    } else {
+        nearest(mid + 1, last, pos, best, bestDistance);
+        if (offset * offset <= bestDistance) {
+            nearest(first, mid, pos, best, bestDistance);
+        }
+    }
+}
+
+QVector<int> PointKdTree::pointsWithin(const QPointF &center, qreal radius) const
+{
+    QVector<int> result;
+    collect(0, m_order.size(), center, radius, result);
+    return result;
+}
+
+void PointKdTree::collect(int first, int last, const QPointF &center, qreal radius, QVector<int> &result) const
+{
+    if (first >= last) {
+        return;
+    }
+
+    const int mid = (first + last) / 2;
+    const QPointF &point = m_points[m_order[mid]];
+    const qreal dx = center.x() - point.x();
+    const qreal dy = center.y() - point.y();
+    if (dx * dx + dy * dy <= radius * radius) {
+        result.append(m_order[mid]);
+    }
+
+    // 左侧的坐标不大于划分点，右侧不小于划分点
+    const qreal offset = m_splitX[mid] ? dx : dy;
+    if (offset <= radius) {
+        collect(first, mid, center, radius, result);
+    }
+    if (offset >= -radius) {
+        collect(mid + 1, last, center, radius, result);
+    }
+}
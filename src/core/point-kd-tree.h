@@ -0,0 +1,42 @@
+#ifndef POINT_KD_TREE_H
+#define POINT_KD_TREE_H
+
+#include <QPointF>
+#include <QVector>
+#include <limits>
+
+/**
+ * 静态点集的二维k-d树
+ *
+ * 点的下标按隐式平衡树排列（每个区间的中位数作为节点，按跨度较大的轴划分），
+ * 不额外分配节点。建立O(n log n)，最近点查询平均O(log n)。
+ * 点集变化后应整体重建
+ */
+class PointKdTree
+{
+public:
+    explicit PointKdTree(const QVector<QPointF> &points);
+
+    /**
+     * 离pos最近的点的下标，距离超过maxDistance时返回-1；距离相同时返回下标较小的点
+     */
+    int nearest(const QPointF &pos, qreal maxDistance = std::numeric_limits<qreal>::max()) const;
+
+    /**
+     * 与center距离不超过radius的所有点的下标（无序）
+     */
+    QVector<int> pointsWithin(const QPointF &center, qreal radius) const;
+
+    int size() const { return m_order.size(); }
+
+private:
+    void build(int first, int last);
+    void nearest(int first, int last, const QPointF &pos, int &best, qreal &bestDistance) const;
+    void collect(int first, int last, const QPointF &center, qreal radius, QVector<int> &result) const;
+
+    QVector<QPointF> m_points;
+    QVector<int> m_order;       // 隐式树中各位置对应的点下标
+    QVector<char> m_splitX;     // 各区间中位数节点的划分轴
+};
+
+#endif // POINT_KD_TREE_H
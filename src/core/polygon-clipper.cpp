@@ -0,0 +1,921 @@
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+#include "polygon-clipper.h"
+#include "bezier-geometry.h"
+
+namespace {
+
+// 量化后坐标的绝对值上限（2^28），中点坐标加倍后的叉积仍在qint64范围内
+const qreal MaxCoordinate = 268435456.0;
+
+// 拟合时转角超过此角度的顶点保留为尖角
+const qreal CornerAngle = M_PI / 6;
+const int MaxReparameterizeIterations = 4;
+
+// 交点取整后拆出的边可能与其他边产生新的交叉，最多重复拆分的遍数
+const int MaxSplitPasses = 8;
+
+struct IPoint {
+    qint64 x;
+    qint64 y;
+};
+
+inline bool operator==(const IPoint &a, const IPoint &b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+inline bool operator!=(const IPoint &a, const IPoint &b)
+{
+    return !(a == b);
+}
+
+// 先比较y再比较x，边的起点总是较小的端点
+inline bool operator<(const IPoint &a, const IPoint &b)
+{
+    return a.y < b.y || (a.y == b.y && a.x < b.x);
+}
+
+inline qint64 cross(qint64 ax, qint64 ay, qint64 bx, qint64 by)
+{
+    return ax * by - ay * bx;
+}
+
+// 输入边，a为较小端点
+struct InputEdge {
+    IPoint a;
+    IPoint b;
+    int operand;
+    int winding;        // 原方向为a到b时为+1，否则为-1
+};
+
+// 合并重合边后每个操作数的环绕贡献
+struct Member {
+    int operand;
+    int winding;
+};
+
+struct Edge {
+    IPoint a;
+    IPoint b;
+    int firstMember;
+    int memberCount;
+};
+
+struct DirectedEdge {
+    IPoint from;
+    IPoint to;
+};
+
+// p与边共线时，判断p是否在边的内部（不含端点）
+inline bool strictlyInside(const IPoint &p, const InputEdge &e)
+{
+    return p != e.a && p != e.b
+        && p.x >= qMin(e.a.x, e.b.x) && p.x <= qMax(e.a.x, e.b.x)
+        && p.y >= qMin(e.a.y, e.b.y) && p.y <= qMax(e.a.y, e.b.y);
+}
+
+// 求两条边的交点和T形连接点，记录为各自的拆分点；交点不在网格上被取整时置rounded
+void intersectEdges(const InputEdge &e, const InputEdge &f, QVector<IPoint> &eSplits, QVector<IPoint> &fSplits,
+                    bool &rounded)
+{
+    const qint64 ex = e.b.x - e.a.x;
+    const qint64 ey = e.b.y - e.a.y;
+    const qint64 fx = f.b.x - f.a.x;
+    const qint64 fy = f.b.y - f.a.y;
+    const qint64 d1 = cross(ex, ey, f.a.x - e.a.x, f.a.y - e.a.y);
+    const qint64 d2 = cross(ex, ey, f.b.x - e.a.x, f.b.y - e.a.y);
+    const qint64 d3 = cross(fx, fy, e.a.x - f.a.x, e.a.y - f.a.y);
+    const qint64 d4 = cross(fx, fy, e.b.x - f.a.x, e.b.y - f.a.y);
+
+    // 端点落在另一条边上（共线重叠时也由这里拆开）
+    if (d1 == 0 && strictlyInside(f.a, e)) {
+        eSplits.append(f.a);
+    }
+    if (d2 == 0 && strictlyInside(f.b, e)) {
+        eSplits.append(f.b);
+    }
+    if (d3 == 0 && strictlyInside(e.a, f)) {
+        fSplits.append(e.a);
+    }
+    if (d4 == 0 && strictlyInside(e.b, f)) {
+        fSplits.append(e.b);
+    }
+
+    // 真正的交叉，交点取整到网格
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+        const qreal t = qreal(d3) / qreal(d3 - d4);
+        const IPoint p = { e.a.x + qRound64(ex * t), e.a.y + qRound64(ey * t) };
+        if (p != e.a && p != e.b) {
+            eSplits.append(p);
+        }
+        if (p != f.a && p != f.b) {
+            fSplits.append(p);
+        }
+        if (cross(ex, ey, p.x - e.a.x, p.y - e.a.y) != 0 || cross(fx, fy, p.x - f.a.x, p.y - f.a.y) != 0) {
+            rounded = true;
+        }
+    }
+}
+
+// 按起点的y排序扫描，只比较y区间和x区间都重叠的边
+QVector<QVector<IPoint>> findSplits(const QVector<InputEdge> &edges, bool &rounded)
+{
+    QVector<QVector<IPoint>> splits(edges.size());
+    QVector<int> order(edges.size());
+    for (int i = 0; i < edges.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&edges](int a, int b) {
+        return edges[a].a.y < edges[b].a.y;
+    });
+
+    QVector<int> active;
+    for (int index : std::as_const(order)) {
+        const InputEdge &e = edges[index];
+        int kept = 0;
+        for (int other : std::as_const(active)) {
+            if (edges[other].b.y >= e.a.y) {
+                active[kept++] = other;
+            }
+        }
+        active.resize(kept);
+
+        const qint64 minX = qMin(e.a.x, e.b.x);
+        const qint64 maxX = qMax(e.a.x, e.b.x);
+        for (int other : std::as_const(active)) {
+            const InputEdge &f = edges[other];
+            if (qMax(f.a.x, f.b.x) < minX || qMin(f.a.x, f.b.x) > maxX) {
+                continue;
+            }
+            intersectEdges(e, f, splits[index], splits[other], rounded);
+        }
+        active.append(index);
+    }
+    return splits;
+}
+
+// 在拆分点处切开一遍，返回是否有交点被取整
+bool splitEdges(const QVector<InputEdge> &input, QVector<InputEdge> &pieces)
+{
+    bool rounded = false;
+    const QVector<QVector<IPoint>> splits = findSplits(input, rounded);
+
+    pieces.clear();
+    pieces.reserve(input.size());
+    for (int i = 0; i < input.size(); ++i) {
+        const InputEdge &edge = input[i];
+        if (splits[i].isEmpty()) {
+            pieces.append(edge);
+            continue;
+        }
+        // 端点按(y, x)排序即为沿边的顺序
+        QVector<IPoint> points = splits[i];
+        points.append(edge.a);
+        points.append(edge.b);
+        std::sort(points.begin(), points.end());
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+        for (int k = 0; k + 1 < points.size(); ++k) {
+            pieces.append({ points[k], points[k + 1], edge.operand, edge.winding });
+        }
+    }
+    return rounded;
+}
+
+// 在拆分点处切开，合并完全重合的边
+void buildEdges(const QVector<InputEdge> &input, QVector<Edge> &edges, QVector<Member> &members)
+{
+    // 取整后的拆分点使新边偏离原边，可能与其他边产生新的交叉；
+    // 重复拆分直到交点都精确落在网格上，即不再产生新的交叉
+    QVector<InputEdge> pieces;
+    bool rounded = splitEdges(input, pieces);
+    for (int pass = 1; rounded && pass < MaxSplitPasses; ++pass) {
+        const QVector<InputEdge> current = pieces;
+        rounded = splitEdges(current, pieces);
+    }
+
+    std::sort(pieces.begin(), pieces.end(), [](const InputEdge &x, const InputEdge &y) {
+        if (x.a != y.a) {
+            return x.a < y.a;
+        }
+        if (x.b != y.b) {
+            return x.b < y.b;
+        }
+        return x.operand < y.operand;
+    });
+
+    edges.reserve(pieces.size());
+    members.reserve(pieces.size());
+    for (int i = 0; i < pieces.size();) {
+        Edge edge = { pieces[i].a, pieces[i].b, int(members.size()), 0 };
+        int j = i;
+        for (; j < pieces.size() && pieces[j].a == edge.a && pieces[j].b == edge.b; ++j) {
+            if (int(members.size()) > edge.firstMember && members.last().operand == pieces[j].operand) {
+                members.last().winding += pieces[j].winding;
+            } else {
+                members.append({ pieces[j].operand, pieces[j].winding });
+            }
+        }
+        i = j;
+
+        // 同一操作数正反两次经过的边互相抵消
+        int kept = edge.firstMember;
+        for (int k = edge.firstMember; k < members.size(); ++k) {
+            if (members[k].winding != 0) {
+                members[kept++] = members[k];
+            }
+        }
+        members.resize(kept);
+        edge.memberCount = kept - edge.firstMember;
+        if (edge.memberCount > 0) {
+            edges.append(edge);
+        }
+    }
+}
+
+// 射线统计时各操作数的环绕数，只重置被修改过的项
+class WindingState
+{
+public:
+    WindingState(const QList<PolygonClipper::FillRule> &fillRules, PolygonClipper::Operation op)
+        : m_fillRules(fillRules)
+        , m_operation(op)
+        , m_winding(fillRules.size(), 0)
+        , m_touched(fillRules.size(), 0)
+    {
+    }
+
+    void add(const QVector<Member> &members, const Edge &edge, int sign)
+    {
+        for (int i = edge.firstMember; i < edge.firstMember + edge.memberCount; ++i) {
+            const int operand = members[i].operand;
+            if (!m_touched[operand]) {
+                m_touched[operand] = 1;
+                m_touchedList.append(operand);
+            }
+            m_winding[operand] += sign * members[i].winding;
+        }
+    }
+
+    // 射线一侧（负侧）与加上边自身贡献的另一侧（正侧）是否在结果内部
+    void classify(const QVector<Member> &members, const Edge &edge, bool &negativeInside, bool &positiveInside)
+    {
+        int count = 0;
+        bool first = false;
+        for (int operand : std::as_const(m_touchedList)) {
+            if (inside(operand, m_winding[operand])) {
+                ++count;
+                first = first || operand == 0;
+            }
+        }
+        negativeInside = result(count, first);
+
+        for (int i = edge.firstMember; i < edge.firstMember + edge.memberCount; ++i) {
+            const int operand = members[i].operand;
+            const bool before = inside(operand, m_winding[operand]);
+            const bool after = inside(operand, m_winding[operand] + members[i].winding);
+            count += int(after) - int(before);
+            if (operand == 0) {
+                first = after;
+            }
+        }
+        positiveInside = result(count, first);
+    }
+
+    void reset()
+    {
+        for (int operand : std::as_const(m_touchedList)) {
+            m_winding[operand] = 0;
+            m_touched[operand] = 0;
+        }
+        m_touchedList.clear();
+    }
+
+private:
+    bool inside(int operand, int winding) const
+    {
+        switch (m_fillRules[operand]) {
+        case PolygonClipper::EvenOdd:
+            return (winding & 1) != 0;
+        case PolygonClipper::NonZero:
+            return winding != 0;
+        case PolygonClipper::Positive:
+            return winding > 0;
+        }
+        return false;
+    }
+
+    bool result(int count, bool first) const
+    {
+        switch (m_operation) {
+        case PolygonClipper::Union:
+            return count > 0;
+        case PolygonClipper::Intersection:
+            return count == m_fillRules.size();
+        case PolygonClipper::Difference:
+            return first && count == 1;
+        case PolygonClipper::Xor:
+            return (count & 1) != 0;
+        }
+        return false;
+    }
+
+    const QList<PolygonClipper::FillRule> &m_fillRules;
+    PolygonClipper::Operation m_operation;
+    QVector<int> m_winding;
+    QVector<char> m_touched;
+    QVector<int> m_touchedList;
+};
+
+inline void emitBoundary(const Edge &edge, bool negativeInside, bool positiveInside, QVector<DirectedEdge> &boundary)
+{
+    if (negativeInside == positiveInside) {
+        return;
+    }
+    // 输出方向使结果内部总在边的正侧（叉积为正的一侧）
+    if (positiveInside) {
+        boundary.append({ edge.a, edge.b });
+    } else {
+        boundary.append({ edge.b, edge.a });
+    }
+}
+
+// 非水平边：从中点向+x发射水平射线，统计负侧（+x侧）的环绕数
+void classifySloped(const QVector<Edge> &edges, const QVector<Member> &members,
+                    WindingState &state, QVector<DirectedEdge> &boundary)
+{
+    QVector<int> sloped;
+    for (int i = 0; i < edges.size(); ++i) {
+        if (edges[i].a.y != edges[i].b.y) {
+            sloped.append(i);
+        }
+    }
+    if (sloped.isEmpty()) {
+        return;
+    }
+
+    // sloped已按起点排序；查询按中点高度（加倍坐标）排序
+    QVector<int> queries = sloped;
+    std::sort(queries.begin(), queries.end(), [&edges](int a, int b) {
+        return edges[a].a.y + edges[a].b.y < edges[b].a.y + edges[b].b.y;
+    });
+
+    QVector<int> active;
+    int next = 0;
+    qint64 lastY2 = std::numeric_limits<qint64>::min();
+    for (int query : std::as_const(queries)) {
+        const Edge &self = edges[query];
+        const qint64 y2 = self.a.y + self.b.y;
+        const qint64 x2 = self.a.x + self.b.x;
+
+        // 活动边的y区间为半开区间[a.y, b.y)
+        while (next < sloped.size() && 2 * edges[sloped[next]].a.y <= y2) {
+            active.append(sloped[next++]);
+        }
+        if (y2 != lastY2) {
+            int kept = 0;
+            for (int index : std::as_const(active)) {
+                if (2 * edges[index].b.y > y2) {
+                    active[kept++] = index;
+                }
+            }
+            active.resize(kept);
+            lastY2 = y2;
+        }
+
+        for (int index : std::as_const(active)) {
+            if (index == query) {
+                continue;
+            }
+            const Edge &edge = edges[index];
+            // 中点在边的左侧，即射线与边相交；边的方向向下，贡献为+winding
+            if (cross(edge.b.x - edge.a.x, edge.b.y - edge.a.y, x2 - 2 * edge.a.x, y2 - 2 * edge.a.y) > 0) {
+                state.add(members, edge, 1);
+            }
+        }
+
+        bool negativeInside = false;
+        bool positiveInside = false;
+        state.classify(members, self, negativeInside, positiveInside);
+        state.reset();
+        emitBoundary(self, negativeInside, positiveInside, boundary);
+    }
+}
+
+// 水平边：从中点向-y发射竖直射线，统计负侧（上方）的环绕数
+void classifyHorizontal(const QVector<Edge> &edges, const QVector<Member> &members,
+                        WindingState &state, QVector<DirectedEdge> &boundary)
+{
+    QVector<int> queries;
+    QVector<int> candidates;
+    for (int i = 0; i < edges.size(); ++i) {
+        if (edges[i].a.y == edges[i].b.y) {
+            queries.append(i);
+        }
+        if (edges[i].a.x != edges[i].b.x) {
+            candidates.append(i);
+        }
+    }
+    if (queries.isEmpty()) {
+        return;
+    }
+
+    auto minX = [&edges](int index) { return qMin(edges[index].a.x, edges[index].b.x); };
+    auto maxX = [&edges](int index) { return qMax(edges[index].a.x, edges[index].b.x); };
+    std::sort(candidates.begin(), candidates.end(), [&minX](int a, int b) { return minX(a) < minX(b); });
+    std::sort(queries.begin(), queries.end(), [&edges](int a, int b) {
+        return edges[a].a.x + edges[a].b.x < edges[b].a.x + edges[b].b.x;
+    });
+
+    QVector<int> active;
+    int next = 0;
+    qint64 lastX2 = std::numeric_limits<qint64>::min();
+    for (int query : std::as_const(queries)) {
+        const Edge &self = edges[query];
+        const qint64 x2 = self.a.x + self.b.x;
+        const qint64 y2 = self.a.y + self.b.y;
+
+        // 活动边的x区间为半开区间[minX, maxX)
+        while (next < candidates.size() && 2 * minX(candidates[next]) <= x2) {
+            active.append(candidates[next++]);
+        }
+        if (x2 != lastX2) {
+            int kept = 0;
+            for (int index : std::as_const(active)) {
+                if (2 * maxX(index) > x2) {
+                    active[kept++] = index;
+                }
+            }
+            active.resize(kept);
+            lastX2 = x2;
+        }
+
+        for (int index : std::as_const(active)) {
+            if (index == query) {
+                continue;
+            }
+            const Edge &edge = edges[index];
+            const IPoint &left = edge.a.x < edge.b.x ? edge.a : edge.b;
+            const IPoint &right = edge.a.x < edge.b.x ? edge.b : edge.a;
+            // 边在中点上方时射线与边相交，贡献的符号取边沿x的方向
+            if (cross(right.x - left.x, right.y - left.y, x2 - 2 * left.x, y2 - 2 * left.y) > 0) {
+                state.add(members, edge, edge.b.x > edge.a.x ? 1 : -1);
+            }
+        }
+
+        bool negativeInside = false;
+        bool positiveInside = false;
+        state.classify(members, self, negativeInside, positiveInside);
+        state.reset();
+        emitBoundary(self, negativeInside, positiveInside, boundary);
+    }
+}
+
+inline bool collinear(const IPoint &a, const IPoint &b, const IPoint &c)
+{
+    return cross(b.x - a.x, b.y - a.y, c.x - b.x, c.y - b.y) == 0;
+}
+
+// 沿边界边首尾相连得到闭合轮廓，并去掉拆分留下的共线顶点
+QVector<QVector<IPoint>> chainContours(QVector<DirectedEdge> &boundary)
+{
+    std::sort(boundary.begin(), boundary.end(), [](const DirectedEdge &a, const DirectedEdge &b) {
+        return a.from < b.from;
+    });
+
+    QVector<QVector<IPoint>> contours;
+    QVector<char> used(boundary.size(), 0);
+    for (int start = 0; start < boundary.size(); ++start) {
+        if (used[start]) {
+            continue;
+        }
+
+        QVector<IPoint> contour;
+        const IPoint origin = boundary[start].from;
+        int current = start;
+        while (true) {
+            used[current] = 1;
+            contour.append(boundary[current].from);
+            const IPoint to = boundary[current].to;
+            if (to == origin) {
+                break;
+            }
+            auto it = std::lower_bound(boundary.begin(), boundary.end(), to, [](const DirectedEdge &edge, const IPoint &p) {
+                return edge.from < p;
+            });
+            int found = -1;
+            for (int k = int(it - boundary.begin()); k < boundary.size() && boundary[k].from == to; ++k) {
+                if (!used[k]) {
+                    found = k;
+                    break;
+                }
+            }
+            if (found < 0) {
+                // 边界不闭合说明拆分留下了断点，残缺的轮廓会错误地填充，直接丢弃
+                contour.clear();
+                break;
+            }
+            current = found;
+        }
+        if (contour.isEmpty()) {
+            continue;
+        }
+
+        QVector<IPoint> simplified;
+        simplified.reserve(contour.size());
+        for (const IPoint &p : std::as_const(contour)) {
+            while (simplified.size() >= 2 && collinear(simplified[simplified.size() - 2], simplified.last(), p)) {
+                simplified.removeLast();
+            }
+            simplified.append(p);
+        }
+        while (simplified.size() >= 3 && collinear(simplified[simplified.size() - 2], simplified.last(), simplified.first())) {
+            simplified.removeLast();
+        }
+        while (simplified.size() >= 3 && collinear(simplified.last(), simplified[0], simplified[1])) {
+            simplified.removeFirst();
+        }
+        if (simplified.size() >= 3) {
+            contours.append(simplified);
+        }
+    }
+    return contours;
+}
+
+// ---- 曲线拟合（Schneider算法） ----
+
+inline QPointF normalized(const QPointF &v)
+{
+    const qreal length = qSqrt(QPointF::dotProduct(v, v));
+    return length > 0 ? v / length : QPointF();
+}
+
+inline QPointF bezierAt(const QPointF *bezier, int degree, qreal t)
+{
+    QPointF temp[4];
+    for (int i = 0; i <= degree; ++i) {
+        temp[i] = bezier[i];
+    }
+    for (int i = 1; i <= degree; ++i) {
+        for (int j = 0; j <= degree - i; ++j) {
+            temp[j] = temp[j] * (1 - t) + temp[j + 1] * t;
+        }
+    }
+    return temp[0];
+}
+
+QVector<qreal> chordLengthParameterize(const QVector<QPointF> &points, int first, int last)
+{
+    QVector<qreal> u(last - first + 1);
+    u[0] = 0;
+    for (int i = first + 1; i <= last; ++i) {
+        const QPointF d = points[i] - points[i - 1];
+        u[i - first] = u[i - first - 1] + qSqrt(QPointF::dotProduct(d, d));
+    }
+    const qreal total = u.last();
+    for (int i = 1; i < u.size(); ++i) {
+        u[i] = total > 0 ? u[i] / total : qreal(i) / (u.size() - 1);
+    }
+    return u;
+}
+
+// 端点切向固定时按最小二乘求两个控制点到端点的距离
+void generateBezier(const QVector<QPointF> &points, int first, int last, const QVector<qreal> &u,
+                    const QPointF &tangent1, const QPointF &tangent2, QPointF bezier[4])
+{
+    qreal c00 = 0;
+    qreal c01 = 0;
+    qreal c11 = 0;
+    qreal x0 = 0;
+    qreal x1 = 0;
+    const QPointF &start = points[first];
+    const QPointF &end = points[last];
+    for (int i = 0; i < u.size(); ++i) {
+        const qreal t = u[i];
+        const qreal s = 1 - t;
+        const qreal b0 = s * s * s;
+        const qreal b1 = 3 * t * s * s;
+        const qreal b2 = 3 * t * t * s;
+        const qreal b3 = t * t * t;
+        const QPointF a0 = tangent1 * b1;
+        const QPointF a1 = tangent2 * b2;
+        c00 += QPointF::dotProduct(a0, a0);
+        c01 += QPointF::dotProduct(a0, a1);
+        c11 += QPointF::dotProduct(a1, a1);
+        const QPointF rest = points[first + i] - (start * (b0 + b1) + end * (b2 + b3));
+        x0 += QPointF::dotProduct(a0, rest);
+        x1 += QPointF::dotProduct(a1, rest);
+    }
+
+    const qreal det = c00 * c11 - c01 * c01;
+    qreal alpha1 = det != 0 ? (x0 * c11 - x1 * c01) / det : 0;
+    qreal alpha2 = det != 0 ? (c00 * x1 - c01 * x0) / det : 0;
+
+    // 解退化时退回到弦长的三分之一
+    const QPointF chord = end - start;
+    const qreal segmentLength = qSqrt(QPointF::dotProduct(chord, chord));
+    const qreal epsilon = 1e-6 * segmentLength;
+    if (alpha1 < epsilon || alpha2 < epsilon) {
+        alpha1 = alpha2 = segmentLength / 3;
+    }
+
+    bezier[0] = start;
+    bezier[1] = start + tangent1 * alpha1;
+    bezier[2] = end + tangent2 * alpha2;
+    bezier[3] = end;
+}
+
+// 最大误差（距离平方）及其所在的点
+qreal maxError(const QVector<QPointF> &points, int first, int last, const QPointF bezier[4],
+               const QVector<qreal> &u, int &splitPoint)
+{
+    qreal result = 0;
+    splitPoint = (first + last) / 2;
+    for (int i = first + 1; i < last; ++i) {
+        const QPointF d = bezierAt(bezier, 3, u[i - first]) - points[i];
+        const qreal distance = QPointF::dotProduct(d, d);
+        if (distance >= result) {
+            result = distance;
+            splitPoint = i;
+        }
+    }
+    return result;
+}
+
+// 牛顿迭代改进各点的参数
+QVector<qreal> reparameterize(const QVector<QPointF> &points, int first, const QVector<qreal> &u, const QPointF bezier[4])
+{
+    QPointF first1[3];
+    QPointF second1[2];
+    for (int i = 0; i < 3; ++i) {
+        first1[i] = (bezier[i + 1] - bezier[i]) * 3;
+    }
+    for (int i = 0; i < 2; ++i) {
+        second1[i] = (first1[i + 1] - first1[i]) * 2;
+    }
+
+    QVector<qreal> result(u.size());
+    for (int i = 0; i < u.size(); ++i) {
+        const qreal t = u[i];
+        const QPointF d = bezierAt(bezier, 3, t) - points[first + i];
+        const QPointF q1 = bezierAt(first1, 2, t);
+        const QPointF q2 = bezierAt(second1, 1, t);
+        const qreal denominator = QPointF::dotProduct(q1, q1) + QPointF::dotProduct(d, q2);
+        result[i] = denominator != 0 ? qBound(qreal(0), t - QPointF::dotProduct(d, q1) / denominator, qreal(1)) : t;
+    }
+    return result;
+}
+
+void fitCubic(const QVector<QPointF> &points, int first, int last, const QPointF &tangent1,
+              const QPointF &tangent2, qreal error, QPainterPath &out)
+{
+    if (last - first == 1) {
+        out.lineTo(points[last]);
+        return;
+    }
+
+    QVector<qreal> u = chordLengthParameterize(points, first, last);
+    QPointF bezier[4];
+    generateBezier(points, first, last, u, tangent1, tangent2, bezier);
+    int splitPoint = 0;
+    qreal currentError = maxError(points, first, last, bezier, u, splitPoint);
+    if (currentError < error) {
+        out.cubicTo(bezier[1], bezier[2], bezier[3]);
+        return;
+    }
+
+    // 误差不太大时先尝试改进参数
+    if (currentError < error * 4) {
+        for (int i = 0; i < MaxReparameterizeIterations; ++i) {
+            u = reparameterize(points, first, u, bezier);
+            generateBezier(points, first, last, u, tangent1, tangent2, bezier);
+            currentError = maxError(points, first, last, bezier, u, splitPoint);
+            if (currentError < error) {
+                out.cubicTo(bezier[1], bezier[2], bezier[3]);
+                return;
+            }
+        }
+    }
+
+    // 在误差最大处分成两段，分点处切向连续
+    QPointF center = normalized(points[splitPoint - 1] - points[splitPoint + 1]);
+    if (center.isNull()) {
+        center = normalized(points[splitPoint - 1] - points[splitPoint]);
+    }
+    fitCubic(points, first, splitPoint, tangent1, center, error, out);
+    fitCubic(points, splitPoint, last, -center, tangent2, error, out);
+}
+
+} // namespace
+
+QList<QPolygonF> PolygonClipper::flatten(const QPainterPath &path, qreal flatness)
+{
+    QList<QPolygonF> polygons;
+    QPolygonF current;
+    const qreal tolerance = qMax(flatness, qreal(1e-3));
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const QPainterPath::Element &element = path.elementAt(i);
+        switch (element.type) {
+        case QPainterPath::MoveToElement:
+            if (current.size() > 1) {
+                polygons.append(current);
+            }
+            current.clear();
+            current.append(QPointF(element.x, element.y));
+            break;
+        case QPainterPath::LineToElement:
+            current.append(QPointF(element.x, element.y));
+            break;
+        case QPainterPath::CurveToElement:
+            if (i + 2 < path.elementCount() && !current.isEmpty()) {
+                BezierGeometry::flattenCubic(current.last(), element, path.elementAt(i + 1), path.elementAt(i + 2),
+                                             tolerance, current);
+            }
+            i += 2;
+            break;
+        case QPainterPath::CurveToDataElement:
+            break;
+        }
+    }
+    if (current.size() > 1) {
+        polygons.append(current);
+    }
+
+    // 闭合子路径的终点与起点重复
+    for (QPolygonF &polygon : polygons) {
+        if (polygon.size() > 1 && polygon.first() == polygon.last()) {
+            polygon.removeLast();
+        }
+    }
+    return polygons;
+}
+
+QList<QPolygonF> PolygonClipper::clip(const QList<QList<QPolygonF>> &operands, const QList<FillRule> &fillRules, Operation op)
+{
+    QList<QPolygonF> output;
+    if (operands.isEmpty()) {
+        return output;
+    }
+
+    qreal maxAbs = 0;
+    for (const QList<QPolygonF> &polygons : operands) {
+        for (const QPolygonF &polygon : polygons) {
+            for (const QPointF &point : polygon) {
+                maxAbs = qMax(maxAbs, qMax(qAbs(point.x()), qAbs(point.y())));
+            }
+        }
+    }
+    const qreal scale = maxAbs > 0 ? qMin(MaxScale, MaxCoordinate / maxAbs) : MaxScale;
+
+    // 量化并生成输入边
+    QVector<InputEdge> input;
+    for (int operand = 0; operand < operands.size(); ++operand) {
+        for (const QPolygonF &polygon : operands[operand]) {
+            QVector<IPoint> points;
+            points.reserve(polygon.size());
+            for (const QPointF &point : polygon) {
+                const IPoint p = { qRound64(point.x() * scale), qRound64(point.y() * scale) };
+                if (points.isEmpty() || points.last() != p) {
+                    points.append(p);
+                }
+            }
+            while (points.size() > 1 && points.first() == points.last()) {
+                points.removeLast();
+            }
+            if (points.size() < 2) {
+                continue;
+            }
+            for (int i = 0; i < points.size(); ++i) {
+                const IPoint &p = points[i];
+                const IPoint &q = points[(i + 1) % points.size()];
+                if (p < q) {
+                    input.append({ p, q, operand, 1 });
+                } else {
+                    input.append({ q, p, operand, -1 });
+                }
+            }
+        }
+    }
+
+    QVector<Edge> edges;
+    QVector<Member> members;
+    buildEdges(input, edges, members);
+
+    QVector<DirectedEdge> boundary;
+    WindingState state(fillRules, op);
+    classifySloped(edges, members, state, boundary);
+    classifyHorizontal(edges, members, state, boundary);
+
+    const QVector<QVector<IPoint>> contours = chainContours(boundary);
+    output.reserve(contours.size());
+    for (const QVector<IPoint> &contour : contours) {
+        QPolygonF polygon;
+        polygon.reserve(contour.size());
+        for (const IPoint &p : contour) {
+            polygon.append(QPointF(p.x / scale, p.y / scale));
+        }
+        output.append(polygon);
+    }
+    return output;
+}
+
+QList<QPolygonF> PolygonClipper::simplify(const QList<QPolygonF> &polygons, FillRule fillRule)
+{
+    return clip({ polygons }, { fillRule }, Union);
+}
+
+QPainterPath PolygonClipper::execute(const QList<QPainterPath> &operands, Operation op, qreal flatness, bool refitCurves)
+{
+    QPainterPath result;
+    result.setFillRule(Qt::OddEvenFill);
+    if (operands.isEmpty()) {
+        return result;
+    }
+
+    QList<QList<QPolygonF>> polygons;
+    QList<FillRule> fillRules;
+    for (const QPainterPath &operand : operands) {
+        polygons.append(flatten(operand, flatness));
+        fillRules.append(operand.fillRule() == Qt::WindingFill ? NonZero : EvenOdd);
+    }
+    const QList<QPolygonF> output = clip(polygons, fillRules, op);
+
+    if (refitCurves) {
+        result = refit(output, flatness * 2);
+    } else {
+        result = toPath(output);
+    }
+    result.setFillRule(Qt::OddEvenFill);
+    return result;
+}
+
+QPainterPath PolygonClipper::toPath(const QList<QPolygonF> &contours)
+{
+    QPainterPath result;
+    for (const QPolygonF &polygon : contours) {
+        if (polygon.isEmpty()) {
+            continue;
+        }
+        result.moveTo(polygon.first());
+        for (int i = 1; i < polygon.size(); ++i) {
+            result.lineTo(polygon[i]);
+        }
+        result.closeSubpath();
+    }
+    result.setFillRule(Qt::OddEvenFill);
+    return result;
+}
+
+QPainterPath PolygonClipper::refit(const QList<QPolygonF> &contours, qreal tolerance)
+{
+    QPainterPath result;
+    const qreal error = tolerance * tolerance;
+    const qreal cornerCos = qCos(CornerAngle);
+
+    for (const QPolygonF &contour : contours) {
+        const int count = contour.size();
+        if (count < 3) {
+            continue;
+        }
+
+        // 找出转角大的顶点作为拟合分段点
+        QVector<int> corners;
+        for (int i = 0; i < count; ++i) {
+            const QPointF in = normalized(contour[i] - contour[(i + count - 1) % count]);
+            const QPointF out = normalized(contour[(i + 1) % count] - contour[i]);
+            if (QPointF::dotProduct(in, out) < cornerCos) {
+                corners.append(i);
+            }
+        }
+
+        // 没有尖角的平滑闭合曲线从第一个点断开，两端使用相同的切向
+        const bool smooth = corners.isEmpty();
+        if (smooth) {
+            corners.append(0);
+        }
+
+        result.moveTo(contour[corners.first()]);
+        for (int k = 0; k < corners.size(); ++k) {
+            const int from = corners[k];
+            const int to = k + 1 < corners.size() ? corners[k + 1] : corners.first() + count;
+            QVector<QPointF> run;
+            run.reserve(to - from + 1);
+            for (int i = from; i <= to; ++i) {
+                run.append(contour[i % count]);
+            }
+
+            QPointF tangent1 = normalized(run[1] - run[0]);
+            QPointF tangent2 = normalized(run[run.size() - 2] - run.last());
+            if (smooth) {
+                tangent1 = normalized(contour[1] - contour[count - 1]);
+                tangent2 = -tangent1;
+            }
+            fitCubic(run, 0, run.size() - 1, tangent1, tangent2, error, result);
+        }
+        result.closeSubpath();
+    }
+
+    result.setFillRule(Qt::OddEvenFill);
+    return result;
+}
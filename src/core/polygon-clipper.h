@@ -0,0 +1,76 @@
+#ifndef POLYGON_CLIPPER_H
+#define POLYGON_CLIPPER_H
+
+#include <QList>
+#include <QPainterPath>
+#include <QPolygonF>
+
+/**
+ * 多边形布尔运算引擎
+ *
+ * 所有操作数一次处理，而不是两两折叠：
+ * 1. 曲线按flatness展平，坐标量化到整数网格，方向判断全部用整数精确计算；
+ * 2. 沿y方向扫描检测边的相交，把所有边在交点处拆开，重合的边合并并累加各操作数的环绕贡献；
+ * 3. 每条边从中点向一侧发射射线（同样用扫描线只检查与射线同高的边），得到两侧各操作数的
+ *    环绕数，按各自的填充规则判断是否在内部，再按运算类型决定结果是否在内部；
+ * 4. 两侧结果不同的边就是结果的边界，按内部在同一侧定向后首尾相连成轮廓。
+ * 可选地把输出轮廓中平滑的折线重新拟合为三次曲线
+ */
+class PolygonClipper
+{
+public:
+    enum Operation {
+        Union,          // 在任一操作数内部
+        Intersection,   // 在所有操作数内部
+        Difference,     // 在第一个操作数内部且不在其余操作数内部
+        Xor             // 在奇数个操作数内部
+    };
+
+    // 多边形操作数的填充规则；Positive只保留环绕数为正的区域，
+    // 即屏幕坐标（y向下）中顺时针、鞋带面积为正的轮廓所包围的区域
+    enum FillRule {
+        EvenOdd,
+        NonZero,
+        Positive
+    };
+
+    // 默认曲线展平容差
+    static constexpr qreal DefaultFlatness = 0.25;
+    // 坐标量化的最细网格为1/MaxScale，坐标很大时自动放粗以保证整数运算不溢出
+    static constexpr qreal MaxScale = 1024.0;
+
+    /**
+     * 对operands执行n元布尔运算，各操作数使用自己的填充规则，结果使用OddEvenFill
+     * @param refitCurves 为true时把输出中平滑的折线重新拟合为三次曲线（误差不超过flatness的两倍）
+     */
+    static QPainterPath execute(const QList<QPainterPath> &operands, Operation op,
+                                qreal flatness = DefaultFlatness, bool refitCurves = false);
+
+    /**
+     * 对已展平的多边形执行n元布尔运算。输出轮廓互不相交：外轮廓鞋带面积为正，洞为负
+     */
+    static QList<QPolygonF> clip(const QList<QList<QPolygonF>> &operands, const QList<FillRule> &fillRules,
+                                 Operation op);
+
+    /**
+     * 按填充规则把可能自相交、相互重叠的多边形归一化为互不相交的轮廓
+     */
+    static QList<QPolygonF> simplify(const QList<QPolygonF> &polygons, FillRule fillRule);
+
+    /**
+     * 把闭合折线转换为路径（OddEvenFill）
+     */
+    static QPainterPath toPath(const QList<QPolygonF> &contours);
+
+    /**
+     * 按容差展平路径，每个子路径得到一个多边形（首尾不重复）
+     */
+    static QList<QPolygonF> flatten(const QPainterPath &path, qreal flatness = DefaultFlatness);
+
+    /**
+     * 把闭合折线拟合为三次曲线，转角大的顶点保留为尖角
+     */
+    static QPainterPath refit(const QList<QPolygonF> &contours, qreal tolerance);
+};
+
+#endif // POLYGON_CLIPPER_H
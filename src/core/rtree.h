@@ -0,0 +1,343 @@
+#ifndef RTREE_H
+#define RTREE_H
+
+#include <QRectF>
+#include <QVector>
+#include <QVarLengthArray>
+#include <QtGlobal>
+#include <limits>
+#include <utility>
+
+/**
+ * 动态R树（Guttman二次分裂）
+ *
+ * 支持逐个插入和删除，删除后不足的节点整体重新插入。
+ * 矩形按闭区间处理，宽或高为0的矩形（水平线、竖直线）同样能被查询到。
+ * 内部按两个角点保存，避免left()+width()的舍入误差使父节点不能精确包含子节点
+ */
+template <typename T>
+class RTree
+{
+public:
+    static constexpr int MaxEntries = 16;
+    static constexpr int MinEntries = 6;
+
+    RTree() : m_root(new Node(0)), m_size(0) {}
+    ~RTree() { delete m_root; }
+
+    void insert(const QRectF &rect, const T &value)
+    {
+        Entry entry;
+        entry.box = Box::fromRect(rect);
+        entry.value = value;
+        insertEntry(entry, 0);
+        ++m_size;
+    }
+
+    /**
+     * 删除值，rect必须与插入时的矩形一致
+     */
+    bool remove(const QRectF &rect, const T &value)
+    {
+        QVector<Step> path;
+        if (!findLeaf(m_root, Box::fromRect(rect), value, path)) {
+            return false;
+        }
+
+        Node *leaf = path.last().node;
+        leaf->entries.remove(path.last().index);
+
+        // 自底向上收缩，不足MinEntries的节点摘下后重新插入其条目
+        QVector<Node*> orphans;
+        for (int i = path.size() - 2; i >= 0; --i) {
+            Node *parent = path[i].node;
+            const int index = path[i].index;
+            Node *child = parent->entries[index].child;
+            if (child->entries.size() < MinEntries) {
+                parent->entries.remove(index);
+                orphans.append(child);
+            } else {
+                parent->entries[index].box = nodeBounds(child);
+            }
+        }
+        --m_size;
+
+        for (Node *orphan : std::as_const(orphans)) {
+            for (const Entry &entry : std::as_const(orphan->entries)) {
+                insertEntry(entry, orphan->level);
+            }
+            orphan->entries.clear();
+            delete orphan;
+        }
+
+        while (m_root->level > 0 && m_root->entries.size() == 1) {
+            Node *oldRoot = m_root;
+            m_root = oldRoot->entries.first().child;
+            oldRoot->entries.clear();
+            delete oldRoot;
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        delete m_root;
+        m_root = new Node(0);
+        m_size = 0;
+    }
+
+    int size() const { return m_size; }
+    int height() const { return m_root->level + 1; }
+
+    /**
+     * 遍历与rect相交的条目，visitor签名为 void(const QRectF &, const T &)
+     */
+    template <typename Visitor>
+    void search(const QRectF &rect, Visitor visitor) const
+    {
+        const Box area = Box::fromRect(rect);
+        QVarLengthArray<const Node*, 32> stack;
+        stack.append(m_root);
+        while (!stack.isEmpty()) {
+            const Node *node = stack.takeLast();
+            for (const Entry &entry : node->entries) {
+                if (!entry.box.overlaps(area)) {
+                    continue;
+                }
+                if (node->level == 0) {
+                    visitor(entry.box.toRect(), entry.value);
+                } else {
+                    stack.append(entry.child);
+                }
+            }
+        }
+    }
+
+private:
+    struct Node;
+
+    struct Box {
+        qreal x1;
+        qreal y1;
+        qreal x2;
+        qreal y2;
+
+        static Box fromRect(const QRectF &rect)
+        {
+            const QRectF r = rect.normalized();
+            return { r.left(), r.top(), r.right(), r.bottom() };
+        }
+
+        QRectF toRect() const { return QRectF(x1, y1, x2 - x1, y2 - y1); }
+        qreal area() const { return (x2 - x1) * (y2 - y1); }
+
+        bool overlaps(const Box &other) const
+        {
+            return x1 <= other.x2 && other.x1 <= x2 && y1 <= other.y2 && other.y1 <= y2;
+        }
+
+        bool encloses(const Box &other) const
+        {
+            return x1 <= other.x1 && other.x2 <= x2 && y1 <= other.y1 && other.y2 <= y2;
+        }
+
+        Box united(const Box &other) const
+        {
+            return { qMin(x1, other.x1), qMin(y1, other.y1), qMax(x2, other.x2), qMax(y2, other.y2) };
+        }
+    };
+
+    struct Entry {
+        Box box;
+        Node *child = nullptr;
+        T value{};
+    };
+
+    struct Node {
+        explicit Node(int nodeLevel) : level(nodeLevel) {}
+        ~Node()
+        {
+            if (level > 0) {
+                for (const Entry &entry : std::as_const(entries)) {
+                    delete entry.child;
+                }
+            }
+        }
+
+        int level;  // 叶子为0
+        QVector<Entry> entries;
+    };
+
+    struct Step {
+        Node *node;
+        int index;
+    };
+
+    RTree(const RTree &) = delete;
+    RTree &operator=(const RTree &) = delete;
+
+    static Box nodeBounds(const Node *node)
+    {
+        Box bounds = node->entries.first().box;
+        for (int i = 1; i < node->entries.size(); ++i) {
+            bounds = bounds.united(node->entries[i].box);
+        }
+        return bounds;
+    }
+
+    static int chooseSubtree(const Node *node, const Box &box)
+    {
+        int best = 0;
+        qreal bestEnlargement = std::numeric_limits<qreal>::max();
+        qreal bestArea = std::numeric_limits<qreal>::max();
+        for (int i = 0; i < node->entries.size(); ++i) {
+            const qreal entryArea = node->entries[i].box.area();
+            const qreal enlargement = node->entries[i].box.united(box).area() - entryArea;
+            if (enlargement < bestEnlargement
+                || (enlargement == bestEnlargement && entryArea < bestArea)) {
+                best = i;
+                bestEnlargement = enlargement;
+                bestArea = entryArea;
+            }
+        }
+        return best;
+    }
+
+    void insertEntry(const Entry &entry, int level)
+    {
+        QVarLengthArray<Step, 16> path;
+        Node *node = m_root;
+        while (node->level > level) {
+            const int index = chooseSubtree(node, entry.box);
+            path.append({node, index});
+            node = node->entries[index].child;
+        }
+
+        node->entries.append(entry);
+        Node *sibling = node->entries.size() > MaxEntries ? splitNode(node) : nullptr;
+
+        for (int i = path.size() - 1; i >= 0; --i) {
+            Node *parent = path[i].node;
+            Entry &childEntry = parent->entries[path[i].index];
+            childEntry.box = nodeBounds(childEntry.child);
+            if (sibling) {
+                Entry siblingEntry;
+                siblingEntry.box = nodeBounds(sibling);
+                siblingEntry.child = sibling;
+                parent->entries.append(siblingEntry);
+                sibling = parent->entries.size() > MaxEntries ? splitNode(parent) : nullptr;
+            }
+        }
+
+        if (sibling) {
+            Node *root = new Node(m_root->level + 1);
+            Entry first;
+            first.box = nodeBounds(m_root);
+            first.child = m_root;
+            Entry second;
+            second.box = nodeBounds(sibling);
+            second.child = sibling;
+            root->entries.append(first);
+            root->entries.append(second);
+            m_root = root;
+        }
+    }
+
+    // 二次分裂：选浪费面积最大的两项作种子，其余逐个分给扩张较小的一组
+    Node *splitNode(Node *node)
+    {
+        QVector<Entry> remaining = node->entries;
+        node->entries.clear();
+        Node *sibling = new Node(node->level);
+
+        int seedA = 0;
+        int seedB = 1;
+        qreal worstWaste = -std::numeric_limits<qreal>::max();
+        for (int i = 0; i < remaining.size(); ++i) {
+            for (int j = i + 1; j < remaining.size(); ++j) {
+                const qreal waste = remaining[i].box.united(remaining[j].box).area()
+                    - remaining[i].box.area() - remaining[j].box.area();
+                if (waste > worstWaste) {
+                    worstWaste = waste;
+                    seedA = i;
+                    seedB = j;
+                }
+            }
+        }
+
+        node->entries.append(remaining[seedA]);
+        sibling->entries.append(remaining[seedB]);
+        Box boundsA = remaining[seedA].box;
+        Box boundsB = remaining[seedB].box;
+        remaining.remove(seedB);
+        remaining.remove(seedA);
+
+        while (!remaining.isEmpty()) {
+            // 一组必须拿走剩余全部才能达到下限时直接分配
+            if (node->entries.size() + remaining.size() == MinEntries) {
+                node->entries.append(remaining);
+                break;
+            }
+            if (sibling->entries.size() + remaining.size() == MinEntries) {
+                sibling->entries.append(remaining);
+                break;
+            }
+
+            int next = 0;
+            qreal maxDifference = -1;
+            qreal growA = 0;
+            qreal growB = 0;
+            for (int i = 0; i < remaining.size(); ++i) {
+                const qreal a = boundsA.united(remaining[i].box).area() - boundsA.area();
+                const qreal b = boundsB.united(remaining[i].box).area() - boundsB.area();
+                if (qAbs(a - b) > maxDifference) {
+                    maxDifference = qAbs(a - b);
+                    next = i;
+                    growA = a;
+                    growB = b;
+                }
+            }
+
+            const Entry entry = remaining.takeAt(next);
+            bool toA = growA < growB;
+            if (growA == growB) {
+                toA = boundsA.area() != boundsB.area() ? boundsA.area() < boundsB.area()
+                                                       : node->entries.size() <= sibling->entries.size();
+            }
+            if (toA) {
+                node->entries.append(entry);
+                boundsA = boundsA.united(entry.box);
+            } else {
+                sibling->entries.append(entry);
+                boundsB = boundsB.united(entry.box);
+            }
+        }
+
+        return sibling;
+    }
+
+    bool findLeaf(Node *node, const Box &box, const T &value, QVector<Step> &path) const
+    {
+        for (int i = 0; i < node->entries.size(); ++i) {
+            const Entry &entry = node->entries[i];
+            if (node->level == 0) {
+                if (entry.value == value) {
+                    path.append({node, i});
+                    return true;
+                }
+            } else if (entry.box.encloses(box)) {
+                path.append({node, i});
+                if (findLeaf(entry.child, box, value, path)) {
+                    return true;
+                }
+                path.removeLast();
+            }
+        }
+        return false;
+    }
+
+    Node *m_root;
+    int m_size;
+};
+
+#endif // RTREE_H
@@ -0,0 +1,189 @@
+#include "shape-record.h"
+#include "drawing-shape.h"
+#include "drawing-group.h"
+
+namespace {
+
+// 记录头：版本(2) + 类型(4) + 长度(4)
+const qint64 RecordHeaderSize = 10;
+// 字段头：ID(2) + 长度(4)
+const qint64 FieldHeaderSize = 6;
+
+} // namespace
+
+ShapeRecordWriter::ShapeRecordWriter(QByteArray *buffer)
+    : m_buffer(buffer)
+{
+    // 以读写方式打开不会截断已有数据，从末尾开始追加
+    m_buffer.open(QIODevice::ReadWrite);
+    m_buffer.seek(m_buffer.size());
+    m_stream.setDevice(&m_buffer);
+    m_stream.setVersion(QDataStream::Qt_6_0);
+}
+
+void ShapeRecordWriter::writeShape(const DrawingShape *shape)
+{
+    if (!shape) {
+        return;
+    }
+
+    m_stream << FormatVersion;
+    m_stream << qint32(shape->shapeType());
+    beginBlock();
+    shape->writeFields(*this);
+    endBlock();
+}
+
+void ShapeRecordWriter::beginField(quint16 fieldId)
+{
+    m_stream << fieldId;
+    beginBlock();
+}
+
+void ShapeRecordWriter::endField()
+{
+    endBlock();
+}
+
+void ShapeRecordWriter::beginBlock()
+{
+    // 先写占位长度，结束时回填
+    m_openBlocks.append(m_buffer.pos());
+    m_stream << quint32(0);
+}
+
+void ShapeRecordWriter::endBlock()
+{
+    if (m_openBlocks.isEmpty()) {
+        return;
+    }
+    const qint64 lengthPos = m_openBlocks.takeLast();
+    const qint64 end = m_buffer.pos();
+    m_buffer.seek(lengthPos);
+    m_stream << quint32(end - lengthPos - sizeof(quint32));
+    m_buffer.seek(end);
+}
+
+ShapeRecordReader::ShapeRecordReader(const QByteArray &data)
+{
+    m_buffer.setData(data);
+    m_buffer.open(QIODevice::ReadOnly);
+    m_stream.setDevice(&m_buffer);
+    m_stream.setVersion(QDataStream::Qt_6_0);
+}
+
+bool ShapeRecordReader::atEnd() const
+{
+    return m_buffer.size() - m_buffer.pos() < RecordHeaderSize;
+}
+
+DrawingShape *ShapeRecordReader::readShape()
+{
+    qint32 shapeType = 0;
+    qint64 recordEnd = 0;
+    if (!readHeader(shapeType, recordEnd)) {
+        return nullptr;
+    }
+
+    DrawingShape *shape = createShape(shapeType);
+    if (!shape) {
+        ++m_skippedRecords;
+        m_buffer.seek(recordEnd);
+        return nullptr;
+    }
+
+    readFields(shape, recordEnd);
+    return shape;
+}
+
+bool ShapeRecordReader::readInto(DrawingShape *shape)
+{
+    qint32 shapeType = 0;
+    qint64 recordEnd = 0;
+    if (!shape || !readHeader(shapeType, recordEnd)) {
+        return false;
+    }
+
+    if (shapeType != shape->shapeType()) {
+        ++m_skippedRecords;
+        m_buffer.seek(recordEnd);
+        return false;
+    }
+
+    readFields(shape, recordEnd);
+    return true;
+}
+
+DrawingShape *ShapeRecordReader::createShape(int shapeType)
+{
+    switch (shapeType) {
+    case DrawingShape::Rectangle:
+        return new DrawingRectangle();
+    case DrawingShape::Ellipse:
+        return new DrawingEllipse();
+    case DrawingShape::Line:
+        return new DrawingLine();
+    case DrawingShape::Path:
+        return new DrawingPath();
+    case DrawingShape::Polyline:
+        return new DrawingPolyline();
+    case DrawingShape::Polygon:
+        return new DrawingPolygon();
+    case DrawingShape::Text:
+        return new DrawingText();
+    case DrawingShape::Group:
+        return new DrawingGroup();
+    default:
+        return nullptr;
+    }
+}
+
+bool ShapeRecordReader::readHeader(qint32 &shapeType, qint64 &recordEnd)
+{
+    if (atEnd()) {
+        return false;
+    }
+
+    quint16 version = 0;
+    quint32 length = 0;
+    m_stream >> version >> shapeType >> length;
+
+    recordEnd = m_buffer.pos() + length;
+    if (m_stream.status() != QDataStream::Ok || recordEnd > m_buffer.size()) {
+        // 长度越界说明数据已损坏，不再继续读取
+        ++m_skippedRecords;
+        m_buffer.seek(m_buffer.size());
+        return false;
+    }
+
+    if (version > ShapeRecordWriter::FormatVersion) {
+        ++m_skippedRecords;
+        m_buffer.seek(recordEnd);
+        return false;
+    }
+    return true;
+}
+
+void ShapeRecordReader::readFields(DrawingShape *shape, qint64 recordEnd)
+{
+    shape->beginDeserialize();
+
+    while (recordEnd - m_buffer.pos() >= FieldHeaderSize) {
+        quint16 fieldId = 0;
+        quint32 length = 0;
+        m_stream >> fieldId >> length;
+
+        const qint64 fieldEnd = m_buffer.pos() + length;
+        if (fieldEnd > recordEnd) {
+            break;
+        }
+
+        // 未知字段直接跳过；已知字段读完后也对齐到字段末尾
+        shape->readField(fieldId, *this);
+        m_stream.resetStatus();
+        m_buffer.seek(fieldEnd);
+    }
+
+    m_buffer.seek(recordEnd);
+    shape->endDeserialize();
+}
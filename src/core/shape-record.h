@@ -0,0 +1,120 @@
+#ifndef SHAPE_RECORD_H
+#define SHAPE_RECORD_H
+
+#include <QByteArray>
+#include <QBuffer>
+#include <QDataStream>
+#include <QVector>
+
+class DrawingShape;
+
+/**
+ * 图形记录格式
+ *
+ *   记录 := 格式版本(quint16) 图形类型(qint32) 负载长度(quint32) 字段*
+ *   字段 := 字段ID(quint16) 数据长度(quint32) 数据
+ *
+ * 每个字段只写一次，读取时按字段ID分派，不认识的字段按长度跳过，
+ * 因此新版本增加字段不会破坏旧数据的读取。组合的子对象作为嵌套记录写在字段中
+ */
+class ShapeRecordWriter
+{
+public:
+    static constexpr quint16 FormatVersion = 1;
+
+    /**
+     * @param buffer 输出缓冲区，记录追加在已有数据之后；
+     *               多个图形可以连续写入同一个缓冲区
+     */
+    explicit ShapeRecordWriter(QByteArray *buffer);
+
+    /**
+     * 写入一个完整的图形记录
+     */
+    void writeShape(const DrawingShape *shape);
+
+    /**
+     * 写入单个字段，值使用QDataStream编码
+     */
+    template <typename T>
+    void writeField(quint16 fieldId, const T &value)
+    {
+        beginField(fieldId);
+        m_stream << value;
+        endField();
+    }
+
+    /**
+     * 手动写入字段：beginField之后直接向stream()写入，最后调用endField补写长度
+     */
+    void beginField(quint16 fieldId);
+    void endField();
+    QDataStream &stream() { return m_stream; }
+
+private:
+    void beginBlock();
+    void endBlock();
+
+    QBuffer m_buffer;
+    QDataStream m_stream;
+    QVector<qint64> m_openBlocks;  // 尚未补写长度的位置
+};
+
+/**
+ * 图形记录读取器，与ShapeRecordWriter对应
+ */
+class ShapeRecordReader
+{
+public:
+    explicit ShapeRecordReader(const QByteArray &data);
+
+    /**
+     * 是否已读完所有记录
+     */
+    bool atEnd() const;
+
+    /**
+     * 读取下一条记录并创建对应类型的图形
+     * @return 新图形；数据损坏或类型未知时返回nullptr（并跳过该记录）
+     */
+    DrawingShape *readShape();
+
+    /**
+     * 读取下一条记录到已有图形中，用于撤销时恢复状态
+     * @return 记录类型与图形一致且读取成功时返回true
+     */
+    bool readInto(DrawingShape *shape);
+
+    /**
+     * 因版本过新、类型未知或数据损坏而跳过的记录数，由调用者决定如何提示
+     */
+    int skippedRecords() const { return m_skippedRecords; }
+
+    /**
+     * 根据类型创建空图形
+     */
+    static DrawingShape *createShape(int shapeType);
+
+    /**
+     * 当前字段的数据流，在DrawingShape::readField中使用
+     */
+    QDataStream &stream() { return m_stream; }
+
+    template <typename T>
+    T read()
+    {
+        T value;
+        m_stream >> value;
+        return value;
+    }
+
+private:
+    bool readHeader(qint32 &shapeType, qint64 &recordEnd);
+    void readFields(DrawingShape *shape, qint64 recordEnd);
+
+    QBuffer m_buffer;
+    QDataStream m_stream;
+    int m_skippedRecords = 0;
+};
+
+#endif // SHAPE_RECORD_H
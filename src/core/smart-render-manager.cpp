@@ -292,6 +292,7 @@ SmartUpdateGuard::~SmartUpdateGuard()
 
 // RenderProfiler 实现
 RenderProfiler* RenderProfiler::s_instance = nullptr;
+const QString RenderProfiler::SavedGeometryPasses = QStringLiteral("省去的几何遍数");
 
 RenderProfiler& RenderProfiler::instance()
 {
@@ -313,11 +314,14 @@ void RenderProfiler::endFrame()
     
     double frameTime = m_frameTimer.elapsed();
     m_frameTimes.append(frameTime);
+    m_frameCounts.append(m_currentCounts);
+    m_currentCounts.clear();
     m_frameCount++;
     
     // 保持最近100帧的数据
     if (m_frameTimes.size() > 100) {
         m_frameTimes.removeFirst();
+        m_frameCounts.removeFirst();
     }
 }
 
@@ -343,6 +347,12 @@ void RenderProfiler::endOperation(const QString& operation)
     }
 }
 
+void RenderProfiler::addCount(const QString& counter, int value)
+{
+    if (!m_enabled) return;
+    m_currentCounts[counter] += value;
+}
+
 RenderProfiler::PerformanceData RenderProfiler::getPerformanceData() const
 {
     PerformanceData data;
@@ -372,12 +382,24 @@ RenderProfiler::PerformanceData RenderProfiler::getPerformanceData() const
         }
     }
     
+    // 计算每帧平均计数
+    for (const QHash<QString, int>& counts : m_frameCounts) {
+        for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+            data.countsPerFrame[it.key()] += it.value();
+        }
+    }
+    for (auto it = data.countsPerFrame.begin(); it != data.countsPerFrame.end(); ++it) {
+        it.value() /= m_frameCounts.size();
+    }
+    
     return data;
 }
 
 void RenderProfiler::reset()
 {
     m_frameTimes.clear();
+    m_frameCounts.clear();
+    m_currentCounts.clear();
     m_frameCount = 0;
     m_operationTimes.clear();
     m_operationTimers.clear();
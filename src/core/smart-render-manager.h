@@ -134,12 +134,19 @@ public:
     void beginOperation(const QString& operation);
     void endOperation(const QString& operation);
     
+    // 累加当前帧的计数，endFrame时归档
+    void addCount(const QString& counter, int value = 1);
+    
+    // 计数名称
+    static const QString SavedGeometryPasses;  // 填充和描边一次绘制相对两遍绘制实际省去的几何遍数
+    
     // 获取性能数据
     struct PerformanceData {
-        double averageFrameTime;
-        double averageFPS;
+        double averageFrameTime = 0;
+        double averageFPS = 0;
         QHash<QString, double> operationTimes;
-        int totalFrames;
+        QHash<QString, double> countsPerFrame;  // 最近帧的平均计数
+        int totalFrames = 0;
     };
     
     PerformanceData getPerformanceData() const;
@@ -155,8 +162,10 @@ private:
     QHash<QString, QList<double>> m_operationTimes;
     
     QList<double> m_frameTimes;
-    int m_frameCount;
-    bool m_enabled;
+    QHash<QString, int> m_currentCounts;
+    QList<QHash<QString, int>> m_frameCounts;
+    int m_frameCount = 0;
+    bool m_enabled = false;
     
     static RenderProfiler* s_instance;
 };
\ No newline at end of file
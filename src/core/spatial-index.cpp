@@ -0,0 +1,458 @@
+#include <QGraphicsScene>
+#include <QElapsedTimer>
+#include <QLineF>
+#include <QTransform>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <limits>
+#include "spatial-index.h"
+#include "drawing-shape.h"
+#include "bezier-geometry.h"
+
+namespace {
+
+// Liang-Barsky裁剪，判断线段是否穿过矩形
+bool segmentIntersectsRect(const QPointF &a, const QPointF &b, const QRectF &rect)
+{
+    qreal t0 = 0;
+    qreal t1 = 1;
+    const qreal dx = b.x() - a.x();
+    const qreal dy = b.y() - a.y();
+    const qreal p[4] = { -dx, dx, -dy, dy };
+    const qreal q[4] = { a.x() - rect.left(), rect.right() - a.x(), a.y() - rect.top(), rect.bottom() - a.y() };
+
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0) {
+            if (q[i] < 0) {
+                return false;
+            }
+            continue;
+        }
+        const qreal t = q[i] / p[i];
+        if (p[i] < 0) {
+            t0 = qMax(t0, t);
+        } else {
+            t1 = qMin(t1, t);
+        }
+        if (t0 > t1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool rectContainsPoint(const QRectF &rect, const QPointF &p)
+{
+    return p.x() >= rect.left() && p.x() <= rect.right() && p.y() >= rect.top() && p.y() <= rect.bottom();
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(QGraphicsScene *scene)
+    : m_scene(scene)
+    , m_built(false)
+    , m_nextOrder(0)
+{
+}
+
+SpatialIndex::~SpatialIndex()
+{
+}
+
+void SpatialIndex::insertShape(DrawingShape *shape)
+{
+    if (!m_built || !shape) {
+        return;
+    }
+
+    // 新加入的顶层图形位于同一Z值的最上层。次序在加入时就分配，
+    // 不能等到flush时遍历无序的m_dirty再分配，否则两次查询之间加入的图形次序会错乱
+    auto it = m_records.find(shape);
+    if (it != m_records.end()) {
+        it->order = ++m_nextOrder;
+    } else {
+        m_pendingOrders.insert(shape, ++m_nextOrder);
+    }
+    m_dirty.insert(shape);
+}
+
+void SpatialIndex::markDirty(DrawingShape *shape)
+{
+    if (!m_built || !shape) {
+        return;
+    }
+
+    m_dirty.insert(shape);
+
+    // 子图形的场景位置随父图形变化
+    const QList<QGraphicsItem*> children = shape->childItems();
+    for (QGraphicsItem *child : children) {
+        if (DrawingShape *childShape = dynamic_cast<DrawingShape*>(child)) {
+            markDirty(childShape);
+        }
+    }
+}
+
+void SpatialIndex::removeShape(DrawingShape *shape)
+{
+    m_dirty.remove(shape);
+    m_pendingOrders.remove(shape);
+    removeRecord(shape);
+}
+
+void SpatialIndex::invalidate()
+{
+    m_tree.clear();
+    m_records.clear();
+    m_dirty.clear();
+    m_pendingOrders.clear();
+    m_built = false;
+}
+
+bool SpatialIndex::contains(DrawingShape *shape) const
+{
+    flush();
+    return m_records.contains(shape);
+}
+
+int SpatialIndex::shapeCount() const
+{
+    flush();
+    return m_records.size();
+}
+
+void SpatialIndex::flush() const
+{
+    if (!m_scene) {
+        return;
+    }
+
+    if (!m_built) {
+        // 按堆叠顺序从下到上编号，与QGraphicsScene的插入次序一致
+        m_tree.clear();
+        m_records.clear();
+        const QList<QGraphicsItem*> items = m_scene->items(Qt::AscendingOrder);
+        for (QGraphicsItem *item : items) {
+            if (DrawingShape *shape = dynamic_cast<DrawingShape*>(item)) {
+                updateRecord(shape);
+            }
+        }
+        m_dirty.clear();
+        m_pendingOrders.clear();
+        m_built = true;
+        ++m_stats.fullBuilds;
+        return;
+    }
+
+    for (DrawingShape *shape : std::as_const(m_dirty)) {
+        updateRecord(shape);
+        ++m_stats.incrementalUpdates;
+    }
+    m_dirty.clear();
+}
+
+void SpatialIndex::updateRecord(DrawingShape *shape) const
+{
+    if (shape->scene() != m_scene || !shape->isVisible()) {
+        // 仍在场景中的隐藏图形保留次序，重新显示时回到原来的堆叠位置
+        auto it = m_records.constFind(shape);
+        if (shape->scene() == m_scene && it != m_records.constEnd()) {
+            m_pendingOrders.insert(shape, it->order);
+        } else if (shape->scene() != m_scene) {
+            m_pendingOrders.remove(shape);
+        }
+        removeRecord(shape);
+        return;
+    }
+
+    auto it = m_records.find(shape);
+    if (it == m_records.end()) {
+        it = m_records.insert(shape, Record());
+        auto pending = m_pendingOrders.find(shape);
+        if (pending != m_pendingOrders.end()) {
+            it->order = pending.value();
+            m_pendingOrders.erase(pending);
+        } else {
+            it->order = ++m_nextOrder;
+        }
+    } else {
+        m_tree.remove(it->bounds, shape);
+    }
+
+    it->bounds = shape->sceneBoundingRect();
+    it->outlineValid = false;
+    it->outline = Outline();
+    m_tree.insert(it->bounds, shape);
+}
+
+void SpatialIndex::removeRecord(DrawingShape *shape) const
+{
+    auto it = m_records.find(shape);
+    if (it == m_records.end()) {
+        return;
+    }
+    // 删除图形时可能已不在场景中，使用记录的边界定位
+    m_tree.remove(it->bounds, shape);
+    m_records.erase(it);
+}
+
+const SpatialIndex::Outline &SpatialIndex::ensureOutline(DrawingShape *shape, Record &record) const
+{
+    if (!record.outlineValid) {
+        // 图形缓存了本地坐标的展平轮廓，这里只需映射到场景坐标
+        const QTransform sceneTransform = shape->sceneTransform();
+        const QList<QPolygonF> &localPolygons = shape->flattenedOutline();
+        record.outline.polygons.clear();
+        record.outline.polygons.reserve(localPolygons.size());
+        qreal left = std::numeric_limits<qreal>::max();
+        qreal top = std::numeric_limits<qreal>::max();
+        qreal right = std::numeric_limits<qreal>::lowest();
+        qreal bottom = std::numeric_limits<qreal>::lowest();
+        for (const QPolygonF &polygon : localPolygons) {
+            const QPolygonF mapped = sceneTransform.map(polygon);
+            for (const QPointF &point : mapped) {
+                left = qMin(left, point.x());
+                top = qMin(top, point.y());
+                right = qMax(right, point.x());
+                bottom = qMax(bottom, point.y());
+            }
+            record.outline.polygons.append(mapped);
+        }
+        record.outline.bounds = left <= right ? QRectF(QPointF(left, top), QPointF(right, bottom)) : QRectF();
+        record.outline.fillRule = shape->shape().fillRule();
+        record.outlineValid = true;
+    }
+    return record.outline;
+}
+
+const SpatialIndex::Outline *SpatialIndex::outline(DrawingShape *shape) const
+{
+    flush();
+    auto it = m_records.find(shape);
+    if (it == m_records.end()) {
+        return nullptr;
+    }
+    return &ensureOutline(shape, it.value());
+}
+
+QList<DrawingShape*> SpatialIndex::candidates(const QRectF &area) const
+{
+    flush();
+    QList<DrawingShape*> shapes;
+    m_tree.search(area, [&shapes](const QRectF &, DrawingShape *shape) {
+        shapes.append(shape);
+    });
+    return shapes;
+}
+
+QList<DrawingShape*> SpatialIndex::shapesAt(const QPointF &pos, qreal tolerance) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QRectF area(pos.x() - tolerance, pos.y() - tolerance, tolerance * 2, tolerance * 2);
+    QList<DrawingShape*> result;
+    const QList<DrawingShape*> shapes = candidates(area);
+    for (DrawingShape *shape : shapes) {
+        const Outline &shapeOutline = ensureOutline(shape, m_records[shape]);
+        if (outlineContains(shapeOutline, pos)
+            || (tolerance > 0 && outlineDistance(shapeOutline, pos) <= tolerance)) {
+            result.append(shape);
+        }
+    }
+    sortByStacking(result);
+
+    recordQuery(timer.nsecsElapsed());
+    return result;
+}
+
+DrawingShape *SpatialIndex::topShapeAt(const QPointF &pos, qreal tolerance) const
+{
+    const QList<DrawingShape*> shapes = shapesAt(pos, tolerance);
+    return shapes.isEmpty() ? nullptr : shapes.first();
+}
+
+QList<DrawingShape*> SpatialIndex::shapesInRect(const QRectF &rect, Qt::ItemSelectionMode mode) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QRectF area = rect.normalized();
+    QList<DrawingShape*> result;
+    const QList<DrawingShape*> shapes = candidates(area);
+    for (DrawingShape *shape : shapes) {
+        Record &record = m_records[shape];
+        bool hit = false;
+        switch (mode) {
+        case Qt::ContainsItemBoundingRect:
+            hit = rectContainsPoint(area, record.bounds.topLeft())
+                && rectContainsPoint(area, record.bounds.bottomRight());
+            break;
+        case Qt::IntersectsItemBoundingRect:
+            hit = true;
+            break;
+        case Qt::ContainsItemShape: {
+            const QRectF bounds = ensureOutline(shape, record).bounds;
+            hit = rectContainsPoint(area, bounds.topLeft()) && rectContainsPoint(area, bounds.bottomRight());
+            break;
+        }
+        case Qt::IntersectsItemShape:
+            hit = outlineIntersects(ensureOutline(shape, record), area);
+            break;
+        }
+        if (hit) {
+            result.append(shape);
+        }
+    }
+    sortByStacking(result);
+
+    recordQuery(timer.nsecsElapsed());
+    return result;
+}
+
+QList<DrawingShape*> SpatialIndex::shapesInRadius(const QPointF &center, qreal radius) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QRectF area(center.x() - radius, center.y() - radius, radius * 2, radius * 2);
+    QList<DrawingShape*> result;
+    const QList<DrawingShape*> shapes = candidates(area);
+    for (DrawingShape *shape : shapes) {
+        const Outline &shapeOutline = ensureOutline(shape, m_records[shape]);
+        if (outlineContains(shapeOutline, center) || outlineDistance(shapeOutline, center) <= radius) {
+            result.append(shape);
+        }
+    }
+    sortByStacking(result);
+
+    recordQuery(timer.nsecsElapsed());
+    return result;
+}
+
+bool SpatialIndex::outlineContains(const Outline &outline, const QPointF &pos)
+{
+    if (!rectContainsPoint(outline.bounds, pos)) {
+        return false;
+    }
+
+    // 所有子路径一起计算环绕数，开放子路径视为首尾相连（与QPainterPath::contains一致）
+    int winding = 0;
+    int crossings = 0;
+    for (const QPolygonF &polygon : outline.polygons) {
+        const int count = polygon.size();
+        for (int i = 0; i < count; ++i) {
+            const QPointF &a = polygon[i];
+            const QPointF &b = polygon[(i + 1) % count];
+            if ((a.y() <= pos.y()) == (b.y() <= pos.y())) {
+                continue;
+            }
+            const qreal x = a.x() + (pos.y() - a.y()) * (b.x() - a.x()) / (b.y() - a.y());
+            if (x > pos.x()) {
+                ++crossings;
+                winding += b.y() > a.y() ? 1 : -1;
+            }
+        }
+    }
+
+    return outline.fillRule == Qt::WindingFill ? winding != 0 : (crossings & 1) != 0;
+}
+
+qreal SpatialIndex::outlineDistance(const Outline &outline, const QPointF &pos)
+{
+    qreal best = std::numeric_limits<qreal>::max();
+    for (const QPolygonF &polygon : outline.polygons) {
+        if (polygon.size() == 1) {
+            best = qMin(best, QLineF(pos, polygon.first()).length());
+        }
+        for (int i = 1; i < polygon.size(); ++i) {
+            best = qMin(best, BezierGeometry::segmentDistance(pos, polygon[i - 1], polygon[i]));
+        }
+    }
+    return best;
+}
+
+bool SpatialIndex::outlineIntersects(const Outline &outline, const QRectF &rect)
+{
+    for (const QPolygonF &polygon : outline.polygons) {
+        for (int i = 0; i < polygon.size(); ++i) {
+            if (rectContainsPoint(rect, polygon[i])) {
+                return true;
+            }
+            if (i > 0 && segmentIntersectsRect(polygon[i - 1], polygon[i], rect)) {
+                return true;
+            }
+        }
+    }
+    // 矩形完全落在图形内部
+    return outlineContains(outline, rect.center());
+}
+
+void SpatialIndex::sortByStacking(QList<DrawingShape*> &shapes) const
+{
+    if (shapes.size() < 2) {
+        return;
+    }
+    std::stable_sort(shapes.begin(), shapes.end(), [this](DrawingShape *a, DrawingShape *b) {
+        return stacksAbove(a, b);
+    });
+}
+
+bool SpatialIndex::stacksAbove(const QGraphicsItem *a, const QGraphicsItem *b) const
+{
+    // 从顶层到自身的祖先链
+    QVarLengthArray<const QGraphicsItem*, 8> chainA;
+    QVarLengthArray<const QGraphicsItem*, 8> chainB;
+    for (const QGraphicsItem *item = a; item; item = item->parentItem()) {
+        chainA.prepend(item);
+    }
+    for (const QGraphicsItem *item = b; item; item = item->parentItem()) {
+        chainB.prepend(item);
+    }
+
+    int depth = 0;
+    while (depth < chainA.size() && depth < chainB.size() && chainA[depth] == chainB[depth]) {
+        ++depth;
+    }
+    // 子项绘制在父项之上
+    if (depth == chainA.size()) {
+        return false;
+    }
+    if (depth == chainB.size()) {
+        return true;
+    }
+
+    const QGraphicsItem *siblingA = chainA[depth];
+    const QGraphicsItem *siblingB = chainB[depth];
+    if (siblingA->zValue() != siblingB->zValue()) {
+        return siblingA->zValue() > siblingB->zValue();
+    }
+
+    if (depth == 0) {
+        auto orderOf = [this](const QGraphicsItem *item) -> quint64 {
+            DrawingShape *shape = const_cast<DrawingShape*>(dynamic_cast<const DrawingShape*>(item));
+            auto it = m_records.constFind(shape);
+            return it == m_records.constEnd() ? 0 : it->order;
+        };
+        return orderOf(siblingA) > orderOf(siblingB);
+    }
+
+    // childItems()按堆叠顺序从下到上排列
+    const QList<QGraphicsItem*> siblings = chainA[depth - 1]->childItems();
+    return siblings.indexOf(const_cast<QGraphicsItem*>(siblingA))
+         > siblings.indexOf(const_cast<QGraphicsItem*>(siblingB));
+}
+
+void SpatialIndex::recordQuery(qint64 ns) const
+{
+    ++m_stats.queries;
+    m_stats.totalQueryNs += ns;
+}
+
+SpatialIndex::Stats SpatialIndex::stats() const
+{
+    Stats result = m_stats;
+    result.shapes = m_records.size();
+    result.treeHeight = m_tree.height();
+    return result;
+}
@@ -0,0 +1,111 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QPolygonF>
+#include <QRectF>
+#include "rtree.h"
+
+class QGraphicsScene;
+class QGraphicsItem;
+class DrawingShape;
+
+/**
+ * 场景的空间索引服务，供各工具统一做命中测试
+ *
+ * 图形的场景边界存放在R树中，精确测试使用缓存的场景坐标展平轮廓
+ * （图形的flattenedOutline()按场景变换映射），按图形的填充规则判断内外。
+ * 图形移动、变换、几何或可见性变化时只标记为脏，下次查询前增量更新。
+ * 查询结果按堆叠顺序排列，最上层的图形在前
+ */
+class SpatialIndex
+{
+public:
+    explicit SpatialIndex(QGraphicsScene *scene);
+    ~SpatialIndex();
+
+    /**
+     * 图形的展平轮廓（场景坐标）
+     */
+    struct Outline {
+        QRectF bounds;
+        QList<QPolygonF> polygons;
+        Qt::FillRule fillRule = Qt::OddEvenFill;
+    };
+
+    // 索引维护，由DrawingScene转发图形的变化
+    void insertShape(DrawingShape *shape);   // 加入场景或层级变化，重新确定堆叠次序
+    void markDirty(DrawingShape *shape);     // 位置、变换、几何或可见性变化
+    void removeShape(DrawingShape *shape);
+    void invalidate();
+
+    bool contains(DrawingShape *shape) const;
+    int shapeCount() const;
+
+    /**
+     * 点查询：点在轮廓内部，或与轮廓的距离不超过tolerance
+     */
+    QList<DrawingShape*> shapesAt(const QPointF &pos, qreal tolerance = 0.0) const;
+    DrawingShape *topShapeAt(const QPointF &pos, qreal tolerance = 0.0) const;
+
+    /**
+     * 矩形查询
+     * @param mode 支持IntersectsItemShape、ContainsItemShape和只比较边界的IntersectsItemBoundingRect、ContainsItemBoundingRect
+     */
+    QList<DrawingShape*> shapesInRect(const QRectF &rect,
+                                      Qt::ItemSelectionMode mode = Qt::IntersectsItemShape) const;
+
+    /**
+     * 半径查询：轮廓与圆相交（包括圆心在轮廓内部）
+     */
+    QList<DrawingShape*> shapesInRadius(const QPointF &center, qreal radius) const;
+
+    /**
+     * 图形的缓存轮廓，不在索引中时返回nullptr
+     */
+    const Outline *outline(DrawingShape *shape) const;
+
+    struct Stats {
+        int shapes = 0;
+        int treeHeight = 0;
+        qint64 queries = 0;
+        qint64 totalQueryNs = 0;
+        qint64 incrementalUpdates = 0;
+        qint64 fullBuilds = 0;
+    };
+    Stats stats() const;
+
+private:
+    struct Record {
+        QRectF bounds;
+        quint64 order = 0;          // 顶层图形的加入次序
+        bool outlineValid = false;
+        Outline outline;
+    };
+
+    void flush() const;
+    void updateRecord(DrawingShape *shape) const;
+    void removeRecord(DrawingShape *shape) const;
+    const Outline &ensureOutline(DrawingShape *shape, Record &record) const;
+    QList<DrawingShape*> candidates(const QRectF &area) const;
+    void sortByStacking(QList<DrawingShape*> &shapes) const;
+    bool stacksAbove(const QGraphicsItem *a, const QGraphicsItem *b) const;
+    void recordQuery(qint64 ns) const;
+
+    static bool outlineContains(const Outline &outline, const QPointF &pos);
+    static qreal outlineDistance(const Outline &outline, const QPointF &pos);
+    static bool outlineIntersects(const Outline &outline, const QRectF &rect);
+
+    QGraphicsScene *m_scene;
+    mutable RTree<DrawingShape*> m_tree;
+    mutable QHash<DrawingShape*, Record> m_records;
+    mutable QSet<DrawingShape*> m_dirty;
+    mutable QHash<DrawingShape*, quint64> m_pendingOrders;  // 已加入但尚未建立记录的图形次序
+    mutable bool m_built;
+    mutable quint64 m_nextOrder;
+    mutable Stats m_stats;
+};
+
+#endif // SPATIAL_INDEX_H
@@ -4,30 +4,30 @@
 #include <QDomNodeList>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <QBuffer>
+#include <QSet>
 #include <QPainter>
 #include <QPainterPath>
 #include <QPainterPathStroker>
 #include <QPointF>
 #include <QTransform>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
 #include <QDebug>
 #include "svghandler.h"
 #include "svgstreamhandler.h"
 #include "fastpathparser.h"
+#include "svgnumberscanner.h"
+#include "svgpathwriter.h"
 #include "svgelementcollector.h"
+#include "svgimportcontext.h"
 #include "drawing-shape.h"
 #include "drawing-layer.h"
 #include "drawing-group.h"
 #include "layer-manager.h"
 #include "../ui/drawingscene.h"
 
-// 全局存储定义
-QHash<QString, QGradient> s_gradients;
-QHash<QString, QGraphicsEffect *> s_filters;
-QHash<QString, QBrush> s_patterns;
-QHash<QString, QDomElement> s_markers;
-QHash<QString, MarkerData> s_markerDataCache;
-QHash<QString, QDomElement> s_definedElements;
-
 // 手写解析器类定义 - 避免Qt正则表达式的性能问题
 
 // SvgStringUtils类定义 - 提供简单的字符串分割功能，避免正则表达式
@@ -242,71 +242,61 @@ public:
         if (pointsStr.isEmpty())
             return;
 
-        const QString str = pointsStr.trimmed();
-        if (str.isEmpty())
-            return;
+        QElapsedTimer timer;
+        timer.start();
 
-        int i = 0;
-        const int len = str.length();
+        const char16_t *chars = reinterpret_cast<const char16_t *>(pointsStr.utf16());
+        const qsizetype length = pointsStr.size();
 
-        while (i < len)
+        // 按块跳过空白和逗号，逐个数字串解析坐标，x和y成对使用
+        SvgTokenCursor<char16_t> cursor(chars, length);
+        qreal x = 0.0;
+        bool hasX = false;
+        qsizetype pos = cursor.nextToken(0);
+        while (pos < length)
         {
-            // 跳过空白字符
-            while (i < len && str[i].isSpace())
-                i++;
-
-            if (i >= len)
-                break;
-
-            // 解析X坐标
-            QString xStr;
-            while (i < len && (str[i].isDigit() || str[i] == '.' || str[i] == '-' || str[i] == '+'))
+            const qsizetype runEnd = cursor.numberRunEnd(pos);
+            if (runEnd == pos)
             {
-                xStr += str[i];
-                i++;
+                // 点列表中不应出现字母，跳过
+                pos = cursor.nextToken(pos + 1);
+                continue;
             }
 
-            // 跳过空白字符
-            while (i < len && str[i].isSpace())
-                i++;
-
-            // 期望遇到逗号
-            if (i < len && str[i] == ',')
-                i++;
-
-            // 跳过空白字符
-            while (i < len && str[i].isSpace())
-                i++;
-
-            // 解析Y坐标
-            QString yStr;
-            while (i < len && (str[i].isDigit() || str[i] == '.' || str[i] == '-' || str[i] == '+'))
+            const char16_t *p = chars + pos;
+            const char16_t *runLast = chars + runEnd;
+            while (p < runLast)
             {
-                yStr += str[i];
-                i++;
-            }
+                qreal value = 0.0;
+                const char16_t *next = SvgNumberScanner::parseNumber(p, runLast, value);
+                if (next == p)
+                {
+                    ++p;
+                    continue;
+                }
+                p = next;
 
-            // 转换为数值并添加到路径
-            bool okX, okY;
-            qreal x = xStr.toDouble(&okX);
-            qreal y = yStr.toDouble(&okY);
+                if (!hasX)
+                {
+                    x = value;
+                    hasX = true;
+                    continue;
+                }
 
-            if (okX && okY)
-            {
                 if (path.elementCount() == 0)
                 {
-                    path.moveTo(x, y);
+                    path.moveTo(x, value);
                 }
                 else
                 {
-                    path.lineTo(x, y);
+                    path.lineTo(x, value);
                 }
+                hasX = false;
             }
-
-            // 跳过到下一个点的空白字符
-            while (i < len && str[i].isSpace())
-                i++;
+            pos = cursor.nextToken(runEnd);
         }
+
+        SvgNumberScanner::recordThroughput(length, timer.nsecsElapsed());
     }
 };
 
@@ -519,9 +509,9 @@ bool SvgHandler::importFromSvg(DrawingScene *scene, const QString &fileName)
         return false;
     }
 
-    // 暂时禁用流式解析，使用DOM方式
+    // 大文件使用流式解析，避免构建整棵DOM树
     qint64 fileSize = file.size();
-    bool useStreamParser = false; // fileSize > 100 * 1024; // 100KB threshold
+    bool useStreamParser = fileSize > 100 * 1024; // 100KB threshold
 
     if (useStreamParser)
     {
@@ -546,13 +536,15 @@ bool SvgHandler::importFromSvg(DrawingScene *scene, const QString &fileName)
 
         file.close();
 
-        bool result = parseSvgDocument(scene, doc);
+        // 每次导入使用独立的上下文保存defs定义
+        SvgImportContext context;
+        bool result = parseSvgDocument(context, scene, doc);
         LayerManager::instance()->setSvgImporting(false);
         return result;
     }
 }
 
-bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
+bool SvgHandler::parseSvgDocument(SvgImportContext &context, DrawingScene *scene, const QDomDocument &doc)
 {
     QDomElement root = doc.documentElement();
 
@@ -571,17 +563,11 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
     // 计算SVG到Scene的变换矩阵
     QTransform svgToSceneTransform = calculateSvgToSceneTransform(metadata);
 
-    // 清空之前存储的定义元素
-    s_definedElements.clear();
-
     // 使用优化的元素收集器，单次遍历收集所有元素
     SvgElementCollector::CollectedElements collected = SvgElementCollector::collect(root);
 
-    // 更新全局定义元素缓存
-    s_definedElements = collected.definedElements;
-
-    // 清理之前的渐变定义
-    s_gradients.clear();
+    // 更新定义元素缓存
+    context.definedElements = collected.definedElements;
 
     // 批量处理渐变定义
     for (const QDomElement &gradient : collected.linearGradients)
@@ -590,7 +576,7 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
         if (!id.isEmpty())
         {
             QLinearGradient linearGradient = parseLinearGradient(gradient);
-            s_gradients[id] = linearGradient;
+            context.gradients[id] = linearGradient;
         }
     }
     for (const QDomElement &gradient : collected.radialGradients)
@@ -599,13 +585,10 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
         if (!id.isEmpty())
         {
             QRadialGradient radialGradient = parseRadialGradient(gradient);
-            s_gradients[id] = radialGradient;
+            context.gradients[id] = radialGradient;
         }
     }
 
-    // 清理之前的滤镜定义
-    s_filters.clear();
-
     // 批量处理滤镜定义
     for (const QDomElement &filter : collected.gaussianBlurFilters)
     {
@@ -615,7 +598,7 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
             QGraphicsBlurEffect *blurEffect = parseGaussianBlurFilter(filter);
             if (blurEffect)
             {
-                s_filters[id] = blurEffect;
+                context.filters[id] = blurEffect;
             }
         }
     }
@@ -627,14 +610,11 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
             QGraphicsDropShadowEffect *shadowEffect = parseDropShadowFilter(filter);
             if (shadowEffect)
             {
-                s_filters[id] = shadowEffect;
+                context.filters[id] = shadowEffect;
             }
         }
     }
 
-    // 清理之前的图案定义
-    s_patterns.clear();
-
     // 批量处理图案定义
     for (const QDomElement &pattern : collected.patterns)
     {
@@ -642,34 +622,33 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
         if (!id.isEmpty())
         {
             QBrush patternBrush = parsePatternBrush(pattern);
-            s_patterns[id] = patternBrush;
+            context.patterns[id] = patternBrush;
         }
     }
 
-    // 清理之前的标记定义
-    s_markers.clear();
-    s_markerDataCache.clear();
-
     // 批量处理标记定义
     for (const QDomElement &marker : collected.markers)
     {
         QString id = marker.attribute("id");
         if (!id.isEmpty())
         {
-            s_markers[id] = marker.cloneNode().toElement();
+            context.markers[id] = marker.cloneNode().toElement();
             // 预解析标记数据
             MarkerData markerData = parseMarkerData(marker);
-            s_markerDataCache[id] = markerData;
+            context.markerDataCache[id] = markerData;
         }
     }
 
+    // 第一阶段：在线程池中预解析路径和样式，后续创建图形时直接取用
+    context.preparsedShapes = preparseShapes(root);
+
     // 使用收集到的元素创建图形对象
     int elementCount = 0;
 
     // 处理图层元素（包括嵌套的处理）
     for (const QDomElement &element : collected.layers)
     {
-        DrawingGroup *group = parseGroupElement(scene, element);
+        DrawingGroup *group = parseGroupElement(context, scene, element);
         if (group)
         {
             elementCount++;
@@ -694,7 +673,7 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
 
         if (isTopLevel)
         {
-            DrawingGroup *group = parseGroupElement(scene, element);
+            DrawingGroup *group = parseGroupElement(context, scene, element);
             if (group)
             {
                 elementCount++;
@@ -723,7 +702,7 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
             // 只有不在组中的元素才直接添加到场景
             if (!isInGroup)
             {
-                DrawingShape *shape = parseSvgElement(element);
+                DrawingShape *shape = parseSvgElement(context, element);
                 if (shape)
                 {
                     scene->addItem(shape);
@@ -802,13 +781,197 @@ bool SvgHandler::parseSvgDocument(DrawingScene *scene, const QDomDocument &doc)
         }
     }
 
+    // 预解析数据只在本次导入期间有效
+    context.preparsedShapes.clear();
+
     // 重置SVG导入标志
     LayerManager::instance()->setSvgImporting(false);
 
     return elementCount > 0;
 }
 
-bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStreamElement &rootElement)
+quint64 SvgHandler::preparseKey(const QDomElement &element)
+{
+    // 只有从文件解析得到的元素才有行列号，流式导入的DOM片段没有
+    return preparseKey(element.lineNumber(), element.columnNumber());
+}
+
+quint64 SvgHandler::preparseKey(qint64 line, qint64 column)
+{
+    if (line < 0 || column < 0)
+    {
+        return 0;
+    }
+    return (quint64(line) << 32) | quint32(column);
+}
+
+const SvgPreparsedShape *SvgHandler::findPreparsedShape(SvgImportContext &context, const QDomElement &element)
+{
+    if (context.preparsedShapes.isEmpty())
+    {
+        return nullptr;
+    }
+
+    // 流式导入的DOM片段没有行列号，由调用方给出当前元素的键
+    quint64 key = preparseKey(element);
+    if (key == 0)
+    {
+        key = context.currentPreparseKey;
+    }
+    if (key == 0)
+    {
+        return nullptr;
+    }
+
+    auto it = context.preparsedShapes.constFind(key);
+    return it != context.preparsedShapes.constEnd() ? &it.value() : nullptr;
+}
+
+SvgPreparsedShape SvgHandler::preparseShape(const QString &tagName, const QString &data,
+                                            const QString &transform, const QString &stroke,
+                                            const QString &fill)
+{
+    SvgPreparsedShape shape;
+
+    if (tagName == "path")
+    {
+        parseSvgPathData(data, shape.path);
+    }
+    else
+    {
+        SvgPointParser::parsePoints(data, shape.path);
+        if (tagName == "polygon")
+        {
+            shape.path.closeSubpath();
+        }
+    }
+
+    // 与parsePathElement一致，保存所有元素作为控制点
+    const int elementCount = shape.path.elementCount();
+    shape.controlPoints.reserve(elementCount);
+    shape.controlPointTypes.reserve(elementCount);
+    for (int i = 0; i < elementCount; ++i)
+    {
+        const QPainterPath::Element &element = shape.path.elementAt(i);
+        shape.controlPoints.append(QPointF(element.x, element.y));
+        shape.controlPointTypes.append(element.type);
+    }
+
+    if (!transform.isEmpty())
+    {
+        if (tagName == "path")
+        {
+            // 与parseTransformAttribute一致：新建路径的位置为原点
+            QString adjustedTransform = adjustTransformForUseElement(transform, 0, 0);
+            if (!adjustedTransform.isEmpty())
+            {
+                shape.transform = parseTransform(adjustedTransform);
+                shape.hasTransform = !shape.transform.isIdentity();
+            }
+        }
+        else
+        {
+            shape.transform = parseTransform(transform);
+            shape.hasTransform = true;
+        }
+    }
+
+    if (!stroke.isEmpty() && stroke != "none")
+    {
+        shape.strokeColor = parseColor(stroke);
+    }
+    if (!fill.isEmpty() && fill != "none" && !fill.startsWith("url(#"))
+    {
+        shape.fillColor = parseColor(fill);
+    }
+
+    return shape;
+}
+
+QHash<quint64, SvgPreparsedShape> SvgHandler::preparseShapes(const QDomElement &root)
+{
+    // GUI线程：单次遍历DOM，只提取属性字符串
+    QVector<SvgPreparseJob> jobs;
+    QDomElement element = root.firstChildElement();
+    while (!element.isNull())
+    {
+        QString tagName = element.tagName();
+        bool isPath = tagName == "path" && element.attribute("sodipodi:type") != "arc";
+        if (isPath || tagName == "polyline" || tagName == "polygon")
+        {
+            QString data = element.attribute(isPath ? "d" : "points");
+            quint64 key = preparseKey(element);
+            if (!data.isEmpty() && key != 0)
+            {
+                jobs.append({key, tagName, data, element.attribute("transform"),
+                             element.attribute("stroke"), element.attribute("fill")});
+            }
+        }
+
+        // 深度优先遍历到下一个元素
+        QDomElement next = element.firstChildElement();
+        if (next.isNull())
+        {
+            QDomNode node = element;
+            while (!node.isNull() && node != root)
+            {
+                next = node.nextSiblingElement();
+                if (!next.isNull())
+                {
+                    break;
+                }
+                node = node.parentNode();
+            }
+        }
+        element = next;
+    }
+
+    return preparseJobs(jobs);
+}
+
+QHash<quint64, SvgPreparsedShape> SvgHandler::preparseJobs(const QVector<SvgPreparseJob> &jobs)
+{
+    QHash<quint64, SvgPreparsedShape> preparsed;
+
+    // 图形很少时线程调度的开销大于收益，保持串行解析
+    const int threadCount = QThread::idealThreadCount();
+    if (threadCount < 2 || jobs.size() < 64)
+    {
+        return preparsed;
+    }
+
+    // 工作线程：解析为纯值结构，每个任务写入互不重叠的结果区间
+    QVector<SvgPreparsedShape> results(jobs.size());
+    SvgPreparsedShape *output = results.data();
+    const SvgPreparseJob *input = jobs.constData();
+    const int chunkSize = qMax(16, int(jobs.size() / (threadCount * 4)));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    for (int begin = 0; begin < jobs.size(); begin += chunkSize)
+    {
+        const int end = qMin(begin + chunkSize, int(jobs.size()));
+        pool.start([input, output, begin, end]()
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                const SvgPreparseJob &job = input[i];
+                output[i] = preparseShape(job.tagName, job.data, job.transform, job.stroke, job.fill);
+            }
+        });
+    }
+    pool.waitForDone();
+
+    preparsed.reserve(jobs.size());
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        preparsed.insert(jobs[i].key, std::move(results[i]));
+    }
+
+    return preparsed;
+}
+
+bool SvgHandler::parseSvgDocumentFromElement(SvgImportContext &context, DrawingScene *scene, const SvgStreamElement &rootElement)
 {
     if (rootElement.tagName != "svg")
     {
@@ -825,17 +988,11 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
     // 计算SVG到Scene的变换矩阵
     QTransform svgToSceneTransform = calculateSvgToSceneTransform(metadata);
 
-    // 清空之前存储的定义元素
-    s_definedElements.clear();
-
     // 使用优化的元素收集器，单次遍历收集所有元素
     SvgElementCollector::CollectedElements collected = collectElementsFromStream(rootElement);
 
-    // 更新全局定义元素缓存
-    s_definedElements = collected.definedElements;
-
-    // 清理之前的渐变定义
-    s_gradients.clear();
+    // 更新定义元素缓存
+    context.definedElements = collected.definedElements;
 
     // 批量处理渐变定义
     for (const QDomElement &gradient : collected.linearGradients)
@@ -844,7 +1001,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
         if (!id.isEmpty())
         {
             QLinearGradient linearGradient = parseLinearGradient(gradient);
-            s_gradients[id] = linearGradient;
+            context.gradients[id] = linearGradient;
         }
     }
     for (const QDomElement &gradient : collected.radialGradients)
@@ -853,13 +1010,10 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
         if (!id.isEmpty())
         {
             QRadialGradient radialGradient = parseRadialGradient(gradient);
-            s_gradients[id] = radialGradient;
+            context.gradients[id] = radialGradient;
         }
     }
 
-    // 清理之前的滤镜定义
-    s_filters.clear();
-
     // 批量处理滤镜定义
     for (const QDomElement &filter : collected.gaussianBlurFilters)
     {
@@ -869,7 +1023,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
             QGraphicsBlurEffect *blurEffect = parseGaussianBlurFilter(filter);
             if (blurEffect)
             {
-                s_filters[id] = blurEffect;
+                context.filters[id] = blurEffect;
             }
         }
     }
@@ -881,14 +1035,11 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
             QGraphicsDropShadowEffect *shadowEffect = parseDropShadowFilter(filter);
             if (shadowEffect)
             {
-                s_filters[id] = shadowEffect;
+                context.filters[id] = shadowEffect;
             }
         }
     }
 
-    // 清理之前的图案定义
-    s_patterns.clear();
-
     // 批量处理图案定义
     for (const QDomElement &pattern : collected.patterns)
     {
@@ -896,23 +1047,19 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
         if (!id.isEmpty())
         {
             QBrush patternBrush = parsePatternBrush(pattern);
-            s_patterns[id] = patternBrush;
+            context.patterns[id] = patternBrush;
         }
     }
 
-    // 清理之前的标记定义
-    s_markers.clear();
-    s_markerDataCache.clear();
-
     // 批量处理标记定义
     for (const QDomElement &marker : collected.markers)
     {
         QString id = marker.attribute("id");
         if (!id.isEmpty())
         {
-            s_markers[id] = marker;
+            context.markers[id] = marker;
             MarkerData markerData = parseMarkerData(marker);
-            s_markerDataCache[id] = markerData;
+            context.markerDataCache[id] = markerData;
         }
     }
 
@@ -922,7 +1069,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
     // 处理所有顶级图形元素
     for (const QDomElement &element : collected.paths)
     {
-        DrawingPath *shape = parsePathElement(element);
+        DrawingPath *shape = parsePathElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -932,7 +1079,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.rectangles)
     {
-        DrawingRectangle *shape = parseRectElement(element);
+        DrawingRectangle *shape = parseRectElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -942,7 +1089,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.circles)
     {
-        DrawingEllipse *shape = parseCircleElement(element);
+        DrawingEllipse *shape = parseCircleElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -952,7 +1099,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.ellipses)
     {
-        DrawingEllipse *shape = parseEllipseElement(element);
+        DrawingEllipse *shape = parseEllipseElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -962,7 +1109,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.lines)
     {
-        DrawingPath *shape = parseLineElement(element);
+        DrawingPath *shape = parseLineElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -972,7 +1119,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.polylines)
     {
-        DrawingPath *shape = parsePolygonElement(element);
+        DrawingPath *shape = parsePolygonElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -982,7 +1129,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.polygons)
     {
-        DrawingPath *shape = parsePolygonElement(element);
+        DrawingPath *shape = parsePolygonElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -992,7 +1139,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.texts)
     {
-        DrawingText *shape = parseTextElement(element);
+        DrawingText *shape = parseTextElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -1002,7 +1149,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.useElements)
     {
-        DrawingShape *shape = parseUseElement(element);
+        DrawingShape *shape = parseUseElement(context, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -1012,7 +1159,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
 
     for (const QDomElement &element : collected.groups)
     {
-        DrawingGroup *shape = parseGroupElement(scene, element);
+        DrawingGroup *shape = parseGroupElement(context, scene, element);
         if (shape)
         {
             scene->addItem(shape);
@@ -1023,7 +1170,7 @@ bool SvgHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStrea
     // 处理图层元素（包括嵌套的处理）
     for (const QDomElement &element : collected.layers)
     {
-        DrawingGroup *group = parseGroupElement(scene, element);
+        DrawingGroup *group = parseGroupElement(context, scene, element);
         if (group)
         {
             elementCount++;
@@ -1113,7 +1260,7 @@ SvgMetadata SvgHandler::parseSvgMetadataFromElement(const SvgStreamElement &svgE
 }
 
 // 从流式解析的元素创建图形对象
-DrawingShape *SvgHandler::parseSvgElementFromStream(const SvgStreamElement &element)
+DrawingShape *SvgHandler::parseSvgElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     QString tagName = element.tagName;
 
@@ -1121,35 +1268,35 @@ DrawingShape *SvgHandler::parseSvgElementFromStream(const SvgStreamElement &elem
     {
         if (tagName == "path")
         {
-            return parsePathElementFromStream(element);
+            return parsePathElementFromStream(context, element);
         }
         else if (tagName == "rect")
         {
-            return parseRectElementFromStream(element);
+            return parseRectElementFromStream(context, element);
         }
         else if (tagName == "circle")
         {
-            return parseCircleElementFromStream(element);
+            return parseCircleElementFromStream(context, element);
         }
         else if (tagName == "ellipse")
         {
-            return parseEllipseElementFromStream(element);
+            return parseEllipseElementFromStream(context, element);
         }
         else if (tagName == "line")
         {
-            return parseLineElementFromStream(element);
+            return parseLineElementFromStream(context, element);
         }
         else if (tagName == "polyline" || tagName == "polygon")
         {
-            return parsePolygonElementFromStream(element);
+            return parsePolygonElementFromStream(context, element);
         }
         else if (tagName == "text")
         {
-            return parseTextElementFromStream(element);
+            return parseTextElementFromStream(context, element);
         }
         else if (tagName == "g")
         {
-            return parseGroupElementFromStream(element);
+            return parseGroupElementFromStream(context, element);
         }
         else if (tagName == "defs" || tagName == "pattern" ||
                  tagName == "filter" || tagName == "marker" ||
@@ -1162,7 +1309,7 @@ DrawingShape *SvgHandler::parseSvgElementFromStream(const SvgStreamElement &elem
         }
         else if (tagName == "use")
         {
-            return parseUseElementFromStream(element);
+            return parseUseElementFromStream(context, element);
         }
         else if (tagName == "image")
         {
@@ -1191,7 +1338,7 @@ DrawingShape *SvgHandler::parseSvgElementFromStream(const SvgStreamElement &elem
 }
 
 // 从流式解析元素创建路径
-DrawingPath *SvgHandler::parsePathElementFromStream(const SvgStreamElement &element)
+DrawingPath *SvgHandler::parsePathElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     if (!element.attributes.contains("d"))
     {
@@ -1225,7 +1372,7 @@ DrawingPath *SvgHandler::parsePathElementFromStream(const SvgStreamElement &elem
     drawingPath->setControlPointTypes(controlPointTypes);
 
     // 解析样式属性
-    parseStyleAttributesFromStream(drawingPath, element);
+    parseStyleAttributesFromStream(context, drawingPath, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1240,13 +1387,13 @@ DrawingPath *SvgHandler::parsePathElementFromStream(const SvgStreamElement &elem
     QString markerEnd = element.attributes.value("marker-end");
 
     // 应用Marker
-    applyMarkers(drawingPath, markerStart, markerMid, markerEnd);
+    applyMarkers(context, drawingPath, markerStart, markerMid, markerEnd);
 
     return drawingPath;
 }
 
 // 从流式解析元素创建矩形
-DrawingRectangle *SvgHandler::parseRectElementFromStream(const SvgStreamElement &element)
+DrawingRectangle *SvgHandler::parseRectElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     qreal x = element.attributes.value("x", "0").toDouble();
     qreal y = element.attributes.value("y", "0").toDouble();
@@ -1262,7 +1409,7 @@ DrawingRectangle *SvgHandler::parseRectElementFromStream(const SvgStreamElement
     rect->setPos(x, y);
 
     // 解析样式属性
-    parseStyleAttributesFromStream(rect, element);
+    parseStyleAttributesFromStream(context, rect, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1275,7 +1422,7 @@ DrawingRectangle *SvgHandler::parseRectElementFromStream(const SvgStreamElement
 }
 
 // 从流式解析元素创建圆形
-DrawingEllipse *SvgHandler::parseCircleElementFromStream(const SvgStreamElement &element)
+DrawingEllipse *SvgHandler::parseCircleElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     qreal cx = element.attributes.value("cx", "0").toDouble();
     qreal cy = element.attributes.value("cy", "0").toDouble();
@@ -1291,7 +1438,7 @@ DrawingEllipse *SvgHandler::parseCircleElementFromStream(const SvgStreamElement
     circle->setPos(cx - r, cy - r);
 
     // 解析样式属性
-    parseStyleAttributesFromStream(circle, element);
+    parseStyleAttributesFromStream(context, circle, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1304,7 +1451,7 @@ DrawingEllipse *SvgHandler::parseCircleElementFromStream(const SvgStreamElement
 }
 
 // 从流式解析元素创建椭圆
-DrawingEllipse *SvgHandler::parseEllipseElementFromStream(const SvgStreamElement &element)
+DrawingEllipse *SvgHandler::parseEllipseElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     qreal cx = element.attributes.value("cx", "0").toDouble();
     qreal cy = element.attributes.value("cy", "0").toDouble();
@@ -1321,7 +1468,7 @@ DrawingEllipse *SvgHandler::parseEllipseElementFromStream(const SvgStreamElement
     ellipse->setPos(cx, cy);
 
     // 解析样式属性
-    parseStyleAttributesFromStream(ellipse, element);
+    parseStyleAttributesFromStream(context, ellipse, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1334,7 +1481,7 @@ DrawingEllipse *SvgHandler::parseEllipseElementFromStream(const SvgStreamElement
 }
 
 // 从流式解析元素创建线条
-DrawingPath *SvgHandler::parseLineElementFromStream(const SvgStreamElement &element)
+DrawingPath *SvgHandler::parseLineElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     qreal x1 = element.attributes.value("x1", "0").toDouble();
     qreal y1 = element.attributes.value("y1", "0").toDouble();
@@ -1349,7 +1496,7 @@ DrawingPath *SvgHandler::parseLineElementFromStream(const SvgStreamElement &elem
     line->setPath(path);
 
     // 解析样式属性
-    parseStyleAttributesFromStream(line, element);
+    parseStyleAttributesFromStream(context, line, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1364,13 +1511,13 @@ DrawingPath *SvgHandler::parseLineElementFromStream(const SvgStreamElement &elem
     QString markerEnd = element.attributes.value("marker-end");
 
     // 应用Marker
-    applyMarkers(line, markerStart, markerMid, markerEnd);
+    applyMarkers(context, line, markerStart, markerMid, markerEnd);
 
     return line;
 }
 
 // 从流式解析元素创建多边形
-DrawingPath *SvgHandler::parsePolygonElementFromStream(const SvgStreamElement &element)
+DrawingPath *SvgHandler::parsePolygonElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     if (!element.attributes.contains("points"))
     {
@@ -1395,7 +1542,7 @@ DrawingPath *SvgHandler::parsePolygonElementFromStream(const SvgStreamElement &e
     shape->setPath(path);
 
     // 解析样式属性
-    parseStyleAttributesFromStream(shape, element);
+    parseStyleAttributesFromStream(context, shape, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1411,13 +1558,13 @@ DrawingPath *SvgHandler::parsePolygonElementFromStream(const SvgStreamElement &e
     QString markerEnd = element.attributes.value("marker-end");
 
     // 应用Marker
-    applyMarkers(shape, markerStart, markerMid, markerEnd);
+    applyMarkers(context, shape, markerStart, markerMid, markerEnd);
 
     return shape;
 }
 
 // 从流式解析元素创建文本
-DrawingText *SvgHandler::parseTextElementFromStream(const SvgStreamElement &element)
+DrawingText *SvgHandler::parseTextElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     QString text = element.text.trimmed();
     if (text.isEmpty())
@@ -1472,7 +1619,7 @@ DrawingText *SvgHandler::parseTextElementFromStream(const SvgStreamElement &elem
     }
 
     // 解析样式属性
-    parseStyleAttributesFromStream(shape, element);
+    parseStyleAttributesFromStream(context, shape, element);
 
     // 解析变换属性
     if (element.attributes.contains("transform"))
@@ -1486,17 +1633,17 @@ DrawingText *SvgHandler::parseTextElementFromStream(const SvgStreamElement &elem
 }
 
 // 从流式解析元素创建组
-DrawingGroup *SvgHandler::parseGroupElementFromStream(const SvgStreamElement &element)
+DrawingGroup *SvgHandler::parseGroupElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     DrawingGroup *group = new DrawingGroup();
 
     // 解析组的样式属性
-    parseStyleAttributesFromStream(group, element);
+    parseStyleAttributesFromStream(context, group, element);
 
     // 处理所有子元素
     for (const SvgStreamElement &childElement : element.children)
     {
-        DrawingShape *shape = parseSvgElementFromStream(childElement);
+        DrawingShape *shape = parseSvgElementFromStream(context, childElement);
         if (shape)
         {
             group->addItem(shape);
@@ -1507,7 +1654,7 @@ DrawingGroup *SvgHandler::parseGroupElementFromStream(const SvgStreamElement &el
 }
 
 // 从流式解析元素创建use元素
-DrawingShape *SvgHandler::parseUseElementFromStream(const SvgStreamElement &element)
+DrawingShape *SvgHandler::parseUseElementFromStream(SvgImportContext &context, const SvgStreamElement &element)
 {
     // 获取href属性（引用的元素ID）
     QString href = element.attributes.value("href");
@@ -1517,12 +1664,12 @@ DrawingShape *SvgHandler::parseUseElementFromStream(const SvgStreamElement &elem
     }
 
     // 查找被引用的元素
-    if (!s_definedElements.contains(href))
+    if (!context.definedElements.contains(href))
     {
         return nullptr;
     }
 
-    QDomElement referencedElement = s_definedElements[href];
+    QDomElement referencedElement = context.definedElements[href];
 
     // 获取use元素的位置
     qreal x = element.attributes.value("x", "0").toDouble();
@@ -1581,13 +1728,13 @@ DrawingShape *SvgHandler::parseUseElementFromStream(const SvgStreamElement &elem
 
     // 合并样式：use元素的样式优先级更高
     // 这里简化处理，直接使用现有的DOM解析函数
-    DrawingShape *shape = parseSvgElement(clonedElement);
+    DrawingShape *shape = parseSvgElement(context, clonedElement);
 
     return shape;
 }
 
 // 从流式解析元素解析样式属性
-void SvgHandler::parseStyleAttributesFromStream(DrawingShape *shape, const SvgStreamElement &element)
+void SvgHandler::parseStyleAttributesFromStream(SvgImportContext &context, DrawingShape *shape, const SvgStreamElement &element)
 {
     // 解析stroke属性
     if (element.attributes.contains("stroke"))
@@ -1641,16 +1788,16 @@ void SvgHandler::parseStyleAttributesFromStream(DrawingShape *shape, const SvgSt
             else if (fill.startsWith("url(#"))
             {
                 QString refId = fill.mid(5, fill.length() - 6);
-                if (s_gradients.contains(refId))
+                if (context.gradients.contains(refId))
                 {
-                    QGradient gradient = s_gradients[refId];
+                    QGradient gradient = context.gradients[refId];
                     gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
                     QBrush brush(gradient);
                     shape->setFillBrush(brush);
                 }
-                else if (s_patterns.contains(refId))
+                else if (context.patterns.contains(refId))
                 {
-                    QBrush patternBrush = s_patterns[refId];
+                    QBrush patternBrush = context.patterns[refId];
                     shape->setFillBrush(patternBrush);
                 }
             }
@@ -1713,7 +1860,7 @@ void SvgHandler::collectElementsFromStreamRecursive(const SvgStreamElement &elem
     if (element.attributes.contains("id"))
     {
         QString id = element.attributes.value("id");
-        // 创建一个临时的QDomElement来存储在s_definedElements中
+        // 创建一个临时的QDomElement来存储在definedElements中
         QDomDocument tempDoc;
         QDomElement tempElement = tempDoc.createElement(tagName);
         for (auto it = element.attributes.begin(); it != element.attributes.end(); ++it)
@@ -2020,7 +2167,7 @@ void SvgHandler::collectElementsFromStreamRecursive(const SvgStreamElement &elem
     }
 }
 
-DrawingShape *SvgHandler::parseSvgElement(const QDomElement &element)
+DrawingShape *SvgHandler::parseSvgElement(SvgImportContext &context, const QDomElement &element)
 {
     QString tagName = element.tagName();
 
@@ -2032,33 +2179,33 @@ DrawingShape *SvgHandler::parseSvgElement(const QDomElement &element)
             if (element.hasAttribute("sodipodi:type") &&
                 element.attribute("sodipodi:type") == "arc")
             {
-                return parseSodipodiArcElement(element);
+                return parseSodipodiArcElement(context, element);
             }
-            return parsePathElement(element);
+            return parsePathElement(context, element);
         }
         else if (tagName == "rect")
         {
-            return parseRectElement(element);
+            return parseRectElement(context, element);
         }
         else if (tagName == "circle")
         {
-            return parseCircleElement(element);
+            return parseCircleElement(context, element);
         }
         else if (tagName == "ellipse")
         {
-            return parseEllipseElement(element);
+            return parseEllipseElement(context, element);
         }
         else if (tagName == "line")
         {
-            return parseLineElement(element);
+            return parseLineElement(context, element);
         }
         else if (tagName == "polyline" || tagName == "polygon")
         {
-            return parsePolygonElement(element);
+            return parsePolygonElement(context, element);
         }
         else if (tagName == "text")
         {
-            return parseTextElement(element);
+            return parseTextElement(context, element);
         }
         else if (tagName == "g")
         {
@@ -2076,7 +2223,7 @@ DrawingShape *SvgHandler::parseSvgElement(const QDomElement &element)
         }
         else if (tagName == "use")
         {
-            return parseUseElement(element);
+            return parseUseElement(context, element);
         }
         else if (tagName == "image")
         {
@@ -2104,7 +2251,7 @@ DrawingShape *SvgHandler::parseSvgElement(const QDomElement &element)
     }
 }
 
-DrawingGroup *SvgHandler::parseGroupElement(DrawingScene *scene, const QDomElement &groupElement)
+DrawingGroup *SvgHandler::parseGroupElement(SvgImportContext &context, DrawingScene *scene, const QDomElement &groupElement)
 {
     // //qDebug() << "parseGroupElement: 开始解析组元素";
     // 检查是否是图层（带有 inkscape:label 属性）
@@ -2149,7 +2296,7 @@ DrawingGroup *SvgHandler::parseGroupElement(DrawingScene *scene, const QDomEleme
         group = new DrawingGroup();
 
         // 解析组的样式属性
-        parseStyleAttributes(group, groupElement);
+        parseStyleAttributes(context, group, groupElement);
     }
 
     // 遍历组中的所有子元素
@@ -2165,7 +2312,7 @@ DrawingGroup *SvgHandler::parseGroupElement(DrawingScene *scene, const QDomEleme
             if (tagName == "g")
             {
                 // 递归处理嵌套组，但不要重复应用变换
-                DrawingGroup *nestedGroup = parseGroupElement(scene, element);
+                DrawingGroup *nestedGroup = parseGroupElement(context, scene, element);
                 if (nestedGroup && group)
                 {
                     // 将嵌套组添加到父组，但不应用父组的变换
@@ -2177,7 +2324,7 @@ DrawingGroup *SvgHandler::parseGroupElement(DrawingScene *scene, const QDomEleme
             {
                 try
                 {
-                    DrawingShape *shape = parseSvgElement(element);
+                    DrawingShape *shape = parseSvgElement(context, element);
                     if (shape)
                     {
                         // 应用子对象自己的变换（如果有）
@@ -2281,7 +2428,7 @@ DrawingLayer *SvgHandler::parseLayerElement(const QDomElement &element)
     return layer;
 }
 
-DrawingEllipse *SvgHandler::parseSodipodiArcElement(const QDomElement &element)
+DrawingEllipse *SvgHandler::parseSodipodiArcElement(SvgImportContext &context, const QDomElement &element)
 {
     // 获取 sodipodi:arc 的属性
     qreal cx = element.attribute("sodipodi:cx", "0").toDouble();
@@ -2309,7 +2456,7 @@ DrawingEllipse *SvgHandler::parseSodipodiArcElement(const QDomElement &element)
     }
 
     // 解析样式属性
-    parseStyleAttributes(ellipse, element);
+    parseStyleAttributes(context, ellipse, element);
 
     // 解析变换属性
     if (element.hasAttribute("transform"))
@@ -2322,7 +2469,7 @@ DrawingEllipse *SvgHandler::parseSodipodiArcElement(const QDomElement &element)
     return ellipse;
 }
 
-DrawingPath *SvgHandler::parsePathElement(const QDomElement &element)
+DrawingPath *SvgHandler::parsePathElement(SvgImportContext &context, const QDomElement &element)
 {
     QString d = element.attribute("d");
     if (d.isEmpty())
@@ -2330,6 +2477,28 @@ DrawingPath *SvgHandler::parsePathElement(const QDomElement &element)
         return nullptr;
     }
 
+    // 两阶段导入时直接使用工作线程预解析的数据
+    const SvgPreparsedShape *preparsed = findPreparsedShape(context, element);
+    if (preparsed)
+    {
+        DrawingPath *drawingPath = new DrawingPath();
+        drawingPath->setPath(preparsed->path);
+        drawingPath->setControlPoints(preparsed->controlPoints);
+        drawingPath->setControlPointTypes(preparsed->controlPointTypes);
+
+        parseStyleAttributes(context, drawingPath, element, preparsed);
+
+        if (preparsed->hasTransform)
+        {
+            drawingPath->applyTransform(preparsed->transform);
+        }
+
+        applyMarkers(context, drawingPath, element.attribute("marker-start"),
+                     element.attribute("marker-mid"), element.attribute("marker-end"));
+
+        return drawingPath;
+    }
+
     QPainterPath path;
     // 解析SVG路径数据
     parseSvgPathData(d, path);
@@ -2354,7 +2523,7 @@ DrawingPath *SvgHandler::parsePathElement(const QDomElement &element)
     drawingPath->setControlPointTypes(controlPointTypes);
 
     // 解析样式属性
-    parseStyleAttributes(drawingPath, element);
+    parseStyleAttributes(context, drawingPath, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2369,7 +2538,7 @@ DrawingPath *SvgHandler::parsePathElement(const QDomElement &element)
     QString markerEnd = element.attribute("marker-end");
 
     // 应用Marker
-    applyMarkers(drawingPath, markerStart, markerMid, markerEnd);
+    applyMarkers(context, drawingPath, markerStart, markerMid, markerEnd);
 
     return drawingPath;
 }
@@ -2380,7 +2549,7 @@ void SvgHandler::parseSvgPathData(const QString &data, QPainterPath &path)
     FastPathParser::parsePathData(data, path);
 }
 
-DrawingRectangle *SvgHandler::parseRectElement(const QDomElement &element)
+DrawingRectangle *SvgHandler::parseRectElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal x = element.attribute("x", "0").toDouble();
     qreal y = element.attribute("y", "0").toDouble();
@@ -2398,7 +2567,7 @@ DrawingRectangle *SvgHandler::parseRectElement(const QDomElement &element)
     rect->setPos(x, y);
 
     // 解析样式属性
-    parseStyleAttributes(rect, element);
+    parseStyleAttributes(context, rect, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2416,7 +2585,7 @@ DrawingRectangle *SvgHandler::parseRectElement(const QDomElement &element)
     return rect;
 }
 
-DrawingEllipse *SvgHandler::parseEllipseElement(const QDomElement &element)
+DrawingEllipse *SvgHandler::parseEllipseElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal cx = element.attribute("cx", "0").toDouble();
     qreal cy = element.attribute("cy", "0").toDouble();
@@ -2436,7 +2605,7 @@ DrawingEllipse *SvgHandler::parseEllipseElement(const QDomElement &element)
     ellipse->setPos(cx, cy);
 
     // 解析样式属性
-    parseStyleAttributes(ellipse, element);
+    parseStyleAttributes(context, ellipse, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2448,7 +2617,7 @@ DrawingEllipse *SvgHandler::parseEllipseElement(const QDomElement &element)
     return ellipse;
 }
 
-DrawingEllipse *SvgHandler::parseCircleElement(const QDomElement &element)
+DrawingEllipse *SvgHandler::parseCircleElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal cx = element.attribute("cx", "0").toDouble();
     qreal cy = element.attribute("cy", "0").toDouble();
@@ -2467,7 +2636,7 @@ DrawingEllipse *SvgHandler::parseCircleElement(const QDomElement &element)
     circle->setPos(cx - r, cy - r);
 
     // 解析样式属性
-    parseStyleAttributes(circle, element);
+    parseStyleAttributes(context, circle, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2479,7 +2648,7 @@ DrawingEllipse *SvgHandler::parseCircleElement(const QDomElement &element)
     return circle;
 }
 
-DrawingPath *SvgHandler::parseLineElement(const QDomElement &element)
+DrawingPath *SvgHandler::parseLineElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal x1 = element.attribute("x1", "0").toDouble();
     qreal y1 = element.attribute("y1", "0").toDouble();
@@ -2494,7 +2663,7 @@ DrawingPath *SvgHandler::parseLineElement(const QDomElement &element)
     line->setPath(path);
 
     // 解析样式属性
-    parseStyleAttributes(line, element);
+    parseStyleAttributes(context, line, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2509,12 +2678,12 @@ DrawingPath *SvgHandler::parseLineElement(const QDomElement &element)
     QString markerEnd = element.attribute("marker-end");
 
     // 应用Marker
-    applyMarkers(line, markerStart, markerMid, markerEnd);
+    applyMarkers(context, line, markerStart, markerMid, markerEnd);
 
     return line;
 }
 
-DrawingPath *SvgHandler::parsePolygonElement(const QDomElement &element)
+DrawingPath *SvgHandler::parsePolygonElement(SvgImportContext &context, const QDomElement &element)
 {
     QString pointsStr = element.attribute("points");
     if (pointsStr.isEmpty())
@@ -2522,28 +2691,48 @@ DrawingPath *SvgHandler::parsePolygonElement(const QDomElement &element)
         return nullptr;
     }
 
-    QPainterPath path;
+    // 两阶段导入时直接使用工作线程预解析的数据
+    const SvgPreparsedShape *preparsed = findPreparsedShape(context, element);
 
-    // 使用手写的点解析器，避免正则表达式
-    SvgPointParser::parsePoints(pointsStr, path);
+    QPainterPath path;
 
-    if (element.tagName() == "polygon")
+    if (preparsed)
+    {
+        path = preparsed->path;
+    }
+    else
     {
-        path.closeSubpath(); // 多边形需要闭合
+        // 使用手写的点解析器，避免正则表达式
+        SvgPointParser::parsePoints(pointsStr, path);
+
+        if (element.tagName() == "polygon")
+        {
+            path.closeSubpath(); // 多边形需要闭合
+        }
     }
 
     DrawingPath *shape = new DrawingPath();
     shape->setPath(path);
 
     // 解析样式属性
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element, preparsed);
 
     // 解析变换属性
-    QString transform = element.attribute("transform");
-    if (!transform.isEmpty())
+    if (preparsed)
     {
-        QTransform transformMatrix = parseTransform(transform);
-        shape->applyTransform(transformMatrix);
+        if (preparsed->hasTransform)
+        {
+            shape->applyTransform(preparsed->transform);
+        }
+    }
+    else
+    {
+        QString transform = element.attribute("transform");
+        if (!transform.isEmpty())
+        {
+            QTransform transformMatrix = parseTransform(transform);
+            shape->applyTransform(transformMatrix);
+        }
     }
 
     // 解析Marker属性
@@ -2552,12 +2741,12 @@ DrawingPath *SvgHandler::parsePolygonElement(const QDomElement &element)
     QString markerEnd = element.attribute("marker-end");
 
     // 应用Marker
-    applyMarkers(shape, markerStart, markerMid, markerEnd);
+    applyMarkers(context, shape, markerStart, markerMid, markerEnd);
 
     return shape;
 }
 
-DrawingText *SvgHandler::parseTextElement(const QDomElement &element)
+DrawingText *SvgHandler::parseTextElement(SvgImportContext &context, const QDomElement &element)
 {
     // 检查是否有tspan子元素
     bool hasTspan = false;
@@ -2575,16 +2764,16 @@ DrawingText *SvgHandler::parseTextElement(const QDomElement &element)
     if (hasTspan)
     {
         // 如果有tspan，创建一个包含所有文本的DrawingText，使用父元素的样式
-        return parseTextElementWithTspan(element);
+        return parseTextElementWithTspan(context, element);
     }
     else
     {
         // 如果没有tspan，使用原来的逻辑
-        return parseSimpleTextElement(element);
+        return parseSimpleTextElement(context, element);
     }
 }
 
-DrawingText *SvgHandler::parseSimpleTextElement(const QDomElement &element)
+DrawingText *SvgHandler::parseSimpleTextElement(SvgImportContext &context, const QDomElement &element)
 {
     // 获取文本内容
     QString text = element.text().trimmed();
@@ -2643,7 +2832,7 @@ DrawingText *SvgHandler::parseSimpleTextElement(const QDomElement &element)
     }
 
     // 解析样式属性
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2655,7 +2844,7 @@ DrawingText *SvgHandler::parseSimpleTextElement(const QDomElement &element)
     return shape;
 }
 
-DrawingText *SvgHandler::parseTextElementWithTspan(const QDomElement &element)
+DrawingText *SvgHandler::parseTextElementWithTspan(SvgImportContext &context, const QDomElement &element)
 {
     // 对于包含tspan的文本，我们将所有文本合并，但使用父元素的样式
     // 这是一个折中方案，确保所有文本都能显示
@@ -2715,7 +2904,7 @@ DrawingText *SvgHandler::parseTextElementWithTspan(const QDomElement &element)
     }
 
     // 使用父元素的样式属性（不包括tspan的特殊样式）
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -2758,7 +2947,8 @@ QString SvgHandler::collectTextContent(const QDomElement &element)
     return content;
 }
 
-void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &element)
+void SvgHandler::parseStyleAttributes(SvgImportContext &context, DrawingShape *shape, const QDomElement &element,
+                                      const SvgPreparsedShape *preparsed)
 {
     // 解析stroke属性
     QString stroke = element.attribute("stroke");
@@ -2771,7 +2961,7 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
         }
         else
         {
-            QColor strokeColor = parseColor(stroke);
+            QColor strokeColor = preparsed ? preparsed->strokeColor : parseColor(stroke);
             if (strokeColor.isValid())
             {
                 QPen pen = shape->strokePen();
@@ -2808,9 +2998,9 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
             QString refId = fill.mid(5, fill.length() - 6); // 去掉 "url(#" 和 ")"
 
             // 首先检查是否是渐变
-            if (s_gradients.contains(refId))
+            if (context.gradients.contains(refId))
             {
-                QGradient gradient = s_gradients[refId];
+                QGradient gradient = context.gradients[refId];
 
                 // 设置渐变坐标模式为对象边界框模式
                 gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
@@ -2838,16 +3028,16 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
                 }
             }
             // 然后检查是否是Pattern
-            else if (s_patterns.contains(refId))
+            else if (context.patterns.contains(refId))
             {
-                QBrush patternBrush = s_patterns[refId];
+                QBrush patternBrush = context.patterns[refId];
                 shape->setFillBrush(patternBrush);
                 // 应用Pattern填充
             }
         }
         else
         {
-            QColor fillColor = parseColor(fill);
+            QColor fillColor = preparsed ? preparsed->fillColor : parseColor(fill);
             if (fillColor.isValid())
             {
                 shape->setFillBrush(QBrush(fillColor));
@@ -2934,11 +3124,11 @@ void SvgHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &el
     {
         QString filterId = filter.mid(5, filter.length() - 6); // 去掉 "url(#" 和 ")"
 
-        applyFilterToShape(shape, filterId);
+        applyFilterToShape(context, shape, filterId);
     }
 }
 
-void SvgHandler::parseStyleAttributes(DrawingGroup *group, const QDomElement &element)
+void SvgHandler::parseStyleAttributes(SvgImportContext &context, DrawingGroup *group, const QDomElement &element)
 {
     // DrawingGroup 本身不需要解析样式，样式应该传递给子元素
     // 这里可以解析组的透明度等属性
@@ -2955,7 +3145,7 @@ void SvgHandler::parseStyleAttributes(DrawingGroup *group, const QDomElement &el
     if (!filter.isEmpty() && filter.startsWith("url(#"))
     {
         QString filterId = filter.mid(5, filter.length() - 6); // 去掉 "url(#" 和 ")"
-        applyFilterToShape(group, filterId);
+        applyFilterToShape(context, group, filterId);
     }
 }
 
@@ -3016,10 +3206,8 @@ void SvgHandler::parseSvgPointsData(const QString &pointsStr, QPainterPath &path
     }
 }
 
-bool SvgHandler::exportToSvg(DrawingScene *scene, const QString &fileName)
+bool SvgHandler::exportToSvg(DrawingScene *scene, const QString &fileName, const SvgPathWriter::Options &pathOptions)
 {
-    QDomDocument doc = exportSceneToSvgDocument(scene);
-
     QFile file(fileName);
     if (!file.open(QIODevice::WriteOnly))
     {
@@ -3027,21 +3215,42 @@ bool SvgHandler::exportToSvg(DrawingScene *scene, const QString &fileName)
         return false;
     }
 
-    file.write(doc.toByteArray(2)); // 2表示缩进为2个空格
+    // 边遍历场景边写入文件，不再在内存中构建完整的DOM树和序列化文本
+    QXmlStreamWriter writer(&file);
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(2); // 与QDomDocument::toByteArray(2)的缩进一致
+    writeSceneToSvg(writer, scene, pathOptions);
+    writer.writeEndDocument();
+
     file.close();
 
-    return true;
+    return !writer.hasError();
 }
 
 QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
 {
+    // 复用流式导出器，保证两种导出方式的输出一致
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    QXmlStreamWriter writer(&buffer);
+    writeSceneToSvg(writer, scene, SvgPathWriter::Options());
+    writer.writeEndDocument();
+    buffer.close();
+
     QDomDocument doc;
+    doc.setContent(data);
+    return doc;
+}
 
+void SvgHandler::writeSceneToSvg(QXmlStreamWriter &writer, DrawingScene *scene, const SvgPathWriter::Options &pathOptions)
+{
     // 创建SVG根元素
-    QDomElement svgElement = doc.createElement("svg");
-    svgElement.setAttribute("xmlns", "http://www.w3.org/2000/svg");
-    svgElement.setAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
-    svgElement.setAttribute("version", "1.1");
+    writer.writeStartElement("svg");
+    writer.writeAttribute("xmlns", "http://www.w3.org/2000/svg");
+    writer.writeAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
+    writer.writeAttribute("version", "1.1");
 
     // 计算场景中所有内容的边界框
     QRectF contentBounds;
@@ -3058,19 +3267,6 @@ QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
         if (item->type() == QGraphicsItem::UserType + 100)
         {
             // DrawingLayer
-
-            // DrawingLayer *layer = static_cast<DrawingLayer*>(item);
-            // if (layer) {
-            //     layers.append(layer);
-            //     // 使用 sceneBoundingRect 获取场景中的实际边界
-            //     QRectF layerBounds = layer->sceneBoundingRect();
-            //     if (firstItem) {
-            //         contentBounds = layerBounds;
-            //         firstItem = false;
-            //     } else {
-            //         contentBounds = contentBounds.united(layerBounds);
-            //     }
-            // }
         }
         else
         {
@@ -3105,51 +3301,48 @@ QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
     }
 
     // 设置 viewBox 从 (0,0) 开始，宽高为内容的实际尺寸
-    svgElement.setAttribute("viewBox", QString("0 0 %1 %2")
-                                           .arg(contentBounds.width())
-                                           .arg(contentBounds.height()));
+    writer.writeAttribute("viewBox", QString("0 0 %1 %2")
+                                         .arg(contentBounds.width())
+                                         .arg(contentBounds.height()));
 
     // 设置 SVG 的实际尺寸
-    svgElement.setAttribute("width", QString::number(contentBounds.width()));
-    svgElement.setAttribute("height", QString::number(contentBounds.height()));
+    writer.writeAttribute("width", QString::number(contentBounds.width()));
+    writer.writeAttribute("height", QString::number(contentBounds.height()));
 
     // 添加一个 transform 来移动内容到正确的位置
     if (contentBounds.left() != 0 || contentBounds.top() != 0)
     {
-        svgElement.setAttribute("transform", QString("translate(%1,%2)")
-                                                 .arg(-contentBounds.left())
-                                                 .arg(-contentBounds.top()));
+        writer.writeAttribute("transform", QString("translate(%1,%2)")
+                                               .arg(-contentBounds.left())
+                                               .arg(-contentBounds.top()));
     }
 
     // 创建defs元素用于定义渐变和滤镜
-    QDomElement defsElement = doc.createElement("defs");
-    svgElement.appendChild(defsElement);
+    writer.writeStartElement("defs");
 
     // 导出渐变定义
-    exportGradientsToSvg(doc, defsElement, allItems);
+    writeGradientsToSvg(writer, allItems);
 
     // 导出滤镜定义
-    exportFiltersToSvg(doc, defsElement, allItems);
+    writeFiltersToSvg(writer, allItems);
+
+    writer.writeEndElement(); // defs
 
     // 创建一个组元素来包含所有内容，并应用必要的变换
-    QDomElement groupElement = doc.createElement("g");
+    writer.writeStartElement("g");
 
     // 如果内容不在原点，添加变换来移动内容
     if (contentBounds.left() != 0 || contentBounds.top() != 0)
     {
-        groupElement.setAttribute("transform", QString("translate(%1,%2)")
-                                                   .arg(-contentBounds.left())
-                                                   .arg(-contentBounds.top()));
+        writer.writeAttribute("transform", QString("translate(%1,%2)")
+                                               .arg(-contentBounds.left())
+                                               .arg(-contentBounds.top()));
     }
 
     // 首先导出图层（保持层次结构）
     for (DrawingLayer *layer : layers)
     {
-        QDomElement layerElement = exportLayerToSvgElement(doc, layer);
-        if (!layerElement.isNull())
-        {
-            groupElement.appendChild(layerElement);
-        }
+        writeLayerToSvg(writer, layer, pathOptions);
     }
 
     // 然后导出不在图层中的独立形状
@@ -3168,68 +3361,74 @@ QDomDocument SvgHandler::exportSceneToSvgDocument(DrawingScene *scene)
 
         if (!inLayer)
         {
-            QDomElement shapeElement = exportShapeToSvgElement(doc, shape);
-            if (!shapeElement.isNull())
-            {
-                groupElement.appendChild(shapeElement);
-            }
+            writeShapeToSvg(writer, shape, pathOptions);
         }
     }
 
-    svgElement.appendChild(groupElement);
-    doc.appendChild(svgElement);
-    return doc;
+    writer.writeEndElement(); // g
+    writer.writeEndElement(); // svg
 }
 
-QDomElement SvgHandler::exportShapeToSvgElement(QDomDocument &doc, DrawingShape *shape)
+void SvgHandler::writeShapeToSvg(QXmlStreamWriter &writer, DrawingShape *shape, const SvgPathWriter::Options &pathOptions)
 {
     if (!shape)
     {
-        return QDomElement();
+        return;
     }
 
     switch (shape->shapeType())
     {
     case DrawingShape::Path:
-        return exportPathToSvgElement(doc, static_cast<DrawingPath *>(shape));
+        writePathToSvg(writer, static_cast<DrawingPath *>(shape), pathOptions);
+        break;
     case DrawingShape::Rectangle:
-        return exportRectangleToSvgElement(doc, static_cast<DrawingRectangle *>(shape));
+        writeRectangleToSvg(writer, static_cast<DrawingRectangle *>(shape));
+        break;
     case DrawingShape::Ellipse:
-        return exportEllipseToSvgElement(doc, static_cast<DrawingEllipse *>(shape));
+        writeEllipseToSvg(writer, static_cast<DrawingEllipse *>(shape));
+        break;
     case DrawingShape::Text:
-        return exportTextToSvgElement(doc, static_cast<DrawingText *>(shape));
+        writeTextToSvg(writer, static_cast<DrawingText *>(shape));
+        break;
     case DrawingShape::Line:
-        return exportLineToSvgElement(doc, static_cast<DrawingLine *>(shape));
+        writeLineToSvg(writer, static_cast<DrawingLine *>(shape));
+        break;
     case DrawingShape::Polyline:
-        return exportPolylineToSvgElement(doc, static_cast<DrawingPolyline *>(shape));
+        writePolylineToSvg(writer, static_cast<DrawingPolyline *>(shape));
+        break;
     case DrawingShape::Polygon:
-        return exportPolygonToSvgElement(doc, static_cast<DrawingPolygon *>(shape));
+        writePolygonToSvg(writer, static_cast<DrawingPolygon *>(shape));
+        break;
     default:
         // qDebug() << "未知的图形类型，无法导出:" << shape->shapeType();
-        return QDomElement();
+        break;
     }
 }
 
-QDomElement SvgHandler::exportPathToSvgElement(QDomDocument &doc, DrawingPath *path)
+void SvgHandler::writePathToSvg(QXmlStreamWriter &writer, DrawingPath *path, const SvgPathWriter::Options &pathOptions)
 {
-    QDomElement pathElement = doc.createElement("path");
+    writer.writeStartElement("path");
 
     // 导出ID
     QString id = path->id();
     if (!id.isEmpty())
     {
-        pathElement.setAttribute("id", id);
+        writer.writeAttribute("id", id);
     }
 
-    // 导出路径数据
-    QString pathData = pathDataToString(path->path());
-    pathElement.setAttribute("d", pathData);
+    // 导出路径数据，Qt 6.5起可以直接写入UTF-8数据而无需转换
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    const QByteArray pathData = SvgPathWriter::write(path->path(), pathOptions);
+    writer.writeAttribute("d", QUtf8StringView(pathData));
+#else
+    writer.writeAttribute("d", pathDataToString(path->path(), pathOptions));
+#endif
 
     // 导出变换
     QTransform transform = path->transform();
     if (!transform.isIdentity())
     {
-        pathElement.setAttribute("transform", transformToString(transform));
+        writer.writeAttribute("transform", transformToString(transform));
     }
 
     // 导出样式
@@ -3238,20 +3437,20 @@ QDomElement SvgHandler::exportPathToSvgElement(QDomDocument &doc, DrawingPath *p
 
     if (pen.style() != Qt::NoPen)
     {
-        pathElement.setAttribute("stroke", pen.color().name());
-        pathElement.setAttribute("stroke-width", QString::number(pen.widthF()));
+        writer.writeAttribute("stroke", pen.color().name());
+        writer.writeAttribute("stroke-width", QString::number(pen.widthF()));
         if (pen.color().alphaF() < 1.0)
         {
-            pathElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
+            writer.writeAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
         }
         // 导出线条样式
         if (pen.style() == Qt::DashLine)
         {
-            pathElement.setAttribute("stroke-dasharray", "5,5");
+            writer.writeAttribute("stroke-dasharray", "5,5");
         }
         else if (pen.style() == Qt::DotLine)
         {
-            pathElement.setAttribute("stroke-dasharray", "2,2");
+            writer.writeAttribute("stroke-dasharray", "2,2");
         }
     }
 
@@ -3259,48 +3458,37 @@ QDomElement SvgHandler::exportPathToSvgElement(QDomDocument &doc, DrawingPath *p
     {
         if (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern)
         {
-            pathElement.setAttribute("fill", QString("url(#grad_%1)").arg(quintptr(brush.gradient())));
+            writer.writeAttribute("fill", QString("url(#grad_%1)").arg(quintptr(brush.gradient())));
         }
         else
         {
-            pathElement.setAttribute("fill", brush.color().name());
+            writer.writeAttribute("fill", brush.color().name());
             if (brush.color().alphaF() < 1.0)
             {
-                pathElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
+                writer.writeAttribute("fill-opacity", QString::number(brush.color().alphaF()));
             }
         }
     }
     else
     {
-        pathElement.setAttribute("fill", "none");
+        writer.writeAttribute("fill", "none");
     }
 
     // 导出滤镜
-    QGraphicsEffect *effect = path->graphicsEffect();
-    if (effect)
-    {
-        if (qobject_cast<QGraphicsBlurEffect *>(effect))
-        {
-            pathElement.setAttribute("filter", QString("url(#blur_0)"));
-        }
-        else if (qobject_cast<QGraphicsDropShadowEffect *>(effect))
-        {
-            pathElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
-    }
+    writeFilterReference(writer, path->graphicsEffect());
 
-    return pathElement;
+    writer.writeEndElement();
 }
 
-QDomElement SvgHandler::exportRectangleToSvgElement(QDomDocument &doc, DrawingRectangle *rect)
+void SvgHandler::writeRectangleToSvg(QXmlStreamWriter &writer, DrawingRectangle *rect)
 {
-    QDomElement rectElement = doc.createElement("rect");
+    writer.writeStartElement("rect");
 
     // 导出ID
     QString id = rect->id();
     if (!id.isEmpty())
     {
-        rectElement.setAttribute("id", id);
+        writer.writeAttribute("id", id);
     }
 
     // 获取图形的位置和本地边界
@@ -3308,23 +3496,23 @@ QDomElement SvgHandler::exportRectangleToSvgElement(QDomDocument &doc, DrawingRe
     QRectF bounds = rect->localBounds();
 
     // 计算实际位置（位置 + 本地边界）
-    rectElement.setAttribute("x", QString::number(pos.x() + bounds.x()));
-    rectElement.setAttribute("y", QString::number(pos.y() + bounds.y()));
-    rectElement.setAttribute("width", QString::number(bounds.width()));
-    rectElement.setAttribute("height", QString::number(bounds.height()));
+    writer.writeAttribute("x", QString::number(pos.x() + bounds.x()));
+    writer.writeAttribute("y", QString::number(pos.y() + bounds.y()));
+    writer.writeAttribute("width", QString::number(bounds.width()));
+    writer.writeAttribute("height", QString::number(bounds.height()));
 
     // 导出圆角
     if (rect->cornerRadius() > 0)
     {
-        rectElement.setAttribute("rx", QString::number(rect->cornerRadius()));
-        rectElement.setAttribute("ry", QString::number(rect->cornerRadius()));
+        writer.writeAttribute("rx", QString::number(rect->cornerRadius()));
+        writer.writeAttribute("ry", QString::number(rect->cornerRadius()));
     }
 
     // 导出变换
     QTransform transform = rect->transform();
     if (!transform.isIdentity())
     {
-        rectElement.setAttribute("transform", transformToString(transform));
+        writer.writeAttribute("transform", transformToString(transform));
     }
 
     // 导出样式
@@ -3333,11 +3521,11 @@ QDomElement SvgHandler::exportRectangleToSvgElement(QDomDocument &doc, DrawingRe
 
     if (pen.style() != Qt::NoPen)
     {
-        rectElement.setAttribute("stroke", pen.color().name());
-        rectElement.setAttribute("stroke-width", QString::number(pen.widthF()));
+        writer.writeAttribute("stroke", pen.color().name());
+        writer.writeAttribute("stroke-width", QString::number(pen.widthF()));
         if (pen.color().alphaF() < 1.0)
         {
-            rectElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
+            writer.writeAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
         }
     }
 
@@ -3346,77 +3534,58 @@ QDomElement SvgHandler::exportRectangleToSvgElement(QDomDocument &doc, DrawingRe
         if (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern)
         {
             // 引用渐变
-            rectElement.setAttribute("fill", QString("url(#grad_%1)").arg(quintptr(brush.gradient())));
+            writer.writeAttribute("fill", QString("url(#grad_%1)").arg(quintptr(brush.gradient())));
         }
         else
         {
-            rectElement.setAttribute("fill", brush.color().name());
+            writer.writeAttribute("fill", brush.color().name());
             if (brush.color().alphaF() < 1.0)
             {
-                rectElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
+                writer.writeAttribute("fill-opacity", QString::number(brush.color().alphaF()));
             }
         }
     }
     else
     {
-        rectElement.setAttribute("fill", "none");
+        writer.writeAttribute("fill", "none");
     }
 
     // 导出滤镜
-    QGraphicsEffect *effect = rect->graphicsEffect();
-    if (effect)
-    {
-        if (qobject_cast<QGraphicsBlurEffect *>(effect))
-        {
-            rectElement.setAttribute("filter", QString("url(#blur_0)"));
-        }
-        else if (qobject_cast<QGraphicsDropShadowEffect *>(effect))
-        {
-            rectElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
-    }
+    writeFilterReference(writer, rect->graphicsEffect());
 
-    return rectElement;
+    writer.writeEndElement();
 }
 
-QDomElement SvgHandler::exportEllipseToSvgElement(QDomDocument &doc, DrawingEllipse *ellipse)
+void SvgHandler::writeEllipseToSvg(QXmlStreamWriter &writer, DrawingEllipse *ellipse)
 {
-    QDomElement ellipseElement;
-
-    // 导出ID
-    QString id = ellipse->id();
-    if (!id.isEmpty())
-    {
-        ellipseElement.setAttribute("id", id);
-    }
-
     // 获取图形的位置和本地边界
     QPointF pos = ellipse->pos();
     QRectF bounds = ellipse->localBounds();
 
     // 检查是否是完整的椭圆（360度或接近360度）
-    qreal startAngle = ellipse->startAngle();
     qreal spanAngle = ellipse->spanAngle();
 
+    // 注意：DOM导出器在创建元素之前设置ID，ID实际从未写出，这里保持相同的输出
+
     // 如果跨度接近360度（允许一些误差），则认为是完整椭圆
     if (qFuzzyCompare(qAbs(spanAngle), 360.0) || qFuzzyCompare(spanAngle, 0.0) || qAbs(spanAngle) > 350)
     {
         // 完整椭圆
-        ellipseElement = doc.createElement("ellipse");
+        writer.writeStartElement("ellipse");
         qreal cx = pos.x() + bounds.x() + bounds.width() / 2;
         qreal cy = pos.y() + bounds.y() + bounds.height() / 2;
         qreal rx = bounds.width() / 2;
         qreal ry = bounds.height() / 2;
 
-        ellipseElement.setAttribute("cx", QString::number(cx));
-        ellipseElement.setAttribute("cy", QString::number(cy));
-        ellipseElement.setAttribute("rx", QString::number(rx));
-        ellipseElement.setAttribute("ry", QString::number(ry));
+        writer.writeAttribute("cx", QString::number(cx));
+        writer.writeAttribute("cy", QString::number(cy));
+        writer.writeAttribute("rx", QString::number(rx));
+        writer.writeAttribute("ry", QString::number(ry));
     }
     else
     {
         // 椭圆弧
-        ellipseElement = doc.createElement("path");
+        writer.writeStartElement("path");
 
         // 使用椭圆弧路径
         qreal cx = pos.x() + bounds.x() + bounds.width() / 2;
@@ -3434,14 +3603,14 @@ QDomElement SvgHandler::exportEllipseToSvgElement(QDomDocument &doc, DrawingElli
                                .arg(cx + rx)
                                .arg(cy); // 终点
 
-        ellipseElement.setAttribute("d", pathData);
+        writer.writeAttribute("d", pathData);
     }
 
     // 导出变换
     QTransform transform = ellipse->transform();
     if (!transform.isIdentity())
     {
-        ellipseElement.setAttribute("transform", transformToString(transform));
+        writer.writeAttribute("transform", transformToString(transform));
     }
 
     // 导出样式
@@ -3450,11 +3619,11 @@ QDomElement SvgHandler::exportEllipseToSvgElement(QDomDocument &doc, DrawingElli
 
     if (pen.style() != Qt::NoPen)
     {
-        ellipseElement.setAttribute("stroke", pen.color().name());
-        ellipseElement.setAttribute("stroke-width", QString::number(pen.widthF()));
+        writer.writeAttribute("stroke", pen.color().name());
+        writer.writeAttribute("stroke-width", QString::number(pen.widthF()));
         if (pen.color().alphaF() < 1.0)
         {
-            ellipseElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
+            writer.writeAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
         }
     }
 
@@ -3462,85 +3631,53 @@ QDomElement SvgHandler::exportEllipseToSvgElement(QDomDocument &doc, DrawingElli
     {
         if (brush.style() == Qt::LinearGradientPattern || brush.style() == Qt::RadialGradientPattern)
         {
-            ellipseElement.setAttribute("fill", QString("url(#radial_%1)").arg(quintptr(brush.gradient())));
+            writer.writeAttribute("fill", QString("url(#radial_%1)").arg(quintptr(brush.gradient())));
         }
         else
         {
-            ellipseElement.setAttribute("fill", brush.color().name());
+            writer.writeAttribute("fill", brush.color().name());
             if (brush.color().alphaF() < 1.0)
             {
-                ellipseElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
+                writer.writeAttribute("fill-opacity", QString::number(brush.color().alphaF()));
             }
         }
     }
     else
     {
-        ellipseElement.setAttribute("fill", "none");
+        writer.writeAttribute("fill", "none");
     }
 
     // 导出滤镜
-    QGraphicsEffect *effect = ellipse->graphicsEffect();
-    if (effect)
-    {
-        if (qobject_cast<QGraphicsBlurEffect *>(effect))
-        {
-            ellipseElement.setAttribute("filter", QString("url(#blur_0)"));
-        }
-        else if (qobject_cast<QGraphicsDropShadowEffect *>(effect))
-        {
-            ellipseElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
-    }
+    writeFilterReference(writer, ellipse->graphicsEffect());
 
-    return ellipseElement;
+    writer.writeEndElement();
 }
 
-QString SvgHandler::pathDataToString(const QPainterPath &path)
+void SvgHandler::writeFilterReference(QXmlStreamWriter &writer, QGraphicsEffect *effect)
 {
-    QString result;
-
-    for (int i = 0; i < path.elementCount(); ++i)
+    if (!effect)
     {
-        QPainterPath::Element element = path.elementAt(i);
+        return;
+    }
 
-        switch (element.type)
-        {
-        case QPainterPath::MoveToElement:
-            result += QString("M %1,%2 ").arg(element.x).arg(element.y);
-            break;
-        case QPainterPath::LineToElement:
-            result += QString("L %1,%2 ").arg(element.x).arg(element.y);
-            break;
-        case QPainterPath::CurveToElement:
-            // 需要获取控制点和终点
-            if (i + 2 < path.elementCount())
-            {
-                QPainterPath::Element ctrl1 = path.elementAt(i);
-                QPainterPath::Element ctrl2 = path.elementAt(i + 1);
-                QPainterPath::Element end = path.elementAt(i + 2);
-
-                result += QString("C %1,%2 %3,%4 %5,%6 ")
-                              .arg(ctrl1.x)
-                              .arg(ctrl1.y)
-                              .arg(ctrl2.x)
-                              .arg(ctrl2.y)
-                              .arg(end.x)
-                              .arg(end.y);
-
-                i += 2; // 跳过已处理的元素
-            }
-            break;
-        case QPainterPath::CurveToDataElement:
-            // 控制点数据，在CurveToElement中处理
-            break;
-        }
+    if (qobject_cast<QGraphicsBlurEffect *>(effect))
+    {
+        writer.writeAttribute("filter", QString("url(#blur_0)"));
     }
+    else if (qobject_cast<QGraphicsDropShadowEffect *>(effect))
+    {
+        writer.writeAttribute("filter", QString("url(#shadow_0)"));
+    }
+}
 
-    return result.trimmed();
+QString SvgHandler::pathDataToString(const QPainterPath &path, const SvgPathWriter::Options &options)
+{
+    // 路径数据只包含ASCII字符
+    return QString::fromLatin1(SvgPathWriter::write(path, options));
 }
 
 // 渐变解析方法
-void SvgHandler::parseDefsElements(const QDomElement &root)
+void SvgHandler::parseDefsElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -3550,9 +3687,6 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
         return;
     }
 
-    // 清理之前的渐变定义
-    s_gradients.clear();
-
     // 处理所有的defs元素
     for (int defsIndex = 0; defsIndex < defsNodes.size(); ++defsIndex)
     {
@@ -3568,7 +3702,7 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
             if (!id.isEmpty())
             {
                 QLinearGradient gradient = parseLinearGradient(element);
-                s_gradients[id] = gradient;
+                context.gradients[id] = gradient;
                 // //qDebug() << "解析线性渐变:" << id;
             }
         }
@@ -3582,7 +3716,7 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
             if (!id.isEmpty())
             {
                 QRadialGradient gradient = parseRadialGradient(element);
-                s_gradients[id] = gradient;
+                context.gradients[id] = gradient;
                 // //qDebug() << "解析径向渐变:" << id;
             }
         }
@@ -3595,9 +3729,9 @@ void SvgHandler::parseDefsElements(const QDomElement &root)
             QString id = markerElement.attribute("id");
             if (!id.isEmpty())
             {
-                s_markers[id] = markerElement;
+                context.markers[id] = markerElement;
                 // 预解析Marker数据
-                s_markerDataCache[id] = parseMarkerData(markerElement);
+                context.markerDataCache[id] = parseMarkerData(markerElement);
                 // 预渲染Marker到缓存
                 renderMarkerToCache(id, markerElement);
                 // //qDebug() << "解析Marker:" << id;
@@ -3803,7 +3937,7 @@ void SvgHandler::parseGradientStops(QGradient *gradient, const QDomElement &elem
 }
 
 // 滤镜解析方法
-void SvgHandler::parseFilterElements(const QDomElement &root)
+void SvgHandler::parseFilterElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -3817,12 +3951,12 @@ void SvgHandler::parseFilterElements(const QDomElement &root)
     // //qDebug() << "解析滤镜元素";
 
     // 清理之前的滤镜定义
-    for (auto it = s_filters.begin(); it != s_filters.end(); ++it)
+    for (auto it = context.filters.begin(); it != context.filters.end(); ++it)
     {
         delete it.value();
     }
-    s_filters.clear();
-    // //qDebug() << "清理了" << s_filters.size() << "个滤镜定义";
+    context.filters.clear();
+    // //qDebug() << "清理了" << context.filters.size() << "个滤镜定义";
 
     // 解析所有滤镜
     QDomNodeList filters = defs.elementsByTagName("filter");
@@ -3866,7 +4000,7 @@ void SvgHandler::parseFilterElements(const QDomElement &root)
             // 使用最后一个效果（Qt会自动处理叠加）
             if (lastEffect)
             {
-                s_filters[id] = lastEffect;
+                context.filters[id] = lastEffect;
             }
         }
     }
@@ -3911,7 +4045,7 @@ QGraphicsDropShadowEffect *SvgHandler::parseDropShadowFilter(const QDomElement &
     return shadow;
 }
 
-void SvgHandler::applyFilterToShape(DrawingShape *shape, const QString &filterId)
+void SvgHandler::applyFilterToShape(SvgImportContext &context, DrawingShape *shape, const QString &filterId)
 {
     if (!shape || filterId.isEmpty())
     {
@@ -3920,9 +4054,9 @@ void SvgHandler::applyFilterToShape(DrawingShape *shape, const QString &filterId
 
     // qDebug() << "应用滤镜到图形:" << filterId;
 
-    if (s_filters.contains(filterId))
+    if (context.filters.contains(filterId))
     {
-        QGraphicsEffect *effect = s_filters[filterId];
+        QGraphicsEffect *effect = context.filters[filterId];
         if (!effect)
         {
             // qDebug() << "滤镜效果为空:" << filterId;
@@ -3961,16 +4095,16 @@ void SvgHandler::applyFilterToShape(DrawingShape *shape, const QString &filterId
     }
 }
 
-void SvgHandler::applyFilterToShape(DrawingGroup *group, const QString &filterId)
+void SvgHandler::applyFilterToShape(SvgImportContext &context, DrawingGroup *group, const QString &filterId)
 {
     if (!group || filterId.isEmpty())
     {
         return;
     }
 
-    if (s_filters.contains(filterId))
+    if (context.filters.contains(filterId))
     {
-        QGraphicsEffect *effect = s_filters[filterId];
+        QGraphicsEffect *effect = context.filters[filterId];
         if (!effect)
         {
             // //qDebug() << "滤镜效果为空:" << filterId;
@@ -4009,7 +4143,7 @@ void SvgHandler::applyFilterToShape(DrawingGroup *group, const QString &filterId
 }
 
 // Pattern解析方法
-void SvgHandler::parsePatternElements(const QDomElement &root)
+void SvgHandler::parsePatternElements(SvgImportContext &context, const QDomElement &root)
 {
     // 查找defs元素
     QDomNodeList defsNodes = root.elementsByTagName("defs");
@@ -4022,9 +4156,6 @@ void SvgHandler::parsePatternElements(const QDomElement &root)
     QDomElement defs = defsNodes.at(0).toElement();
     // //qDebug() << "解析Pattern元素";
 
-    // 清理之前的Pattern定义
-    s_patterns.clear();
-
     // 解析所有Pattern
     QDomNodeList patterns = defs.elementsByTagName("pattern");
     for (int i = 0; i < patterns.size(); ++i)
@@ -4035,7 +4166,7 @@ void SvgHandler::parsePatternElements(const QDomElement &root)
         {
             // 解析Pattern内容
             QBrush patternBrush = parsePatternBrush(patternElement);
-            s_patterns[id] = patternBrush;
+            context.patterns[id] = patternBrush;
             // //qDebug() << "解析Pattern:" << id;
         }
     }
@@ -4146,12 +4277,12 @@ QBrush SvgHandler::parsePatternBrush(const QDomElement &patternElement)
     return patternBrush;
 }
 
-QBrush SvgHandler::parsePatternBrush(const QString &patternId)
+QBrush SvgHandler::parsePatternBrush(SvgImportContext &context, const QString &patternId)
 {
     // 兼容旧接口
-    if (s_patterns.contains(patternId))
+    if (context.patterns.contains(patternId))
     {
-        return s_patterns[patternId];
+        return context.patterns[patternId];
     }
 
     // 返回默认Pattern
@@ -4398,21 +4529,21 @@ void SvgHandler::renderMarkerToCache(const QString &id, const QDomElement &marke
     }
 
     painter.end();
-    // s_markerCache已弃用，使用s_markerDataCache
+    // s_markerCache已弃用，使用markerDataCache
 }
 
 // 创建Marker路径
-QPainterPath SvgHandler::createMarkerPath(const QString &markerId, const QPointF &startPoint, const QPointF &endPoint)
+QPainterPath SvgHandler::createMarkerPath(SvgImportContext &context, const QString &markerId, const QPointF &startPoint, const QPointF &endPoint)
 {
     QPainterPath markerPath;
 
-    if (!s_markers.contains(markerId) || !s_markerDataCache.contains(markerId))
+    if (!context.markers.contains(markerId) || !context.markerDataCache.contains(markerId))
     {
         return markerPath;
     }
 
-    QDomElement markerElement = s_markers[markerId];
-    // QPixmap markerPixmap已弃用，使用s_markerDataCache
+    QDomElement markerElement = context.markers[markerId];
+    // QPixmap markerPixmap已弃用，使用markerDataCache
 
     // 获取Marker属性
     qreal markerWidth = parseLength(markerElement.attribute("markerWidth", "10"));
@@ -4446,7 +4577,7 @@ QPainterPath SvgHandler::createMarkerPath(const QString &markerId, const QPointF
 }
 
 // 应用所有类型的marker
-void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd)
+void SvgHandler::applyMarkers(SvgImportContext &context, DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd)
 {
     if (!path)
     {
@@ -4459,7 +4590,7 @@ void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, con
         QString markerId = SvgUrlParser::parseUrlReference(markerStart);
         if (!markerId.isEmpty())
         {
-            applyMarkerToPath(path, markerId, "start");
+            applyMarkerToPath(context, path, markerId, "start");
         }
     }
 
@@ -4469,7 +4600,7 @@ void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, con
         QString markerId = SvgUrlParser::parseUrlReference(markerEnd);
         if (!markerId.isEmpty())
         {
-            applyMarkerToPath(path, markerId, "end");
+            applyMarkerToPath(context, path, markerId, "end");
         }
     }
 
@@ -4507,9 +4638,9 @@ void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, con
                     qreal avgAngle = (angle1 + angle2) / 2.0;
 
                     // 获取marker数据
-                    if (s_markerDataCache.contains(markerId))
+                    if (context.markerDataCache.contains(markerId))
                     {
-                        MarkerData markerData = s_markerDataCache[markerId];
+                        MarkerData markerData = context.markerDataCache[markerId];
 
                         // 创建Marker变换
                         QTransform transform;
@@ -4527,22 +4658,22 @@ void SvgHandler::applyMarkers(DrawingPath *path, const QString &markerStart, con
             else
             {
                 // 对于简单的路径，使用原来的逻辑
-                applyMarkerToPath(path, markerId, "mid");
+                applyMarkerToPath(context, path, markerId, "mid");
             }
         }
     }
 }
 
-void SvgHandler::applyMarkerToPath(DrawingPath *path, const QString &markerId, const QString &position)
+void SvgHandler::applyMarkerToPath(SvgImportContext &context, DrawingPath *path, const QString &markerId, const QString &position)
 {
     if (!path || markerId.isEmpty())
     {
         return;
     }
 
-    if (s_markerDataCache.contains(markerId))
+    if (context.markerDataCache.contains(markerId))
     {
-        MarkerData markerData = s_markerDataCache[markerId];
+        MarkerData markerData = context.markerDataCache[markerId];
 
         if (!markerData.isValid)
         {
@@ -4654,30 +4785,30 @@ void SvgHandler::applyMarkerToPath(DrawingPath *path, const QString &markerId, c
 }
 
 // 导出辅助函数实现
-QDomElement SvgHandler::exportLayerToSvgElement(QDomDocument &doc, DrawingLayer *layer)
+void SvgHandler::writeLayerToSvg(QXmlStreamWriter &writer, DrawingLayer *layer, const SvgPathWriter::Options &pathOptions)
 {
-    QDomElement gElement = doc.createElement("g");
+    writer.writeStartElement("g");
 
     // 设置图层属性
     if (!layer->name().isEmpty())
     {
-        gElement.setAttribute("id", layer->name());
+        writer.writeAttribute("id", layer->name());
     }
 
     if (layer->opacity() < 1.0)
     {
-        gElement.setAttribute("opacity", QString::number(layer->opacity()));
+        writer.writeAttribute("opacity", QString::number(layer->opacity()));
     }
 
     if (!layer->isVisible())
     {
-        gElement.setAttribute("visibility", "hidden");
+        writer.writeAttribute("visibility", "hidden");
     }
 
     // 导出图层变换
     if (!layer->layerTransform().isIdentity())
     {
-        gElement.setAttribute("transform", transformToString(layer->layerTransform()));
+        writer.writeAttribute("transform", transformToString(layer->layerTransform()));
     }
 
     // 导出图层中的所有形状
@@ -4685,20 +4816,31 @@ QDomElement SvgHandler::exportLayerToSvgElement(QDomDocument &doc, DrawingLayer
     {
         if (shape)
         {
-            QDomElement shapeElement = exportShapeToSvgElement(doc, shape);
-            if (!shapeElement.isNull())
-            {
-                gElement.appendChild(shapeElement);
-            }
+            writeShapeToSvg(writer, shape, pathOptions);
         }
     }
 
-    return gElement;
+    writer.writeEndElement();
 }
 
-void SvgHandler::exportGradientsToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem *> &items)
+void SvgHandler::writeGradientStopsToSvg(QXmlStreamWriter &writer, const QGradientStops &stops)
 {
-    QSet<QString> exportedGradients;
+    for (const QGradientStop &stop : stops)
+    {
+        writer.writeStartElement("stop");
+        writer.writeAttribute("offset", QString::number(stop.first));
+        writer.writeAttribute("stop-color", stop.second.name());
+        if (stop.second.alphaF() < 1.0)
+        {
+            writer.writeAttribute("stop-opacity", QString::number(stop.second.alphaF()));
+        }
+        writer.writeEndElement();
+    }
+}
+
+void SvgHandler::writeGradientsToSvg(QXmlStreamWriter &writer, const QList<QGraphicsItem *> &items)
+{
+    QSet<quintptr> exportedGradients;
 
     // 收集所有使用的渐变
     for (QGraphicsItem *item : items)
@@ -4710,67 +4852,47 @@ void SvgHandler::exportGradientsToSvg(QDomDocument &doc, QDomElement &defsElemen
             if (brush.style() == Qt::LinearGradientPattern)
             {
                 const QLinearGradient *gradient = static_cast<const QLinearGradient *>(brush.gradient());
-                if (gradient && !exportedGradients.contains(QString::number(quintptr(gradient))))
+                if (gradient && !exportedGradients.contains(quintptr(gradient)))
                 {
-                    QDomElement gradElement = doc.createElement("linearGradient");
-                    gradElement.setAttribute("id", QString("grad_%1").arg(exportedGradients.size()));
-                    gradElement.setAttribute("x1", QString::number(gradient->start().x()));
-                    gradElement.setAttribute("y1", QString::number(gradient->start().y()));
-                    gradElement.setAttribute("x2", QString::number(gradient->finalStop().x()));
-                    gradElement.setAttribute("y2", QString::number(gradient->finalStop().y()));
+                    writer.writeStartElement("linearGradient");
+                    writer.writeAttribute("id", QString("grad_%1").arg(exportedGradients.size()));
+                    writer.writeAttribute("x1", QString::number(gradient->start().x()));
+                    writer.writeAttribute("y1", QString::number(gradient->start().y()));
+                    writer.writeAttribute("x2", QString::number(gradient->finalStop().x()));
+                    writer.writeAttribute("y2", QString::number(gradient->finalStop().y()));
 
                     // 导出停止点
-                    for (const QGradientStop &stop : gradient->stops())
-                    {
-                        QDomElement stopElement = doc.createElement("stop");
-                        stopElement.setAttribute("offset", QString::number(stop.first));
-                        stopElement.setAttribute("stop-color", stop.second.name());
-                        if (stop.second.alphaF() < 1.0)
-                        {
-                            stopElement.setAttribute("stop-opacity", QString::number(stop.second.alphaF()));
-                        }
-                        gradElement.appendChild(stopElement);
-                    }
+                    writeGradientStopsToSvg(writer, gradient->stops());
 
-                    defsElement.appendChild(gradElement);
-                    exportedGradients.insert(QString::number(quintptr(gradient)));
+                    writer.writeEndElement();
+                    exportedGradients.insert(quintptr(gradient));
                 }
             }
             else if (brush.style() == Qt::RadialGradientPattern)
             {
                 const QRadialGradient *gradient = static_cast<const QRadialGradient *>(brush.gradient());
-                if (gradient && !exportedGradients.contains(QString::number(quintptr(gradient))))
+                if (gradient && !exportedGradients.contains(quintptr(gradient)))
                 {
-                    QDomElement gradElement = doc.createElement("radialGradient");
-                    gradElement.setAttribute("id", QString("radial_%1").arg(exportedGradients.size()));
-                    gradElement.setAttribute("cx", QString::number(gradient->center().x()));
-                    gradElement.setAttribute("cy", QString::number(gradient->center().y()));
-                    gradElement.setAttribute("r", QString::number(gradient->radius()));
-                    gradElement.setAttribute("fx", QString::number(gradient->focalPoint().x()));
-                    gradElement.setAttribute("fy", QString::number(gradient->focalPoint().y()));
+                    writer.writeStartElement("radialGradient");
+                    writer.writeAttribute("id", QString("radial_%1").arg(exportedGradients.size()));
+                    writer.writeAttribute("cx", QString::number(gradient->center().x()));
+                    writer.writeAttribute("cy", QString::number(gradient->center().y()));
+                    writer.writeAttribute("r", QString::number(gradient->radius()));
+                    writer.writeAttribute("fx", QString::number(gradient->focalPoint().x()));
+                    writer.writeAttribute("fy", QString::number(gradient->focalPoint().y()));
 
                     // 导出停止点
-                    for (const QGradientStop &stop : gradient->stops())
-                    {
-                        QDomElement stopElement = doc.createElement("stop");
-                        stopElement.setAttribute("offset", QString::number(stop.first));
-                        stopElement.setAttribute("stop-color", stop.second.name());
-                        if (stop.second.alphaF() < 1.0)
-                        {
-                            stopElement.setAttribute("stop-opacity", QString::number(stop.second.alphaF()));
-                        }
-                        gradElement.appendChild(stopElement);
-                    }
+                    writeGradientStopsToSvg(writer, gradient->stops());
 
-                    defsElement.appendChild(gradElement);
-                    exportedGradients.insert(QString::number(quintptr(gradient)));
+                    writer.writeEndElement();
+                    exportedGradients.insert(quintptr(gradient));
                 }
             }
         }
     }
 }
 
-void SvgHandler::exportFiltersToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem *> &items)
+void SvgHandler::writeFiltersToSvg(QXmlStreamWriter &writer, const QList<QGraphicsItem *> &items)
 {
     QSet<QString> exportedFilters;
 
@@ -4788,18 +4910,18 @@ void SvgHandler::exportFiltersToSvg(QDomDocument &doc, QDomElement &defsElement,
                     QString filterId = QString("blur_%1").arg(exportedFilters.size());
                     if (!exportedFilters.contains(filterId))
                     {
-                        QDomElement filterElement = doc.createElement("filter");
-                        filterElement.setAttribute("id", filterId);
-                        filterElement.setAttribute("x", "-50%");
-                        filterElement.setAttribute("y", "-50%");
-                        filterElement.setAttribute("width", "200%");
-                        filterElement.setAttribute("height", "200%");
-
-                        QDomElement blurElement = doc.createElement("feGaussianBlur");
-                        blurElement.setAttribute("stdDeviation", QString::number(blurEffect->blurRadius()));
-
-                        filterElement.appendChild(blurElement);
-                        defsElement.appendChild(filterElement);
+                        writer.writeStartElement("filter");
+                        writer.writeAttribute("id", filterId);
+                        writer.writeAttribute("x", "-50%");
+                        writer.writeAttribute("y", "-50%");
+                        writer.writeAttribute("width", "200%");
+                        writer.writeAttribute("height", "200%");
+
+                        writer.writeStartElement("feGaussianBlur");
+                        writer.writeAttribute("stdDeviation", QString::number(blurEffect->blurRadius()));
+                        writer.writeEndElement();
+
+                        writer.writeEndElement();
                         exportedFilters.insert(filterId);
                     }
                 }
@@ -4808,21 +4930,21 @@ void SvgHandler::exportFiltersToSvg(QDomDocument &doc, QDomElement &defsElement,
                     QString filterId = QString("shadow_%1").arg(exportedFilters.size());
                     if (!exportedFilters.contains(filterId))
                     {
-                        QDomElement filterElement = doc.createElement("filter");
-                        filterElement.setAttribute("id", filterId);
-                        filterElement.setAttribute("x", "-50%");
-                        filterElement.setAttribute("y", "-50%");
-                        filterElement.setAttribute("width", "200%");
-                        filterElement.setAttribute("height", "200%");
-
-                        QDomElement shadowElement = doc.createElement("feDropShadow");
-                        shadowElement.setAttribute("dx", QString::number(shadowEffect->offset().x()));
-                        shadowElement.setAttribute("dy", QString::number(shadowEffect->offset().y()));
-                        shadowElement.setAttribute("stdDeviation", QString::number(shadowEffect->blurRadius()));
-                        shadowElement.setAttribute("flood-color", shadowEffect->color().name());
-
-                        filterElement.appendChild(shadowElement);
-                        defsElement.appendChild(filterElement);
+                        writer.writeStartElement("filter");
+                        writer.writeAttribute("id", filterId);
+                        writer.writeAttribute("x", "-50%");
+                        writer.writeAttribute("y", "-50%");
+                        writer.writeAttribute("width", "200%");
+                        writer.writeAttribute("height", "200%");
+
+                        writer.writeStartElement("feDropShadow");
+                        writer.writeAttribute("dx", QString::number(shadowEffect->offset().x()));
+                        writer.writeAttribute("dy", QString::number(shadowEffect->offset().y()));
+                        writer.writeAttribute("stdDeviation", QString::number(shadowEffect->blurRadius()));
+                        writer.writeAttribute("flood-color", shadowEffect->color().name());
+                        writer.writeEndElement();
+
+                        writer.writeEndElement();
                         exportedFilters.insert(filterId);
                     }
                 }
@@ -4848,49 +4970,46 @@ QString SvgHandler::transformToString(const QTransform &transform)
         .arg(transform.dy());
 }
 
-QDomElement SvgHandler::exportTextToSvgElement(QDomDocument &doc, DrawingText *text)
+void SvgHandler::writeTextToSvg(QXmlStreamWriter &writer, DrawingText *text)
 {
-    QDomElement textElement = doc.createElement("text");
+    writer.writeStartElement("text");
 
     // 导出ID
     QString id = text->id();
     if (!id.isEmpty())
     {
-        textElement.setAttribute("id", id);
+        writer.writeAttribute("id", id);
     }
 
-    // 设置文本内容
-    textElement.appendChild(doc.createTextNode(text->text()));
-
     // 设置位置
     QPointF pos = text->position();
-    textElement.setAttribute("x", QString::number(pos.x()));
-    textElement.setAttribute("y", QString::number(pos.y()));
+    writer.writeAttribute("x", QString::number(pos.x()));
+    writer.writeAttribute("y", QString::number(pos.y()));
 
     // 导出字体属性
     QFont font = text->font();
     if (!font.family().isEmpty())
     {
-        textElement.setAttribute("font-family", font.family());
+        writer.writeAttribute("font-family", font.family());
     }
     if (font.pointSizeF() > 0)
     {
-        textElement.setAttribute("font-size", QString::number(font.pointSizeF()));
+        writer.writeAttribute("font-size", QString::number(font.pointSizeF()));
     }
     if (font.bold())
     {
-        textElement.setAttribute("font-weight", "bold");
+        writer.writeAttribute("font-weight", "bold");
     }
     if (font.italic())
     {
-        textElement.setAttribute("font-style", "italic");
+        writer.writeAttribute("font-style", "italic");
     }
 
     // 导出变换
     QTransform transform = text->transform();
     if (!transform.isIdentity())
     {
-        textElement.setAttribute("transform", transformToString(transform));
+        writer.writeAttribute("transform", transformToString(transform));
     }
 
     // 导出样式
@@ -4899,58 +5018,50 @@ QDomElement SvgHandler::exportTextToSvgElement(QDomDocument &doc, DrawingText *t
 
     if (pen.style() != Qt::NoPen)
     {
-        textElement.setAttribute("stroke", pen.color().name());
-        textElement.setAttribute("stroke-width", QString::number(pen.widthF()));
+        writer.writeAttribute("stroke", pen.color().name());
+        writer.writeAttribute("stroke-width", QString::number(pen.widthF()));
         if (pen.color().alphaF() < 1.0)
         {
-            textElement.setAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
+            writer.writeAttribute("stroke-opacity", QString::number(pen.color().alphaF()));
         }
     }
 
     if (brush.style() != Qt::NoBrush)
     {
-        textElement.setAttribute("fill", brush.color().name());
+        writer.writeAttribute("fill", brush.color().name());
         if (brush.color().alphaF() < 1.0)
         {
-            textElement.setAttribute("fill-opacity", QString::number(brush.color().alphaF()));
+            writer.writeAttribute("fill-opacity", QString::number(brush.color().alphaF()));
         }
     }
     else
     {
-        textElement.setAttribute("fill", "black"); // 默认文本颜色
+        writer.writeAttribute("fill", "black"); // 默认文本颜色
     }
 
     // 导出滤镜
-    QGraphicsEffect *effect = text->graphicsEffect();
-    if (effect)
-    {
-        if (qobject_cast<QGraphicsBlurEffect *>(effect))
-        {
-            textElement.setAttribute("filter", QString("url(#blur_0)"));
-        }
-        else if (qobject_cast<QGraphicsDropShadowEffect *>(effect))
-        {
-            textElement.setAttribute("filter", QString("url(#shadow_0)"));
-        }
-    }
+    writeFilterReference(writer, text->graphicsEffect());
 
-    return textElement;
+    // 设置文本内容（属性必须在内容之前写出）
+    writer.writeCharacters(text->text());
+
+    writer.writeEndElement();
 }
 
-QDomElement SvgHandler::exportLineToSvgElement(QDomDocument &doc, DrawingLine *line)
+void SvgHandler::writeLineToSvg(QXmlStreamWriter &writer, DrawingLine *line)
 {
     if (!line)
     {
-        return QDomElement();
+        return;
     }
 
-    QDomElement lineElement = doc.createElement("line");
+    writer.writeStartElement("line");
 
     // 导出ID
     QString id = line->id();
     if (!id.isEmpty())
     {
-        lineElement.setAttribute("id", id);
+        writer.writeAttribute("id", id);
     }
 
     // 获取线条的位置和线条本身
@@ -4958,134 +5069,127 @@ QDomElement SvgHandler::exportLineToSvgElement(QDomDocument &doc, DrawingLine *l
     QLineF l = line->line();
 
     // 计算实际位置（位置 + 线条坐标）
-    lineElement.setAttribute("x1", QString::number(pos.x() + l.x1()));
-    lineElement.setAttribute("y1", QString::number(pos.y() + l.y1()));
-    lineElement.setAttribute("x2", QString::number(pos.x() + l.x2()));
-    lineElement.setAttribute("y2", QString::number(pos.y() + l.y2()));
+    writer.writeAttribute("x1", QString::number(pos.x() + l.x1()));
+    writer.writeAttribute("y1", QString::number(pos.y() + l.y1()));
+    writer.writeAttribute("x2", QString::number(pos.x() + l.x2()));
+    writer.writeAttribute("y2", QString::number(pos.y() + l.y2()));
 
     // 导出样式
     if (line->strokePen() != Qt::NoPen)
     {
-        lineElement.setAttribute("stroke", line->strokePen().color().name());
-        lineElement.setAttribute("stroke-width", QString::number(line->strokePen().widthF()));
+        writer.writeAttribute("stroke", line->strokePen().color().name());
+        writer.writeAttribute("stroke-width", QString::number(line->strokePen().widthF()));
     }
 
     if (line->fillBrush() != Qt::NoBrush)
     {
-        lineElement.setAttribute("fill", line->fillBrush().color().name());
+        writer.writeAttribute("fill", line->fillBrush().color().name());
     }
     else
     {
-        lineElement.setAttribute("fill", "none");
+        writer.writeAttribute("fill", "none");
     }
 
-    return lineElement;
+    writer.writeEndElement();
+}
+
+QString SvgHandler::pointsToString(const QPointF &offset, const QVector<QPointF> &points)
+{
+    // 计算实际位置（位置 + 点坐标），点之间以空格分隔
+    QString pointsStr;
+    pointsStr.reserve(points.size() * 16);
+    for (int i = 0; i < points.size(); ++i)
+    {
+        const QPointF &p = points[i];
+        pointsStr += QString::number(offset.x() + p.x());
+        pointsStr += QLatin1Char(',');
+        pointsStr += QString::number(offset.y() + p.y());
+        if (i < points.size() - 1)
+        {
+            pointsStr += QLatin1Char(' ');
+        }
+    }
+    return pointsStr;
 }
 
-QDomElement SvgHandler::exportPolylineToSvgElement(QDomDocument &doc, DrawingPolyline *polyline)
+void SvgHandler::writePolylineToSvg(QXmlStreamWriter &writer, DrawingPolyline *polyline)
 {
     if (!polyline)
     {
-        return QDomElement();
+        return;
     }
 
-    QDomElement polylineElement = doc.createElement("polyline");
+    writer.writeStartElement("polyline");
 
     // 导出ID
     QString id = polyline->id();
     if (!id.isEmpty())
     {
-        polylineElement.setAttribute("id", id);
+        writer.writeAttribute("id", id);
     }
 
     // 构建点字符串
-    QString pointsStr;
-    QPointF pos = polyline->pos();
-    QVector<QPointF> points = polyline->getNodePoints();
-    for (int i = 0; i < points.size(); ++i)
-    {
-        const QPointF &p = points[i];
-        // 计算实际位置（位置 + 点坐标）
-        pointsStr += QString("%1,%2").arg(pos.x() + p.x()).arg(pos.y() + p.y());
-        if (i < points.size() - 1)
-        {
-            pointsStr += " ";
-        }
-    }
-    polylineElement.setAttribute("points", pointsStr);
+    writer.writeAttribute("points", pointsToString(polyline->pos(), polyline->getNodePoints()));
 
     // 导出样式
     if (polyline->strokePen() != Qt::NoPen)
     {
-        polylineElement.setAttribute("stroke", polyline->strokePen().color().name());
-        polylineElement.setAttribute("stroke-width", QString::number(polyline->strokePen().widthF()));
+        writer.writeAttribute("stroke", polyline->strokePen().color().name());
+        writer.writeAttribute("stroke-width", QString::number(polyline->strokePen().widthF()));
     }
 
     if (polyline->fillBrush() != Qt::NoBrush)
     {
-        polylineElement.setAttribute("fill", polyline->fillBrush().color().name());
+        writer.writeAttribute("fill", polyline->fillBrush().color().name());
     }
     else
     {
-        polylineElement.setAttribute("fill", "none");
+        writer.writeAttribute("fill", "none");
     }
 
-    return polylineElement;
+    writer.writeEndElement();
 }
 
-QDomElement SvgHandler::exportPolygonToSvgElement(QDomDocument &doc, DrawingPolygon *polygon)
+void SvgHandler::writePolygonToSvg(QXmlStreamWriter &writer, DrawingPolygon *polygon)
 {
     if (!polygon)
     {
-        return QDomElement();
+        return;
     }
 
-    QDomElement polygonElement = doc.createElement("polygon");
+    writer.writeStartElement("polygon");
 
     // 导出ID
     QString id = polygon->id();
     if (!id.isEmpty())
     {
-        polygonElement.setAttribute("id", id);
+        writer.writeAttribute("id", id);
     }
 
     // 构建点字符串
-    QString pointsStr;
-    QPointF pos = polygon->pos();
-    QVector<QPointF> points = polygon->getNodePoints();
-    for (int i = 0; i < points.size(); ++i)
-    {
-        const QPointF &p = points[i];
-        // 计算实际位置（位置 + 点坐标）
-        pointsStr += QString("%1,%2").arg(pos.x() + p.x()).arg(pos.y() + p.y());
-        if (i < points.size() - 1)
-        {
-            pointsStr += " ";
-        }
-    }
-    polygonElement.setAttribute("points", pointsStr);
+    writer.writeAttribute("points", pointsToString(polygon->pos(), polygon->getNodePoints()));
 
     // 导出样式
     if (polygon->strokePen() != Qt::NoPen)
     {
-        polygonElement.setAttribute("stroke", polygon->strokePen().color().name());
-        polygonElement.setAttribute("stroke-width", QString::number(polygon->strokePen().widthF()));
+        writer.writeAttribute("stroke", polygon->strokePen().color().name());
+        writer.writeAttribute("stroke-width", QString::number(polygon->strokePen().widthF()));
     }
 
     if (polygon->fillBrush() != Qt::NoBrush)
     {
-        polygonElement.setAttribute("fill", polygon->fillBrush().color().name());
+        writer.writeAttribute("fill", polygon->fillBrush().color().name());
     }
     else
     {
-        polygonElement.setAttribute("fill", "none");
+        writer.writeAttribute("fill", "none");
     }
 
-    return polygonElement;
+    writer.writeEndElement();
 }
 
 // 收集所有有id的元素（用于use元素）
-void SvgHandler::collectDefinedElements(const QDomElement &parent)
+void SvgHandler::collectDefinedElements(SvgImportContext &context, const QDomElement &parent)
 {
     QDomNodeList children = parent.childNodes();
     for (int i = 0; i < children.size(); ++i)
@@ -5105,21 +5209,21 @@ void SvgHandler::collectDefinedElements(const QDomElement &parent)
                 // 移除transform属性，避免在use元素中重复处理变换
                 clonedElement.removeAttribute("transform");
 
-                s_definedElements[id] = clonedElement;
+                context.definedElements[id] = clonedElement;
                 // qDebug() << "存储定义元素:" << id << "移除transform属性:" << !clonedElement.hasAttribute("transform");
             }
 
             // 递归处理子元素
             if (tagName == "defs" || tagName == "g")
             {
-                collectDefinedElements(element);
+                collectDefinedElements(context, element);
             }
         }
     }
 }
 
 // 解析use元素
-DrawingShape *SvgHandler::parseUseElement(const QDomElement &element)
+DrawingShape *SvgHandler::parseUseElement(SvgImportContext &context, const QDomElement &element)
 {
     // qDebug() << "解析use元素";
 
@@ -5141,13 +5245,13 @@ DrawingShape *SvgHandler::parseUseElement(const QDomElement &element)
     // qDebug() << "use元素引用ID:" << refId;
 
     // 查找定义的元素
-    if (!s_definedElements.contains(refId))
+    if (!context.definedElements.contains(refId))
     {
         // qDebug() << "未找到引用的元素:" << refId;
         return nullptr;
     }
 
-    QDomElement referencedElement = s_definedElements[refId];
+    QDomElement referencedElement = context.definedElements[refId];
     // qDebug() << "找到引用元素:" << referencedElement.tagName();
     // qDebug() << "引用元素是否有transform:" << referencedElement.hasAttribute("transform");
     if (referencedElement.hasAttribute("transform"))
@@ -5156,7 +5260,7 @@ DrawingShape *SvgHandler::parseUseElement(const QDomElement &element)
     }
 
     // 克隆并解析引用的元素
-    DrawingShape *shape = parseSvgElement(referencedElement);
+    DrawingShape *shape = parseSvgElement(context, referencedElement);
     if (!shape)
     {
         // qDebug() << "解析引用元素失败";
@@ -5186,7 +5290,7 @@ DrawingShape *SvgHandler::parseUseElement(const QDomElement &element)
 
     // 解析样式属性：use元素的样式会覆盖引用元素的样式
     // 但如果use元素没有某个样式属性，应该继承引用元素的样式
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
 
     // 如果use元素没有fill属性，继承引用元素的fill
     if (!element.hasAttribute("fill") && referencedElement.hasAttribute("fill"))
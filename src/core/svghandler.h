@@ -16,7 +16,9 @@
 #include <QGraphicsDropShadowEffect>
 #include <QHash>
 #include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include "svgelementcollector.h"
+#include "svgpathwriter.h"
 
 // 前向声明
 struct MarkerData;
@@ -41,14 +43,7 @@ private:
 
 
 
-// 全局存储 - 声明为extern以便其他文件访问
-extern QHash<QString, QGradient> s_gradients;
-extern QHash<QString, QGraphicsEffect *> s_filters;
-extern QHash<QString, QBrush> s_patterns;
-extern QHash<QString, QDomElement> s_markers;
-extern QHash<QString, MarkerData> s_markerDataCache;
-extern QHash<QString, QDomElement> s_definedElements;
-
+class SvgImportContext;
 class DrawingScene;
 class DrawingShape;
 class DrawingPath;
@@ -77,6 +72,34 @@ struct SvgMetadata {
     SvgMetadata() : hasViewBox(false), hasSize(false) {}
 };
 
+/**
+ * 预解析的图形数据 - 在工作线程中由属性字符串解析得到的纯值结构
+ * GUI线程只需用它实例化图形项，不再重复解析路径、变换和颜色
+ */
+struct SvgPreparsedShape {
+    QPainterPath path;                                  // 解析后的几何路径
+    QVector<QPointF> controlPoints;                     // 节点编辑用的控制点
+    QVector<QPainterPath::ElementType> controlPointTypes;
+    QTransform transform;                               // 解析后的transform属性
+    bool hasTransform;                                  // 是否需要应用transform
+    QColor strokeColor;                                 // 解析后的stroke颜色（无或引用时无效）
+    QColor fillColor;                                   // 解析后的fill颜色（无或引用时无效）
+    
+    SvgPreparsedShape() : hasTransform(false) {}
+};
+
+/**
+ * 预解析任务 - GUI线程从源文件中提取的属性字符串（QDom与QXmlStreamReader都不是线程安全的）
+ */
+struct SvgPreparseJob {
+    quint64 key;                    // 元素在源文件中的行列号，见SvgHandler::preparseKey
+    QString tagName;
+    QString data;                   // path的d属性或polyline/polygon的points属性
+    QString transform;
+    QString stroke;
+    QString fill;
+};
+
 /**
  * SVG处理类 - 负责导入和导出SVG文件
  */
@@ -86,19 +109,21 @@ public:
     // 从SVG文件导入
     static bool importFromSvg(DrawingScene *scene, const QString &fileName);
     
-    // 导出到SVG文件
-    static bool exportToSvg(DrawingScene *scene, const QString &fileName);
+    // 导出到SVG文件，pathOptions控制路径数据的精度和压缩方式
+    static bool exportToSvg(DrawingScene *scene, const QString &fileName,
+                            const SvgPathWriter::Options &pathOptions = SvgPathWriter::Options());
     
     // 公共的解析函数，供SvgStreamHandler使用
-    static DrawingPath* parsePathElement(const QDomElement &element);
-    static DrawingRectangle* parseRectElement(const QDomElement &element);
-    static DrawingEllipse* parseEllipseElement(const QDomElement &element);
-    static DrawingEllipse* parseCircleElement(const QDomElement &element);
-    static DrawingPath* parseLineElement(const QDomElement &element);
-    static DrawingPath* parsePolygonElement(const QDomElement &element);
-    static DrawingText* parseTextElement(const QDomElement &element);
-    static DrawingGroup* parseGroupElement(DrawingScene *scene, const QDomElement &groupElement);
-    static DrawingShape* parseUseElement(const QDomElement &element);
+    static DrawingShape* parseSvgElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingPath* parsePathElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingRectangle* parseRectElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingEllipse* parseEllipseElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingEllipse* parseCircleElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingPath* parseLineElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingPath* parsePolygonElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingText* parseTextElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingGroup* parseGroupElement(SvgImportContext &context, DrawingScene *scene, const QDomElement &groupElement);
+    static DrawingShape* parseUseElement(SvgImportContext &context, const QDomElement &element);
     
     // 调整use元素的变换，考虑位置偏移
     static QString adjustTransformForUseElement(const QString &transformStr, qreal x, qreal y);
@@ -115,7 +140,8 @@ public:
     static qreal parseLength(const QString &lengthStr);
     static void parseSvgPointsData(const QString &pointsStr, QPainterPath &path, bool closePath = true);
     static void parseSvgPathData(const QString &data, QPainterPath &path);
-    static void applyMarkers(DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd);
+    static QTransform parseTransform(const QString &transformStr);
+    static void applyMarkers(SvgImportContext &context, DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd);
     
 private:
     // 解析SVG元数据
@@ -135,39 +161,35 @@ private:
 
 private:
     // 解析SVG文档
-    static bool parseSvgDocument(DrawingScene *scene, const QDomDocument &doc);
+    static bool parseSvgDocument(SvgImportContext &context, DrawingScene *scene, const QDomDocument &doc);
     
     // 从流式解析的元素解析SVG文档
-    static bool parseSvgDocumentFromElement(DrawingScene *scene, const SvgStreamElement &rootElement);
-    
-    // 解析SVG元素
-    static DrawingShape* parseSvgElement(const QDomElement &element);
+    static bool parseSvgDocumentFromElement(SvgImportContext &context, DrawingScene *scene, const SvgStreamElement &rootElement);
     
     // 收集所有有id的元素（用于use元素）
-    static void collectDefinedElements(const QDomElement &parent);
+    static void collectDefinedElements(SvgImportContext &context, const QDomElement &parent);
     
     // 解析变换字符串为QTransform
-    static QTransform parseTransform(const QString &transformStr);
     static QTransform parseAdjustedTransform(const QString &transformStr, const QPointF &shapePos);
     
     // 应用样式到图形
     static void applyStyleToShape(DrawingShape *shape, const QString &style);
     
     // 解析 Inkscape sodipodi:arc 元素
-    static DrawingEllipse* parseSodipodiArcElement(const QDomElement &element);
+    static DrawingEllipse* parseSodipodiArcElement(SvgImportContext &context, const QDomElement &element);
     
     // 流式解析相关函数
-    static DrawingShape* parseSvgElementFromStream(const SvgStreamElement &element);
-    static DrawingPath* parsePathElementFromStream(const SvgStreamElement &element);
-    static DrawingRectangle* parseRectElementFromStream(const SvgStreamElement &element);
-    static DrawingEllipse* parseCircleElementFromStream(const SvgStreamElement &element);
-    static DrawingEllipse* parseEllipseElementFromStream(const SvgStreamElement &element);
-    static DrawingPath* parseLineElementFromStream(const SvgStreamElement &element);
-    static DrawingPath* parsePolygonElementFromStream(const SvgStreamElement &element);
-    static DrawingText* parseTextElementFromStream(const SvgStreamElement &element);
-    static DrawingGroup* parseGroupElementFromStream(const SvgStreamElement &element);
-    static DrawingShape* parseUseElementFromStream(const SvgStreamElement &element);
-    static void parseStyleAttributesFromStream(DrawingShape *shape, const SvgStreamElement &element);
+    static DrawingShape* parseSvgElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingPath* parsePathElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingRectangle* parseRectElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingEllipse* parseCircleElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingEllipse* parseEllipseElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingPath* parseLineElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingPath* parsePolygonElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingText* parseTextElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingGroup* parseGroupElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static DrawingShape* parseUseElementFromStream(SvgImportContext &context, const SvgStreamElement &element);
+    static void parseStyleAttributesFromStream(SvgImportContext &context, DrawingShape *shape, const SvgStreamElement &element);
     
     // 流式解析辅助函数
     static SvgElementCollector::CollectedElements collectElementsFromStream(const SvgStreamElement &rootElement);
@@ -182,73 +204,89 @@ private:
     static QString collectTextContent(const QDomElement &element);
     
     // 解析简单文本元素（不含tspan）
-    static DrawingText* parseSimpleTextElement(const QDomElement &element);
+    static DrawingText* parseSimpleTextElement(SvgImportContext &context, const QDomElement &element);
     
     // 解析包含tspan的文本元素
-    static DrawingText* parseTextElementWithTspan(const QDomElement &element);
+    static DrawingText* parseTextElementWithTspan(SvgImportContext &context, const QDomElement &element);
     
     // 解析组元素（现在支持图层）
     static DrawingLayer* parseLayerElement(const QDomElement &element);
     
-    // 解析样式属性
-    static void parseStyleAttributes(DrawingShape *shape, const QDomElement &element);
-    static void parseStyleAttributes(DrawingGroup *group, const QDomElement &element);
+    // 解析样式属性，preparsed不为空时直接使用预解析的颜色
+    static void parseStyleAttributes(SvgImportContext &context, DrawingShape *shape, const QDomElement &element,
+                                     const SvgPreparsedShape *preparsed = nullptr);
+    static void parseStyleAttributes(SvgImportContext &context, DrawingGroup *group, const QDomElement &element);
+    
+    // 两阶段导入：在线程池中预解析路径、点、变换和颜色，GUI线程只负责创建图形项
+    static QHash<quint64, SvgPreparsedShape> preparseShapes(const QDomElement &root);
+    // 在线程池中执行预解析任务，任务太少时返回空表，由调用方串行解析
+    static QHash<quint64, SvgPreparsedShape> preparseJobs(const QVector<SvgPreparseJob> &jobs);
+    static SvgPreparsedShape preparseShape(const QString &tagName, const QString &data,
+                                           const QString &transform, const QString &stroke,
+                                           const QString &fill);
+    static quint64 preparseKey(const QDomElement &element);
+    static quint64 preparseKey(qint64 line, qint64 column);
+    static const SvgPreparsedShape *findPreparsedShape(SvgImportContext &context, const QDomElement &element);
     
     // 解析变换属性
     static void parseTransformAttribute(DrawingShape *shape, const QString &transformStr);
     
     
     // 解析defs元素中的渐变定义
-    static void parseDefsElements(const QDomElement &root);
+    static void parseDefsElements(SvgImportContext &context, const QDomElement &root);
     
     // 解析渐变停止点
     static void parseGradientStops(QGradient *gradient, const QDomElement &element);
     
     // 解析滤镜效果
-    static void parseFilterElements(const QDomElement &root);
-    static void applyFilterToShape(DrawingShape *shape, const QString &filterId);
-    static void applyFilterToShape(DrawingGroup *group, const QString &filterId);
+    static void parseFilterElements(SvgImportContext &context, const QDomElement &root);
+    static void applyFilterToShape(SvgImportContext &context, DrawingShape *shape, const QString &filterId);
+    static void applyFilterToShape(SvgImportContext &context, DrawingGroup *group, const QString &filterId);
     
     // 解析Pattern
-    static void parsePatternElements(const QDomElement &root);
-    static QBrush parsePatternBrush(const QString &patternId);
+    static void parsePatternElements(SvgImportContext &context, const QDomElement &root);
+    static QBrush parsePatternBrush(SvgImportContext &context, const QString &patternId);
     
     // 解析Marker
     static void renderMarkerToCache(const QString &id, const QDomElement &markerElement);
-    static QPainterPath createMarkerPath(const QString &markerId, const QPointF &startPoint, const QPointF &endPoint);
+    static QPainterPath createMarkerPath(SvgImportContext &context, const QString &markerId, const QPointF &startPoint, const QPointF &endPoint);
     // 应用Marker到路径
-    static void applyMarkerToPath(DrawingPath *path, const QString &markerId, const QString &position = "end");
+    static void applyMarkerToPath(SvgImportContext &context, DrawingPath *path, const QString &markerId, const QString &position = "end");
     
     // 导出场景到SVG文档
     static QDomDocument exportSceneToSvgDocument(DrawingScene *scene);
     
-    // 导出形状到SVG元素
-    static QDomElement exportShapeToSvgElement(QDomDocument &doc, DrawingShape *shape);
+    // 流式写出整个场景，exportToSvg和exportSceneToSvgDocument共用
+    static void writeSceneToSvg(QXmlStreamWriter &writer, DrawingScene *scene, const SvgPathWriter::Options &pathOptions);
+    
+    // 写出形状对应的SVG元素
+    static void writeShapeToSvg(QXmlStreamWriter &writer, DrawingShape *shape, const SvgPathWriter::Options &pathOptions);
     
-    // 导出路径到SVG路径元素
-    static QDomElement exportPathToSvgElement(QDomDocument &doc, DrawingPath *path);
+    // 写出路径元素
+    static void writePathToSvg(QXmlStreamWriter &writer, DrawingPath *path, const SvgPathWriter::Options &pathOptions);
     
-    // 导出矩形到SVG矩形元素
-    static QDomElement exportRectangleToSvgElement(QDomDocument &doc, DrawingRectangle *rect);
+    // 写出矩形元素
+    static void writeRectangleToSvg(QXmlStreamWriter &writer, DrawingRectangle *rect);
     
-    // 导出椭圆到SVG椭圆元素
-    static QDomElement exportEllipseToSvgElement(QDomDocument &doc, DrawingEllipse *ellipse);
+    // 写出椭圆元素（非完整椭圆写为弧路径）
+    static void writeEllipseToSvg(QXmlStreamWriter &writer, DrawingEllipse *ellipse);
     
-    // 导出文本到SVG文本元素
-    static QDomElement exportTextToSvgElement(QDomDocument &doc, DrawingText *text);
+    // 写出文本元素
+    static void writeTextToSvg(QXmlStreamWriter &writer, DrawingText *text);
     
-    // 导出线条到SVG线条元素
-    static QDomElement exportLineToSvgElement(QDomDocument &doc, DrawingLine *line);
+    // 写出线条元素
+    static void writeLineToSvg(QXmlStreamWriter &writer, DrawingLine *line);
     
-    // 导出折线到SVG折线元素
-    static QDomElement exportPolylineToSvgElement(QDomDocument &doc, DrawingPolyline *polyline);
+    // 写出折线元素
+    static void writePolylineToSvg(QXmlStreamWriter &writer, DrawingPolyline *polyline);
     
-    // 导出多边形到SVG多边形元素
-    static QDomElement exportPolygonToSvgElement(QDomDocument &doc, DrawingPolygon *polygon);
+    // 写出多边形元素
+    static void writePolygonToSvg(QXmlStreamWriter &writer, DrawingPolygon *polygon);
     
     // 辅助函数
-    static QString pathDataToString(const QPainterPath &path);
-    static void parseGroupElement(const QDomElement &groupElement);
+    static QString pathDataToString(const QPainterPath &path,
+                                    const SvgPathWriter::Options &options = SvgPathWriter::Options());
+    static void parseGroupElement(SvgImportContext &context, const QDomElement &groupElement);
     
     // 椭圆弧转换函数
     static void convertEllipticalArcToBezier(QPainterPath &path, const QPointF &start, const QPointF &end, 
@@ -256,9 +294,12 @@ private:
                                            bool largeArcFlag, bool sweepFlag);
     
     // 导出辅助函数
-    static QDomElement exportLayerToSvgElement(QDomDocument &doc, DrawingLayer *layer);
-    static void exportGradientsToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem*> &items);
-    static void exportFiltersToSvg(QDomDocument &doc, QDomElement &defsElement, const QList<QGraphicsItem*> &items);
+    static void writeLayerToSvg(QXmlStreamWriter &writer, DrawingLayer *layer, const SvgPathWriter::Options &pathOptions);
+    static void writeGradientsToSvg(QXmlStreamWriter &writer, const QList<QGraphicsItem*> &items);
+    static void writeGradientStopsToSvg(QXmlStreamWriter &writer, const QGradientStops &stops);
+    static void writeFiltersToSvg(QXmlStreamWriter &writer, const QList<QGraphicsItem*> &items);
+    static void writeFilterReference(QXmlStreamWriter &writer, QGraphicsEffect *effect);
+    static QString pointsToString(const QPointF &offset, const QVector<QPointF> &points);
     static QString transformToString(const QTransform &transform);
 };
 
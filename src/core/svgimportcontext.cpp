@@ -0,0 +1,11 @@
+#include "svgimportcontext.h"
+
+SvgImportContext::SvgImportContext()
+{
+}
+
+SvgImportContext::~SvgImportContext()
+{
+    // 滤镜模板只在导入期间使用，图形上的效果是克隆出来的
+    qDeleteAll(filters);
+}
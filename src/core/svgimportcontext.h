@@ -0,0 +1,50 @@
+#ifndef SVGIMPORTCONTEXT_H
+#define SVGIMPORTCONTEXT_H
+
+#include <QHash>
+#include <QString>
+#include <QGradient>
+#include <QBrush>
+#include <QDomElement>
+#include <QGraphicsEffect>
+#include "drawing-shape.h"
+#include "svghandler.h"
+
+/**
+ * SVG导入上下文 - 保存一次导入过程中解析得到的定义表
+ * 每次导入各自持有一个实例，并作为参数传递给解析函数，
+ * 因此多个导入可以同时在不同线程中进行而互不干扰
+ */
+class SvgImportContext
+{
+public:
+    SvgImportContext();
+    ~SvgImportContext();
+
+    // 渐变定义，按id索引
+    QHash<QString, QGradient> gradients;
+
+    // 滤镜模板，应用到图形时会克隆，由上下文负责释放
+    QHash<QString, QGraphicsEffect *> filters;
+
+    // 图案画刷，按id索引
+    QHash<QString, QBrush> patterns;
+
+    // 标记元素及其预解析数据
+    QHash<QString, QDomElement> markers;
+    QHash<QString, MarkerData> markerDataCache;
+
+    // 有id的元素（用于use元素引用）
+    QHash<QString, QDomElement> definedElements;
+
+    // 两阶段导入中预解析的图形数据，按元素在源文件中的行列号索引
+    QHash<quint64, SvgPreparsedShape> preparsedShapes;
+
+    // 流式导入时正在创建的图形元素的键，DOM片段本身不带行列号
+    quint64 currentPreparseKey = 0;
+
+private:
+    Q_DISABLE_COPY(SvgImportContext)
+};
+
+#endif // SVGIMPORTCONTEXT_H
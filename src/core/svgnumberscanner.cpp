@@ -0,0 +1,206 @@
+#include <atomic>
+#include "svgnumberscanner.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SVG_SCANNER_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// GCC/Clang可以单独为AVX2编译一个函数并在运行时检测CPU；MSVC只在开启/arch:AVX2时使用
+#if defined(SVG_SCANNER_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SVG_SCANNER_HAS_AVX2
+#define SVG_SCANNER_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(SVG_SCANNER_HAS_SSE2) && defined(__AVX2__)
+#define SVG_SCANNER_HAS_AVX2
+#define SVG_SCANNER_AVX2_TARGET
+#include <immintrin.h>
+#endif
+
+const double SvgNumberScanner::s_powersOfTen[23] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+namespace {
+
+std::atomic<qint64> s_scannedCharacters{0};
+std::atomic<qint64> s_scanNanoseconds{0};
+
+#ifdef SVG_SCANNER_HAS_SSE2
+// 对16个字节分类，返回数字字符掩码和命令字母掩码
+inline void classifyBytesSse2(__m128i bytes, quint32 &numberBits, quint32 &commandBits)
+{
+    // 有符号比较：>= 0x80的字节为负数，自然不会落在任何范围内
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+    const __m128i sign = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('-')),
+                                      _mm_cmpeq_epi8(bytes, _mm_set1_epi8('+')));
+    const __m128i dot = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('.'));
+
+    // 或上0x20统一转换为小写后判断字母
+    const __m128i lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+    const __m128i exponent = _mm_cmpeq_epi8(lower, _mm_set1_epi8('e'));
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+
+    const __m128i number = _mm_or_si128(_mm_or_si128(digit, sign), _mm_or_si128(dot, exponent));
+    const __m128i command = _mm_andnot_si128(exponent, alpha);
+
+    numberBits = quint32(_mm_movemask_epi8(number));
+    commandBits = quint32(_mm_movemask_epi8(command));
+}
+
+void classifyBlockSse2(const char *block, quint64 &numberMask, quint64 &commandMask)
+{
+    numberMask = 0;
+    commandMask = 0;
+    for (int i = 0; i < SvgNumberScanner::BlockSize; i += 16) {
+        quint32 numberBits, commandBits;
+        classifyBytesSse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i)), numberBits, commandBits);
+        numberMask |= quint64(numberBits) << i;
+        commandMask |= quint64(commandBits) << i;
+    }
+}
+
+void classifyBlockSse2(const char16_t *block, quint64 &numberMask, quint64 &commandMask)
+{
+    numberMask = 0;
+    commandMask = 0;
+    for (int i = 0; i < SvgNumberScanner::BlockSize; i += 16) {
+        // 16个UTF-16字符饱和压缩为字节，非ASCII字符变为0或0xFF，不会被误判
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i + 8));
+        quint32 numberBits, commandBits;
+        classifyBytesSse2(_mm_packus_epi16(low, high), numberBits, commandBits);
+        numberMask |= quint64(numberBits) << i;
+        commandMask |= quint64(commandBits) << i;
+    }
+}
+#endif
+
+#ifdef SVG_SCANNER_HAS_AVX2
+SVG_SCANNER_AVX2_TARGET
+inline void classifyBytesAvx2(__m256i bytes, quint32 &numberBits, quint32 &commandBits)
+{
+    const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('0' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), bytes));
+    const __m256i sign = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('-')),
+                                         _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('+')));
+    const __m256i dot = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('.'));
+
+    const __m256i lower = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+    const __m256i exponent = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('e'));
+    const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+
+    const __m256i number = _mm256_or_si256(_mm256_or_si256(digit, sign), _mm256_or_si256(dot, exponent));
+    const __m256i command = _mm256_andnot_si256(exponent, alpha);
+
+    numberBits = quint32(_mm256_movemask_epi8(number));
+    commandBits = quint32(_mm256_movemask_epi8(command));
+}
+
+SVG_SCANNER_AVX2_TARGET
+void classifyBlockAvx2(const char *block, quint64 &numberMask, quint64 &commandMask)
+{
+    quint32 numberLow, commandLow, numberHigh, commandHigh;
+    classifyBytesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)), numberLow, commandLow);
+    classifyBytesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32)), numberHigh, commandHigh);
+    numberMask = quint64(numberLow) | (quint64(numberHigh) << 32);
+    commandMask = quint64(commandLow) | (quint64(commandHigh) << 32);
+}
+
+SVG_SCANNER_AVX2_TARGET
+void classifyBlockAvx2(const char16_t *block, quint64 &numberMask, quint64 &commandMask)
+{
+    numberMask = 0;
+    commandMask = 0;
+    for (int i = 0; i < SvgNumberScanner::BlockSize; i += 32) {
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i + 16));
+        // packus按128位通道交错，重新排列恢复字符顺序
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+        quint32 numberBits, commandBits;
+        classifyBytesAvx2(packed, numberBits, commandBits);
+        numberMask |= quint64(numberBits) << i;
+        commandMask |= quint64(commandBits) << i;
+    }
+}
+
+bool cpuSupportsAvx2()
+{
+#if defined(__AVX2__)
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#endif
+}
+#endif
+
+} // namespace
+
+void SvgNumberScanner::classifyBlock(const char *block, quint64 &numberMask, quint64 &commandMask)
+{
+#ifdef SVG_SCANNER_HAS_AVX2
+    if (cpuSupportsAvx2()) {
+        classifyBlockAvx2(block, numberMask, commandMask);
+        return;
+    }
+#endif
+#ifdef SVG_SCANNER_HAS_SSE2
+    classifyBlockSse2(block, numberMask, commandMask);
+#else
+    classifyTail(block, BlockSize, numberMask, commandMask);
+#endif
+}
+
+void SvgNumberScanner::classifyBlock(const char16_t *block, quint64 &numberMask, quint64 &commandMask)
+{
+#ifdef SVG_SCANNER_HAS_AVX2
+    if (cpuSupportsAvx2()) {
+        classifyBlockAvx2(block, numberMask, commandMask);
+        return;
+    }
+#endif
+#ifdef SVG_SCANNER_HAS_SSE2
+    classifyBlockSse2(block, numberMask, commandMask);
+#else
+    classifyTail(block, BlockSize, numberMask, commandMask);
+#endif
+}
+
+const char *SvgNumberScanner::backendName()
+{
+#ifdef SVG_SCANNER_HAS_AVX2
+    if (cpuSupportsAvx2()) {
+        return "AVX2";
+    }
+#endif
+#ifdef SVG_SCANNER_HAS_SSE2
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+void SvgNumberScanner::recordThroughput(qint64 characters, qint64 nanoseconds)
+{
+    s_scannedCharacters.fetch_add(characters, std::memory_order_relaxed);
+    s_scanNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+SvgNumberScanner::Throughput SvgNumberScanner::throughput()
+{
+    Throughput result;
+    result.characters = s_scannedCharacters.load(std::memory_order_relaxed);
+    result.nanoseconds = s_scanNanoseconds.load(std::memory_order_relaxed);
+    return result;
+}
+
+void SvgNumberScanner::resetThroughput()
+{
+    s_scannedCharacters.store(0, std::memory_order_relaxed);
+    s_scanNanoseconds.store(0, std::memory_order_relaxed);
+}
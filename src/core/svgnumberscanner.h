@@ -0,0 +1,258 @@
+#ifndef SVGNUMBERSCANNER_H
+#define SVGNUMBERSCANNER_H
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <cmath>
+
+/**
+ * SVG数字扫描器
+ * 以64个字符为一块，用SSE2/AVX2批量分类出数字字符和命令字母，
+ * 再用位运算定位数字边界；不支持SIMD的平台使用标量实现
+ */
+class SvgNumberScanner
+{
+public:
+    // 每次分类的字符数，与掩码位数一致
+    static constexpr int BlockSize = 64;
+
+    /**
+     * 路径文本扫描吞吐量统计
+     */
+    struct Throughput {
+        qint64 characters = 0;   // 已扫描的字符数
+        qint64 nanoseconds = 0;  // 累计耗时(ns)
+
+        double megabytesPerSecond() const
+        {
+            return nanoseconds > 0 ? (characters / (1024.0 * 1024.0)) / (nanoseconds / 1e9) : 0.0;
+        }
+    };
+
+    /**
+     * 对连续64个字符进行分类
+     * @param block 字符起始指针，至少可读BlockSize个字符
+     * @param numberMask 输出：第i位表示第i个字符可以出现在数字中（0-9 . + - e E）
+     * @param commandMask 输出：第i位表示第i个字符是路径命令字母
+     */
+    static void classifyBlock(const char *block, quint64 &numberMask, quint64 &commandMask);
+    static void classifyBlock(const char16_t *block, quint64 &numberMask, quint64 &commandMask);
+
+    /**
+     * 标量分类，用于不足一块的尾部和不支持SIMD的平台
+     * @param count 字符数，不超过BlockSize
+     */
+    template <typename Char>
+    static void classifyTail(const Char *block, int count, quint64 &numberMask, quint64 &commandMask);
+
+    /**
+     * 当前使用的分类实现："AVX2"、"SSE2"或"Scalar"
+     */
+    static const char *backendName();
+
+    /**
+     * 记录一次扫描，线程安全
+     * @param characters 扫描的字符数
+     * @param nanoseconds 耗时(ns)
+     */
+    static void recordThroughput(qint64 characters, qint64 nanoseconds);
+    static Throughput throughput();
+    static void resetThroughput();
+
+    template <typename Char>
+    static bool isNumberChar(Char c)
+    {
+        return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+    }
+
+    template <typename Char>
+    static bool isCommandChar(Char c)
+    {
+        // 指数符号e/E只出现在数字内部
+        return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) && c != 'e' && c != 'E';
+    }
+
+    /**
+     * from_chars风格的数字解析：从[first, last)解析一个SVG数字
+     * 数字边界遵循SVG语法，如"1-2"解析为1和-2，"0.5.5"解析为0.5和.5
+     * @return 成功时返回数字之后的位置，失败时返回first
+     */
+    template <typename Char>
+    static const Char *parseNumber(const Char *first, const Char *last, qreal &value);
+
+private:
+    static const double s_powersOfTen[23];
+};
+
+/**
+ * 基于分类掩码的token游标
+ * 一次分类一块，之后在块内用位扫描跳过分隔符、查找数字串结尾
+ */
+template <typename Char>
+class SvgTokenCursor
+{
+public:
+    SvgTokenCursor(const Char *data, qsizetype length)
+        : m_data(data)
+        , m_length(length)
+        , m_blockStart(-SvgNumberScanner::BlockSize)
+        , m_numberMask(0)
+        , m_commandMask(0)
+    {
+    }
+
+    /**
+     * 查找from之后第一个数字字符或命令字母的位置，没有则返回length
+     */
+    qsizetype nextToken(qsizetype from)
+    {
+        while (from < m_length) {
+            ensureBlock(from);
+            const int offset = int(from - m_blockStart);
+            const quint64 mask = (m_numberMask | m_commandMask) >> offset;
+            if (mask) {
+                return from + qCountTrailingZeroBits(mask);
+            }
+            from = m_blockStart + SvgNumberScanner::BlockSize;
+        }
+        return m_length;
+    }
+
+    /**
+     * 查找from开始的数字串结尾（第一个非数字字符的位置）
+     */
+    qsizetype numberRunEnd(qsizetype from)
+    {
+        while (from < m_length) {
+            ensureBlock(from);
+            const int offset = int(from - m_blockStart);
+            const quint64 mask = ~m_numberMask >> offset;
+            if (mask) {
+                return qMin(m_length, from + qsizetype(qCountTrailingZeroBits(mask)));
+            }
+            from = m_blockStart + SvgNumberScanner::BlockSize;
+        }
+        return m_length;
+    }
+
+private:
+    void ensureBlock(qsizetype from)
+    {
+        if (from >= m_blockStart && from < m_blockStart + SvgNumberScanner::BlockSize) {
+            return;
+        }
+        m_blockStart = from;
+        const qsizetype remaining = m_length - from;
+        if (remaining >= SvgNumberScanner::BlockSize) {
+            SvgNumberScanner::classifyBlock(m_data + from, m_numberMask, m_commandMask);
+        } else {
+            SvgNumberScanner::classifyTail(m_data + from, int(remaining), m_numberMask, m_commandMask);
+        }
+    }
+
+    const Char *m_data;
+    qsizetype m_length;
+    qsizetype m_blockStart;
+    quint64 m_numberMask;
+    quint64 m_commandMask;
+};
+
+template <typename Char>
+void SvgNumberScanner::classifyTail(const Char *block, int count, quint64 &numberMask, quint64 &commandMask)
+{
+    numberMask = 0;
+    commandMask = 0;
+    for (int i = 0; i < count; ++i) {
+        if (isNumberChar(block[i])) {
+            numberMask |= quint64(1) << i;
+        } else if (isCommandChar(block[i])) {
+            commandMask |= quint64(1) << i;
+        }
+    }
+}
+
+template <typename Char>
+const Char *SvgNumberScanner::parseNumber(const Char *first, const Char *last, qreal &value)
+{
+    const Char *p = first;
+    bool negative = false;
+    if (p < last && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // 最多累积19位有效数字，超出部分只影响指数
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    while (p < last && *p >= '0' && *p <= '9') {
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + quint64(*p - '0');
+            if (mantissa != 0) {
+                ++significantDigits;
+            }
+        } else {
+            ++exponent;
+        }
+        hasDigits = true;
+        ++p;
+    }
+
+    if (p < last && *p == '.') {
+        ++p;
+        while (p < last && *p >= '0' && *p <= '9') {
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + quint64(*p - '0');
+                if (mantissa != 0) {
+                    ++significantDigits;
+                }
+                --exponent;
+            }
+            hasDigits = true;
+            ++p;
+        }
+    }
+
+    if (!hasDigits) {
+        return first;
+    }
+
+    // 指数部分：只有e后面跟着数字时才算指数
+    if (p < last && (*p == 'e' || *p == 'E')) {
+        const Char *q = p + 1;
+        bool exponentNegative = false;
+        if (q < last && (*q == '-' || *q == '+')) {
+            exponentNegative = (*q == '-');
+            ++q;
+        }
+        if (q < last && *q >= '0' && *q <= '9') {
+            int explicitExponent = 0;
+            while (q < last && *q >= '0' && *q <= '9') {
+                if (explicitExponent < 10000) {
+                    explicitExponent = explicitExponent * 10 + int(*q - '0');
+                }
+                ++q;
+            }
+            exponent += exponentNegative ? -explicitExponent : explicitExponent;
+            p = q;
+        }
+    }
+
+    double result = 0.0;
+    if (mantissa != 0) {
+        if (mantissa <= (quint64(1) << 53) && exponent >= -22 && exponent <= 22) {
+            // 尾数和10的幂都可精确表示，一次乘除即得到正确舍入的结果
+            result = exponent < 0 ? double(mantissa) / s_powersOfTen[-exponent]
+                                  : double(mantissa) * s_powersOfTen[exponent];
+        } else {
+            result = double(mantissa) * std::pow(10.0, exponent);
+        }
+    }
+
+    value = negative ? -result : result;
+    return p;
+}
+
+#endif // SVGNUMBERSCANNER_H
@@ -0,0 +1,213 @@
+#include <cmath>
+#include <cstring>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#include <QLocale>
+#include "svgpathwriter.h"
+
+namespace {
+
+// 按小数位数取整，precision < 0 时保持原值
+inline qreal roundToPrecision(qreal value, int precision)
+{
+    if (precision < 0) {
+        return value;
+    }
+    const double scale = std::pow(10.0, precision);
+    return std::round(value * scale) / scale;
+}
+
+} // namespace
+
+// 预分配的缓冲区，按需倍增，避免逐段拼接QString带来的重复分配
+class SvgPathWriter::Buffer
+{
+public:
+    explicit Buffer(qsizetype capacity)
+        : m_size(0)
+        , afterNumber(false)
+        , lastNumberHasDot(false)
+    {
+        m_data.resize(capacity);
+    }
+
+    char *reserve(qsizetype count)
+    {
+        if (m_size + count > m_data.size()) {
+            m_data.resize(qMax(m_data.size() * 2, m_size + count));
+        }
+        return m_data.data() + m_size;
+    }
+
+    void commit(qsizetype count) { m_size += count; }
+
+    void append(char c)
+    {
+        *reserve(1) = c;
+        ++m_size;
+    }
+
+    qsizetype size() const { return m_size; }
+
+    QByteArray take()
+    {
+        m_data.resize(m_size);
+        return m_data;
+    }
+
+private:
+    QByteArray m_data;
+    qsizetype m_size;
+
+public:
+    // 压缩模式下判断数字之间是否需要分隔符
+    bool afterNumber;
+    bool lastNumberHasDot;
+};
+
+int SvgPathWriter::formatNumber(char *buffer, qreal value, int precision)
+{
+    value = roundToPrecision(value, precision);
+    if (value == 0.0) {
+        value = 0.0; // 避免输出"-0"
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const std::to_chars_result result = std::to_chars(buffer, buffer + 32, double(value));
+    return int(result.ptr - buffer);
+#else
+    // 标准库不支持浮点to_chars时退回Qt的最短格式，同样与区域设置无关
+    const QByteArray text = QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+    const int length = int(qMin<qsizetype>(text.size(), 32));
+    std::memcpy(buffer, text.constData(), length);
+    return length;
+#endif
+}
+
+QByteArray SvgPathWriter::write(const QPainterPath &path, const Options &options)
+{
+    const int elementCount = path.elementCount();
+    Buffer buffer(qsizetype(elementCount) * (options.compact ? 20 : 28) + 16);
+
+    char lastCommand = 0;
+    QPointF emittedPoint(0, 0);
+
+    for (int i = 0; i < elementCount; ++i) {
+        const QPainterPath::Element element = path.elementAt(i);
+
+        switch (element.type) {
+        case QPainterPath::MoveToElement: {
+            const QPointF point(element.x, element.y);
+            writeCommand(buffer, 'M', options, lastCommand);
+            writeCoordinates(buffer, &point, 1, options, emittedPoint);
+            break;
+        }
+        case QPainterPath::LineToElement: {
+            const QPointF point(element.x, element.y);
+            writeCommand(buffer, 'L', options, lastCommand);
+            writeCoordinates(buffer, &point, 1, options, emittedPoint);
+            break;
+        }
+        case QPainterPath::CurveToElement:
+            // 曲线元素后跟两个数据元素：第二控制点和终点
+            if (i + 2 < elementCount) {
+                const QPainterPath::Element ctrl2 = path.elementAt(i + 1);
+                const QPainterPath::Element end = path.elementAt(i + 2);
+                const QPointF points[3] = {
+                    QPointF(element.x, element.y),
+                    QPointF(ctrl2.x, ctrl2.y),
+                    QPointF(end.x, end.y)
+                };
+                writeCommand(buffer, 'C', options, lastCommand);
+                writeCoordinates(buffer, points, 3, options, emittedPoint);
+                i += 2; // 跳过已处理的元素
+            }
+            break;
+        case QPainterPath::CurveToDataElement:
+            // 控制点数据，在CurveToElement中处理
+            break;
+        }
+    }
+
+    return buffer.take();
+}
+
+void SvgPathWriter::writeCommand(Buffer &buffer, char command, const Options &options,
+                                 char &lastCommand)
+{
+    const char letter = options.relative ? char(command - 'A' + 'a') : command;
+
+    if (options.compact) {
+        // 与上一条命令相同时可以省略；moveto之后的坐标对隐式为lineto
+        const char implicitCommand = (lastCommand == 'M') ? 'L' : (lastCommand == 'm') ? 'l' : lastCommand;
+        lastCommand = letter;
+        if (letter == implicitCommand) {
+            return;
+        }
+        buffer.append(letter);
+        buffer.afterNumber = false;
+        return;
+    }
+
+    if (buffer.size() > 0) {
+        buffer.append(' ');
+    }
+    buffer.append(letter);
+    lastCommand = letter;
+}
+
+void SvgPathWriter::writeCoordinates(Buffer &buffer, const QPointF *points, int count,
+                                     const Options &options, QPointF &emittedPoint)
+{
+    // 相对命令的所有坐标都相对于命令开始时的当前点；
+    // 基准点使用已写出（取整后）的坐标，避免相对坐标的误差累积
+    const QPointF base = emittedPoint;
+
+    for (int i = 0; i < count; ++i) {
+        const QPointF target = options.relative ? points[i] - base : points[i];
+        const qreal values[2] = { target.x(), target.y() };
+        qreal written[2];
+
+        for (int axis = 0; axis < 2; ++axis) {
+            written[axis] = roundToPrecision(values[axis], options.precision);
+
+            char number[32];
+            int length = formatNumber(number, written[axis]);
+
+            const char *text = number;
+            if (options.compact) {
+                // 去掉前导零：0.5 -> .5，-0.5 -> -.5
+                if (length > 2 && number[0] == '0' && number[1] == '.') {
+                    ++text;
+                    --length;
+                } else if (length > 3 && number[0] == '-' && number[1] == '0' && number[2] == '.') {
+                    number[1] = '-';
+                    ++text;
+                    --length;
+                }
+
+                const bool hasDot = std::memchr(text, '.', length) != nullptr;
+                const bool hasExponent = std::memchr(text, 'e', length) != nullptr;
+                // 负号或紧跟在小数后的小数点可以直接分隔数字
+                const bool selfDelimited = text[0] == '-'
+                    || (text[0] == '.' && buffer.lastNumberHasDot);
+                if (buffer.afterNumber && !selfDelimited) {
+                    buffer.append(' ');
+                }
+                buffer.lastNumberHasDot = hasDot && !hasExponent;
+                buffer.afterNumber = true;
+            } else {
+                buffer.append(axis == 0 ? ' ' : ',');
+            }
+
+            std::memcpy(buffer.reserve(length), text, length);
+            buffer.commit(length);
+        }
+
+        if (i == count - 1) {
+            emittedPoint = options.relative ? base + QPointF(written[0], written[1])
+                                            : QPointF(written[0], written[1]);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SVGPATHWRITER_H
+#define SVGPATHWRITER_H
+
+#include <QByteArray>
+#include <QPainterPath>
+#include <QPointF>
+
+/**
+ * SVG路径数据序列化器
+ * 直接写入预分配的UTF-8缓冲区，数字使用最短可往返格式（std::to_chars），
+ * 支持精度控制、相对坐标和省略重复命令等压缩选项
+ */
+class SvgPathWriter
+{
+public:
+    /**
+     * 序列化选项
+     */
+    struct Options {
+        int precision = -1;     // 小数位数，-1表示最短可往返格式（无损）
+        bool relative = false;  // 使用相对坐标命令（m/l/c）
+        bool compact = false;   // 省略重复命令、多余的分隔符和前导零
+
+        Options() {}
+    };
+
+    /**
+     * 将路径序列化为SVG路径数据
+     * @param path 路径对象
+     * @param options 序列化选项
+     * @return UTF-8编码的路径数据
+     */
+    static QByteArray write(const QPainterPath &path, const Options &options = Options());
+
+    /**
+     * 格式化单个数字
+     * @param buffer 输出缓冲区，至少32字节
+     * @param value 数值
+     * @param precision 小数位数，-1表示最短可往返格式
+     * @return 写入的字节数
+     */
+    static int formatNumber(char *buffer, qreal value, int precision = -1);
+
+private:
+    class Buffer;
+
+    static void writeCommand(Buffer &buffer, char command, const Options &options,
+                             char &lastCommand);
+    static void writeCoordinates(Buffer &buffer, const QPointF *points, int count,
+                                 const Options &options, QPointF &emittedPoint);
+};
+
+#endif // SVGPATHWRITER_H
@@ -2,6 +2,7 @@
 #include <QTextStream>
 #include <QFile>
 #include <QXmlStreamReader>
+#include <QDomDocument>
 
 #include <QPainter>
 #include <QPainterPath>
@@ -13,6 +14,7 @@
 #include "svgstreamhandler.h"
 #include "fastpathparser.h"
 #include "svgelementcollector.h"
+#include "svgimportcontext.h"
 #include "drawing-shape.h"
 #include "drawing-layer.h"
 #include "drawing-group.h"
@@ -20,13 +22,18 @@
 #include "../ui/drawingscene.h"
 #include "svghandler.h"  // 为了复用函数
 
-// 使用SvgHandler中的全局存储
-extern QHash<QString, QGradient> s_gradients;
-extern QHash<QString, QGraphicsEffect *> s_filters;
-extern QHash<QString, QBrush> s_patterns;
-extern QHash<QString, QDomElement> s_markers;
-extern QHash<QString, MarkerData> s_markerDataCache;
-extern QHash<QString, QDomElement> s_definedElements;
+namespace {
+
+// 每个预解析窗口的元素数，足以摊薄线程池的调度开销，同时限制驻留的属性字符串
+const int PreparseWindowSize = 4096;
+
+} // namespace
+
+// 预解析扫描器的位置：已预解析到的最后一个元素的键，扫描完毕或出错后scanner为空
+struct SvgPreparseCursor {
+    QXmlStreamReader *scanner = nullptr;
+    quint64 windowEnd = 0;
+};
 
 // SvgStreamParser类实现
 bool SvgStreamParser::parseSvgFile(const QString &fileName, SvgStreamElement &rootElement)
@@ -106,6 +113,17 @@ bool SvgStreamHandler::importFromSvg(DrawingScene *scene, const QString &fileNam
         return false;
     }
 
+    // 预解析用独立的文件句柄和扫描器，随主读取器推进按窗口读取路径和点数据，
+    // 同时只保留一个窗口的属性字符串和解析结果
+    SvgImportContext context;
+    QFile scanFile(fileName);
+    QXmlStreamReader scanner;
+    SvgPreparseCursor preparse;
+    if (scanFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        scanner.setDevice(&scanFile);
+        preparse.scanner = &scanner;
+    }
+
     QXmlStreamReader reader(&file);
     
     if (!reader.readNextStartElement())
@@ -120,8 +138,8 @@ bool SvgStreamHandler::importFromSvg(DrawingScene *scene, const QString &fileNam
         return false;
     }
 
-    // 使用栈结构进行真正的流式解析
-    bool result = parseSvgStream(scene, reader);
+    // 第二阶段：使用栈结构进行真正的流式解析，defs定义保存在本次导入的上下文中
+    bool result = parseSvgStream(context, scene, reader, preparse);
     LayerManager::instance()->setSvgImporting(false);
     return result;
 }
@@ -213,7 +231,7 @@ void SvgStreamHandler::collectElementsFromStreamRecursive(const SvgStreamElement
     // 收集有id的元素（用于use元素引用）
     if (element.attributes.contains("id")) {
         QString id = element.attributes.value("id");
-        // 创建一个临时的QDomElement来存储在s_definedElements中
+        // 创建一个临时的QDomElement来存储在definedElements中
         QDomDocument tempDoc;
         QDomElement tempElement = tempDoc.createElement(tagName);
         for (auto it = element.attributes.begin(); it != element.attributes.end(); ++it) {
@@ -452,194 +470,418 @@ void SvgStreamHandler::collectElementsFromStreamRecursive(const SvgStreamElement
     }
 }
 
-// 辅助方法：将元素添加到正确的位置
-static void addShapeToCorrectPlace(DrawingScene *scene, DrawingShape *shape, 
-                                   QStack<DrawingShape*> &elementStack, int &elementCount,
-                                   const QTransform &svgToSceneTransform)
+// 辅助方法：将当前StartElement及其子树读取为独立的DOM片段
+// 只用于defs、图形等小元素，读取后reader停在该元素的EndElement上
+static QDomElement readElementAsDom(QXmlStreamReader &reader, QDomDocument &fragmentDoc)
 {
-    // 应用SVG到Scene的变换
-    if (!svgToSceneTransform.isIdentity()) {
-        shape->setTransform(svgToSceneTransform * shape->transform());
+    QDomElement element = fragmentDoc.createElement(reader.qualifiedName().toString());
+    const QXmlStreamAttributes attributes = reader.attributes();
+    for (const QXmlStreamAttribute &attribute : attributes) {
+        element.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
     }
-    
-    if (elementStack.isEmpty()) {
-        // 检查是否有当前活动图层
-        DrawingLayer *activeLayer = LayerManager::instance()->activeLayer();
-        if (activeLayer && LayerManager::instance()->layerCount() > 1) {
-            // 有图层，添加到图层
-            activeLayer->addShape(shape);
-        } else {
-            // 没有图层，直接添加到scene
-            scene->addItem(shape);
-            shape->setZValue(elementCount++);
+
+    while (!reader.atEnd()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            element.appendChild(readElementAsDom(reader, fragmentDoc));
+        } else if (token == QXmlStreamReader::Characters) {
+            // 与QDomDocument::setContent一致，忽略纯空白文本
+            if (!reader.isWhitespace()) {
+                element.appendChild(fragmentDoc.createTextNode(reader.text().toString()));
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            break;
+        }
+    }
+
+    return element;
+}
+
+// 流式解析中的组上下文：图层或普通组
+struct SvgStreamGroupFrame {
+    DrawingLayer *layer = nullptr;
+    DrawingGroup *group = nullptr;
+    QString transform;
+};
+
+// 引用目标尚未出现的use元素，在文档结束后再解析
+struct SvgStreamPendingUse {
+    QDomElement element;
+    DrawingLayer *layer = nullptr;
+    DrawingGroup *group = nullptr;
+    bool isTopLevel = false;
+    int zValue = 0;
+};
+
+// 只提取属性字符串，元素以StartElement处的行列号为键，主读取器读到同一元素时行列号相同。
+// 行列号按文档顺序递增，主读取器请求的键超出当前窗口时才读取下一个窗口
+void SvgStreamHandler::preparseWindow(SvgImportContext &context, SvgPreparseCursor &cursor, quint64 key)
+{
+    if (!cursor.scanner || key <= cursor.windowEnd) {
+        return;
+    }
+
+    // 上一窗口的元素主读取器都已读过
+    context.preparsedShapes.clear();
+
+    QXmlStreamReader &reader = *cursor.scanner;
+    QVector<SvgPreparseJob> jobs;
+    jobs.reserve(PreparseWindowSize);
+    while (jobs.size() < PreparseWindowSize && !reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        const QStringView tagName = reader.qualifiedName();
+        // 主读取器把定义子树整体读为DOM片段，其中的图形不会请求预解析结果
+        if (tagName == QLatin1String("defs") || tagName == QLatin1String("pattern") ||
+            tagName == QLatin1String("marker") || tagName == QLatin1String("symbol") ||
+            tagName == QLatin1String("clipPath") || tagName == QLatin1String("mask")) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        const QXmlStreamAttributes attributes = reader.attributes();
+        const bool isPath = tagName == QLatin1String("path") &&
+                            attributes.value("sodipodi:type") != QLatin1String("arc");
+        if (!isPath && tagName != QLatin1String("polyline") && tagName != QLatin1String("polygon")) {
+            continue;
+        }
+
+        // 主读取器已经越过的元素不再需要
+        quint64 elementKey = SvgHandler::preparseKey(reader.lineNumber(), reader.columnNumber());
+        if (elementKey < key) {
+            continue;
+        }
+
+        QString data = attributes.value(isPath ? QLatin1String("d") : QLatin1String("points")).toString();
+        if (!data.isEmpty() && elementKey != 0) {
+            jobs.append({elementKey, tagName.toString(), data, attributes.value("transform").toString(),
+                         attributes.value("stroke").toString(), attributes.value("fill").toString()});
         }
+    }
+
+    // 格式错误由主读取器报告，这里只放弃剩余的预解析
+    if (reader.hasError()) {
+        cursor.scanner = nullptr;
+        return;
+    }
+    if (reader.atEnd() || jobs.isEmpty()) {
+        cursor.scanner = nullptr;
     } else {
-        DrawingShape *parent = elementStack.top();
-        if (DrawingGroup *group = dynamic_cast<DrawingGroup*>(parent)) {
-            group->addItem(shape);
+        cursor.windowEnd = jobs.last().key;
+    }
+    context.preparsedShapes = SvgHandler::preparseJobs(jobs);
+}
+
+// 注册定义元素（渐变、滤镜、图案、标记以及带id的元素）
+void SvgStreamHandler::registerDefinitions(SvgImportContext &context, const QDomElement &element)
+{
+    SvgElementCollector::CollectedElements collected = SvgElementCollector::collect(element);
+
+    for (auto it = collected.definedElements.constBegin(); it != collected.definedElements.constEnd(); ++it) {
+        context.definedElements.insert(it.key(), it.value());
+    }
+
+    for (const QDomElement &gradient : collected.linearGradients) {
+        QString id = gradient.attribute("id");
+        if (!id.isEmpty()) {
+            context.gradients[id] = SvgHandler::parseLinearGradient(gradient);
+        }
+    }
+    for (const QDomElement &gradient : collected.radialGradients) {
+        QString id = gradient.attribute("id");
+        if (!id.isEmpty()) {
+            context.gradients[id] = SvgHandler::parseRadialGradient(gradient);
+        }
+    }
+
+    for (const QDomElement &filter : collected.gaussianBlurFilters) {
+        QString id = filter.attribute("filter-id");
+        if (!id.isEmpty()) {
+            QGraphicsBlurEffect *blurEffect = SvgHandler::parseGaussianBlurFilter(filter);
+            if (blurEffect) {
+                context.filters[id] = blurEffect;
+            }
+        }
+    }
+    for (const QDomElement &filter : collected.dropShadowFilters) {
+        QString id = filter.attribute("filter-id");
+        if (!id.isEmpty()) {
+            QGraphicsDropShadowEffect *shadowEffect = SvgHandler::parseDropShadowFilter(filter);
+            if (shadowEffect) {
+                context.filters[id] = shadowEffect;
+            }
+        }
+    }
+
+    for (const QDomElement &pattern : collected.patterns) {
+        QString id = pattern.attribute("id");
+        if (!id.isEmpty()) {
+            context.patterns[id] = SvgHandler::parsePatternBrush(pattern);
+        }
+    }
+
+    for (const QDomElement &marker : collected.markers) {
+        QString id = marker.attribute("id");
+        if (!id.isEmpty()) {
+            context.markers[id] = marker;
+            context.markerDataCache[id] = SvgHandler::parseMarkerData(marker);
         }
     }
 }
 
 // 真正的基于栈的流式解析
-bool SvgStreamHandler::parseSvgStream(DrawingScene *scene, QXmlStreamReader &reader)
+// 组和图层保持流式处理，只有单个图形元素和defs子树会被读取为小的DOM片段，
+// 再交给SvgHandler的解析函数，保证与DOM导入结果一致，同时避免为整个文件构建DOM树
+bool SvgStreamHandler::parseSvgStream(SvgImportContext &context, DrawingScene *scene, QXmlStreamReader &reader,
+                                      SvgPreparseCursor &preparse)
 {
-    // 元素栈：存储当前嵌套的父元素
-    QStack<DrawingShape*> elementStack;
+    // 组栈：存储当前嵌套的图层/组
+    QStack<SvgStreamGroupFrame> groupStack;
+    QList<DrawingShape *> topLevelShapes;
+    QList<DrawingLayer *> importedLayers;
+    QList<SvgStreamPendingUse> pendingUses;
     int elementCount = 0;
-    bool inDefs = false;  // 跟踪是否在defs元素中
-    
+
+    // 所有DOM片段共享同一个文档，未挂到文档树上的片段在释放引用后即被回收
+    QDomDocument fragmentDoc;
+
     // 解析SVG元数据
-    SvgMetadata metadata;
-    if (reader.attributes().hasAttribute("width")) {
-        metadata.size.setWidth(parseLength(reader.attributes().value("width").toString()));
-        metadata.hasSize = true;
-    }
-    if (reader.attributes().hasAttribute("height")) {
-        metadata.size.setHeight(parseLength(reader.attributes().value("height").toString()));
-        metadata.hasSize = true;
+    SvgStreamElement svgElement;
+    svgElement.tagName = reader.name().toString();
+    const QXmlStreamAttributes svgAttributes = reader.attributes();
+    for (const QXmlStreamAttribute &attribute : svgAttributes) {
+        svgElement.attributes.insert(attribute.qualifiedName().toString(), attribute.value().toString());
     }
-    if (reader.attributes().hasAttribute("viewBox")) {
-        QString viewBoxStr = reader.attributes().value("viewBox").toString();
-        QStringList parts = viewBoxStr.split(' ', Qt::SkipEmptyParts);
-        if (parts.size() == 4) {
-            qreal x = parts[0].toDouble();
-            qreal y = parts[1].toDouble();
-            qreal width = parts[2].toDouble();
-            qreal height = parts[3].toDouble();
-            metadata.viewBox = QRectF(x, y, width, height);
-            metadata.hasViewBox = true;
-        }
-    }
-    
+    SvgMetadata metadata = parseSvgMetadataFromElement(svgElement);
+
     // 应用SVG设置到Scene
     applySvgSettingsToScene(scene, metadata);
-    
+
     // 计算SVG到Scene的变换矩阵
     QTransform svgToSceneTransform = calculateSvgToSceneTransform(metadata);
-    
+
+    // 将图形放到当前组上下文中，规则与SvgHandler::parseGroupElement一致
+    auto placeShape = [&](DrawingShape *shape, const QDomElement &element,
+                          DrawingLayer *layer, DrawingGroup *group, bool isTopLevel, int zValue) {
+        if (isTopLevel) {
+            scene->addItem(shape);
+            // 设置Z值，确保按照SVG文档顺序显示
+            shape->setZValue(zValue);
+            topLevelShapes.append(shape);
+            return;
+        }
+
+        // 应用子对象自己的变换（如果有）
+        QString transform = element.attribute("transform");
+        if (!transform.isEmpty()) {
+            shape->applyTransform(parseTransform(transform));
+        }
+
+        if (group) {
+            group->addItem(shape);
+        } else if (layer) {
+            layer->addShape(shape);
+        } else {
+            scene->addItem(shape);
+        }
+    };
+
     while (!reader.atEnd())
     {
         QXmlStreamReader::TokenType token = reader.readNext();
-        
+
         if (token == QXmlStreamReader::StartElement)
         {
-            QString tagName = reader.name().toString();
-            
-            // 处理defs元素
-            if (tagName == "defs") {
-                inDefs = true;
-                continue;
-            }
-            
-            // 跳过defs中的所有元素（暂时不处理渐变）
-            if (inDefs) {
-                continue;
-            }
-            
+            QString tagName = reader.qualifiedName().toString();
+
             if (tagName == "g")
             {
+                QXmlStreamAttributes attributes = reader.attributes();
+                SvgStreamGroupFrame frame;
+                frame.transform = attributes.value("transform").toString();
+
                 // 检查是否为Inkscape图层
-                QString inkscapeLabel = reader.attributes().value("inkscape:label").toString();
-                QString inkscapeGroupmode = reader.attributes().value("inkscape:groupmode").toString();
-                bool isLayer = (!inkscapeGroupmode.isEmpty() && inkscapeGroupmode == "layer") || 
-                               (!inkscapeLabel.isEmpty());
-                
+                QString inkscapeLabel = attributes.value("inkscape:label").toString();
+                bool isLayer = !inkscapeLabel.isEmpty() &&
+                               attributes.value("inkscape:groupmode") == QLatin1String("layer");
+
                 if (isLayer) {
-                    // 创建Inkscape图层
+                    // 为SVG导入创建图层，保持顺序
                     DrawingLayer *layer = LayerManager::instance()->createLayerForSvg(inkscapeLabel);
-                    
-                    // 解析图层属性
-                    QString visibility = reader.attributes().value("visibility", "visible").toString();
+
+                    QString visibility = attributes.hasAttribute("visibility") ?
+                                         attributes.value("visibility").toString() : QString("visible");
                     layer->setVisible(visibility != "hidden");
-                    
-                    QString opacity = reader.attributes().value("opacity", "1.0").toString();
+
+                    QString opacity = attributes.hasAttribute("opacity") ?
+                                      attributes.value("opacity").toString() : QString("1.0");
                     layer->setOpacity(opacity.toDouble());
-                    
-                    // 处理图层变换
-                    if (reader.attributes().hasAttribute("transform")) {
-                        QString transform = reader.attributes().value("transform").toString();
-                        // TODO: 应用变换到图层
-                    }
-                    
-                    // 图层不推入栈，后续元素直接添加到当前活动图层
+
+                    QString style = attributes.value("style").toString();
+                    layer->setLocked(style.contains("display:none") || style.contains("visibility:hidden"));
+
+                    frame.layer = layer;
+                    importedLayers.append(layer);
                 } else {
-                    // 普通group
+                    // 普通group，样式通过只含属性的DOM片段复用DOM版本的解析
                     DrawingGroup *group = new DrawingGroup();
-                    parseStyleAttributes(group, reader.attributes());
-                    
-                    // 处理变换
-                    if (reader.attributes().hasAttribute("transform")) {
-                        QString transform = reader.attributes().value("transform").toString();
-                        parseTransformAttribute(group, transform);
-                    }
-                    
-                    if (elementStack.isEmpty()) {
-                        // 顶级group，直接添加到scene
-                        scene->addItem(group);
-                        group->setZValue(elementCount++);
-                    } else {
-                        // 嵌套group，添加到父元素
-                        DrawingShape *parent = elementStack.top();
-                        if (DrawingGroup *parentGroup = dynamic_cast<DrawingGroup*>(parent)) {
-                            parentGroup->addItem(group);
-                        }
+                    QDomElement groupElement = fragmentDoc.createElement(tagName);
+                    for (const QXmlStreamAttribute &attribute : attributes) {
+                        groupElement.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
                     }
-                    elementStack.push(group);
+                    parseStyleAttributes(context, group, groupElement);
+                    frame.group = group;
                 }
+
+                groupStack.push(frame);
             }
-            else if (tagName == "rect")
+            else if (tagName == "defs" || tagName == "linearGradient" || tagName == "radialGradient" ||
+                     tagName == "pattern" || tagName == "marker" || tagName == "filter" ||
+                     tagName == "symbol" || tagName == "clipPath" || tagName == "mask")
             {
-                DrawingRectangle *rect = parseRectElementFromAttributes(reader.attributes());
-                if (rect) {
-                    addShapeToCorrectPlace(scene, rect, elementStack, elementCount, svgToSceneTransform);
-                }
+                // 定义子树通常很小，整体读取后注册
+                registerDefinitions(context, readElementAsDom(reader, fragmentDoc));
             }
-            else if (tagName == "circle")
+            else if (tagName == "path" || tagName == "rect" || tagName == "circle" ||
+                     tagName == "ellipse" || tagName == "line" || tagName == "polyline" ||
+                     tagName == "polygon" || tagName == "text" || tagName == "use")
             {
-                DrawingEllipse *circle = parseCircleElementFromAttributes(reader.attributes());
-                if (circle) {
-                    addShapeToCorrectPlace(scene, circle, elementStack, elementCount, svgToSceneTransform);
+                // 行列号须在读取子树之前取得，与第一阶段的键一致
+                quint64 preparseKey = SvgHandler::preparseKey(reader.lineNumber(), reader.columnNumber());
+                QDomElement element = readElementAsDom(reader, fragmentDoc);
+
+                // 收集有id的元素（用于use元素引用）
+                QString id = element.attribute("id");
+                if (!id.isEmpty()) {
+                    context.definedElements[id] = element;
                 }
-            }
-            else if (tagName == "ellipse")
-            {
-                DrawingEllipse *ellipse = parseEllipseElementFromAttributes(reader.attributes());
-                if (ellipse) {
-                    addShapeToCorrectPlace(scene, ellipse, elementStack, elementCount, svgToSceneTransform);
+
+                DrawingLayer *layer = groupStack.isEmpty() ? nullptr : groupStack.top().layer;
+                DrawingGroup *group = groupStack.isEmpty() ? nullptr : groupStack.top().group;
+                bool isTopLevel = groupStack.isEmpty();
+                int zValue = isTopLevel ? elementCount++ : 0;
+
+                if (tagName == "use") {
+                    QString href = element.attribute("href");
+                    if (href.isEmpty()) {
+                        href = element.attribute("xlink:href");
+                    }
+                    if (href.startsWith("#") && !context.definedElements.contains(href.mid(1))) {
+                        // 引用目标在后面定义，文档结束后再解析
+                        SvgStreamPendingUse pending;
+                        pending.element = element;
+                        pending.layer = layer;
+                        pending.group = group;
+                        pending.isTopLevel = isTopLevel;
+                        pending.zValue = zValue;
+                        pendingUses.append(pending);
+                        continue;
+                    }
                 }
-            }
-            else if (tagName == "path")
-            {
-                DrawingPath *path = parsePathElementFromAttributes(reader.attributes());
-                if (path) {
-                    addShapeToCorrectPlace(scene, path, elementStack, elementCount, svgToSceneTransform);
+
+                if (tagName == "path" || tagName == "polyline" || tagName == "polygon") {
+                    preparseWindow(context, preparse, preparseKey);
+                }
+                context.currentPreparseKey = preparseKey;
+                DrawingShape *shape = SvgHandler::parseSvgElement(context, element);
+                context.currentPreparseKey = 0;
+                if (shape) {
+                    placeShape(shape, element, layer, group, isTopLevel, zValue);
                 }
             }
-            else if (tagName == "text")
+            else if (tagName == "metadata" || tagName == "sodipodi:namedview" || tagName == "title" ||
+                     tagName == "desc" || tagName == "style" || tagName == "script" || tagName == "image")
             {
-                DrawingText *text = parseTextElementFromAttributes(reader);
-                if (text) {
-                    addShapeToCorrectPlace(scene, text, elementStack, elementCount, svgToSceneTransform);
-                }
+                // 不生成图形的元素，直接跳过整个子树
+                reader.skipCurrentElement();
             }
-            // 可以继续添加其他元素类型...
+            // 其他容器（如a、switch、嵌套svg）继续向下解析其子元素
         }
         else if (token == QXmlStreamReader::EndElement)
         {
-            QString tagName = reader.name().toString();
-            
-            // 处理defs结束
-            if (tagName == "defs") {
-                inDefs = false;
+            if (reader.qualifiedName() == QLatin1String("g") && !groupStack.isEmpty()) {
+                SvgStreamGroupFrame frame = groupStack.pop();
+
+                if (frame.layer) {
+                    // 图层的变换需要应用到所有子元素
+                    if (!frame.transform.isEmpty()) {
+                        QTransform layerTransform = parseTransform(frame.transform);
+                        for (DrawingShape *shape : frame.layer->shapes()) {
+                            shape->applyTransform(layerTransform);
+                        }
+                    }
+                } else if (frame.group) {
+                    // 与SvgHandler::parseGroupElement一致：组先加入场景并应用自身的变换，
+                    // 再由父组收纳，父组加入已在场景中的子项时会保留其变换
+                    scene->addItem(frame.group);
+                    if (!frame.transform.isEmpty()) {
+                        parseTransformAttribute(frame.group, frame.transform);
+                    }
+
+                    DrawingGroup *parentGroup = groupStack.isEmpty() ? nullptr : groupStack.top().group;
+                    if (parentGroup) {
+                        parentGroup->addItem(frame.group);
+                    } else if (groupStack.isEmpty()) {
+                        frame.group->setZValue(elementCount++);
+                        topLevelShapes.append(frame.group);
+                    }
+                }
             }
-            // 处理group结束
-            else if (tagName == "g" && !elementStack.isEmpty()) {
-                elementStack.pop(); // group结束，出栈
+        }
+    }
+
+    if (reader.hasError()) {
+        // qDebug() << "流式解析SVG失败:" << reader.errorString() << "行:" << reader.lineNumber();
+        return false;
+    }
+
+    // 解析引用目标在后面定义的use元素
+    for (const SvgStreamPendingUse &pending : pendingUses) {
+        DrawingShape *shape = SvgHandler::parseSvgElement(context, pending.element);
+        if (shape) {
+            placeShape(shape, pending.element, pending.layer, pending.group, pending.isTopLevel, pending.zValue);
+        }
+    }
+
+    // SVG导入完成后，只删除现有的背景图层，保持导入图层的原始名称
+    LayerManager *layerManager = LayerManager::instance();
+    if (layerManager->layerCount() > 0) {
+        QList<DrawingLayer *> layersToDelete;
+        for (DrawingLayer *layer : layerManager->layers()) {
+            if (layer->name() == "背景图层") {
+                layersToDelete.append(layer);
             }
         }
+
+        for (DrawingLayer *layer : layersToDelete) {
+            importedLayers.removeAll(layer);
+            layerManager->deleteLayer(layer);
+        }
+
+        // 设置第一个导入图层为活动图层
+        if (layerManager->layerCount() > 0) {
+            layerManager->setActiveLayer(layerManager->layer(0));
+        }
     }
-    
+
+    // 应用SVG到Scene的变换到导入的顶级元素和图层
+    if (!svgToSceneTransform.isIdentity()) {
+        for (DrawingShape *shape : topLevelShapes) {
+            if (!shape->parentItem()) {
+                shape->setTransform(svgToSceneTransform * shape->transform());
+            }
+        }
+        for (DrawingLayer *layer : importedLayers) {
+            layer->setLayerTransform(svgToSceneTransform * layer->layerTransform());
+        }
+    }
+
+    // 定义元素和预解析数据只在导入期间有效
+    context.definedElements.clear();
+    context.preparsedShapes.clear();
+
     return true;
 }
 
@@ -712,9 +954,9 @@ DrawingPath* SvgStreamHandler::parsePathElementFromAttributes(const QXmlStreamAt
         return nullptr;
     }
     
-    QString d = attributes.value("d").toString();
+    // 直接解析属性视图，避免复制路径字符串
     QPainterPath path;
-    parseSvgPathData(d, path);
+    FastPathParser::parsePathData(attributes.value("d"), path);
     
     DrawingPath *drawingPath = new DrawingPath();
     drawingPath->setPath(path);
@@ -897,7 +1139,7 @@ void SvgStreamHandler::parseStyleAttributesFromStyleString(DrawingShape *shape,
 }
 
 // 从流式解析的元素解析SVG文档
-bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const SvgStreamElement &rootElement)
+bool SvgStreamHandler::parseSvgDocumentFromElement(SvgImportContext &context, DrawingScene *scene, const SvgStreamElement &rootElement)
 {
     if (rootElement.tagName != "svg")
     {
@@ -913,44 +1155,35 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     // 计算SVG到Scene的变换矩阵
     QTransform svgToSceneTransform = calculateSvgToSceneTransform(metadata);
 
-    // 清空之前存储的定义元素
-    s_definedElements.clear();
-
     // 使用优化的元素收集器，单次遍历收集所有元素
     SvgElementCollector::CollectedElements collected = collectElementsFromStream(rootElement);
     
-    // 更新全局定义元素缓存
-    s_definedElements = collected.definedElements;
-
-    // 清理之前的渐变定义
-    s_gradients.clear();
+    // 更新定义元素缓存
+    context.definedElements = collected.definedElements;
 
     // 批量处理渐变定义 - 使用SvgHandler的静态函数
     for (const QDomElement &gradient : collected.linearGradients) {
         QString id = gradient.attribute("id");
         if (!id.isEmpty()) {
             QLinearGradient linearGradient = SvgHandler::parseLinearGradient(gradient);
-            s_gradients[id] = linearGradient;
+            context.gradients[id] = linearGradient;
         }
     }
     for (const QDomElement &gradient : collected.radialGradients) {
         QString id = gradient.attribute("id");
         if (!id.isEmpty()) {
             QRadialGradient radialGradient = SvgHandler::parseRadialGradient(gradient);
-            s_gradients[id] = radialGradient;
+            context.gradients[id] = radialGradient;
         }
     }
 
-    // 清理之前的滤镜定义
-    s_filters.clear();
-
     // 批量处理滤镜定义 - 使用SvgHandler的静态函数
     for (const QDomElement &filter : collected.gaussianBlurFilters) {
         QString id = filter.attribute("filter-id"); // 使用我们设置的filter-id属性
         if (!id.isEmpty()) {
             QGraphicsBlurEffect *blurEffect = SvgHandler::parseGaussianBlurFilter(filter);
             if (blurEffect) {
-                s_filters[id] = blurEffect;
+                context.filters[id] = blurEffect;
             }
         }
     }
@@ -959,34 +1192,27 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
         if (!id.isEmpty()) {
             QGraphicsDropShadowEffect *shadowEffect = SvgHandler::parseDropShadowFilter(filter);
             if (shadowEffect) {
-                s_filters[id] = shadowEffect;
+                context.filters[id] = shadowEffect;
             }
         }
     }
 
-    // 清理之前的图案定义
-    s_patterns.clear();
-
     // 批量处理图案定义 - 使用SvgHandler的静态函数
     for (const QDomElement &pattern : collected.patterns) {
         QString id = pattern.attribute("id");
         if (!id.isEmpty()) {
             QBrush patternBrush = SvgHandler::parsePatternBrush(pattern);
-            s_patterns[id] = patternBrush;
+            context.patterns[id] = patternBrush;
         }
     }
 
-    // 清理之前的标记定义
-    s_markers.clear();
-    s_markerDataCache.clear();
-
     // 批量处理标记定义 - 使用SvgHandler的静态函数
     for (const QDomElement &marker : collected.markers) {
         QString id = marker.attribute("id");
         if (!id.isEmpty()) {
-            s_markers[id] = marker;
+            context.markers[id] = marker;
             MarkerData markerData = SvgHandler::parseMarkerData(marker);
-            s_markerDataCache[id] = markerData;
+            context.markerDataCache[id] = markerData;
         }
     }
 
@@ -1003,7 +1229,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     // 首先处理group和layer元素，它们包含子元素
     for (const QDomElement &element : collected.groups) {
         qDebug() << "处理group:" << element.attribute("transform");
-        DrawingGroup *shape = parseGroupElement(scene, element);
+        DrawingGroup *shape = parseGroupElement(context, scene, element);
         qDebug() << "Group结果:" << shape << "子项:" << (shape ? shape->childItems().count() : 0);
         if (shape) {
             scene->addItem(shape);
@@ -1014,7 +1240,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     
     // 处理图层元素（包括嵌套的处理）
     for (const QDomElement &element : collected.layers) {
-        DrawingGroup *group = parseGroupElement(scene, element);
+        DrawingGroup *group = parseGroupElement(context, scene, element);
         if (group) {
             elementCount++;
         }
@@ -1022,7 +1248,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     
     // 然后处理不属于任何group的顶级图形元素
     for (const QDomElement &element : collected.paths) {
-        DrawingPath *shape = parsePathElement(element);
+        DrawingPath *shape = parsePathElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1030,7 +1256,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.rectangles) {
-        DrawingRectangle *shape = parseRectElement(element);
+        DrawingRectangle *shape = parseRectElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1038,7 +1264,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.circles) {
-        DrawingEllipse *shape = parseCircleElement(element);
+        DrawingEllipse *shape = parseCircleElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1046,7 +1272,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.ellipses) {
-        DrawingEllipse *shape = parseEllipseElement(element);
+        DrawingEllipse *shape = parseEllipseElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1054,7 +1280,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.lines) {
-        DrawingPath *shape = parseLineElement(element);
+        DrawingPath *shape = parseLineElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1062,7 +1288,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.polylines) {
-        DrawingPath *shape = parsePolygonElement(element);
+        DrawingPath *shape = parsePolygonElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1070,7 +1296,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.polygons) {
-        DrawingPath *shape = parsePolygonElement(element);
+        DrawingPath *shape = parsePolygonElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1078,7 +1304,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.texts) {
-        DrawingText *shape = parseTextElement(element);
+        DrawingText *shape = parseTextElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1086,7 +1312,7 @@ bool SvgStreamHandler::parseSvgDocumentFromElement(DrawingScene *scene, const Sv
     }
     
     for (const QDomElement &element : collected.useElements) {
-        DrawingShape *shape = parseUseElement(element);
+        DrawingShape *shape = parseUseElement(context, element);
         if (shape) {
             scene->addItem(shape);
             shape->setZValue(elementCount++);
@@ -1148,7 +1374,7 @@ void SvgStreamHandler::parseTransformAttribute(DrawingShape *shape, const QStrin
 }
 
 // 基础图形解析函数实现
-DrawingRectangle* SvgStreamHandler::parseRectElement(const QDomElement &element)
+DrawingRectangle* SvgStreamHandler::parseRectElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal x = element.attribute("x", "0").toDouble();
     qreal y = element.attribute("y", "0").toDouble();
@@ -1164,7 +1390,7 @@ DrawingRectangle* SvgStreamHandler::parseRectElement(const QDomElement &element)
     rect->setPos(x, y);
 
     // 解析样式属性
-    parseStyleAttributes(rect, element);
+    parseStyleAttributes(context, rect, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1176,7 +1402,7 @@ DrawingRectangle* SvgStreamHandler::parseRectElement(const QDomElement &element)
     return rect;
 }
 
-DrawingEllipse* SvgStreamHandler::parseCircleElement(const QDomElement &element)
+DrawingEllipse* SvgStreamHandler::parseCircleElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal cx = element.attribute("cx", "0").toDouble();
     qreal cy = element.attribute("cy", "0").toDouble();
@@ -1192,7 +1418,7 @@ DrawingEllipse* SvgStreamHandler::parseCircleElement(const QDomElement &element)
     circle->setPos(cx - r, cy - r);
 
     // 解析样式属性
-    parseStyleAttributes(circle, element);
+    parseStyleAttributes(context, circle, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1204,7 +1430,7 @@ DrawingEllipse* SvgStreamHandler::parseCircleElement(const QDomElement &element)
     return circle;
 }
 
-DrawingEllipse* SvgStreamHandler::parseEllipseElement(const QDomElement &element)
+DrawingEllipse* SvgStreamHandler::parseEllipseElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal cx = element.attribute("cx", "0").toDouble();
     qreal cy = element.attribute("cy", "0").toDouble();
@@ -1221,7 +1447,7 @@ DrawingEllipse* SvgStreamHandler::parseEllipseElement(const QDomElement &element
     ellipse->setPos(cx, cy);
 
     // 解析样式属性
-    parseStyleAttributes(ellipse, element);
+    parseStyleAttributes(context, ellipse, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1233,7 +1459,7 @@ DrawingEllipse* SvgStreamHandler::parseEllipseElement(const QDomElement &element
     return ellipse;
 }
 
-DrawingPath* SvgStreamHandler::parseLineElement(const QDomElement &element)
+DrawingPath* SvgStreamHandler::parseLineElement(SvgImportContext &context, const QDomElement &element)
 {
     qreal x1 = element.attribute("x1", "0").toDouble();
     qreal y1 = element.attribute("y1", "0").toDouble();
@@ -1248,7 +1474,7 @@ DrawingPath* SvgStreamHandler::parseLineElement(const QDomElement &element)
     line->setPath(path);
 
     // 解析样式属性
-    parseStyleAttributes(line, element);
+    parseStyleAttributes(context, line, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1263,12 +1489,12 @@ DrawingPath* SvgStreamHandler::parseLineElement(const QDomElement &element)
     QString markerEnd = element.attribute("marker-end");
 
     // 应用Marker
-    applyMarkers(line, markerStart, markerMid, markerEnd);
+    applyMarkers(context, line, markerStart, markerMid, markerEnd);
 
     return line;
 }
 
-DrawingPath* SvgStreamHandler::parsePolygonElement(const QDomElement &element)
+DrawingPath* SvgStreamHandler::parsePolygonElement(SvgImportContext &context, const QDomElement &element)
 {
     QString tagName = element.tagName();
     QString pointsStr = element.attribute("points");
@@ -1289,7 +1515,7 @@ DrawingPath* SvgStreamHandler::parsePolygonElement(const QDomElement &element)
     shape->setPath(path);
 
     // 解析样式属性
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1304,56 +1530,56 @@ DrawingPath* SvgStreamHandler::parsePolygonElement(const QDomElement &element)
     QString markerEnd = element.attribute("marker-end");
 
     // 应用Marker
-    applyMarkers(shape, markerStart, markerMid, markerEnd);
+    applyMarkers(context, shape, markerStart, markerMid, markerEnd);
 
     return shape;
 }
 
 // 其他函数继续使用SvgHandler的实现
-DrawingShape* SvgStreamHandler::parseSvgElement(const QDomElement &element)
+DrawingShape* SvgStreamHandler::parseSvgElement(SvgImportContext &context, const QDomElement &element)
 {
     QString tagName = element.tagName();
     
     if (tagName == "path")
     {
-        return parsePathElement(element);
+        return parsePathElement(context, element);
     }
     else if (tagName == "rect")
     {
-        return parseRectElement(element);
+        return parseRectElement(context, element);
     }
     else if (tagName == "circle")
     {
-        return parseCircleElement(element);
+        return parseCircleElement(context, element);
     }
     else if (tagName == "ellipse")
     {
-        return parseEllipseElement(element);
+        return parseEllipseElement(context, element);
     }
     else if (tagName == "line")
     {
-        return parseLineElement(element);
+        return parseLineElement(context, element);
     }
     else if (tagName == "polyline")
     {
-        return parsePolygonElement(element); // polyline和polygon使用相同的解析
+        return parsePolygonElement(context, element); // polyline和polygon使用相同的解析
     }
     else if (tagName == "polygon")
     {
-        return parsePolygonElement(element);
+        return parsePolygonElement(context, element);
     }
     else if (tagName == "text")
     {
-        return parseTextElement(element);
+        return parseTextElement(context, element);
     }
     else if (tagName == "use")
     {
-        return parseUseElement(element);
+        return parseUseElement(context, element);
     }
     
     return nullptr;
 }
-DrawingPath* SvgStreamHandler::parsePathElement(const QDomElement &element)
+DrawingPath* SvgStreamHandler::parsePathElement(SvgImportContext &context, const QDomElement &element)
 {
     QString d = element.attribute("d");
     if (d.isEmpty())
@@ -1385,7 +1611,7 @@ DrawingPath* SvgStreamHandler::parsePathElement(const QDomElement &element)
     drawingPath->setControlPointTypes(controlPointTypes);
 
     // 解析样式属性
-    parseStyleAttributes(drawingPath, element);
+    parseStyleAttributes(context, drawingPath, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1400,11 +1626,11 @@ DrawingPath* SvgStreamHandler::parsePathElement(const QDomElement &element)
     QString markerEnd = element.attribute("marker-end");
 
     // 应用Marker
-    applyMarkers(drawingPath, markerStart, markerMid, markerEnd);
+    applyMarkers(context, drawingPath, markerStart, markerMid, markerEnd);
 
     return drawingPath;
 }
-DrawingText* SvgStreamHandler::parseTextElement(const QDomElement &element)
+DrawingText* SvgStreamHandler::parseTextElement(SvgImportContext &context, const QDomElement &element)
 {
     // 获取文本内容
     QString text = element.text().trimmed();
@@ -1471,7 +1697,7 @@ DrawingText* SvgStreamHandler::parseTextElement(const QDomElement &element)
     }
 
     // 解析样式属性
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
 
     // 解析变换属性
     QString transform = element.attribute("transform");
@@ -1483,7 +1709,7 @@ DrawingText* SvgStreamHandler::parseTextElement(const QDomElement &element)
     
     return shape;
 }
-DrawingGroup* SvgStreamHandler::parseGroupElement(DrawingScene *scene, const QDomElement &groupElement)
+DrawingGroup* SvgStreamHandler::parseGroupElement(SvgImportContext &context, DrawingScene *scene, const QDomElement &groupElement)
 {
     // 检查是否是图层（带有 inkscape:label 属性）
     QString layerId = groupElement.attribute("inkscape:label");
@@ -1525,7 +1751,7 @@ DrawingGroup* SvgStreamHandler::parseGroupElement(DrawingScene *scene, const QDo
         group = new DrawingGroup();
 
         // 解析组的样式属性
-        parseStyleAttributes(group, groupElement);
+        parseStyleAttributes(context, group, groupElement);
     }
 
     // 遍历组中的所有子元素
@@ -1541,7 +1767,7 @@ DrawingGroup* SvgStreamHandler::parseGroupElement(DrawingScene *scene, const QDo
             if (tagName == "g")
             {
                 // 递归处理嵌套组
-                DrawingGroup *nestedGroup = parseGroupElement(scene, element);
+                DrawingGroup *nestedGroup = parseGroupElement(context, scene, element);
                 if (nestedGroup && group) {
                     group->addItem(nestedGroup);
                 }
@@ -1550,7 +1776,7 @@ DrawingGroup* SvgStreamHandler::parseGroupElement(DrawingScene *scene, const QDo
             {
                 try
                 {
-                    DrawingShape *shape = parseSvgElement(element);
+                    DrawingShape *shape = parseSvgElement(context, element);
                     if (shape)
                     {
                         // 应用子对象自己的变换（如果有）
@@ -1630,7 +1856,7 @@ DrawingGroup* SvgStreamHandler::parseGroupElement(DrawingScene *scene, const QDo
     return group;
 }
 DrawingLayer* SvgStreamHandler::parseLayerElement(const QDomElement &element) { return nullptr; }
-DrawingShape* SvgStreamHandler::parseUseElement(const QDomElement &element)
+DrawingShape* SvgStreamHandler::parseUseElement(SvgImportContext &context, const QDomElement &element)
 {
     // 获取href属性（引用的元素ID）
     QString href = element.attribute("href");
@@ -1648,15 +1874,15 @@ DrawingShape* SvgStreamHandler::parseUseElement(const QDomElement &element)
     QString refId = href.mid(1); // 去掉#
 
     // 查找定义的元素
-    if (!s_definedElements.contains(refId))
+    if (!context.definedElements.contains(refId))
     {
         return nullptr;
     }
 
-    QDomElement referencedElement = s_definedElements[refId];
+    QDomElement referencedElement = context.definedElements[refId];
 
     // 克隆并解析引用的元素
-    DrawingShape *shape = parseSvgElement(referencedElement);
+    DrawingShape *shape = parseSvgElement(context, referencedElement);
     if (!shape)
     {
         return nullptr;
@@ -1685,7 +1911,7 @@ DrawingShape* SvgStreamHandler::parseUseElement(const QDomElement &element)
 
     // 解析样式属性：use元素的样式会覆盖引用元素的样式
     // 但如果use元素没有某个样式属性，应该继承引用元素的样式
-    parseStyleAttributes(shape, element);
+    parseStyleAttributes(context, shape, element);
     
     // 如果use元素没有fill属性，继承引用元素的fill
     if (!element.hasAttribute("fill") && referencedElement.hasAttribute("fill"))
@@ -1750,7 +1976,7 @@ DrawingShape* SvgStreamHandler::parseUseElement(const QDomElement &element)
     return shape;
 }
 
-void SvgStreamHandler::parseStyleAttributes(DrawingShape *shape, const QDomElement &element)
+void SvgStreamHandler::parseStyleAttributes(SvgImportContext &context, DrawingShape *shape, const QDomElement &element)
 {
     // 解析stroke属性
     QString stroke = element.attribute("stroke");
@@ -1796,16 +2022,16 @@ void SvgStreamHandler::parseStyleAttributes(DrawingShape *shape, const QDomEleme
         else if (fill.startsWith("url(#"))
         {
             QString refId = fill.mid(5, fill.length() - 6);
-            if (s_gradients.contains(refId))
+            if (context.gradients.contains(refId))
             {
-                QGradient gradient = s_gradients[refId];
+                QGradient gradient = context.gradients[refId];
                 gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
                 QBrush brush(gradient);
                 shape->setFillBrush(brush);
             }
-            else if (s_patterns.contains(refId))
+            else if (context.patterns.contains(refId))
             {
-                QBrush patternBrush = s_patterns[refId];
+                QBrush patternBrush = context.patterns[refId];
                 shape->setFillBrush(patternBrush);
             }
         }
@@ -1840,10 +2066,10 @@ void SvgStreamHandler::parseStyleAttributes(DrawingShape *shape, const QDomEleme
     }
 }
 
-void SvgStreamHandler::parseStyleAttributes(DrawingGroup *group, const QDomElement &element)
+void SvgStreamHandler::parseStyleAttributes(SvgImportContext &context, DrawingGroup *group, const QDomElement &element)
 {
     // 组元素的样式解析逻辑
-    parseStyleAttributes(static_cast<DrawingShape*>(group), element);
+    parseStyleAttributes(context, static_cast<DrawingShape*>(group), element);
 }
 
 void SvgStreamHandler::applyStyleToShape(DrawingShape *shape, const QString &style) 
@@ -1873,9 +2099,9 @@ void SvgStreamHandler::parseSvgPathData(const QString &data, QPainterPath &path)
     SvgHandler::parseSvgPathData(data, path); 
 }
 
-void SvgStreamHandler::applyMarkers(DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd) 
+void SvgStreamHandler::applyMarkers(SvgImportContext &context, DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd) 
 { 
-    SvgHandler::applyMarkers(path, markerStart, markerMid, markerEnd); 
+    SvgHandler::applyMarkers(context, path, markerStart, markerMid, markerEnd); 
 }
 
 QLinearGradient SvgStreamHandler::parseLinearGradient(const QDomElement &element)
@@ -40,6 +40,7 @@ class DrawingPolygon;
 // 前向声明
 struct SvgStreamElement;
 struct SvgMetadata;
+struct SvgPreparseCursor;
 class SvgStreamParser;
 
 /**
@@ -62,7 +63,14 @@ private:
     static void applySvgSettingsToScene(DrawingScene *scene, const SvgMetadata &metadata);
     
     // 真正的流式解析函数 - 使用栈结构
-    static bool parseSvgStream(DrawingScene *scene, QXmlStreamReader &reader);
+    static bool parseSvgStream(SvgImportContext &context, DrawingScene *scene, QXmlStreamReader &reader,
+                               SvgPreparseCursor &preparse);
+    
+    // 预解析：独立的扫描器从key处起提取下一批路径和点数据，在线程池中解析后替换上一批
+    static void preparseWindow(SvgImportContext &context, SvgPreparseCursor &cursor, quint64 key);
+    
+    // 注册流式读取到的定义元素（渐变、滤镜、图案、标记、带id的元素）
+    static void registerDefinitions(SvgImportContext &context, const QDomElement &element);
     
     // 从属性直接创建元素的辅助函数
     static DrawingRectangle* parseRectElementFromAttributes(const QXmlStreamAttributes &attributes);
@@ -72,7 +80,7 @@ private:
     static DrawingText* parseTextElementFromAttributes(const QXmlStreamReader &reader);
     
     // 从流式解析的元素解析SVG文档
-    static bool parseSvgDocumentFromElement(DrawingScene *scene, const SvgStreamElement &rootElement);
+    static bool parseSvgDocumentFromElement(SvgImportContext &context, DrawingScene *scene, const SvgStreamElement &rootElement);
     
     // 流式解析辅助函数
     static SvgElementCollector::CollectedElements collectElementsFromStream(const SvgStreamElement &rootElement);
@@ -82,17 +90,17 @@ private:
                                                    bool isInGroup = false);
     
     // 解析SVG元素（复用DOM版本的函数）
-    static DrawingShape* parseSvgElement(const QDomElement &element);
-    static DrawingPath* parsePathElement(const QDomElement &element);
-    static DrawingRectangle* parseRectElement(const QDomElement &element);
-    static DrawingEllipse* parseEllipseElement(const QDomElement &element);
-    static DrawingEllipse* parseCircleElement(const QDomElement &element);
-    static DrawingPath* parseLineElement(const QDomElement &element);
-    static DrawingPath* parsePolygonElement(const QDomElement &element);
-    static DrawingText* parseTextElement(const QDomElement &element);
-    static DrawingGroup* parseGroupElement(DrawingScene *scene, const QDomElement &groupElement);
+    static DrawingShape* parseSvgElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingPath* parsePathElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingRectangle* parseRectElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingEllipse* parseEllipseElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingEllipse* parseCircleElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingPath* parseLineElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingPath* parsePolygonElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingText* parseTextElement(SvgImportContext &context, const QDomElement &element);
+    static DrawingGroup* parseGroupElement(SvgImportContext &context, DrawingScene *scene, const QDomElement &groupElement);
     static DrawingLayer* parseLayerElement(const QDomElement &element);
-    static DrawingShape* parseUseElement(const QDomElement &element);
+    static DrawingShape* parseUseElement(SvgImportContext &context, const QDomElement &element);
     
     // 解析变换字符串为QTransform（复用DOM版本的函数）
     static QTransform parseTransform(const QString &transformStr);
@@ -100,8 +108,8 @@ private:
     
     // 解析样式到图形（复用DOM版本的函数）
     static void applyStyleToShape(DrawingShape *shape, const QString &style);
-    static void parseStyleAttributes(DrawingShape *shape, const QDomElement &element);
-    static void parseStyleAttributes(DrawingGroup *group, const QDomElement &element);
+    static void parseStyleAttributes(SvgImportContext &context, DrawingShape *shape, const QDomElement &element);
+    static void parseStyleAttributes(SvgImportContext &context, DrawingGroup *group, const QDomElement &element);
     
     // 流式解析版本的样式解析
     static void parseStyleAttributes(DrawingShape *shape, const QXmlStreamAttributes &attributes);
@@ -132,7 +140,7 @@ private:
     
     // 解析Marker（复用DOM版本的函数）
     static MarkerData parseMarkerData(const QDomElement &markerElement);
-    static void applyMarkers(DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd);
+    static void applyMarkers(SvgImportContext &context, DrawingPath *path, const QString &markerStart, const QString &markerMid, const QString &markerEnd);
     
     // 辅助函数：从字符串解析点数据（复用DOM版本的函数）
     static void parseSvgPointsData(const QString &pointsStr, QPainterPath &path, bool closePath = true);
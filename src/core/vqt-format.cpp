@@ -0,0 +1,1056 @@
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <cstddef>
+#include <cstring>
+#include "vqt-format.h"
+#include "drawing-shape.h"
+#include "drawing-group.h"
+#include "drawing-layer.h"
+#include "layer-manager.h"
+#include "../ui/drawingscene.h"
+
+namespace {
+
+// 文件各段，顺序即段表中的顺序
+enum VqtSectionId
+{
+    StringEntries,
+    StringData,
+    PathElements,
+    Points,
+    Pens,
+    Brushes,
+    BlobEntries,
+    BlobData,
+    Layers,
+    Shapes,
+    SectionCount
+};
+
+const char VqtMagic[4] = { 'V', 'Q', 'T', 'D' };
+const quint32 VqtByteOrderMark = 0x01020304;
+const quint32 VqtNoIndex = 0xffffffffu;
+
+// 从此版本起组合的附加数据块为ShapeRecordWriter记录，之前为已废弃的原始序列化格式
+const quint16 VqtRecordGroupVersion = 2;
+
+// 从此版本起组合展开为带父索引的图形记录，图形记录增加图形项变换，路径元素记录节点类型
+const quint16 VqtFlatGroupVersion = 3;
+
+struct VqtSection
+{
+    quint64 offset;
+    quint64 count;  // 元素个数，不是字节数
+};
+
+struct VqtHeader
+{
+    char magic[4];
+    quint16 version;
+    quint16 headerSize;
+    quint32 byteOrder;
+    qint32 activeLayer;
+    double sceneRect[4];
+    VqtSection sections[SectionCount];
+};
+
+// 字符串（UTF-16单元）和附加数据块（字节）在数据区中的范围
+struct VqtRange
+{
+    quint32 offset;
+    quint32 length;
+};
+
+struct VqtPathElement
+{
+    double x;
+    double y;
+    qint32 type;
+    quint32 nodeType;   // 以该元素为锚点的节点类型加1，0表示未记录（按路径推导）
+};
+
+struct VqtPoint
+{
+    double x;
+    double y;
+};
+
+struct VqtPen
+{
+    quint64 color;      // QRgba64
+    double width;
+    double miterLimit;
+    quint16 capStyle;
+    quint16 joinStyle;
+    quint8 style;
+    quint8 cosmetic;
+    quint16 reserved;
+    quint32 blob;       // 渐变画笔、自定义虚线等无法扁平化的画笔
+    quint32 reserved2;
+};
+
+struct VqtBrush
+{
+    quint64 color;      // QRgba64
+    quint32 style;
+    quint32 blob;       // 渐变、纹理或带变换的画刷
+};
+
+struct VqtLayer
+{
+    quint32 name;
+    quint32 flags;
+    double opacity;
+    double transform[9];
+    quint32 firstShape;
+    quint32 shapeCount;
+};
+
+struct VqtShape
+{
+    quint8 type;
+    quint8 flags;
+    quint16 fillRule;
+    quint32 id;
+    quint32 pen;
+    quint32 brush;
+    quint32 dataOffset;  // 路径元素或点数组中的起始索引
+    quint32 dataCount;
+    quint32 text;
+    quint32 font;
+    quint32 blob;        // 路径的marker（版本2的组合为子对象记录）
+    quint32 parent;      // 所属组合的记录索引，顶层图形为VqtNoIndex
+    double pos[2];
+    double scale;
+    double rotation;
+    double zValue;
+    double opacity;
+    double transform[9];      // DrawingShape自身的变换
+    double geometry[8];       // 按类型解释，见writeGeometry
+    double itemTransform[9];  // QGraphicsItem的变换，SVG导入等会设置
+};
+
+// 版本3之前的图形记录没有itemTransform，parent位置恒为0
+const quint64 VqtShapeV2Size = 224;
+
+static_assert(sizeof(VqtHeader) % 8 == 0, "VqtHeader must keep 8-byte alignment");
+static_assert(sizeof(VqtPathElement) == 24, "unexpected VqtPathElement layout");
+static_assert(sizeof(VqtPen) == 40, "unexpected VqtPen layout");
+static_assert(sizeof(VqtBrush) == 16, "unexpected VqtBrush layout");
+static_assert(sizeof(VqtLayer) == 96, "unexpected VqtLayer layout");
+static_assert(sizeof(VqtShape) == 296, "unexpected VqtShape layout");
+static_assert(offsetof(VqtShape, itemTransform) == VqtShapeV2Size, "itemTransform must extend the version 2 record");
+
+enum VqtLayerFlag
+{
+    LayerVisible = 0x1,
+    LayerLocked = 0x2
+};
+
+enum VqtShapeFlag
+{
+    ShapeVisible = 0x1,
+    ShapeEnabled = 0x2,
+    ShapeClosed = 0x4,
+    ShapeShowControlPolygon = 0x8
+};
+
+inline qint64 alignTo8(qint64 value)
+{
+    return (value + 7) & ~qint64(7);
+}
+
+void transformToArray(const QTransform &transform, double *out)
+{
+    out[0] = transform.m11(); out[1] = transform.m12(); out[2] = transform.m13();
+    out[3] = transform.m21(); out[4] = transform.m22(); out[5] = transform.m23();
+    out[6] = transform.m31(); out[7] = transform.m32(); out[8] = transform.m33();
+}
+
+QTransform transformFromArray(const double *in)
+{
+    return QTransform(in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7], in[8]);
+}
+
+template <typename T>
+QByteArray recordKey(const T &record)
+{
+    return QByteArray(reinterpret_cast<const char *>(&record), sizeof(T));
+}
+
+/**
+ * 收集场景数据并写出各段
+ */
+class VqtWriter
+{
+public:
+    quint32 addString(const QString &text)
+    {
+        auto it = m_stringIndex.constFind(text);
+        if (it != m_stringIndex.constEnd()) {
+            return it.value();
+        }
+        VqtRange range;
+        range.offset = quint32(m_stringData.size());
+        range.length = quint32(text.size());
+        m_stringData.resize(m_stringData.size() + text.size());
+        std::memcpy(m_stringData.data() + range.offset, text.utf16(), text.size() * sizeof(char16_t));
+        const quint32 index = quint32(m_stringEntries.size());
+        m_stringEntries.append(range);
+        m_stringIndex.insert(text, index);
+        return index;
+    }
+
+    quint32 addBlob(const QByteArray &data)
+    {
+        VqtRange range;
+        range.offset = quint32(m_blobData.size());
+        range.length = quint32(data.size());
+        m_blobData.append(data);
+        m_blobEntries.append(range);
+        return quint32(m_blobEntries.size() - 1);
+    }
+
+    quint32 addPen(const QPen &pen)
+    {
+        VqtPen record = {};
+        record.color = pen.color().rgba64();
+        record.width = pen.widthF();
+        record.miterLimit = pen.miterLimit();
+        record.capStyle = quint16(pen.capStyle());
+        record.joinStyle = quint16(pen.joinStyle());
+        record.style = quint8(pen.style());
+        record.cosmetic = pen.isCosmetic() ? 1 : 0;
+        record.blob = VqtNoIndex;
+
+        const bool plainBrush = pen.brush().style() == Qt::SolidPattern
+            || pen.brush().style() == Qt::NoBrush;
+        if (!plainBrush || pen.style() == Qt::CustomDashLine || pen.dashOffset() != 0.0) {
+            record.blob = addBlob(streamed(pen));
+            return appendRecord(m_pens, record);
+        }
+        return appendUnique(m_pens, m_penIndex, record);
+    }
+
+    quint32 addBrush(const QBrush &brush)
+    {
+        VqtBrush record = {};
+        record.color = brush.color().rgba64();
+        record.style = quint32(brush.style());
+        record.blob = VqtNoIndex;
+
+        if (brush.gradient() || brush.style() == Qt::TexturePattern || !brush.transform().isIdentity()) {
+            record.blob = addBlob(streamed(brush));
+            return appendRecord(m_brushes, record);
+        }
+        return appendUnique(m_brushes, m_brushIndex, record);
+    }
+
+    void addLayer(DrawingLayer *layer)
+    {
+        VqtLayer record = {};
+        record.name = addString(layer->name());
+        record.flags = (layer->isVisible() ? LayerVisible : 0) | (layer->isLocked() ? LayerLocked : 0);
+        record.opacity = layer->opacity();
+        transformToArray(layer->layerTransform(), record.transform);
+        record.firstShape = quint32(m_shapes.size());
+
+        for (DrawingShape *shape : layer->shapes()) {
+            if (shape) {
+                addShape(shape);
+            }
+        }
+
+        record.shapeCount = quint32(m_shapes.size()) - record.firstShape;
+        m_layers.append(record);
+    }
+
+    /**
+     * 写入图形记录；组合的子对象作为后续记录展开，通过parent指向组合记录
+     * @return 图形记录的索引
+     */
+    quint32 addShape(DrawingShape *shape, quint32 parent = VqtNoIndex)
+    {
+        VqtShape record = {};
+        record.type = quint8(shape->shapeType());
+        record.flags = (shape->isVisible() ? ShapeVisible : 0) | (shape->isEnabled() ? ShapeEnabled : 0);
+        record.fillRule = quint16(shape->fillRule());
+        record.id = addString(shape->id());
+        record.pen = addPen(shape->strokePen());
+        record.brush = addBrush(shape->fillBrush());
+        record.text = VqtNoIndex;
+        record.font = VqtNoIndex;
+        record.blob = VqtNoIndex;
+        record.parent = parent;
+        record.pos[0] = shape->pos().x();
+        record.pos[1] = shape->pos().y();
+        record.scale = shape->scale();
+        record.rotation = shape->rotation();
+        record.zValue = shape->zValue();
+        record.opacity = shape->opacity();
+        transformToArray(shape->transform(), record.transform);
+        transformToArray(shape->QGraphicsItem::transform(), record.itemTransform);
+
+        writeGeometry(shape, record);
+        const quint32 index = quint32(m_shapes.size());
+        m_shapes.append(record);
+
+        if (shape->shapeType() == DrawingShape::Group) {
+            for (DrawingShape *child : static_cast<DrawingGroup *>(shape)->items()) {
+                if (child) {
+                    addShape(child, index);
+                }
+            }
+        }
+        return index;
+    }
+
+    bool writeTo(QIODevice *device, DrawingScene *scene, int activeLayer) const
+    {
+        VqtHeader header = {};
+        std::memcpy(header.magic, VqtMagic, sizeof(VqtMagic));
+        header.version = VqtFormat::Version;
+        header.headerSize = quint16(sizeof(VqtHeader));
+        header.byteOrder = VqtByteOrderMark;
+        header.activeLayer = activeLayer;
+        const QRectF sceneRect = scene->sceneRect();
+        header.sceneRect[0] = sceneRect.x();
+        header.sceneRect[1] = sceneRect.y();
+        header.sceneRect[2] = sceneRect.width();
+        header.sceneRect[3] = sceneRect.height();
+
+        const QByteArray sections[SectionCount] = {
+            rawBytes(m_stringEntries),
+            rawBytes(m_stringData),
+            rawBytes(m_pathElements),
+            rawBytes(m_points),
+            rawBytes(m_pens),
+            rawBytes(m_brushes),
+            rawBytes(m_blobEntries),
+            m_blobData,
+            rawBytes(m_layers),
+            rawBytes(m_shapes)
+        };
+        const quint64 counts[SectionCount] = {
+            quint64(m_stringEntries.size()), quint64(m_stringData.size()),
+            quint64(m_pathElements.size()), quint64(m_points.size()),
+            quint64(m_pens.size()), quint64(m_brushes.size()),
+            quint64(m_blobEntries.size()), quint64(m_blobData.size()),
+            quint64(m_layers.size()), quint64(m_shapes.size())
+        };
+
+        qint64 offset = alignTo8(sizeof(VqtHeader));
+        for (int i = 0; i < SectionCount; ++i) {
+            header.sections[i].offset = quint64(offset);
+            header.sections[i].count = counts[i];
+            offset = alignTo8(offset + sections[i].size());
+        }
+
+        static const char padding[8] = {};
+        if (device->write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))) {
+            return false;
+        }
+        qint64 written = sizeof(header);
+        for (int i = 0; i < SectionCount; ++i) {
+            const qint64 gap = qint64(header.sections[i].offset) - written;
+            if (gap > 0 && device->write(padding, gap) != gap) {
+                return false;
+            }
+            if (device->write(sections[i]) != sections[i].size()) {
+                return false;
+            }
+            written = qint64(header.sections[i].offset) + sections[i].size();
+        }
+        return true;
+    }
+
+private:
+    template <typename T>
+    static QByteArray rawBytes(const QVector<T> &records)
+    {
+        return QByteArray(reinterpret_cast<const char *>(records.constData()),
+                          records.size() * qsizetype(sizeof(T)));
+    }
+
+    template <typename T>
+    static QByteArray streamed(const T &value)
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << value;
+        return data;
+    }
+
+    template <typename T>
+    static quint32 appendRecord(QVector<T> &records, const T &record)
+    {
+        records.append(record);
+        return quint32(records.size() - 1);
+    }
+
+    // 绝大多数图形共用少数几种画笔和画刷，按记录字节去重
+    template <typename T>
+    static quint32 appendUnique(QVector<T> &records, QHash<QByteArray, quint32> &index, const T &record)
+    {
+        const QByteArray key = recordKey(record);
+        auto it = index.constFind(key);
+        if (it != index.constEnd()) {
+            return it.value();
+        }
+        const quint32 position = appendRecord(records, record);
+        index.insert(key, position);
+        return position;
+    }
+
+    void appendPoints(const QVector<QPointF> &points, VqtShape &record)
+    {
+        record.dataOffset = quint32(m_points.size());
+        record.dataCount = quint32(points.size());
+        for (const QPointF &point : points) {
+            m_points.append(VqtPoint{ point.x(), point.y() });
+        }
+    }
+
+    // geometry数组的含义：
+    //   矩形   x, y, w, h, 圆角半径, 圆角比例X, 圆角比例Y
+    //   椭圆   x, y, w, h, 起始角, 跨度角
+    //   直线   x1, y1, x2, y2, 线宽
+    //   折线   线宽
+    //   文本   位置x, 位置y（字号包含在字体字符串中）
+    void writeGeometry(DrawingShape *shape, VqtShape &record)
+    {
+        double *g = record.geometry;
+
+        switch (shape->shapeType()) {
+        case DrawingShape::Rectangle: {
+            DrawingRectangle *rect = static_cast<DrawingRectangle *>(shape);
+            const QRectF r = rect->rectangle();
+            g[0] = r.x(); g[1] = r.y(); g[2] = r.width(); g[3] = r.height();
+            g[4] = rect->cornerRadius();
+            g[5] = rect->cornerRadiusRatioX();
+            g[6] = rect->cornerRadiusRatioY();
+            break;
+        }
+        case DrawingShape::Ellipse: {
+            DrawingEllipse *ellipse = static_cast<DrawingEllipse *>(shape);
+            const QRectF r = ellipse->ellipse();
+            g[0] = r.x(); g[1] = r.y(); g[2] = r.width(); g[3] = r.height();
+            g[4] = ellipse->startAngle();
+            g[5] = ellipse->spanAngle();
+            break;
+        }
+        case DrawingShape::Line: {
+            DrawingLine *line = static_cast<DrawingLine *>(shape);
+            const QLineF l = line->line();
+            g[0] = l.x1(); g[1] = l.y1(); g[2] = l.x2(); g[3] = l.y2();
+            g[4] = line->lineWidth();
+            break;
+        }
+        case DrawingShape::Polyline: {
+            DrawingPolyline *polyline = static_cast<DrawingPolyline *>(shape);
+            QVector<QPointF> points;
+            points.reserve(polyline->pointCount());
+            for (int i = 0; i < polyline->pointCount(); ++i) {
+                points.append(polyline->point(i));
+            }
+            appendPoints(points, record);
+            g[0] = polyline->lineWidth();
+            if (polyline->isClosed()) {
+                record.flags |= ShapeClosed;
+            }
+            break;
+        }
+        case DrawingShape::Polygon: {
+            DrawingPolygon *polygon = static_cast<DrawingPolygon *>(shape);
+            QVector<QPointF> points;
+            points.reserve(polygon->pointCount());
+            for (int i = 0; i < polygon->pointCount(); ++i) {
+                points.append(polygon->point(i));
+            }
+            appendPoints(points, record);
+            break;
+        }
+        case DrawingShape::Path: {
+            DrawingPath *drawingPath = static_cast<DrawingPath *>(shape);
+            const QPainterPath path = drawingPath->path();
+            record.dataOffset = quint32(m_pathElements.size());
+            record.dataCount = quint32(path.elementCount());
+            for (int i = 0; i < path.elementCount(); ++i) {
+                const QPainterPath::Element element = path.elementAt(i);
+                m_pathElements.append(VqtPathElement{ element.x, element.y, qint32(element.type), 0 });
+            }
+            // 节点类型（平滑、对称等）无法从路径推导，记在节点所在的元素上
+            VqtPathElement *elements = m_pathElements.data() + record.dataOffset;
+            for (const NodeInfo &node : drawingPath->getNodeInfo()) {
+                if (node.elementIndex >= 0 && node.elementIndex < path.elementCount()) {
+                    elements[node.elementIndex].nodeType = quint32(node.type) + 1;
+                }
+            }
+            if (drawingPath->showControlPolygon()) {
+                record.flags |= ShapeShowControlPolygon;
+            }
+            if (drawingPath->hasMarker()) {
+                record.blob = addBlob(markerBlob(drawingPath));
+            }
+            break;
+        }
+        case DrawingShape::Text: {
+            DrawingText *text = static_cast<DrawingText *>(shape);
+            record.text = addString(text->text());
+            record.font = addString(text->font().toString());
+            g[0] = text->position().x();
+            g[1] = text->position().y();
+            break;
+        }
+        case DrawingShape::Group:
+            // 组合没有自身的几何数据，子对象由addShape展开为后续记录
+            break;
+        }
+    }
+
+    static QByteArray markerBlob(DrawingPath *path)
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << qint32(path->markers().size());
+        for (const DrawingPath::MarkerInfo &marker : path->markers()) {
+            const MarkerData &markerData = marker.markerData;
+            stream << marker.markerId << marker.position << marker.markerTransform;
+            stream << qint32(markerData.type) << markerData.params
+                   << markerData.fillColor << markerData.strokeColor << markerData.strokeWidth
+                   << markerData.isValid << markerData.refX << markerData.refY
+                   << markerData.markerWidth << markerData.markerHeight << markerData.orient;
+        }
+        return data;
+    }
+
+    QVector<VqtRange> m_stringEntries;
+    QVector<char16_t> m_stringData;
+    QHash<QString, quint32> m_stringIndex;
+    QVector<VqtPathElement> m_pathElements;
+    QVector<VqtPoint> m_points;
+    QVector<VqtPen> m_pens;
+    QHash<QByteArray, quint32> m_penIndex;
+    QVector<VqtBrush> m_brushes;
+    QHash<QByteArray, quint32> m_brushIndex;
+    QVector<VqtRange> m_blobEntries;
+    QByteArray m_blobData;
+    QVector<VqtLayer> m_layers;
+    QVector<VqtShape> m_shapes;
+};
+
+/**
+ * 在映射内存上读取各段，所有偏移和索引在使用前都做边界检查
+ */
+class VqtReader
+{
+public:
+    VqtReader(const uchar *data, qint64 size)
+        : m_data(data)
+        , m_size(size)
+        , m_header(nullptr)
+    {
+    }
+
+    bool open()
+    {
+        if (m_size < qint64(sizeof(VqtHeader))) {
+            return false;
+        }
+        m_header = reinterpret_cast<const VqtHeader *>(m_data);
+        if (std::memcmp(m_header->magic, VqtMagic, sizeof(VqtMagic)) != 0
+            || m_header->byteOrder != VqtByteOrderMark
+            || m_header->version > VqtFormat::Version
+            || m_header->headerSize < sizeof(VqtHeader)) {
+            return false;
+        }
+
+        return section(m_stringEntries, StringEntries)
+            && section(m_stringData, StringData)
+            && section(m_pathElements, PathElements)
+            && section(m_points, Points)
+            && section(m_pens, Pens)
+            && section(m_brushes, Brushes)
+            && section(m_blobEntries, BlobEntries)
+            && section(m_blobData, BlobData)
+            && section(m_layers, Layers)
+            && shapeSection();
+    }
+
+    const VqtHeader &header() const { return *m_header; }
+
+    QString string(quint32 index) const
+    {
+        if (index >= m_stringEntries.count) {
+            return QString();
+        }
+        const VqtRange &range = m_stringEntries.records[index];
+        if (quint64(range.offset) + range.length > m_stringData.count) {
+            return QString();
+        }
+        return QString(reinterpret_cast<const QChar *>(m_stringData.records + range.offset), range.length);
+    }
+
+    // 返回的数据直接引用映射内存，只在映射有效期间使用
+    QByteArray blob(quint32 index) const
+    {
+        if (index >= m_blobEntries.count) {
+            return QByteArray();
+        }
+        const VqtRange &range = m_blobEntries.records[index];
+        if (quint64(range.offset) + range.length > m_blobData.count) {
+            return QByteArray();
+        }
+        return QByteArray::fromRawData(m_blobData.records + range.offset, range.length);
+    }
+
+    QPen pen(quint32 index) const
+    {
+        if (index >= m_pens.count) {
+            return QPen(Qt::NoPen);
+        }
+        const VqtPen &record = m_pens.records[index];
+        if (record.blob != VqtNoIndex) {
+            QPen pen;
+            QDataStream stream(blob(record.blob));
+            stream >> pen;
+            return pen;
+        }
+        QPen pen(QColor::fromRgba64(QRgba64::fromRgba64(record.color)));
+        pen.setWidthF(record.width);
+        pen.setMiterLimit(record.miterLimit);
+        pen.setCapStyle(Qt::PenCapStyle(record.capStyle));
+        pen.setJoinStyle(Qt::PenJoinStyle(record.joinStyle));
+        pen.setStyle(Qt::PenStyle(record.style));
+        pen.setCosmetic(record.cosmetic != 0);
+        return pen;
+    }
+
+    QBrush brush(quint32 index) const
+    {
+        if (index >= m_brushes.count) {
+            return QBrush(Qt::NoBrush);
+        }
+        const VqtBrush &record = m_brushes.records[index];
+        if (record.blob != VqtNoIndex) {
+            QBrush brush;
+            QDataStream stream(blob(record.blob));
+            stream >> brush;
+            return brush;
+        }
+        return QBrush(QColor::fromRgba64(QRgba64::fromRgba64(record.color)), Qt::BrushStyle(record.style));
+    }
+
+    quint64 layerCount() const { return m_layers.count; }
+    const VqtLayer &layer(quint64 index) const { return m_layers.records[index]; }
+
+    quint64 shapeCount() const { return m_shapeCount; }
+
+    // 旧版本的记录较短，按记录长度复制并补上缺少的字段
+    VqtShape shape(quint64 index) const
+    {
+        VqtShape record = {};
+        std::memcpy(&record, m_shapeRecords + index * m_shapeSize, m_shapeSize);
+        if (m_header->version < VqtFlatGroupVersion) {
+            record.parent = VqtNoIndex;
+            transformToArray(QTransform(), record.itemTransform);
+        }
+        return record;
+    }
+
+    DrawingShape *createShape(const VqtShape &record) const;
+
+private:
+    template <typename T>
+    struct Span
+    {
+        const T *records = nullptr;
+        quint64 count = 0;
+    };
+
+    template <typename T>
+    bool section(Span<T> &span, VqtSectionId id)
+    {
+        const VqtSection &entry = m_header->sections[id];
+        if (entry.offset % alignof(T) != 0 || entry.offset > quint64(m_size)
+            || entry.count > (quint64(m_size) - entry.offset) / sizeof(T)) {
+            return false;
+        }
+        span.records = reinterpret_cast<const T *>(m_data + entry.offset);
+        span.count = entry.count;
+        return true;
+    }
+
+    bool shapeSection()
+    {
+        const VqtSection &entry = m_header->sections[Shapes];
+        m_shapeSize = m_header->version < VqtFlatGroupVersion ? VqtShapeV2Size : sizeof(VqtShape);
+        if (entry.offset % alignof(VqtShape) != 0 || entry.offset > quint64(m_size)
+            || entry.count > (quint64(m_size) - entry.offset) / m_shapeSize) {
+            return false;
+        }
+        m_shapeRecords = m_data + entry.offset;
+        m_shapeCount = entry.count;
+        return true;
+    }
+
+    bool validRange(quint64 dataCount, const VqtShape &record) const
+    {
+        return quint64(record.dataOffset) + record.dataCount <= dataCount;
+    }
+
+    QVector<QPointF> points(const VqtShape &record) const
+    {
+        QVector<QPointF> result;
+        if (!validRange(m_points.count, record)) {
+            return result;
+        }
+        result.reserve(record.dataCount);
+        const VqtPoint *point = m_points.records + record.dataOffset;
+        for (quint32 i = 0; i < record.dataCount; ++i, ++point) {
+            result.append(QPointF(point->x, point->y));
+        }
+        return result;
+    }
+
+    QPainterPath path(const VqtShape &record) const
+    {
+        QPainterPath result;
+        if (!validRange(m_pathElements.count, record)) {
+            return result;
+        }
+        result.reserve(int(record.dataCount));
+        const VqtPathElement *elements = m_pathElements.records + record.dataOffset;
+        const quint32 count = record.dataCount;
+        for (quint32 i = 0; i < count; ++i) {
+            const VqtPathElement &element = elements[i];
+            switch (element.type) {
+            case QPainterPath::MoveToElement:
+                result.moveTo(element.x, element.y);
+                break;
+            case QPainterPath::LineToElement:
+                result.lineTo(element.x, element.y);
+                break;
+            case QPainterPath::CurveToElement:
+                // 曲线元素后跟两个数据元素：第二控制点和终点
+                if (i + 2 < count) {
+                    result.cubicTo(element.x, element.y,
+                                   elements[i + 1].x, elements[i + 1].y,
+                                   elements[i + 2].x, elements[i + 2].y);
+                    i += 2;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+
+    void readNodeTypes(DrawingPath *path, const VqtShape &record) const
+    {
+        if (!validRange(m_pathElements.count, record)) {
+            return;
+        }
+        const VqtPathElement *elements = m_pathElements.records + record.dataOffset;
+        const QVector<NodeInfo> nodes = path->getNodeInfo();
+        for (int i = 0; i < nodes.size(); ++i) {
+            const int element = nodes[i].elementIndex;
+            if (element >= 0 && quint32(element) < record.dataCount && elements[element].nodeType != 0) {
+                path->setNodeType(i, NodeInfo::NodeType(elements[element].nodeType - 1));
+            }
+        }
+    }
+
+    void readMarkers(DrawingPath *path, quint32 blobIndex) const
+    {
+        QDataStream stream(blob(blobIndex));
+        qint32 count = 0;
+        stream >> count;
+        for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+            QString markerId;
+            QString position;
+            QTransform markerTransform;
+            qint32 type = 0;
+            MarkerData markerData;
+            stream >> markerId >> position >> markerTransform;
+            stream >> type >> markerData.params
+                   >> markerData.fillColor >> markerData.strokeColor >> markerData.strokeWidth
+                   >> markerData.isValid >> markerData.refX >> markerData.refY
+                   >> markerData.markerWidth >> markerData.markerHeight >> markerData.orient;
+            markerData.type = static_cast<MarkerData::Type>(type);
+            if (stream.status() == QDataStream::Ok) {
+                path->setMarker(markerId, markerData, markerTransform, position);
+            }
+        }
+    }
+
+    const uchar *m_data;
+    qint64 m_size;
+    const VqtHeader *m_header;
+
+    Span<VqtRange> m_stringEntries;
+    Span<char16_t> m_stringData;
+    Span<VqtPathElement> m_pathElements;
+    Span<VqtPoint> m_points;
+    Span<VqtPen> m_pens;
+    Span<VqtBrush> m_brushes;
+    Span<VqtRange> m_blobEntries;
+    Span<char> m_blobData;
+    Span<VqtLayer> m_layers;
+    const uchar *m_shapeRecords = nullptr;
+    quint64 m_shapeCount = 0;
+    quint64 m_shapeSize = sizeof(VqtShape);
+};
+
+DrawingShape *VqtReader::createShape(const VqtShape &record) const
+{
+    const double *g = record.geometry;
+    DrawingShape *shape = nullptr;
+
+    switch (record.type) {
+    case DrawingShape::Rectangle: {
+        DrawingRectangle *rect = new DrawingRectangle();
+        rect->setRectangle(QRectF(g[0], g[1], g[2], g[3]));
+        rect->setCornerRadius(g[4]);
+        rect->setCornerRadiusRatios(g[5], g[6]);
+        shape = rect;
+        break;
+    }
+    case DrawingShape::Ellipse: {
+        DrawingEllipse *ellipse = new DrawingEllipse();
+        ellipse->setEllipse(QRectF(g[0], g[1], g[2], g[3]));
+        ellipse->setStartAngle(g[4]);
+        ellipse->setSpanAngle(g[5]);
+        shape = ellipse;
+        break;
+    }
+    case DrawingShape::Line: {
+        DrawingLine *line = new DrawingLine();
+        line->setLine(QLineF(g[0], g[1], g[2], g[3]));
+        line->setLineWidth(g[4]);
+        shape = line;
+        break;
+    }
+    case DrawingShape::Polyline: {
+        DrawingPolyline *polyline = new DrawingPolyline();
+        for (const QPointF &point : points(record)) {
+            polyline->addPoint(point);
+        }
+        polyline->setLineWidth(g[0]);
+        polyline->setClosed(record.flags & ShapeClosed);
+        shape = polyline;
+        break;
+    }
+    case DrawingShape::Polygon: {
+        DrawingPolygon *polygon = new DrawingPolygon();
+        for (const QPointF &point : points(record)) {
+            polygon->addPoint(point);
+        }
+        shape = polygon;
+        break;
+    }
+    case DrawingShape::Path: {
+        DrawingPath *drawingPath = new DrawingPath();
+        // 填充规则需要在setPath之前设置，setPath会把它应用到路径上
+        drawingPath->setFillRule(Qt::FillRule(record.fillRule));
+        drawingPath->setPath(path(record));
+        drawingPath->setShowControlPolygon(record.flags & ShapeShowControlPolygon);
+        readNodeTypes(drawingPath, record);
+        if (record.blob != VqtNoIndex) {
+            readMarkers(drawingPath, record.blob);
+        }
+        shape = drawingPath;
+        break;
+    }
+    case DrawingShape::Text: {
+        DrawingText *text = new DrawingText();
+        text->setText(string(record.text));
+        QFont font;
+        if (font.fromString(string(record.font))) {
+            text->setFont(font);
+        }
+        text->setPosition(QPointF(g[0], g[1]));
+        shape = text;
+        break;
+    }
+    case DrawingShape::Group: {
+        if (m_header->version >= VqtFlatGroupVersion) {
+            // 子对象是后续带parent的记录，由加载过程挂到组合上
+            shape = new DrawingGroup();
+            break;
+        }
+        // 旧版本文件中的组合数据已无法解析，跳过而不是按新格式误读
+        if (m_header->version < VqtRecordGroupVersion) {
+            return nullptr;
+        }
+        const QByteArray data = blob(record.blob);
+        if (data.isEmpty()) {
+            return nullptr;
+        }
+        // 版本2的附加数据是完整的DrawingGroup::serialize()结果，已包含组合自身的属性
+        DrawingGroup *group = new DrawingGroup();
+        group->deserialize(data);
+        return group;
+    }
+    default:
+        return nullptr;
+    }
+
+    shape->setFillRule(Qt::FillRule(record.fillRule));
+    shape->setPos(QPointF(record.pos[0], record.pos[1]));
+    shape->setScale(record.scale);
+    shape->setRotation(record.rotation);
+    shape->applyTransform(transformFromArray(record.transform));
+    shape->setTransform(transformFromArray(record.itemTransform));
+    shape->setZValue(record.zValue);
+    shape->setVisible(record.flags & ShapeVisible);
+    shape->setEnabled(record.flags & ShapeEnabled);
+    shape->setFillBrush(brush(record.brush));
+    shape->setStrokePen(pen(record.pen));
+    shape->setOpacity(record.opacity);
+    shape->setId(string(record.id));
+    return shape;
+}
+
+} // namespace
+
+bool VqtFormat::isNativeFile(const QString &fileName)
+{
+    return QFileInfo(fileName).suffix().compare(QLatin1String("vqt"), Qt::CaseInsensitive) == 0;
+}
+
+bool VqtFormat::save(DrawingScene *scene, const QString &fileName)
+{
+    if (!scene) {
+        return false;
+    }
+
+    VqtWriter writer;
+    LayerManager *layerManager = LayerManager::instance();
+    QSet<DrawingShape *> layeredShapes;
+    for (DrawingLayer *layer : layerManager->layers()) {
+        if (layer) {
+            writer.addLayer(layer);
+            for (DrawingShape *shape : layer->shapes()) {
+                layeredShapes.insert(shape);
+            }
+        }
+    }
+
+    // 不属于任何图层的顶层图形放在图形表末尾，加载时直接加入场景
+    for (QGraphicsItem *item : scene->items(Qt::AscendingOrder)) {
+        DrawingShape *shape = dynamic_cast<DrawingShape *>(item);
+        if (shape && !shape->parentItem() && !layeredShapes.contains(shape)) {
+            writer.addShape(shape);
+        }
+    }
+
+    // 写入临时文件后再替换，保存中途失败不会破坏原有的工作文件
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (!writer.writeTo(&file, scene, layerManager->activeLayerIndex())) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool VqtFormat::load(DrawingScene *scene, const QString &fileName)
+{
+    if (!scene) {
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // 优先使用内存映射，只有实际访问到的页才会被读入；
+    // 不支持映射的文件系统退回到一次性读取
+    const qint64 size = file.size();
+    QByteArray fallback;
+    const uchar *data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data) {
+        fallback = file.readAll();
+        data = reinterpret_cast<const uchar *>(fallback.constData());
+    }
+
+    VqtReader reader(data, size);
+    if (size <= 0 || !reader.open()) {
+        return false;
+    }
+
+    const VqtHeader &header = reader.header();
+    scene->setSceneRect(QRectF(header.sceneRect[0], header.sceneRect[1],
+                               header.sceneRect[2], header.sceneRect[3]));
+
+    // 子对象记录排在所属组合之后，parent只能指向已创建的组合；
+    // 组合创建失败时它的子对象一并丢弃，而不是按组内坐标放到顶层
+    QVector<DrawingShape *> created(qsizetype(reader.shapeCount()), nullptr);
+    auto restoreShape = [&](quint64 index, DrawingLayer *layer) {
+        const VqtShape record = reader.shape(index);
+        DrawingGroup *group = nullptr;
+        if (record.parent != VqtNoIndex) {
+            group = record.parent < index ? dynamic_cast<DrawingGroup *>(created[record.parent]) : nullptr;
+            if (!group) {
+                return;
+            }
+        }
+        DrawingShape *shape = reader.createShape(record);
+        if (!shape) {
+            return;
+        }
+        created[qsizetype(index)] = shape;
+        if (group) {
+            group->restoreItem(shape);
+        } else if (layer) {
+            layer->addShape(shape);
+        } else {
+            scene->addItem(shape);
+        }
+    };
+
+    LayerManager *layerManager = LayerManager::instance();
+    quint64 layeredEnd = 0;
+    if (reader.layerCount() > 0) {
+        // 文件中的图层替换新文档的默认图层
+        layerManager->clearAllLayers();
+        layerManager->setSvgImporting(true);
+
+        for (quint64 i = 0; i < reader.layerCount(); ++i) {
+            const VqtLayer &record = reader.layer(i);
+            DrawingLayer *layer = layerManager->createLayerForSvg(reader.string(record.name));
+            layer->setVisible(record.flags & LayerVisible);
+            layer->setOpacity(record.opacity);
+            layer->setLocked(record.flags & LayerLocked);
+            layer->setLayerTransform(transformFromArray(record.transform));
+
+            const quint64 first = qMin<quint64>(record.firstShape, reader.shapeCount());
+            const quint64 end = qMin<quint64>(first + record.shapeCount, reader.shapeCount());
+            for (quint64 j = first; j < end; ++j) {
+                restoreShape(j, layer);
+            }
+            layeredEnd = qMax(layeredEnd, end);
+        }
+
+        layerManager->setSvgImporting(false);
+        if (header.activeLayer >= 0 && header.activeLayer < layerManager->layerCount()) {
+            layerManager->setActiveLayer(header.activeLayer);
+        }
+    }
+
+    for (quint64 i = layeredEnd; i < reader.shapeCount(); ++i) {
+        restoreShape(i, nullptr);
+    }
+
+    return true;
+}
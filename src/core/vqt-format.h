@@ -0,0 +1,59 @@
+#ifndef VQT_FORMAT_H
+#define VQT_FORMAT_H
+
+#include <QString>
+
+class DrawingScene;
+
+/**
+ * VectorQt原生二进制文档格式（.vqt）
+ * 用于工作文件和自动保存，SVG仍作为交换格式。
+ *
+ * 文件布局（主机字节序，按8字节对齐）：
+ *   文件头      魔数、版本、字节序标记、场景矩形、活动图层、段表
+ *   字符串表    {偏移, 长度}数组 + UTF-16字符数据（ID、图层名、文本、字体）
+ *   路径元素    {x, y, type}扁平数组，所有路径共享
+ *   点数组      折线/多边形的顶点，所有图形共享
+ *   画笔/画刷   去重后的定长记录，渐变等复杂样式落入附加数据块
+ *   附加数据块  {偏移, 长度}数组 + QDataStream数据（marker、渐变）
+ *   图层表      图层属性及其图形在图形表中的范围
+ *   图形表      定长记录，通过索引引用上面的各个数组；组合的子对象紧随其后，
+ *               以父索引指向组合记录
+ *
+ * 加载时通过QFile::map映射文件，定长记录直接在映射内存上读取，
+ * 不需要先把整个文件读入缓冲区，也没有XML、颜色和路径文本的解析
+ */
+class VqtFormat
+{
+public:
+    /**
+     * 格式版本，写入时使用当前版本，读取时接受不高于当前版本的文件
+     *   1 初始版本
+     *   2 组合的附加数据块改为ShapeRecordWriter记录
+     *   3 组合展开为带父索引的图形记录，增加图形项变换和路径节点类型
+     */
+    static constexpr quint16 Version = 3;
+
+    /**
+     * 判断文件名是否为原生格式（按扩展名）
+     */
+    static bool isNativeFile(const QString &fileName);
+
+    /**
+     * 将场景及其图层保存为.vqt文件
+     * @param scene 场景
+     * @param fileName 文件名
+     * @return 成功返回true
+     */
+    static bool save(DrawingScene *scene, const QString &fileName);
+
+    /**
+     * 从.vqt文件加载图层和图形到场景
+     * @param scene 场景，调用前应已清空
+     * @param fileName 文件名
+     * @return 成功返回true；文件损坏或版本不支持时返回false
+     */
+    static bool load(DrawingScene *scene, const QString &fileName);
+};
+
+#endif // VQT_FORMAT_H
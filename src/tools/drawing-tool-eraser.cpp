@@ -9,6 +9,7 @@
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/spatial-index.h"
 
 DrawingToolEraser::DrawingToolEraser(QObject *parent)
     : ToolBase(parent)
@@ -156,24 +157,11 @@ QList<DrawingShape*> DrawingToolEraser::findShapesInArea(const QPointF &center,
     
     if (!m_scene) return shapesInArea;
     
-    // 创建擦除区域
-    QRectF eraseArea(center.x() - radius, center.y() - radius, radius * 2, radius * 2);
-    
-    // 获取区域内的所有图形项
-    QList<QGraphicsItem*> items = m_scene->items(eraseArea);
-    
-    for (QGraphicsItem *item : items) {
-        // 检查项目是否有效
-        if (!item) continue;
-        
-        // 使用类型检查而不是qgraphicsitem_cast
-        if (item->type() == QGraphicsItem::UserType + 2) { // DrawingShape类型
-            DrawingShape *shape = static_cast<DrawingShape*>(item);
-            // 检查图形是否真的在擦除范围内
-            if (isInRange(shape->sceneBoundingRect().center(), center, radius) ||
-                shape->sceneBoundingRect().intersects(eraseArea)) {
-                shapesInArea.append(shape);
-            }
+    // 轮廓与擦除圆相交的图形（组合本身不擦除）
+    const QList<DrawingShape*> shapes = m_scene->spatialIndex()->shapesInRadius(center, radius);
+    for (DrawingShape *shape : shapes) {
+        if (shape->shapeType() != DrawingShape::Group) {
+            shapesInArea.append(shape);
         }
     }
     
@@ -5,6 +5,7 @@
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/spatial-index.h"
 #include "../ui/mainwindow.h"
 #include "../ui/colorpalette.h"
 
@@ -67,40 +68,20 @@ DrawingShape* DrawingToolFill::findEnclosedShape(const QPointF &scenePos)
         return nullptr;
     }
     
-    // 获取点击位置的所有图形
-    QList<QGraphicsItem*> items = m_scene->items(scenePos);
-    
-    // qDebug() << "Fill tool: clicked at" << scenePos << "found" << items.size() << "items";
+    // 空间索引已按图形轮廓精确判断点是否在内部，结果从上到下排列
+    const QList<DrawingShape*> shapes = m_scene->spatialIndex()->shapesAt(scenePos);
     
     // 从上到下查找第一个可填充的图形
-    for (QGraphicsItem *item : items) {
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
-        if (shape) {
-            // 检查图形类型是否支持填充
-            DrawingShape::ShapeType type = shape->shapeType();
-            // qDebug() << "Fill tool: found shape type" << type;
-            
-            if (type == DrawingShape::Rectangle || 
-                type == DrawingShape::Ellipse || 
-                type == DrawingShape::Polygon) {
-                // 将场景坐标转换为图形本地坐标
-                QPointF localPos = shape->mapFromScene(scenePos);
-                // qDebug() << "Fill tool: scenePos=" << scenePos << "localPos=" << localPos;
-                
-                // 检查点是否在图形内部
-                bool contains = shape->shape().contains(localPos);
-                // qDebug() << "Fill tool: shape contains point?" << contains;
-                if (contains) {
-                    return shape;
-                }
-            }
-            // 对于路径，也检查是否封闭
-            else if (type == DrawingShape::Path) {
-                // TODO: 检查路径是否封闭
-                if (shape->shape().contains(scenePos)) {
-                    return shape;
-                }
-            }
+    for (DrawingShape *shape : shapes) {
+        // 检查图形类型是否支持填充
+        DrawingShape::ShapeType type = shape->shapeType();
+        
+        // TODO: 检查路径是否封闭
+        if (type == DrawingShape::Rectangle || 
+            type == DrawingShape::Ellipse || 
+            type == DrawingShape::Polygon ||
+            type == DrawingShape::Path) {
+            return shape;
         }
     }
     
@@ -10,6 +10,7 @@
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/spatial-index.h"
 #include "../ui/mainwindow.h"
 #include "../ui/colorpalette.h"
 
@@ -349,15 +350,13 @@ DrawingShape* DrawingToolGradientFill::findEnclosedShape(const QPointF &scenePos
 {
     if (!m_scene) return nullptr;
     
-    // 获取点击位置的所有图形项
-    QList<QGraphicsItem *> items = m_scene->items(scenePos);
+    // 获取点击位置的所有图形，最上层在前
+    const QList<DrawingShape*> shapes = m_scene->spatialIndex()->shapesAt(scenePos);
     
-    // 查找第一个封闭图形
-    for (QGraphicsItem *item : items) {
-        // 直接使用QGraphicsItem，不依赖qgraphicsitem_cast
-        // 既然m_scene->items()已经返回了这个位置的项，那它就是我们要找的
-        if (item->type() == QGraphicsItem::UserType + 2) { // DrawingShape类型
-            return static_cast<DrawingShape*>(item);
+    // 查找第一个封闭图形（跳过组合本身）
+    for (DrawingShape *shape : shapes) {
+        if (shape->shapeType() != DrawingShape::Group) {
+            return shape;
         }
     }
     
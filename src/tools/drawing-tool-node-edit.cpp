@@ -8,6 +8,7 @@
 #include "node-handle-manager.h"
 #include "handle-item.h"
 #include "../core/drawing-shape.h"
+#include "../core/spatial-index.h"
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../ui/snap-manager.h"
@@ -85,7 +86,7 @@ void NodeEditCommand::redo()
 }
 
 DrawingNodeEditTool::DrawingNodeEditTool(QObject *parent)
-    : ToolBase(parent), m_selectedShape(nullptr), m_activeHandle(nullptr), m_dragging(false), m_handleManager(nullptr)
+    : ToolBase(parent), m_selectedShape(nullptr), m_highlightedShape(nullptr), m_activeHandle(nullptr), m_dragging(false), m_handleManager(nullptr)
 {
 }
 
@@ -162,16 +163,7 @@ bool DrawingNodeEditTool::mousePressEvent(QMouseEvent *event, const QPointF &sce
             clearNodeHandles();
 
             // 检查是否点击了图形
-            QGraphicsItem *clickedItem = m_scene->itemAt(scenePos, QTransform());
-
-            // 跳过DrawingLayer
-            if (clickedItem && clickedItem->type() == QGraphicsItem::UserType + 100)
-            {
-                // qDebug() << "Node edit tool: clicked on DrawingLayer, skipping";
-                return false;
-            }
-
-            DrawingShape *shape = dynamic_cast<DrawingShape *>(clickedItem);
+            DrawingShape *shape = m_scene->spatialIndex()->topShapeAt(scenePos);
 
             if (shape)
             {
@@ -322,69 +314,69 @@ bool DrawingNodeEditTool::mouseMoveEvent(QMouseEvent *event, const QPointF &scen
     // 处理悬停检测和高亮 - 检测所有路径对象
     if (m_scene && !m_dragging)
     {
-        QList<QGraphicsItem *> allItems = m_scene->items();
+        SpatialIndex *spatialIndex = m_scene->spatialIndex();
         bool hoveringOnNode = false;
         DrawingShape *hoveredShape = nullptr;
 
-        // 首先清除所有高亮
-        for (QGraphicsItem *item : allItems)
+        // 节点很多的路径由覆盖层绘制手柄，只为鼠标下的节点创建真实手柄
+        if (m_handleManager)
         {
-            // 跳过DrawingLayer
-            if (item->type() == QGraphicsItem::UserType + 100)
-            {
-                continue;
-            }
+            m_handleManager->updateHoveredHandle(scenePos);
+        }
 
-            DrawingShape *shape = dynamic_cast<DrawingShape *>(item);
-            if (shape)
-            {
-                shape->clearHighlights();
-            }
+        // 首先清除上次的高亮（图形删除时已从索引中移除，不会访问已删除的对象）
+        if (m_highlightedShape && spatialIndex->contains(m_highlightedShape))
+        {
+            m_highlightedShape->clearHighlights();
         }
+        m_highlightedShape = nullptr;
 
-        // 然后检测悬停
-        for (QGraphicsItem *item : allItems)
+        // 只检测边界在检测范围内的图形，最上层在前；
+        // 正在编辑的图形的控制点可能在边界之外，始终参与检测
+        // 检测范围按屏幕像素计算，缩放视图时手感不变
+        const qreal viewScale = m_view ? m_view->zoomLevel() : 1.0;
+        const qreal hoverRange = viewScale > 0 ? 8.0 / viewScale : 8.0;
+        QList<DrawingShape *> candidates = spatialIndex->shapesInRect(
+            QRectF(scenePos.x() - hoverRange, scenePos.y() - hoverRange, hoverRange * 2, hoverRange * 2),
+            Qt::IntersectsItemBoundingRect);
+        if (m_selectedShape && !candidates.contains(m_selectedShape) && spatialIndex->contains(m_selectedShape))
         {
-            // 跳过DrawingLayer
-            if (item->type() == QGraphicsItem::UserType + 100)
-            {
-                continue;
-            }
+            candidates.append(m_selectedShape);
+        }
 
-            // 使用安全的类型检查
-            DrawingShape *shape = dynamic_cast<DrawingShape *>(item);
-            if (shape)
+        // 然后检测悬停
+        for (DrawingShape *shape : std::as_const(candidates))
+        {
+            // 检查是否悬停在节点上（优先级更高）
+            int nodeIndex = shape->findNodeAt(scenePos, hoverRange);
+            if (nodeIndex >= 0)
             {
-                // 检查是否悬停在节点上（优先级更高）
-                int nodeIndex = shape->findNodeAt(scenePos, 8.0);
-                if (nodeIndex >= 0)
+                // 悬停在节点上 - 显示高亮（只有选中的对象才显示节点高亮）
+                if (shape->isSelected())
                 {
-                    // 悬停在节点上 - 显示高亮（只有选中的对象才显示节点高亮）
-                    QList<QGraphicsItem *> selectedItems = m_scene->selectedItems();
-                    if (selectedItems.contains(item))
+                    shape->highlightNode(nodeIndex);
+                    m_highlightedShape = shape;
+                    if (m_view)
                     {
-                        shape->highlightNode(nodeIndex);
-                        if (m_view)
-                        {
-                            m_view->setCursor(QCursor(Qt::CrossCursor)); // 探针指针
-                        }
+                        m_view->setCursor(QCursor(Qt::CrossCursor)); // 探针指针
                     }
-                    hoveringOnNode = true;
-                    hoveredShape = shape;
-                    break; // 找到一个就停止
                 }
-                else if (shape->isPointOnPath(scenePos, 5.0))
+                hoveringOnNode = true;
+                hoveredShape = shape;
+                break; // 找到一个就停止
+            }
+            else if (shape->isPointOnPath(scenePos, 5.0))
+            {
+                // 悬停在路径上 - 显示路径高亮
+                shape->highlightPath(scenePos);
+                m_highlightedShape = shape;
+                if (m_view)
                 {
-                    // 悬停在路径上 - 显示路径高亮
-                    shape->highlightPath(scenePos);
-                    if (m_view)
-                    {
-                        m_view->setCursor(QCursor(Qt::PointingHandCursor)); // 手型指针
-                    }
-                    hoveringOnNode = true;
-                    hoveredShape = shape;
-                    break; // 找到一个就停止
+                    m_view->setCursor(QCursor(Qt::PointingHandCursor)); // 手型指针
                 }
+                hoveringOnNode = true;
+                hoveredShape = shape;
+                break; // 找到一个就停止
             }
         }
 
@@ -77,6 +77,7 @@ private:
     
     // 状态变量
     DrawingShape *m_selectedShape;  // 当前选中的形状
+    DrawingShape *m_highlightedShape; // 悬停高亮的形状
     CustomHandleItem *m_activeHandle;     // 当前激活的编辑手柄
     bool m_dragging;                // 是否正在拖动
     QPointF m_dragStartPos;         // 拖动起始位置
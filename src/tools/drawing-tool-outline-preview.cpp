@@ -7,6 +7,7 @@
 #include "transform-handle.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/spatial-index.h"
 #include "../ui/drawingscene.h"
 #include "../ui/snap-manager.h"
 
@@ -222,7 +223,7 @@ bool OutlinePreviewTransformTool::mousePressEvent(QMouseEvent *event, const QPoi
         }
     }
 
-    QGraphicsItem *item = m_scene->itemAt(scenePos, QTransform());
+    QGraphicsItem *item = m_scene->spatialIndex()->topShapeAt(scenePos);
     if (item)
     {
         // 如果点击了图形
@@ -12,6 +12,7 @@
 #include "../ui/drawingscene.h"
 #include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
+#include "../core/spatial-index.h"
 #include "../core/drawing-layer.h"
 #include "../core/layer-manager.h"
 #include "../ui/mainwindow.h"
@@ -140,7 +141,7 @@ bool DrawingToolText::mouseDoubleClickEvent(QMouseEvent *event, const QPointF &s
     
     if (event->button() == Qt::LeftButton) {
         // 检查是否双击了现有文本对象
-        QGraphicsItem *item = m_scene->itemAt(scenePos, m_view->transform());
+        DrawingShape *item = m_scene->spatialIndex()->topShapeAt(scenePos);
         if (item) {
             DrawingText *textItem = dynamic_cast<DrawingText*>(item);
             if (textItem) {
@@ -1,11 +1,15 @@
 #include <QDebug>
 #include <QGraphicsLineItem>
+#include <QtMath>
 #include "node-handle-manager.h"
+#include "node-handle-overlay.h"
 #include "../ui/drawingscene.h"
+#include "../ui/drawingview.h"
 #include "../core/drawing-shape.h"
 
 // 静态常量定义
 const qreal NodeHandleManager::DEFAULT_HANDLE_SIZE = 8.0;
+const int NodeHandleManager::DEFAULT_VIRTUALIZATION_THRESHOLD = 256;
 const QColor NodeHandleManager::CORNER_RADIUS_COLOR = QColor(255, 165, 0, 200);  // 橙色
 const QColor NodeHandleManager::SIZE_CONTROL_COLOR = QColor(70, 130, 180, 200);  // 钢蓝色
 const QColor NodeHandleManager::PATH_NODE_COLOR = QColor(255, 255, 255, 230);     // 白色
@@ -20,12 +24,55 @@ const QColor NodeHandleManager::SMOOTH_NODE_COLOR = QColor(100, 255, 100, 230);
 const QColor NodeHandleManager::SYMMETRIC_NODE_COLOR = QColor(200, 100, 255, 230); // 紫色 - 对称节点
 const QColor NodeHandleManager::CURVE_NODE_COLOR = QColor(255, 180, 100, 230);      // 橙色 - 曲线节点
 
+namespace {
+
+// 一次遍历区分节点和控制点，并记录控制杆连接的手柄下标
+// 三次曲线为CurveTo（第一个控制点）、CurveToData（第二个控制点）、CurveToData（终点）
+void classifyPathHandles(const QVector<QPainterPath::ElementType> &types, int count,
+                         QVector<NodeHandleManager::NodeHandleType> &handleTypes,
+                         QVector<QPair<int, int>> &arms)
+{
+    handleTypes.resize(count);
+    arms.clear();
+    int lastNode = -1;
+    int curveStart = -1;
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::ElementType type = i < types.size() ? types[i] : QPainterPath::MoveToElement;
+        bool control = false;
+        if (type == QPainterPath::CurveToElement) {
+            control = true;
+            curveStart = i;
+            // 第一个控制点连到曲线起点
+            if (lastNode >= 0) {
+                arms.append(qMakePair(lastNode, i));
+            }
+        } else if (type == QPainterPath::CurveToDataElement) {
+            control = curveStart >= 0 && i - curveStart == 1;
+            // 第二个控制点连到曲线终点
+            if (control && i + 1 < count) {
+                arms.append(qMakePair(i, i + 1));
+            }
+        } else {
+            curveStart = -1;
+        }
+
+        handleTypes[i] = control ? NodeHandleManager::PathControlHandle : NodeHandleManager::PathNodeHandle;
+        if (!control) {
+            lastNode = i;
+        }
+    }
+}
+
+} // namespace
+
 NodeHandleManager::NodeHandleManager(DrawingScene *scene, QObject *parent)
     : QObject(parent)
     , m_scene(scene)
     , m_currentShape(nullptr)
     , m_activeHandle(nullptr)
     , m_handlesVisible(false)
+    , m_overlay(nullptr)
+    , m_virtualizationThreshold(DEFAULT_VIRTUALIZATION_THRESHOLD)
 {
     qDebug() << "Creating node handles...";
 }
@@ -82,7 +129,7 @@ void NodeHandleManager::clearHandles()
     }
     
     // 如果已经没有手柄，直接返回
-    if (m_handleInfos.isEmpty()) {
+    if (m_handleInfos.isEmpty() && !m_overlay) {
         qDebug() << "clearHandles() called but no handles to clear";
         return;
     }
@@ -115,6 +162,16 @@ void NodeHandleManager::clearHandles()
     // 清除贝塞尔节点数据
     m_bezierNodes.clear();
     
+    // 清除虚拟化手柄的覆盖层
+    if (m_overlay) {
+        if (m_scene && m_overlay->scene()) {
+            m_scene->removeItem(m_overlay);
+        }
+        delete m_overlay;
+        m_overlay = nullptr;
+    }
+    m_virtualTypes.clear();
+    
     m_handleInfos.clear();
     m_activeHandle = nullptr;
     m_currentShape = nullptr;
@@ -123,14 +180,40 @@ void NodeHandleManager::clearHandles()
     inClearHandles = false;
 }
 
-CustomHandleItem* NodeHandleManager::getHandleAt(const QPointF &scenePos) const
+CustomHandleItem* NodeHandleManager::getHandleAt(const QPointF &scenePos)
 {
     for (const NodeHandleInfo &info : m_handleInfos) {
         if (info.handle && info.handle->contains(info.handle->mapFromScene(scenePos))) {
             return info.handle;
         }
     }
-    return nullptr;
+    
+    if (!m_overlay) {
+        return nullptr;
+    }
+    
+    // 覆盖层通过k-d树查找，命中范围与真实手柄的大小一致
+    const qreal unitsPerPixel = sceneUnitsPerPixel();
+    m_overlay->setSceneUnitsPerPixel(unitsPerPixel);
+    int index = m_overlay->handleAt(scenePos, DEFAULT_HANDLE_SIZE / 2 * unitsPerPixel);
+    return index >= 0 ? realizeVirtualHandle(index) : nullptr;
+}
+
+void NodeHandleManager::updateHoveredHandle(const QPointF &scenePos)
+{
+    if (!m_overlay) {
+        return;
+    }
+    
+    CustomHandleItem *hovered = getHandleAt(scenePos);
+    
+    // 释放既不是活动手柄也不在鼠标下的真实手柄，交回覆盖层绘制
+    for (int i = m_handleInfos.size() - 1; i >= 0; --i) {
+        CustomHandleItem *handle = m_handleInfos[i].handle;
+        if (handle != hovered && handle != m_activeHandle) {
+            releaseVirtualHandle(i);
+        }
+    }
 }
 
 NodeHandleManager::NodeHandleInfo NodeHandleManager::getHandleInfo(CustomHandleItem *handle) const
@@ -151,6 +234,9 @@ void NodeHandleManager::showHandles()
             info.handle->setVisible(true);
         }
     }
+    if (m_overlay) {
+        m_overlay->setVisible(true);
+    }
 }
 
 void NodeHandleManager::hideHandles()
@@ -161,6 +247,9 @@ void NodeHandleManager::hideHandles()
             info.handle->setVisible(false);
         }
     }
+    if (m_overlay) {
+        m_overlay->setVisible(false);
+    }
 }
 
 void NodeHandleManager::setActiveHandle(CustomHandleItem *handle)
@@ -188,12 +277,16 @@ void NodeHandleManager::updateHandlePosition(CustomHandleItem *handle, const QPo
     for (NodeHandleInfo &info : m_handleInfos) {
         if (info.handle == handle) {
             info.originalPos = newPos;
+            // 覆盖层的控制杆跟随拖动的手柄
+            if (m_overlay) {
+                m_overlay->setHandlePosition(info.nodeIndex, newPos);
+            }
             break;
         }
     }
     
     // 如果是路径类型，实时更新控制点连线
-    if (m_currentShape && m_currentShape->shapeType() == DrawingShape::Path) {
+    if (!m_overlay && m_currentShape && m_currentShape->shapeType() == DrawingShape::Path) {
         updatePathControlLines();
     }
 }
@@ -456,6 +549,12 @@ void NodeHandleManager::createHandlesForPath(DrawingPath *path)
 {
     if (!path) return;
     
+    // 节点很多时为每个节点创建图形项代价过高，改由覆盖层批量绘制
+    if (path->controlPoints().size() > m_virtualizationThreshold) {
+        createVirtualHandlesForPath(path);
+        return;
+    }
+    
     // 强制禁用路径的自绘控制点，改用手柄系统
     path->setShowControlPolygon(false);
     path->update(); // 立即更新以确保禁用生效
@@ -613,6 +712,11 @@ void NodeHandleManager::setupHandleStyle(CustomHandleItem *handle, NodeHandleTyp
 
 void NodeHandleManager::updateExistingHandlePositions(DrawingShape *shape)
 {
+    if (m_overlay && shape && shape->shapeType() == DrawingShape::Path) {
+        updateVirtualHandles(static_cast<DrawingPath*>(shape));
+        return;
+    }
+    
     if (!shape || m_handleInfos.isEmpty()) return;
     
     // 获取图形的当前节点点
@@ -752,6 +856,121 @@ void NodeHandleManager::clearPathControlLines()
     m_controlLines.clear();
 }
 
+void NodeHandleManager::createVirtualHandlesForPath(DrawingPath *path)
+{
+    if (!path || !m_scene) return;
+    
+    path->setShowControlPolygon(false);
+    
+    m_overlay = new NodeHandleOverlay();
+    m_overlay->setHandleStyle(DEFAULT_HANDLE_SIZE, BEZIER_NODE_COLOR,
+                              DEFAULT_HANDLE_SIZE * 0.8, BEZIER_CONTROL_IN_COLOR);
+    m_overlay->setSceneUnitsPerPixel(sceneUnitsPerPixel());
+    m_scene->addItem(m_overlay);
+    
+    // 缩放后手柄的屏幕大小不变，覆盖层的边界留白随之变化
+    for (QGraphicsView *view : m_scene->views()) {
+        if (DrawingView *drawingView = qobject_cast<DrawingView*>(view)) {
+            connect(drawingView, &DrawingView::zoomChanged, this, &NodeHandleManager::onViewZoomChanged, Qt::UniqueConnection);
+        }
+    }
+    
+    updateVirtualHandles(path);
+}
+
+void NodeHandleManager::updateVirtualHandles(DrawingPath *path)
+{
+    if (!path || !m_overlay) return;
+    
+    const QVector<QPointF> controlPoints = path->controlPoints();
+    
+    // 整条路径共用一个变换，不必逐点调用calculateHandlePosition
+    const QTransform toScene = path->transform() * path->sceneTransform();
+    QVector<QPointF> scenePoints(controlPoints.size());
+    for (int i = 0; i < controlPoints.size(); ++i) {
+        scenePoints[i] = toScene.map(controlPoints[i]);
+    }
+    
+    if (controlPoints.size() == m_virtualTypes.size()) {
+        m_overlay->setHandlePositions(scenePoints);
+    } else {
+        // 首次创建或节点数变化时重新区分节点和控制点
+        QVector<QPair<int, int>> arms;
+        classifyPathHandles(path->controlPointTypes(), controlPoints.size(), m_virtualTypes, arms);
+        QVector<bool> isControl(m_virtualTypes.size());
+        for (int i = 0; i < m_virtualTypes.size(); ++i) {
+            isControl[i] = m_virtualTypes[i] == PathControlHandle;
+        }
+        m_overlay->setHandles(scenePoints, isControl, arms);
+    }
+    
+    // 同步已创建的真实手柄
+    for (NodeHandleInfo &info : m_handleInfos) {
+        if (info.handle && info.nodeIndex < scenePoints.size()) {
+            info.handle->setPos(scenePoints[info.nodeIndex]);
+            info.originalPos = scenePoints[info.nodeIndex];
+            m_overlay->setHandleHidden(info.nodeIndex, true);
+        }
+    }
+}
+
+CustomHandleItem* NodeHandleManager::realizeVirtualHandle(int index)
+{
+    if (!m_overlay || index < 0 || index >= m_virtualTypes.size()) return nullptr;
+    
+    for (const NodeHandleInfo &info : m_handleInfos) {
+        if (info.nodeIndex == index) {
+            return info.handle;
+        }
+    }
+    
+    NodeHandleInfo info;
+    info.nodeIndex = index;
+    info.type = m_virtualTypes[index];
+    info.originalPos = m_overlay->handlePosition(index);
+    info.handle = info.type == PathControlHandle ? createPathControlHandle(info.originalPos)
+                                                 : createPathNodeHandle(info.originalPos);
+    info.handle->setVisible(m_overlay->isVisible());
+    m_handleInfos.append(info);
+    
+    m_overlay->setHandleHidden(index, true);
+    return info.handle;
+}
+
+void NodeHandleManager::releaseVirtualHandle(int infoIndex)
+{
+    if (infoIndex < 0 || infoIndex >= m_handleInfos.size()) return;
+    
+    NodeHandleInfo info = m_handleInfos.takeAt(infoIndex);
+    if (m_overlay) {
+        m_overlay->setHandleHidden(info.nodeIndex, false);
+    }
+    if (info.handle) {
+        if (m_scene && info.handle->scene()) {
+            m_scene->removeItem(info.handle);
+        }
+        delete info.handle;
+    }
+}
+
+qreal NodeHandleManager::sceneUnitsPerPixel() const
+{
+    if (m_scene && !m_scene->views().isEmpty()) {
+        const qreal scale = qSqrt(qAbs(m_scene->views().first()->transform().determinant()));
+        if (scale > 0) {
+            return 1.0 / scale;
+        }
+    }
+    return 1.0;
+}
+
+void NodeHandleManager::onViewZoomChanged()
+{
+    if (m_overlay) {
+        m_overlay->setSceneUnitsPerPixel(sceneUnitsPerPixel());
+    }
+}
+
 // 控制杆相关方法实现
 void NodeHandleManager::updateBezierControlArms(DrawingShape *shape)
 {
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QVector>
 #include <QPointF>
 #include <QRectF>
 #include "handle-item.h"
@@ -12,6 +13,7 @@
 
 class DrawingScene;
 class DrawingShape;
+class NodeHandleOverlay;
 
 /**
  * @brief 节点手柄管理器 - 专门用于节点编辑工具的手柄管理
@@ -54,8 +56,16 @@ public:
     // 清除所有手柄
     void clearHandles();
     
-    // 获取指定位置的手柄
-    CustomHandleItem* getHandleAt(const QPointF &scenePos) const;
+    // 获取指定位置的手柄（虚拟化模式下会为命中的节点创建真实手柄）
+    CustomHandleItem* getHandleAt(const QPointF &scenePos);
+    
+    // 虚拟化模式下只为悬停节点和活动节点保留真实手柄
+    void updateHoveredHandle(const QPointF &scenePos);
+    
+    // 控制点数超过阈值的路径改由覆盖层批量绘制手柄，0表示所有路径都使用覆盖层
+    void setVirtualizationThreshold(int count) { m_virtualizationThreshold = count; }
+    int virtualizationThreshold() const { return m_virtualizationThreshold; }
+    bool isVirtualized() const { return m_overlay != nullptr; }
     
     // 获取手柄数量（用于调试）
     int getHandleCount() const { return m_handleInfos.size(); }
@@ -122,6 +132,16 @@ private:
     // 路径控制点连线管理
     void updatePathControlLines();
     void clearPathControlLines();
+    
+    // 虚拟化的路径手柄
+    void createVirtualHandlesForPath(DrawingPath *path);
+    void updateVirtualHandles(DrawingPath *path);
+    CustomHandleItem* realizeVirtualHandle(int index);
+    void releaseVirtualHandle(int infoIndex);
+    qreal sceneUnitsPerPixel() const;
+
+private slots:
+    void onViewZoomChanged();
 
 private:
     DrawingScene *m_scene;
@@ -137,8 +157,14 @@ private:
     QList<BezierNode> m_bezierNodes;
     QList<QGraphicsLineItem*> m_controlArmLines;  // 控制杆连线
     
+    // 虚拟化模式：覆盖层绘制所有手柄，m_handleInfos只包含活动和悬停节点的真实手柄
+    NodeHandleOverlay *m_overlay;
+    QVector<NodeHandleType> m_virtualTypes;
+    int m_virtualizationThreshold;
+    
     // 手柄样式配置
     static const qreal DEFAULT_HANDLE_SIZE;
+    static const int DEFAULT_VIRTUALIZATION_THRESHOLD;
     static const QColor CORNER_RADIUS_COLOR;
     static const QColor SIZE_CONTROL_COLOR;
     static const QColor PATH_NODE_COLOR;        // 节点（方形）- 深蓝色
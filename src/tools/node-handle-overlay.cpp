@@ -0,0 +1,257 @@
+#include <QPainter>
+#include <QPen>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+#include "node-handle-overlay.h"
+#include "../core/point-kd-tree.h"
+
+namespace {
+
+const QColor ArmColor(100, 100, 255, 128);
+
+inline bool segmentOutside(const QPointF &a, const QPointF &b, const QRectF &rect)
+{
+    return qMax(a.x(), b.x()) < rect.left() || qMin(a.x(), b.x()) > rect.right()
+        || qMax(a.y(), b.y()) < rect.top() || qMin(a.y(), b.y()) > rect.bottom();
+}
+
+} // namespace
+
+NodeHandleOverlay::NodeHandleOverlay()
+    : QGraphicsItem(nullptr)
+    , m_sceneUnitsPerPixel(1.0)
+    , m_nodeSize(8.0)
+    , m_controlSize(6.4)
+    , m_nodeColor(255, 255, 255, 230)
+    , m_controlColor(255, 255, 255, 200)
+{
+    // 需要exposedRect做视口裁剪
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    setAcceptedMouseButtons(Qt::NoButton);
+    setAcceptHoverEvents(false);
+}
+
+NodeHandleOverlay::~NodeHandleOverlay()
+{
+}
+
+QRectF NodeHandleOverlay::boundingRect() const
+{
+    if (m_points.isEmpty()) {
+        return QRectF();
+    }
+    // 手柄以中心为原点，按屏幕大小向外留白
+    const qreal margin = (qMax(m_nodeSize, m_controlSize) / 2 + 1) * m_sceneUnitsPerPixel;
+    return m_bounds.adjusted(-margin, -margin, margin, margin);
+}
+
+void NodeHandleOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget)
+
+    if (m_points.isEmpty()) {
+        return;
+    }
+
+    const QTransform deviceTransform = painter->worldTransform();
+    const qreal scale = qSqrt(qAbs(deviceTransform.determinant()));
+    if (scale <= 0) {
+        return;
+    }
+
+    // 暴露区域外扩一个手柄大小，只露出一部分的手柄也要绘制
+    const qreal margin = qMax(m_nodeSize, m_controlSize) / scale;
+    const QRectF visible = option->exposedRect.adjusted(-margin, -margin, margin, margin);
+
+    QVector<QLineF> arms;
+    for (const QPair<int, int> &arm : std::as_const(m_arms)) {
+        const QPointF &a = m_points[arm.first];
+        const QPointF &b = m_points[arm.second];
+        if (!segmentOutside(a, b, visible)) {
+            arms.append(QLineF(deviceTransform.map(a), deviceTransform.map(b)));
+        }
+    }
+
+    // 在设备坐标中收集可见手柄，批量绘制
+    QVector<QRectF> nodes;
+    QVector<QRectF> controls;
+    const qreal nodeHalf = m_nodeSize / 2;
+    const qreal controlHalf = m_controlSize / 2;
+    for (int i = 0; i < m_points.size(); ++i) {
+        const QPointF &point = m_points[i];
+        if (point.x() < visible.left() || point.x() > visible.right()
+            || point.y() < visible.top() || point.y() > visible.bottom()
+            || (!m_hidden.isEmpty() && m_hidden.contains(i))) {
+            continue;
+        }
+        const QPointF center = deviceTransform.map(point);
+        if (m_isControl[i]) {
+            controls.append(QRectF(center.x() - controlHalf, center.y() - controlHalf, m_controlSize, m_controlSize));
+        } else {
+            nodes.append(QRectF(center.x() - nodeHalf, center.y() - nodeHalf, m_nodeSize, m_nodeSize));
+        }
+    }
+
+    painter->save();
+    painter->resetTransform();
+
+    if (!arms.isEmpty()) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(QPen(ArmColor, 1, Qt::DashLine));
+        painter->drawLines(arms);
+    }
+
+    // 与CustomHandleItem的外观一致：黑色描边加半透明内框
+    QColor innerColor(Qt::black);
+    innerColor.setAlpha(100);
+    const QPen outlinePen(Qt::black, 1);
+    const QPen innerPen(innerColor, 0.5);
+
+    if (!nodes.isEmpty()) {
+        painter->setRenderHint(QPainter::Antialiasing, true);
+        painter->setPen(outlinePen);
+        painter->setBrush(m_nodeColor);
+        painter->drawRects(nodes);
+
+        const qreal inset = m_nodeSize * 0.3;
+        for (QRectF &rect : nodes) {
+            rect.adjust(inset, inset, -inset, -inset);
+        }
+        painter->setPen(innerPen);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRects(nodes);
+    }
+
+    if (!controls.isEmpty()) {
+        painter->setRenderHint(QPainter::Antialiasing, true);
+        const qreal inset = m_controlSize * 0.3;
+        painter->setPen(outlinePen);
+        painter->setBrush(m_controlColor);
+        for (const QRectF &rect : std::as_const(controls)) {
+            painter->drawEllipse(rect);
+        }
+        painter->setPen(innerPen);
+        painter->setBrush(Qt::NoBrush);
+        for (const QRectF &rect : std::as_const(controls)) {
+            painter->drawEllipse(rect.adjusted(inset, inset, -inset, -inset));
+        }
+    }
+
+    painter->restore();
+}
+
+void NodeHandleOverlay::setHandles(const QVector<QPointF> &points, const QVector<bool> &isControl,
+                                   const QVector<QPair<int, int>> &arms)
+{
+    prepareGeometryChange();
+    m_points = points;
+    m_isControl = isControl;
+    m_isControl.resize(m_points.size());
+    m_arms.clear();
+    m_arms.reserve(arms.size());
+    for (const QPair<int, int> &arm : arms) {
+        if (arm.first >= 0 && arm.first < m_points.size() && arm.second >= 0 && arm.second < m_points.size()) {
+            m_arms.append(arm);
+        }
+    }
+    m_hidden.clear();
+    m_index.reset();
+    updateBounds();
+    update();
+}
+
+void NodeHandleOverlay::setHandlePositions(const QVector<QPointF> &points)
+{
+    if (points.size() != m_points.size()) {
+        return;
+    }
+    prepareGeometryChange();
+    m_points = points;
+    m_index.reset();
+    updateBounds();
+    update();
+}
+
+void NodeHandleOverlay::setHandlePosition(int index, const QPointF &pos)
+{
+    if (index < 0 || index >= m_points.size() || m_points[index] == pos) {
+        return;
+    }
+
+    // 拖动时只有一个点变化，手柄仍在包围盒内时不必改变边界
+    // （QRectF::contains和united会忽略宽或高为0的矩形，这里直接比较坐标）
+    if (pos.x() >= m_bounds.left() && pos.x() <= m_bounds.right()
+        && pos.y() >= m_bounds.top() && pos.y() <= m_bounds.bottom()) {
+        m_points[index] = pos;
+    } else {
+        prepareGeometryChange();
+        m_points[index] = pos;
+        m_bounds = QRectF(QPointF(qMin(m_bounds.left(), pos.x()), qMin(m_bounds.top(), pos.y())),
+                          QPointF(qMax(m_bounds.right(), pos.x()), qMax(m_bounds.bottom(), pos.y())));
+    }
+    m_index.reset();
+    update();
+}
+
+void NodeHandleOverlay::setHandleHidden(int index, bool hidden)
+{
+    if (index < 0 || index >= m_points.size() || m_hidden.contains(index) == hidden) {
+        return;
+    }
+    if (hidden) {
+        m_hidden.insert(index);
+    } else {
+        m_hidden.remove(index);
+    }
+    update();
+}
+
+void NodeHandleOverlay::setHandleStyle(qreal nodeSize, const QColor &nodeColor, qreal controlSize, const QColor &controlColor)
+{
+    prepareGeometryChange();
+    m_nodeSize = nodeSize;
+    m_nodeColor = nodeColor;
+    m_controlSize = controlSize;
+    m_controlColor = controlColor;
+    update();
+}
+
+void NodeHandleOverlay::setSceneUnitsPerPixel(qreal units)
+{
+    if (units <= 0 || qFuzzyCompare(units, m_sceneUnitsPerPixel)) {
+        return;
+    }
+    prepareGeometryChange();
+    m_sceneUnitsPerPixel = units;
+}
+
+int NodeHandleOverlay::handleAt(const QPointF &scenePos, qreal radius) const
+{
+    if (m_points.isEmpty()) {
+        return -1;
+    }
+    if (!m_index) {
+        m_index = std::make_shared<PointKdTree>(m_points);
+    }
+    return m_index->nearest(scenePos, radius);
+}
+
+void NodeHandleOverlay::updateBounds()
+{
+    if (m_points.isEmpty()) {
+        m_bounds = QRectF();
+        return;
+    }
+
+    qreal left = m_points.first().x();
+    qreal right = left;
+    qreal top = m_points.first().y();
+    qreal bottom = top;
+    for (const QPointF &point : std::as_const(m_points)) {
+        left = qMin(left, point.x());
+        right = qMax(right, point.x());
+        top = qMin(top, point.y());
+        bottom = qMax(bottom, point.y());
+    }
+    m_bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+}
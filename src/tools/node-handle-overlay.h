@@ -0,0 +1,77 @@
+#ifndef NODE_HANDLE_OVERLAY_H
+#define NODE_HANDLE_OVERLAY_H
+
+#include <QColor>
+#include <QGraphicsItem>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+#include <memory>
+
+class PointKdTree;
+
+/**
+ * @brief 批量绘制路径节点手柄的覆盖层
+ * @details 用一个图形项绘制整条路径的节点（方形）、控制点（圆形）和控制杆（虚线），
+ * 每次只绘制暴露区域内的部分，命中测试通过k-d树完成，不再为每个节点创建图形项。
+ * 手柄按屏幕像素大小绘制，不随视图缩放。
+ * 正在交互的节点由NodeHandleManager另行创建真实手柄，覆盖层跳过这些节点
+ */
+class NodeHandleOverlay : public QGraphicsItem
+{
+public:
+    NodeHandleOverlay();
+    ~NodeHandleOverlay() override;
+
+    // QGraphicsItem接口
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    /**
+     * 设置所有手柄
+     * @param points 手柄的场景坐标
+     * @param isControl 是否为控制点（圆形），否则为节点（方形）
+     * @param arms 控制杆连接的两个手柄下标
+     */
+    void setHandles(const QVector<QPointF> &points, const QVector<bool> &isControl,
+                    const QVector<QPair<int, int>> &arms);
+
+    // 手柄数量不变时只更新位置，保留类型和控制杆
+    void setHandlePositions(const QVector<QPointF> &points);
+    void setHandlePosition(int index, const QPointF &pos);
+    QPointF handlePosition(int index) const { return m_points.value(index); }
+    int handleCount() const { return m_points.size(); }
+
+    // 隐藏已由真实手柄项显示的手柄
+    void setHandleHidden(int index, bool hidden);
+
+    // 手柄外观，大小以屏幕像素计
+    void setHandleStyle(qreal nodeSize, const QColor &nodeColor, qreal controlSize, const QColor &controlColor);
+
+    // 当前视图一个像素对应的场景长度，用于计算边界留白
+    void setSceneUnitsPerPixel(qreal units);
+
+    /**
+     * 离scenePos最近且距离不超过radius的手柄下标，没有时返回-1
+     */
+    int handleAt(const QPointF &scenePos, qreal radius) const;
+
+private:
+    void updateBounds();
+
+    QVector<QPointF> m_points;
+    QVector<bool> m_isControl;
+    QVector<QPair<int, int>> m_arms;
+    QSet<int> m_hidden;
+    QRectF m_bounds;            // 所有手柄中心的包围盒
+    qreal m_sceneUnitsPerPixel;
+
+    qreal m_nodeSize;
+    qreal m_controlSize;
+    QColor m_nodeColor;
+    QColor m_controlColor;
+
+    mutable std::shared_ptr<PointKdTree> m_index;   // 命中测试时按需建立，位置变化后丢弃
+};
+
+#endif // NODE_HANDLE_OVERLAY_H
@@ -1,26 +1,120 @@
 #include <QGraphicsItem>
 #include <QDataStream>
+#include <typeinfo>
 #include "command-manager.h"
 #include "drawingscene.h"
 #include "../core/drawing-shape.h"
 #include "../core/drawing-group.h"
+#include "../core/shape-record.h"
 #include "../core/layer-manager.h"
 #include "../core/drawing-layer.h"
 
 // 静态成员初始化
 CommandManager* CommandManager::s_instance = nullptr;
 
+namespace {
+// 默认撤销内存预算
+const qint64 DefaultUndoMemoryBudget = 64 * 1024 * 1024;
+
+// 估算图形本身占用的内存，组合包含其子对象
+qint64 shapeMemoryCost(const DrawingShape *shape)
+{
+    qint64 cost = sizeof(DrawingShape);
+    switch (shape->shapeType()) {
+    case DrawingShape::Path:
+        // 路径元素和节点编辑用的控制点
+        cost += 2 * static_cast<const DrawingPath*>(shape)->path().elementCount()
+                * qint64(sizeof(QPainterPath::Element));
+        break;
+    case DrawingShape::Polyline:
+        cost += static_cast<const DrawingPolyline*>(shape)->pointCount() * qint64(sizeof(QPointF));
+        break;
+    case DrawingShape::Polygon:
+        cost += static_cast<const DrawingPolygon*>(shape)->pointCount() * qint64(sizeof(QPointF));
+        break;
+    case DrawingShape::Text:
+        cost += static_cast<const DrawingText*>(shape)->text().size() * qint64(sizeof(QChar));
+        break;
+    case DrawingShape::Group:
+        for (const DrawingShape *child : static_cast<const DrawingGroup*>(shape)->items()) {
+            if (child) {
+                cost += shapeMemoryCost(child);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+    return cost;
+}
+
+// 场景中的图形由场景持有，不在场景中的由持有它的命令负责
+qint64 detachedShapeCost(const DrawingShape *shape)
+{
+    return shape && !shape->scene() ? shapeMemoryCost(shape) : 0;
+}
+
+// 删除已不在场景中的图形，先从所属图层中移除，避免图层保留悬空指针
+void deleteDetachedShape(DrawingShape *shape)
+{
+    if (!shape || shape->scene()) {
+        return;
+    }
+    if (LayerManager *layerManager = LayerManager::instance()) {
+        for (DrawingLayer *layer : layerManager->layers()) {
+            if (layer) {
+                layer->removeShape(shape);
+            }
+        }
+    }
+    delete shape;
+}
+
+// 只有BaseCommand能释放自己保存的状态；beginMacro生成的宏命令本身不保存状态，
+// 能否释放取决于其子命令
+bool isReleasable(const QUndoCommand *command)
+{
+    if (!dynamic_cast<const BaseCommand*>(command) && typeid(*command) != typeid(QUndoCommand)) {
+        return false;
+    }
+    for (int i = 0; i < command->childCount(); ++i) {
+        if (!isReleasable(command->child(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void releaseCommand(QUndoCommand *command)
+{
+    if (BaseCommand *baseCommand = dynamic_cast<BaseCommand*>(command)) {
+        baseCommand->releaseMemory();
+    }
+    for (int i = 0; i < command->childCount(); ++i) {
+        releaseCommand(const_cast<QUndoCommand*>(command->child(i)));
+    }
+}
+}
+
 CommandManager::CommandManager(QObject *parent)
     : QObject(parent)
     , m_scene(nullptr)
     , m_undoStack(new QUndoStack(this))
+    , m_memoryBudget(DefaultUndoMemoryBudget)
+    , m_undoFloor(0)
 {
     // qDebug() << "CommandManager created";
     
     connect(m_undoStack, &QUndoStack::cleanChanged, this, &CommandManager::undoStackChanged);
-    connect(m_undoStack, &QUndoStack::canUndoChanged, this, [this](bool canUndo) { 
+    connect(m_undoStack, &QUndoStack::canUndoChanged, this, [this](bool) { 
         // qDebug() << "CommandManager: canUndoChanged:" << canUndo; 
-        emit canUndoChanged(canUndo); 
+        emit canUndoChanged(canUndo()); 
+    });
+    connect(m_undoStack, &QUndoStack::indexChanged, this, [this](int index) {
+        // 历史面板可以直接跳转到任意位置，不允许回到状态已释放的命令之前
+        if (index < m_undoFloor) {
+            m_undoStack->setIndex(m_undoFloor);
+        }
     });
     connect(m_undoStack, &QUndoStack::canRedoChanged, this, [this](bool canRedo) { 
         // qDebug() << "CommandManager: canRedoChanged:" << canRedo; 
@@ -73,7 +167,7 @@ void CommandManager::redo()
 
 bool CommandManager::canUndo() const
 {
-    return m_undoStack->canUndo();
+    return m_undoStack->canUndo() && m_undoStack->index() > m_undoFloor;
 }
 
 bool CommandManager::canRedo() const
@@ -83,9 +177,73 @@ bool CommandManager::canRedo() const
 
 void CommandManager::clear()
 {
+    m_undoFloor = 0;
     m_undoStack->clear();
 }
 
+void CommandManager::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+qint64 CommandManager::memoryUsage() const
+{
+    qint64 total = 0;
+    for (int i = 0; i < m_undoStack->count(); ++i) {
+        total += commandMemoryCost(m_undoStack->command(i));
+    }
+    return total;
+}
+
+qint64 CommandManager::averageCommandBytes() const
+{
+    const int count = m_undoStack->count();
+    return count > 0 ? memoryUsage() / count : 0;
+}
+
+qint64 CommandManager::commandMemoryCost(const QUndoCommand *command)
+{
+    if (!command) {
+        return 0;
+    }
+    
+    // 不是BaseCommand的命令（如场景变换命令）按对象大小估算
+    const BaseCommand *baseCommand = dynamic_cast<const BaseCommand*>(command);
+    qint64 cost = baseCommand ? baseCommand->memoryCost() : qint64(sizeof(QUndoCommand));
+    
+    // 宏命令的子命令
+    for (int i = 0; i < command->childCount(); ++i) {
+        cost += commandMemoryCost(command->child(i));
+    }
+    return cost;
+}
+
+void CommandManager::enforceMemoryBudget()
+{
+    if (m_memoryBudget <= 0) {
+        return;
+    }
+    
+    qint64 total = memoryUsage();
+    // 从最早的命令开始释放，当前命令始终保留。
+    // 遇到无法释放的命令即停止，下限不会越过仍保存着状态的命令
+    const int last = m_undoStack->index() - 1;
+    while (m_undoFloor < last && total > m_memoryBudget) {
+        QUndoCommand *command = const_cast<QUndoCommand*>(m_undoStack->command(m_undoFloor));
+        if (!command || !isReleasable(command)) {
+            break;
+        }
+        
+        const qint64 before = commandMemoryCost(command);
+        releaseCommand(command);
+        total -= before - commandMemoryCost(command);
+        ++m_undoFloor;
+    }
+    
+    emit canUndoChanged(canUndo());
+}
+
 void CommandManager::pushCommand(QUndoCommand *command)
 {
     if (!command) {
@@ -103,6 +261,10 @@ void CommandManager::pushCommand(QUndoCommand *command)
     // qDebug() << "CommandManager::pushCommand - undoStack count before:" << m_undoStack->count();
     m_undoStack->push(command);
     // qDebug() << "CommandManager::pushCommand - undoStack count after:" << m_undoStack->count();
+    // 宏命令录制期间栈中还没有该命令，等结束时再检查
+    if (m_undoStack->command(m_undoStack->index() - 1) == command) {
+        enforceMemoryBudget();
+    }
     emit commandExecuted(command->text());
     if (m_scene) m_scene->setModified(true);
     // qDebug() << "CommandManager::pushCommand completed";
@@ -123,6 +285,7 @@ void CommandManager::endMacro()
     if (m_undoStack) {
         // qDebug() << "CommandManager::endMacro called";
         m_undoStack->endMacro();
+        enforceMemoryBudget();
     } else {
         qWarning() << "CommandManager::endMacro - no undo stack available";
     }
@@ -148,15 +311,30 @@ SelectionCommand::SelectionCommand(CommandManager *manager, const QList<DrawingS
 TransformCommand::TransformCommand(CommandManager *manager, const QList<DrawingShape*>& shapes,
                                   const QString &text, QUndoCommand *parent)
     : SelectionCommand(manager, shapes, text, parent)
+    , m_stateFlags(GeometryState | StyleState)
+    , m_released(false)
 {
 }
 
+qint64 TransformCommand::memoryCost() const
+{
+    // 画笔画刷与图形共享数据，只计算结构本身
+    return sizeof(*this) + (m_originalStates.size() + m_newStates.size()) * qint64(sizeof(ShapeState));
+}
+
+void TransformCommand::releaseMemory()
+{
+    m_originalStates.clear();
+    m_newStates.clear();
+    m_released = true;
+}
+
 void TransformCommand::saveOriginalStates()
 {
     m_originalStates.clear();
     for (DrawingShape *shape : m_shapes) {
         if (shape) {
-            m_originalStates[shape] = shape->serialize();
+            m_originalStates[shape] = captureState(shape);
         }
     }
 }
@@ -166,21 +344,56 @@ void TransformCommand::saveNewStates()
     m_newStates.clear();
     for (DrawingShape *shape : m_shapes) {
         if (shape) {
-            m_newStates[shape] = shape->serialize();
+            m_newStates[shape] = captureState(shape);
         }
     }
 }
 
-void TransformCommand::restoreStates(const QMap<DrawingShape*, QByteArray>& states)
+void TransformCommand::restoreStates(const QMap<DrawingShape*, ShapeState>& states)
 {
     for (auto it = states.begin(); it != states.end(); ++it) {
         DrawingShape *shape = it.key();
         if (shape) {
-            shape->deserialize(it.value());
+            applyState(shape, it.value());
         }
     }
 }
 
+TransformCommand::ShapeState TransformCommand::captureState(DrawingShape *shape) const
+{
+    ShapeState state;
+    if (m_stateFlags & GeometryState) {
+        state.position = shape->pos();
+        state.rotation = shape->rotation();
+        state.scale = shape->scale();
+        state.transform = shape->transform();
+    }
+    if (m_stateFlags & StyleState) {
+        // QPen/QBrush是隐式共享的，只增加引用计数
+        state.pen = shape->strokePen();
+        state.brush = shape->fillBrush();
+    }
+    return state;
+}
+
+void TransformCommand::applyState(DrawingShape *shape, const ShapeState &state) const
+{
+    if (m_stateFlags & GeometryState) {
+        shape->setPos(state.position);
+        shape->setRotation(state.rotation);
+        shape->setScale(state.scale);
+        // 只恢复图形自身的变换矩阵；DrawingGroup::applyTransform会把变换
+        // 再叠加到子对象上，而子对象的状态不由这里记录
+        if (shape->transform() != state.transform) {
+            shape->DrawingShape::applyTransform(state.transform);
+        }
+    }
+    if (m_stateFlags & StyleState) {
+        shape->setStrokePen(state.pen);
+        shape->setFillBrush(state.brush);
+    }
+}
+
 // PropertyCommand实现
 PropertyCommand::PropertyCommand(CommandManager *manager, const QList<DrawingShape*>& shapes,
                                 const QString &propertyName, const QVariant &oldValue, const QVariant &newValue,
@@ -312,18 +525,32 @@ void DeleteCommand::redo()
     emit m_commandManager->statusMessageChanged(QString("已删除 %1 个对象").arg(m_shapes.count()));
 }
 
+qint64 DeleteCommand::memoryCost() const
+{
+    qint64 cost = sizeof(*this);
+    for (const DrawingShape *shape : m_shapes) {
+        cost += detachedShapeCost(shape);
+    }
+    return cost;
+}
+
+void DeleteCommand::releaseMemory()
+{
+    // 已经不能撤销，被删除的图形不会再回到场景
+    for (DrawingShape *shape : m_shapes) {
+        deleteDetachedShape(shape);
+    }
+    m_shapes.clear();
+    m_parents.clear();
+    m_positions.clear();
+}
+
 // DuplicateCommand实现
 DuplicateCommand::DuplicateCommand(CommandManager *manager, const QList<DrawingShape*>& shapes,
                                   const QPointF &offset, QUndoCommand *parent)
     : SelectionCommand(manager, shapes, "复制对象", parent)
     , m_offset(offset)
 {
-    // 保存原始对象的序列化数据
-    for (DrawingShape *shape : shapes) {
-        if (shape) {
-            m_serializedData[shape] = shape->serialize();
-        }
-    }
 }
 
 DuplicateCommand::~DuplicateCommand()
@@ -339,6 +566,13 @@ DuplicateCommand::~DuplicateCommand()
     m_duplicatedShapes.clear();
 }
 
+void DuplicateCommand::releaseMemory()
+{
+    // 复制出的图形在场景中，由场景持有；之后的删除命令释放时可能已将其删除，
+    // 清空列表避免析构时重复删除
+    m_duplicatedShapes.clear();
+}
+
 void DuplicateCommand::undo()
 {
     if (!m_scene) return;
@@ -388,48 +622,10 @@ void DuplicateCommand::redo()
         if (!duplicate) {
             // 回退到序列化方式
             qDebug() << "DuplicateCommand: clone failed, using serialization";
-            QByteArray shapeData = original->serialize();
-            QDataStream typeStream(shapeData);
-            int typeValue;
-            typeStream >> typeValue;
-            DrawingShape::ShapeType shapeType = static_cast<DrawingShape::ShapeType>(typeValue);
-            
-            switch (shapeType) {
-                case DrawingShape::Rectangle:
-                    duplicate = new DrawingRectangle();
-                    break;
-                case DrawingShape::Ellipse:
-                    duplicate = new DrawingEllipse();
-                    break;
-                case DrawingShape::Line:
-                    duplicate = new DrawingLine();
-                    break;
-                case DrawingShape::Path:
-                    duplicate = new DrawingPath();
-                    break;
-                case DrawingShape::Polyline:
-                    duplicate = new DrawingPolyline();
-                    break;
-                case DrawingShape::Polygon:
-                    duplicate = new DrawingPolygon();
-                    break;
-                case DrawingShape::Text:
-                    duplicate = new DrawingText();
-                    break;
-                case DrawingShape::Group:
-                    duplicate = new DrawingGroup();
-                    break;
-                default:
-                    continue;
-            }
-            
+            ShapeRecordReader reader(original->serialize());
+            duplicate = reader.readShape();
             if (duplicate) {
-                qDebug() << "DuplicateCommand: deserializing shape type" << shapeType << "data size:" << shapeData.size();
-                duplicate->deserialize(shapeData);
                 qDebug() << "DuplicateCommand: deserialized pos:" << duplicate->pos();
-                qDebug() << "DuplicateCommand: rect bounds:" << duplicate->boundingRect();
-                qDebug() << "DuplicateCommand: stroke pen:" << duplicate->strokePen().color();
-                qDebug() << "DuplicateCommand: fill brush:" << duplicate->fillBrush().color();
             }
         }
         
@@ -468,21 +664,23 @@ AlignCommand::AlignCommand(CommandManager *manager, const QList<DrawingShape*>&
     : TransformCommand(manager, shapes, "对齐对象", parent)
     , m_alignment(alignment)
 {
+    // 对齐只改变位置
+    setStateFlags(GeometryState);
     saveOriginalStates();
 }
 
 void AlignCommand::undo()
 {
+    if (m_released) return;
+    
     restoreStates(m_originalStates);
     emit m_commandManager->statusMessageChanged("已撤销对齐");
 }
 
 void AlignCommand::redo()
 {
-    saveNewStates();
-    
     // 执行对齐操作
-    if (m_shapes.isEmpty()) return;
+    if (m_released || m_shapes.isEmpty()) return;
     
     // 计算对齐边界
     QRectF combinedBounds = m_shapes.first()->boundingRect();
@@ -566,6 +764,7 @@ void AlignCommand::redo()
         case Bottom: alignmentName = "底对齐"; break;
     }
     
+    saveNewStates();
     emit m_commandManager->statusMessageChanged(QString("已%1").arg(alignmentName));
 }
 
@@ -577,11 +776,15 @@ EffectCommand::EffectCommand(CommandManager *manager, const QList<DrawingShape*>
     , m_effectType(effectType)
     , m_effectParams(effectParams)
 {
+    // 效果命令修改画笔和画刷
+    setStateFlags(StyleState);
     saveOriginalStates();
 }
 
 void EffectCommand::undo()
 {
+    if (m_released) return;
+    
     restoreStates(m_originalStates);
     emit m_commandManager->statusMessageChanged("已撤销效果");
 }
@@ -589,7 +792,7 @@ void EffectCommand::undo()
 void EffectCommand::redo()
 {
     qDebug() << "EffectCommand::redo called, effectType:" << m_effectType << "shapes count:" << m_shapes.count();
-    saveNewStates();
+    if (m_released) return;
     
     // 应用效果
     for (DrawingShape *shape : m_shapes) {
@@ -651,6 +854,7 @@ void EffectCommand::redo()
         }
     }
     
+    saveNewStates();
     emit m_commandManager->statusMessageChanged("已应用效果");
 }
 
@@ -702,10 +906,10 @@ void CreateCommand::redo()
 }
 
 // PasteCommand 实现
-PasteCommand::PasteCommand(CommandManager *manager, const QList<QByteArray> &shapeDataList, 
+PasteCommand::PasteCommand(CommandManager *manager, const QByteArray &shapeData, 
                            const QPointF &offset, QUndoCommand *parent)
     : BaseCommand(manager, "粘贴对象", parent)
-    , m_shapeDataList(shapeDataList)
+    , m_shapeData(shapeData)
     , m_offset(offset)
 {
 }
@@ -736,65 +940,44 @@ void PasteCommand::redo()
     
     m_pastedShapes.clear();
     
-    // 创建并添加对象到场景
-    for (const QByteArray &shapeData : m_shapeDataList) {
-        // 读取形状类型
-        QDataStream typeStream(shapeData);
-        int typeValue;
-        typeStream >> typeValue;
-        DrawingShape::ShapeType shapeType = static_cast<DrawingShape::ShapeType>(typeValue);
-        
-        // 创建对应的形状对象
-        DrawingShape *shape = nullptr;
-        switch (shapeType) {
-            case DrawingShape::Rectangle:
-                shape = new DrawingRectangle();
-                break;
-            case DrawingShape::Ellipse:
-                shape = new DrawingEllipse();
-                break;
-            case DrawingShape::Line:
-                shape = new DrawingLine();
-                break;
-            case DrawingShape::Path:
-                shape = new DrawingPath();
-                break;
-            case DrawingShape::Polyline:
-                shape = new DrawingPolyline();
-                break;
-            case DrawingShape::Polygon:
-                shape = new DrawingPolygon();
-                break;
-            case DrawingShape::Text:
-                shape = new DrawingText();
-                break;
-            case DrawingShape::Group:
-                shape = new DrawingGroup();
-                break;
-            default:
-                qDebug() << "Unsupported shape type for pasting:" << typeValue;
-                continue;
+    // 按顺序读取剪贴板缓冲区中的所有图形记录，无法读取的记录跳过
+    ShapeRecordReader reader(m_shapeData);
+    while (!reader.atEnd()) {
+        DrawingShape *shape = reader.readShape();
+        if (!shape) {
+            continue;
         }
         
-        if (shape) {
-            qDebug() << "PasteCommand: deserializing shape type" << shapeType << "data size:" << shapeData.size();
-            shape->deserialize(shapeData);
-            qDebug() << "PasteCommand: deserialized shape pos:" << shape->pos();
-            // 应用偏移
-            shape->setPos(shape->pos() + m_offset);
-            qDebug() << "PasteCommand: final pos after offset:" << shape->pos();
-            
-            m_scene->addItem(shape);
-            shape->setSelected(true);
-            m_pastedShapes.append(shape);
-            qDebug() << "PasteCommand: shape added to scene, visible:" << shape->isVisible();
-        }
+        // 应用偏移
+        shape->setPos(shape->pos() + m_offset);
+        m_scene->addItem(shape);
+        shape->setSelected(true);
+        m_pastedShapes.append(shape);
     }
     
     qDebug() << "PasteCommand::redo created" << m_pastedShapes.count() << "pasted shapes";
+    if (reader.skippedRecords() > 0) {
+        qWarning() << "PasteCommand: skipped" << reader.skippedRecords() << "unsupported or corrupt shape records";
+        emit m_commandManager->statusMessageChanged(QString("已粘贴 %1 个对象，%2 个对象无法读取")
+                                                        .arg(m_pastedShapes.count())
+                                                        .arg(reader.skippedRecords()));
+        return;
+    }
     emit m_commandManager->statusMessageChanged(QString("已粘贴 %1 个对象").arg(m_pastedShapes.count()));
 }
 
+qint64 PasteCommand::memoryCost() const
+{
+    // 粘贴出的图形在场景中，只计算剪贴板记录
+    return sizeof(*this) + m_shapeData.capacity();
+}
+
+void PasteCommand::releaseMemory()
+{
+    m_shapeData = QByteArray();
+    m_pastedShapes.clear();
+}
+
 // GroupCommand 实现
 GroupCommand::GroupCommand(CommandManager *manager, const QList<DrawingShape*>& shapes, 
                            QUndoCommand *parent)
@@ -1022,6 +1205,28 @@ void TextToPathCommand::undo()
     emit m_commandManager->statusMessageChanged(QString("已恢复 %1 个文本对象").arg(m_textShapes.count()));
 }
 
+qint64 TextToPathCommand::memoryCost() const
+{
+    qint64 cost = sizeof(*this);
+    for (const DrawingText *textShape : m_textShapes) {
+        cost += detachedShapeCost(textShape);
+    }
+    return cost;
+}
+
+void TextToPathCommand::releaseMemory()
+{
+    // 已经不能撤销，原文本不会再回到场景；转换得到的路径由场景持有
+    for (DrawingText *textShape : m_textShapes) {
+        deleteDetachedShape(textShape);
+    }
+    m_textShapes.clear();
+    m_pathShapes.clear();
+    m_positions.clear();
+    m_fillBrushes.clear();
+    m_strokePens.clear();
+}
+
 // TextEditCommand 实现
 TextEditCommand::TextEditCommand(CommandManager *manager, DrawingText *textShape, 
                                 const QString &oldText, const QString &newText,
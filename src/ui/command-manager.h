@@ -11,6 +11,9 @@
 #include <QVariantMap>
 #include <QPointF>
 #include <QGraphicsItem>
+#include <QTransform>
+#include <QPen>
+#include <QBrush>
 
 class DrawingScene;
 class DrawingShape;
@@ -83,6 +86,15 @@ public:
     
     // 获取撤销栈
     QUndoStack* undoStack() const { return m_undoStack; }
+    
+    // 撤销内存预算（字节）：超出后释放最早命令保存的状态，这些命令不再能撤销
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    
+    // 撤销栈中命令占用的内存（估算）
+    qint64 memoryUsage() const;
+    qint64 averageCommandBytes() const;
+    static qint64 commandMemoryCost(const QUndoCommand *command);
 
 signals:
     void commandExecuted(const QString &commandText);
@@ -92,9 +104,13 @@ signals:
     void canRedoChanged(bool canRedo);
 
 private:
+    void enforceMemoryBudget();
+    
     static CommandManager* s_instance;
     DrawingScene *m_scene;
     QUndoStack *m_undoStack;
+    qint64 m_memoryBudget;
+    int m_undoFloor;   // 低于此索引的命令状态已释放，不能再撤销；下限不会越过未释放的命令
 };
 
 // 基础命令类
@@ -103,6 +119,13 @@ class BaseCommand : public QUndoCommand
 public:
     BaseCommand(CommandManager *manager, const QString &text, QUndoCommand *parent = nullptr);
     
+    // 命令保存的状态占用的内存（估算），用于撤销内存预算
+    virtual qint64 memoryCost() const { return sizeof(*this); }
+    
+    // 释放保存的状态以回收内存，释放后undo/redo不再生效
+    // 只会对已执行且位于撤销下限之下的命令调用；默认没有需要释放的状态
+    virtual void releaseMemory() {}
+    
 protected:
     CommandManager *m_commandManager;
     DrawingScene *m_scene;
@@ -120,19 +143,46 @@ protected:
 };
 
 // 变换命令
+// 只记录命令会修改的状态（位置、变换矩阵、画笔画刷）
 class TransformCommand : public SelectionCommand
 {
 public:
+    enum StateFlag {
+        GeometryState = 0x1,   // 位置、旋转、缩放和变换矩阵
+        StyleState = 0x2       // 描边画笔和填充画刷
+    };
+    
     TransformCommand(CommandManager *manager, const QList<DrawingShape*>& shapes,
                     const QString &text, QUndoCommand *parent = nullptr);
     
+    qint64 memoryCost() const override;
+    void releaseMemory() override;
+    
 protected:
-    QMap<DrawingShape*, QByteArray> m_originalStates;
-    QMap<DrawingShape*, QByteArray> m_newStates;
+    struct ShapeState {
+        QPointF position;
+        qreal rotation = 0;
+        qreal scale = 1;
+        QTransform transform;
+        QPen pen;
+        QBrush brush;
+    };
+    
+    // 设置需要保存的状态，应在saveOriginalStates之前调用
+    void setStateFlags(int flags) { m_stateFlags = flags; }
+    
+    QMap<DrawingShape*, ShapeState> m_originalStates;
+    QMap<DrawingShape*, ShapeState> m_newStates;
+    int m_stateFlags;
+    bool m_released;
     
     void saveOriginalStates();
     void saveNewStates();
-    void restoreStates(const QMap<DrawingShape*, QByteArray>& states);
+    void restoreStates(const QMap<DrawingShape*, ShapeState>& states);
+    
+private:
+    ShapeState captureState(DrawingShape *shape) const;
+    void applyState(DrawingShape *shape, const ShapeState &state) const;
 };
 
 // 属性修改命令
@@ -162,6 +212,10 @@ public:
     void undo() override;
     void redo() override;
     
+    // 已删除的图形不在场景中，由命令持有
+    qint64 memoryCost() const override;
+    void releaseMemory() override;
+    
 private:
     QMap<DrawingShape*, QGraphicsItem*> m_parents;
     QMap<DrawingShape*, QPointF> m_positions; // 保存场景位置
@@ -177,11 +231,11 @@ public:
     ~DuplicateCommand();
     void undo() override;
     void redo() override;
+    void releaseMemory() override;
     
 private:
     QPointF m_offset;
     QList<DrawingShape*> m_duplicatedShapes;
-    QMap<DrawingShape*, QByteArray> m_serializedData;
 };
 
 // 对齐命令
@@ -244,14 +298,17 @@ private:
 class PasteCommand : public BaseCommand
 {
 public:
-    PasteCommand(CommandManager *manager, const QList<QByteArray> &shapeDataList, 
+    PasteCommand(CommandManager *manager, const QByteArray &shapeData, 
                  const QPointF &offset, QUndoCommand *parent = nullptr);
     
     void undo() override;
     void redo() override;
     
+    qint64 memoryCost() const override;
+    void releaseMemory() override;
+    
 private:
-    QList<QByteArray> m_shapeDataList;
+    QByteArray m_shapeData;  // 连续的图形记录，见ShapeRecordWriter
     QPointF m_offset;
     QList<DrawingShape*> m_pastedShapes;
 };
@@ -316,6 +373,10 @@ public:
     void undo() override;
     void redo() override;
     
+    // 转换后原文本不在场景中，由命令持有
+    qint64 memoryCost() const override;
+    void releaseMemory() override;
+    
 private:
     QList<DrawingText*> m_textShapes;
     QList<DrawingPath*> m_pathShapes;
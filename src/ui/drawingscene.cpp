@@ -19,6 +19,7 @@
 #include "../core/drawing-layer.h"
 #include "../core/layer-manager.h"
 #include "../core/performance-monitor.h"
+#include "../core/spatial-index.h"
 
 class AddItemCommand : public QUndoCommand
 {
@@ -364,7 +365,8 @@ DrawingScene::DrawingScene(QObject *parent)
     , m_guidesEnabled(true)
     , m_scaleHintVisible(false)
     , m_rotateHintVisible(false)
-    
+    , m_snapManager(nullptr)
+    , m_spatialIndex(new SpatialIndex(this))
     , m_currentTool(0) // 默认为选择工具
 {
     // 不在这里创建选择层，只在选择工具激活时创建
@@ -372,6 +374,43 @@ DrawingScene::DrawingScene(QObject *parent)
     // connect(this, &DrawingScene::selectionChanged, this, &DrawingScene::onSelectionChanged);
 }
 
+DrawingScene::~DrawingScene()
+{
+    // 图形在QGraphicsScene析构时才删除，此时已无法转换为DrawingScene，不会再访问索引
+    delete m_spatialIndex;
+    m_spatialIndex = nullptr;
+}
+
+void DrawingScene::notifyShapeAdded(DrawingShape *shape)
+{
+    if (m_spatialIndex) {
+        m_spatialIndex->insertShape(shape);
+    }
+    if (m_snapManager) {
+        m_snapManager->markShapeDirty(shape);
+    }
+}
+
+void DrawingScene::notifyShapeGeometryChanged(DrawingShape *shape)
+{
+    if (m_spatialIndex) {
+        m_spatialIndex->markDirty(shape);
+    }
+    if (m_snapManager) {
+        m_snapManager->markShapeDirty(shape);
+    }
+}
+
+void DrawingScene::notifyShapeRemoved(DrawingShape *shape)
+{
+    if (m_spatialIndex) {
+        m_spatialIndex->removeShape(shape);
+    }
+    if (m_snapManager) {
+        m_snapManager->removeShape(shape);
+    }
+}
+
 void DrawingScene::setCurrentTool(int toolType)
 {
     m_currentTool = toolType;
@@ -558,21 +597,18 @@ void DrawingScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 void DrawingScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
 {
-    // 获取双击位置的项目
-    QGraphicsItem *item = itemAt(event->scenePos(), QTransform());
-    
-    if (item) {
-        // 双击图形，在节点编辑和选择工具之间切换
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
-        if (shape) {
-            // 发出工具切换请求信号
-            if (m_currentTool == static_cast<int>(ToolType::NodeEdit)) {
-                emit toolSwitchRequested(static_cast<int>(ToolType::Select));
-            } else {
-                emit toolSwitchRequested(static_cast<int>(ToolType::NodeEdit));
-            }
-            return;
+    // 获取双击位置的图形
+    DrawingShape *shape = m_spatialIndex->topShapeAt(event->scenePos());
+    
+    // 双击图形，在节点编辑和选择工具之间切换
+    if (shape) {
+        // 发出工具切换请求信号
+        if (m_currentTool == static_cast<int>(ToolType::NodeEdit)) {
+            emit toolSwitchRequested(static_cast<int>(ToolType::Select));
+        } else {
+            emit toolSwitchRequested(static_cast<int>(ToolType::NodeEdit));
         }
+        return;
     }
     
     // 其他情况传递给基类处理
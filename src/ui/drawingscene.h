@@ -13,6 +13,7 @@ class TransformCommand;
 class GroupCommand;
 class UngroupCommand;
 class SnapManager;
+class SpatialIndex;
 
 class DrawingScene : public QGraphicsScene
 {
@@ -27,6 +28,7 @@ public:
     };
     
     explicit DrawingScene(QObject *parent = nullptr);
+    ~DrawingScene();
     
     bool isModified() const { return m_isModified; }
     void setModified(bool modified);
@@ -37,6 +39,14 @@ public:
     void setSnapManager(SnapManager *snapManager);
     SnapManager* snapManager() const { return m_snapManager; }
     
+    // 空间索引，工具的命中测试统一通过它查询
+    SpatialIndex* spatialIndex() const { return m_spatialIndex; }
+    
+    // 图形变化通知，由DrawingShape调用，同步更新空间索引和吸附点索引
+    void notifyShapeAdded(DrawingShape *shape);
+    void notifyShapeGeometryChanged(DrawingShape *shape);
+    void notifyShapeRemoved(DrawingShape *shape);
+    
     // 选择层管理
     // SelectionLayer* selectionLayer() const { return m_selectionLayer; } // 已移除 - 老的选择层系统
     
@@ -216,6 +226,9 @@ private:
     // SnapManager 引用（合并了网格和对象吸附）
     SnapManager *m_snapManager;
     
+    // 场景空间索引
+    SpatialIndex *m_spatialIndex;
+    
     // 当前工具类型
     int m_currentTool;
     
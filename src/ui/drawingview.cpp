@@ -3,9 +3,17 @@
 #include <QResizeEvent>
 #include <QKeyEvent>
 #include <QPainter>
+#include <QPaintEvent>
+#include <QStyleOptionGraphicsItem>
+#include <QStyleOptionRubberBand>
+#include <QRubberBand>
+#include <QSet>
 #include "drawingview.h"
 #include "drawingscene.h"
 #include "snap-manager.h"
+#include "tile-render-cache.h"
+#include "../core/drawing-shape.h"
+#include "../core/smart-render-manager.h"
 #include "../core/toolbase.h"
 #include "../tools/tool-manager.h"
 
@@ -14,7 +22,8 @@ DrawingView::DrawingView(QGraphicsScene *scene, QWidget *parent)
     , m_zoomLevel(1.0)
     , m_currentTool(nullptr)
     , m_toolManager(nullptr)
-    
+    , m_tileCache(new TileRenderCache(this))
+    , m_tileCacheEnabled(true)
 {
     // Qt原生渲染优化
     setRenderHint(QPainter::Antialiasing);
@@ -40,6 +49,23 @@ DrawingView::DrawingView(QGraphicsScene *scene, QWidget *parent)
     if (scene) {
         setSceneRect(scene->sceneRect());
     }
+    
+    // 瓦片完成后只重绘对应区域
+    connect(m_tileCache, &TileRenderCache::tileReady, this, [this](const QRectF &sceneRect) {
+        viewport()->update(mapFromScene(sceneRect).boundingRect().adjusted(-1, -1, 1, 1));
+    });
+    connect(m_tileCache, &TileRenderCache::updateRequested, this, [this]() {
+        viewport()->update();
+    });
+}
+
+void DrawingView::setTileCacheEnabled(bool enabled)
+{
+    if (m_tileCacheEnabled != enabled) {
+        m_tileCacheEnabled = enabled;
+        m_tileCache->setScene(enabled ? scene() : nullptr);
+        viewport()->update();
+    }
 }
 
 void DrawingView::setZoomLevel(double zoom)
@@ -170,6 +196,178 @@ void DrawingView::scrollContentsBy(int dx, int dy)
     emit viewportChanged();
 }
 
+void DrawingView::paintEvent(QPaintEvent *event)
+{
+    RenderProfiler::instance().beginFrame();
+    paintViewport(event);
+    RenderProfiler::instance().endFrame();
+}
+
+void DrawingView::paintViewport(QPaintEvent *event)
+{
+    const QTransform viewTransform = viewportTransform();
+    
+    // 瓦片只支持缩放和平移
+    if (!m_tileCacheEnabled || !scene() || viewTransform.type() > QTransform::TxScale
+        || viewTransform.m11() != viewTransform.m22()) {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+    
+    m_tileCache->setScene(scene());
+    
+    const QRectF exposedRect = mapToScene(event->rect().adjusted(-1, -1, 1, 1)).boundingRect();
+    const QList<QGraphicsItem*> items = scene()->items(exposedRect, Qt::IntersectsItemBoundingRect,
+                                                       Qt::AscendingOrder);
+    
+    // 图形效果需要QGraphicsScene的效果管线，这类区域交给默认绘制
+    QList<QGraphicsItem*> liveItems;
+    for (QGraphicsItem *item : items) {
+        if (item->graphicsEffect() && item->isVisible()) {
+            QGraphicsView::paintEvent(event);
+            return;
+        }
+        if (!TileRenderCache::isTileable(item) && item->isVisible()) {
+            liveItems.append(item);
+        }
+    }
+    
+    QPainter painter(viewport());
+    painter.setRenderHints(renderHints());
+    painter.setClipRect(event->rect());
+    painter.setTransform(viewTransform);
+    
+    drawBackground(&painter, exposedRect);
+    
+    // 合成已缓存的瓦片，尚未完成的瓦片区域直接绘制
+    const QList<QRectF> missing = m_tileCache->paint(&painter, viewTransform, exposedRect);
+    if (!missing.isEmpty()) {
+        QRegion missingRegion;
+        for (const QRectF &rect : missing) {
+            missingRegion += viewTransform.mapRect(rect).toAlignedRect();
+        }
+        
+        QList<QGraphicsItem*> tileItems;
+        for (QGraphicsItem *item : items) {
+            if (TileRenderCache::isTileable(item)) {
+                tileItems.append(item);
+            }
+        }
+        
+        painter.save();
+        painter.resetTransform();
+        painter.setClipRegion(missingRegion, Qt::IntersectClip);
+        drawItemsDirect(&painter, tileItems, missingRegion.boundingRect() & event->rect());
+        painter.restore();
+    }
+    
+    // 直接绘制的图形上方若还有进入瓦片的图形，最后再画它会盖住这些图形。
+    // 这类图形所在的区域重画背景，并按堆叠顺序连同上方的图形一起直接绘制
+    QRegion restackRegion;
+    QSet<QGraphicsItem*> restackedItems;
+    QRectF tileableAbove;
+    for (int i = items.size() - 1; i >= 0; --i) {
+        QGraphicsItem *item = items.at(i);
+        if (TileRenderCache::isTileable(item)) {
+            tileableAbove |= item->sceneBoundingRect();
+            continue;
+        }
+        if (!item->isVisible() || !dynamic_cast<DrawingShape*>(item)) {
+            continue;
+        }
+        const QRectF bounds = item->sceneBoundingRect();
+        if (!bounds.intersects(tileableAbove)) {
+            continue;
+        }
+        for (int j = i + 1; j < items.size(); ++j) {
+            QGraphicsItem *above = items.at(j);
+            if (TileRenderCache::isTileable(above) && above->sceneBoundingRect().intersects(bounds)) {
+                restackRegion += viewTransform.mapRect(bounds).toAlignedRect().adjusted(-1, -1, 1, 1);
+                restackedItems.insert(item);
+                break;
+            }
+        }
+    }
+    
+    if (!restackRegion.isEmpty()) {
+        const QRectF restackBounds = viewTransform.inverted().mapRect(QRectF(restackRegion.boundingRect()));
+        QList<QGraphicsItem*> stackItems;
+        for (QGraphicsItem *item : items) {
+            if (dynamic_cast<DrawingShape*>(item) && item->isVisible()
+                && item->sceneBoundingRect().intersects(restackBounds)) {
+                stackItems.append(item);
+            }
+        }
+        
+        painter.save();
+        painter.resetTransform();
+        painter.setClipRegion(restackRegion, Qt::IntersectClip);
+        painter.setTransform(viewTransform);
+        drawBackground(&painter, restackBounds);
+        drawItemsDirect(&painter, stackItems, restackRegion.boundingRect() & event->rect());
+        painter.restore();
+        
+        liveItems.removeIf([&restackedItems](QGraphicsItem *item) {
+            return restackedItems.contains(item);
+        });
+    }
+    
+    // 选中的图形、手柄等每帧都直接绘制
+    drawItemsDirect(&painter, liveItems, event->rect());
+    
+    painter.setTransform(viewTransform);
+    drawForeground(&painter, exposedRect);
+    
+    drawRubberBand(&painter);
+}
+
+void DrawingView::drawItemsDirect(QPainter *painter, const QList<QGraphicsItem*> &items, const QRect &exposed)
+{
+    const QTransform viewTransform = viewportTransform();
+    QStyleOptionGraphicsItem option;
+    
+    for (QGraphicsItem *item : items) {
+        painter->save();
+        // deviceTransform会处理忽略变换的项（如手柄）
+        const QTransform deviceTransform = item->deviceTransform(viewTransform);
+        painter->setTransform(deviceTransform);
+        painter->setOpacity(item->effectiveOpacity());
+        option.state = item->isSelected() ? QStyle::State_Selected : QStyle::State_None;
+        // 与QGraphicsView一致：声明ItemUsesExtendedStyleOption的项得到实际暴露的区域，
+        // 用于裁剪（如节点手柄只画视口内的部分）
+        if (item->flags() & QGraphicsItem::ItemUsesExtendedStyleOption) {
+            option.exposedRect = deviceTransform.inverted().mapRect(QRectF(exposed)) & item->boundingRect();
+        } else {
+            option.exposedRect = item->boundingRect();
+        }
+        // widget传空：图形据此区分不经过QGraphicsScene图形项缓存的绘制
+        item->paint(painter, &option, nullptr);
+        painter->restore();
+    }
+}
+
+void DrawingView::drawRubberBand(QPainter *painter)
+{
+    const QRect band = rubberBandRect();
+    if (band.isEmpty()) {
+        return;
+    }
+    
+    painter->resetTransform();
+    painter->setClipping(false);
+    
+    QStyleOptionRubberBand option;
+    option.initFrom(viewport());
+    option.rect = band;
+    option.shape = QRubberBand::Rectangle;
+    
+    QStyleHintReturnMask mask;
+    if (viewport()->style()->styleHint(QStyle::SH_RubberBand_Mask, &option, viewport(), &mask)) {
+        painter->setClipRegion(mask.region, Qt::IntersectClip);
+    }
+    viewport()->style()->drawControl(QStyle::CE_RubberBand, &option, painter, viewport());
+}
+
 void DrawingView::setToolManager(ToolManager* toolManager)
 {
     m_toolManager = toolManager;
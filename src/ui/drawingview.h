@@ -5,6 +5,7 @@
 
 class ToolBase;
 class ToolManager;
+class TileRenderCache;
 
 
 // 前向声明
@@ -33,6 +34,10 @@ public:
     
     // 设置光标样式
     void setCursorForTool(ToolBase *tool);
+    
+    // 瓦片渲染缓存，关闭时使用QGraphicsView的默认绘制
+    void setTileCacheEnabled(bool enabled);
+    bool isTileCacheEnabled() const { return m_tileCacheEnabled; }
 
 signals:
     void zoomChanged(double zoom);
@@ -47,16 +52,23 @@ protected:
     void mouseDoubleClickEvent(QMouseEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     void scrollContentsBy(int dx, int dy) override;
+    void paintEvent(QPaintEvent *event) override;
 
 private slots:
     void onToolSwitchRequested(ToolType newTool);
     
 private:
     void updateZoomLabel();
+    void paintViewport(QPaintEvent *event);
+    // exposed为需要绘制的视口区域（设备坐标）
+    void drawItemsDirect(QPainter *painter, const QList<QGraphicsItem*> &items, const QRect &exposed);
+    void drawRubberBand(QPainter *painter);
     
     double m_zoomLevel;
     ToolBase *m_currentTool;
     ToolManager* m_toolManager;
+    TileRenderCache *m_tileCache;
+    bool m_tileCacheEnabled;
     
 };
 
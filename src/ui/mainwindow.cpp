@@ -798,6 +798,14 @@ void MainWindow::setupMenus()
     m_pathClipPathAction->setStatusTip(tr("使用边界框裁剪路径"));
     pathMenu->addAction(m_pathClipPathAction);
     
+    m_pathConvexHullAction = new QAction("凸包(&H)", this);
+    m_pathConvexHullAction->setStatusTip(tr("用凸包替换选中的图形"));
+    pathMenu->addAction(m_pathConvexHullAction);
+    
+    m_pathWrapSelectionAction = new QAction("包围选区(&W)", this);
+    m_pathWrapSelectionAction->setStatusTip(tr("创建包围所有选中图形的凸包"));
+    pathMenu->addAction(m_pathWrapSelectionAction);
+    
     pathMenu->addSeparator();
     
     m_generateShapeAction = new QAction("生成图形(&G)", this);
@@ -1641,6 +1649,16 @@ void MainWindow::connectActions()
             m_pathOperationsManager->pathClipPath();
         }
     });
+    connect(m_pathConvexHullAction, &QAction::triggered, this, [this]() {
+        if (m_pathOperationsManager) {
+            m_pathOperationsManager->pathConvexHull();
+        }
+    });
+    connect(m_pathWrapSelectionAction, &QAction::triggered, this, [this]() {
+        if (m_pathOperationsManager) {
+            m_pathOperationsManager->pathWrapSelection();
+        }
+    });
     connect(m_generateShapeAction, &QAction::triggered, this, [this]() {
         if (m_pathOperationsManager) {
             m_pathOperationsManager->generateShape();
@@ -1780,7 +1798,7 @@ void MainWindow::openFile()
     if (maybeSave()) {
         QString fileName = QFileDialog::getOpenFileName(this,
             tr("打开文件"), "",
-            tr("SVG 文件 (*.svg);;所有文件 (*.*)"));
+            tr("所有支持的文件 (*.vqt *.svg);;VectorQt 文档 (*.vqt);;SVG 文件 (*.svg);;所有文件 (*.*)"));
         
         if (!fileName.isEmpty()) {
             loadFile(fileName);
@@ -1808,7 +1826,7 @@ bool MainWindow::saveFileAs()
     
     QString fileName = QFileDialog::getSaveFileName(this,
         tr("保存文件"), m_currentFilePath,
-        tr("SVG 文件 (*.svg);;所有文件 (*.*)"));
+        tr("SVG 文件 (*.svg);;VectorQt 文档 (*.vqt);;所有文件 (*.*)"));
     
     if (!fileName.isEmpty()) {
         // 使用Document保存
@@ -2616,6 +2634,8 @@ void MainWindow::showContextMenu(const QPointF &pos)
             pathMenu->addAction(m_pathConvertToCurveAction);
             pathMenu->addAction(m_pathOffsetPathAction);
             pathMenu->addAction(m_pathClipPathAction);
+            pathMenu->addAction(m_pathConvexHullAction);
+            pathMenu->addAction(m_pathWrapSelectionAction);
             pathMenu->addSeparator();
         }
         
@@ -220,6 +220,8 @@ private:
     QAction *m_pathConvertToCurveAction;
     QAction *m_pathOffsetPathAction;
     QAction *m_pathClipPathAction;
+    QAction *m_pathConvexHullAction;
+    QAction *m_pathWrapSelectionAction;
     QAction *m_generateShapeAction;
     QAction *m_generateStarAction;
     QAction *m_generateArrowAction;
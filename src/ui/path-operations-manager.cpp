@@ -8,6 +8,27 @@
 #include "command-manager.h"
 #include "../core/drawing-shape.h"
 #include "../core/patheditor.h"
+#include "../core/path-offset.h"
+#include "../core/convex-hull.h"
+
+namespace {
+
+PathEditor::BooleanOperation toPathEditorOperation(PathOperationsManager::BooleanOperation op)
+{
+    switch (op) {
+        case PathOperationsManager::Union:
+            return PathEditor::Union;
+        case PathOperationsManager::Subtract:
+            return PathEditor::Subtraction;
+        case PathOperationsManager::Intersect:
+            return PathEditor::Intersection;
+        case PathOperationsManager::Xor:
+            return PathEditor::Xor;
+    }
+    return PathEditor::Union;
+}
+
+} // namespace
 
 PathOperationsManager::PathOperationsManager(MainWindow *parent)
     : QObject(parent)
@@ -97,7 +118,10 @@ void PathOperationsManager::pathClipPath()
     performPathOperationMacro(ClipPath, "裁剪路径");
 }
 
-
+void PathOperationsManager::pathConvexHull()
+{
+    performPathOperationMacro(ConvexHull, "凸包");
+}
 
 void PathOperationsManager::convertTextToPath()
 {
@@ -378,24 +402,8 @@ void PathOperationsManager::performBooleanOperation(BooleanOperation op, const Q
                 
                 if (paths.size() < 2) return;
                 
-                // 执行布尔运算
-                QPainterPath result = paths.first();
-                for (int i = 1; i < paths.size(); ++i) {
-                    switch (m_operation) {
-                        case Union:
-                            result = result.united(paths[i]);
-                            break;
-                        case Subtract:
-                            result = result.subtracted(paths[i]);
-                            break;
-                        case Intersect:
-                            result = result.intersected(paths[i]);
-                            break;
-                        case Xor:
-                            result = result.subtracted(paths[i]).united(paths[i].subtracted(result));
-                            break;
-                    }
-                }
+                // 执行布尔运算：所有操作数一次扫描完成
+                QPainterPath result = PathEditor::booleanOperation(paths, toPathEditorOperation(m_operation));
                 
                 if (result.isEmpty()) return;
                 
@@ -794,37 +802,7 @@ void PathOperationsManager::executeBooleanOperationSteps(BooleanOperation op)
     }
     
     // 第三步：计算布尔运算结果
-    QPainterPath resultPath;
-    switch (op) {
-        case Union:
-            resultPath = paths.first();
-            for (int i = 1; i < paths.size(); ++i) {
-                resultPath = resultPath.united(paths[i]);
-            }
-            break;
-        case Subtract:
-            resultPath = paths.first();
-            for (int i = 1; i < paths.size(); ++i) {
-                resultPath = resultPath.subtracted(paths[i]);
-            }
-            break;
-        case Intersect:
-            resultPath = paths.first();
-            for (int i = 1; i < paths.size(); ++i) {
-                resultPath = resultPath.intersected(paths[i]);
-            }
-            break;
-        case Xor:
-            resultPath = paths.first();
-            for (int i = 1; i < paths.size(); ++i) {
-                // QPainterPath 没有 xored 方法，使用替代实现
-                QPainterPath temp = paths[i];
-                temp.setFillRule(Qt::OddEvenFill);
-                resultPath.setFillRule(Qt::OddEvenFill);
-                resultPath = resultPath.subtracted(temp).united(temp.subtracted(resultPath));
-            }
-            break;
-    }
+    const QPainterPath resultPath = PathEditor::booleanOperation(paths, toPathEditorOperation(op));
     
     // 第四步：使用分解式命令创建新路径
     if (!resultPath.isEmpty()) {
@@ -837,6 +815,39 @@ void PathOperationsManager::executeBooleanOperationSteps(BooleanOperation op)
     }
 }
 
+void PathOperationsManager::pathWrapSelection()
+{
+    if (!m_scene || !CommandManager::hasInstance()) {
+        emit statusMessageChanged("场景未初始化");
+        return;
+    }
+    
+    QList<DrawingShape*> shapes;
+    const QList<QGraphicsItem*> selectedItems = m_scene->selectedItems();
+    for (QGraphicsItem *item : selectedItems) {
+        if (DrawingShape *shape = dynamic_cast<DrawingShape*>(item)) {
+            shapes.append(shape);
+        }
+    }
+    
+    // 未缓存凸包的图形较多时（如框选大量导入的路径）并行计算
+    const QPainterPath hullPath = PathEditor::convexHull(shapes);
+    if (hullPath.isEmpty()) {
+        emit statusMessageChanged("选中的图形无法生成凸包");
+        return;
+    }
+    
+    // 凸包只描边，不遮挡被包围的图形
+    DrawingPath *newPath = new DrawingPath();
+    newPath->setPath(hullPath);
+    newPath->setStrokePen(shapes.first()->strokePen());
+    newPath->setFillBrush(Qt::NoBrush);
+    CommandManager::instance()->pushCommand(new CreatePathCommand(m_scene, newPath));
+    
+    emit pathOperationCompleted("包围选区");
+    emit statusMessageChanged("已创建包围选区的凸包");
+}
+
 void PathOperationsManager::performPathOperation(PathOperation op, const QString &opName)
 {
     qDebug() << "PathOperationsManager::performPathOperation() called with operation:" << opName;
@@ -1041,6 +1052,9 @@ void PathOperationCommand::redo() {
                 case PathOperationsManager::ClipPath:
                     newPath.addRect(originalPath.boundingRect());
                     break;
+                case PathOperationsManager::ConvexHull:
+                    newPath = PathOperationsManager::convexHullStatic(shape);
+                    break;
             }
             
             if (!newPath.isEmpty()) {
@@ -1053,8 +1067,8 @@ void PathOperationCommand::redo() {
                 newPathShape->setFillBrush(shape->fillBrush());
                 newPathShape->setPos(shape->pos());
                 
-                // 对于Path类型，需要应用变换；对于其他类型，变换已经在路径中了
-                if (shape->shapeType() == DrawingShape::Path) {
+                // 对于Path类型，需要应用变换；对于其他类型和凸包，变换已经在路径中了
+                if (shape->shapeType() == DrawingShape::Path && m_operation != PathOperationsManager::ConvexHull) {
                     newPathShape->applyTransform(shape->transform());
                 }
                 
@@ -1162,6 +1176,9 @@ void PathOperationsManager::executePathOperationSteps(PathOperation op)
                 // 裁剪路径实现（简化版）
                 newPath.addRect(originalPath.boundingRect());
                 break;
+            case ConvexHull:
+                newPath = convexHullStatic(shape);
+                break;
         }
         
         if (!newPath.isEmpty()) {
@@ -1174,8 +1191,8 @@ void PathOperationsManager::executePathOperationSteps(PathOperation op)
             newPathShape->setFillBrush(shape->fillBrush());
             newPathShape->setPos(shape->pos());
             
-            // 对于Path类型，需要应用变换；对于其他类型，变换已经在路径中了
-            if (shape->shapeType() == DrawingShape::Path) {
+            // 对于Path类型，需要应用变换；对于其他类型和凸包，变换已经在路径中了
+            if (shape->shapeType() == DrawingShape::Path && op != ConvexHull) {
                 newPathShape->applyTransform(shape->transform());
             }
             
@@ -1298,6 +1315,12 @@ void PathOperationsManager::addPathOperationsToMenu(QMenu *menu, const QPointF &
         QAction *clipAction = pathMenu->addAction("裁剪路径(&P)");
         connect(clipAction, &QAction::triggered, this, &PathOperationsManager::pathClipPath);
         
+        QAction *hullAction = pathMenu->addAction("凸包(&H)");
+        connect(hullAction, &QAction::triggered, this, &PathOperationsManager::pathConvexHull);
+        
+        QAction *wrapAction = pathMenu->addAction("包围选区(&W)");
+        connect(wrapAction, &QAction::triggered, this, &PathOperationsManager::pathWrapSelection);
+        
         pathMenu->addSeparator();
         
         // 检查是否有文本对象
@@ -1509,23 +1532,14 @@ QPainterPath PathOperationsManager::offsetPathStatic(const QPainterPath &path, q
         return path;
     }
     
-    // 简单的偏移实现：创建外轮廓
-    QPainterPathStroker stroker;
-    stroker.setWidth(offset * 2);
-    stroker.setJoinStyle(Qt::RoundJoin);
-    stroker.setCapStyle(Qt::RoundCap);
-    
-    QPainterPath offsetPath = stroker.createStroke(path);
-    
-    // 如果需要内偏移，可以使用裁剪
-    if (offset < 0) {
-        QPainterPath clipPath = path;
-        QRectF bounds = path.boundingRect();
-        clipPath.addRect(bounds.adjusted(offset, offset, -offset, -offset));
-        offsetPath = offsetPath.intersected(clipPath);
-    }
-    
-    return offsetPath;
+    // 正值外扩、负值内缩，得到单一轮廓而不是描边的内外两圈
+    return PathOffsetter::offset(path, offset, PathOffsetter::MiterJoin);
+}
+
+QPainterPath PathOperationsManager::convexHullStatic(const DrawingShape *shape)
+{
+    // 使用图形缓存的凸包（已包含图形自身的变换），重复查询不再计算
+    return ::ConvexHull::toPath(shape->convexHull());
 }
 
 QPainterPath PathOperationsManager::clipPathStatic(const QPainterPath &path)
@@ -50,7 +50,8 @@ public:
         Reverse,
         ConvertToCurve,
         OffsetPath,
-        ClipPath
+        ClipPath,
+        ConvexHull
     };
 
 signals:
@@ -71,6 +72,10 @@ public slots:
     void pathConvertToCurve();
     void pathOffsetPath();
     void pathClipPath();
+    void pathConvexHull();
+    
+    // 用一个凸包包围所有选中的图形（保留原图形）
+    void pathWrapSelection();
     
     // 文本转路径
     void convertTextToPath();
@@ -140,6 +145,7 @@ private:
     static QPainterPath convertToCurveStatic(const QPainterPath &path);
     static QPainterPath offsetPathStatic(const QPainterPath &path, qreal offset);
     static QPainterPath clipPathStatic(const QPainterPath &path);
+    static QPainterPath convexHullStatic(const DrawingShape *shape);
     
     // 宏命令版本的状态保存
     QMap<DrawingShape*, QPainterPath> m_originalPaths;
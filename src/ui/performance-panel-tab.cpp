@@ -10,7 +10,12 @@
 #include "performance-panel-tab.h"
 #include "../core/performance-monitor.h"
 #include "../core/smart-render-manager.h"
+#include "../core/svgnumberscanner.h"
+#include "../core/cache-policy.h"
+#include "../core/spatial-index.h"
+#include "../core/drawing-shape.h"
 #include "drawingscene.h"
+#include "command-manager.h"
 
 PerformancePanelTab::PerformancePanelTab(QWidget *parent)
     : QWidget(parent)
@@ -28,6 +33,7 @@ PerformancePanelTab::PerformancePanelTab(QWidget *parent)
     
     // 启用性能监控
     PerformanceMonitor::instance().setEnabled(true);
+    RenderProfiler::instance().setEnabled(true);
     
     // 初始更新
     updatePerformanceStats();
@@ -85,7 +91,70 @@ void PerformancePanelTab::setupUI()
     m_shapesCountLabel->setStyleSheet("font-weight: bold; color: #0066cc; font-size: 14px;");
     statsLayout->addWidget(m_shapesCountLabel, 4, 1);
     
+    // 路径文本解析吞吐量
+    statsLayout->addWidget(new QLabel("路径解析:"), 5, 0);
+    m_pathParseLabel = new QLabel("-");
+    m_pathParseLabel->setStyleSheet("font-weight: bold; color: #008080; font-size: 14px;");
+    statsLayout->addWidget(m_pathParseLabel, 5, 1);
+    
+    // 撤销栈内存
+    statsLayout->addWidget(new QLabel("撤销内存:"), 6, 0);
+    m_undoMemoryLabel = new QLabel("-");
+    m_undoMemoryLabel->setStyleSheet("font-weight: bold; color: #8b4513; font-size: 14px;");
+    statsLayout->addWidget(m_undoMemoryLabel, 6, 1);
+    
+    // 单遍绘制：每帧相对两遍绘制实际省去的几何遍数（填充和描边都可见的图形、自绘样式的图形和marker）
+    statsLayout->addWidget(new QLabel("单遍绘制:"), 7, 0);
+    m_singlePassLabel = new QLabel("-");
+    m_singlePassLabel->setStyleSheet("font-weight: bold; color: #556b2f; font-size: 14px;");
+    statsLayout->addWidget(m_singlePassLabel, 7, 1);
+    
     mainLayout->addWidget(statsGroup);
+    
+    // 图形缓存策略组
+    QGroupBox *cacheGroup = new QGroupBox("缓存策略", this);
+    QGridLayout *cacheLayout = new QGridLayout(cacheGroup);
+    cacheLayout->setSpacing(8);
+    cacheLayout->setContentsMargins(10, 20, 10, 10);
+    
+    cacheLayout->addWidget(new QLabel("缓存内存:"), 0, 0);
+    m_cacheBudgetLabel = new QLabel("-");
+    m_cacheBudgetLabel->setStyleSheet("font-weight: bold; color: #4b0082; font-size: 14px;");
+    cacheLayout->addWidget(m_cacheBudgetLabel, 0, 1);
+    
+    cacheLayout->addWidget(new QLabel("本周期调整:"), 1, 0);
+    m_cacheChangesLabel = new QLabel("-");
+    cacheLayout->addWidget(m_cacheChangesLabel, 1, 1);
+    
+    // 最近的升级/降级决策
+    m_cacheDecisionsLabel = new QLabel;
+    m_cacheDecisionsLabel->setWordWrap(true);
+    cacheLayout->addWidget(m_cacheDecisionsLabel, 2, 0, 1, 2);
+    
+    // 图形的边界、形状和展平轮廓缓存
+    cacheLayout->addWidget(new QLabel("几何缓存:"), 3, 0);
+    m_geometryCacheLabel = new QLabel("-");
+    cacheLayout->addWidget(m_geometryCacheLabel, 3, 1);
+    
+    mainLayout->addWidget(cacheGroup);
+    
+    // 空间索引组
+    QGroupBox *indexGroup = new QGroupBox("空间索引", this);
+    QGridLayout *indexLayout = new QGridLayout(indexGroup);
+    indexLayout->setSpacing(8);
+    indexLayout->setContentsMargins(10, 20, 10, 10);
+    
+    indexLayout->addWidget(new QLabel("索引图形:"), 0, 0);
+    m_spatialIndexLabel = new QLabel("-");
+    m_spatialIndexLabel->setStyleSheet("font-weight: bold; color: #2f4f4f; font-size: 14px;");
+    indexLayout->addWidget(m_spatialIndexLabel, 0, 1);
+    
+    indexLayout->addWidget(new QLabel("查询延迟:"), 1, 0);
+    m_spatialQueryLabel = new QLabel("-");
+    indexLayout->addWidget(m_spatialQueryLabel, 1, 1);
+    
+    mainLayout->addWidget(indexGroup);
+    
     mainLayout->addStretch();
     
     // 设置现代化样式
@@ -206,10 +275,79 @@ void PerformancePanelTab::updatePerformanceStats()
     }
     m_shapesCountLabel->setText(QString::number(shapesCount));
     
+    // 更新路径解析吞吐量（MB/s），附带当前的SIMD实现
+    const SvgNumberScanner::Throughput parseThroughput = SvgNumberScanner::throughput();
+    if (parseThroughput.characters > 0) {
+        m_pathParseLabel->setText(QString("%1 MB/s (%2)")
+                                      .arg(parseThroughput.megabytesPerSecond(), 0, 'f', 1)
+                                      .arg(QLatin1String(SvgNumberScanner::backendName())));
+    } else {
+        m_pathParseLabel->setText(QString("- (%1)").arg(QLatin1String(SvgNumberScanner::backendName())));
+    }
+    
+    // 更新撤销栈内存：总量和每条命令的平均字节数
+    CommandManager *commandManager = CommandManager::instance();
+    if (commandManager && commandManager->undoStack()->count() > 0) {
+        m_undoMemoryLabel->setText(QString("%1 KB (%2 B/条)")
+                                       .arg(commandManager->memoryUsage() / 1024.0, 0, 'f', 1)
+                                       .arg(commandManager->averageCommandBytes()));
+    } else {
+        m_undoMemoryLabel->setText("-");
+    }
+    
+    // 更新单遍绘制统计
+    const RenderProfiler::PerformanceData renderData = RenderProfiler::instance().getPerformanceData();
+    if (renderData.totalFrames > 0) {
+        m_singlePassLabel->setText(QString("省去 %1 遍/帧 (%2 ms/帧)")
+                                       .arg(renderData.countsPerFrame.value(RenderProfiler::SavedGeometryPasses), 0, 'f', 0)
+                                       .arg(renderData.averageFrameTime, 0, 'f', 1));
+    } else {
+        m_singlePassLabel->setText("-");
+    }
+    
+    // 更新缓存策略
+    const CachePolicy::Stats cacheStats = CachePolicy::instance().stats();
+    m_cacheBudgetLabel->setText(QString("%1 / %2 MB (%3 个图形)")
+                                    .arg(cacheStats.cachedBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                    .arg(CachePolicy::instance().memoryBudget() / 1024)
+                                    .arg(cacheStats.cachedShapes));
+    m_cacheChangesLabel->setText(QString("升级 %1，降级 %2")
+                                     .arg(cacheStats.promotions)
+                                     .arg(cacheStats.demotions));
+    m_cacheDecisionsLabel->setText(cacheStats.recentDecisions.join('\n'));
+    
+    const DrawingShape::GeometryCacheStats geometryStats = DrawingShape::geometryCacheStats();
+    const qint64 geometryLookups = geometryStats.hits + geometryStats.misses;
+    if (geometryLookups > 0) {
+        m_geometryCacheLabel->setText(QString("命中率 %1% (命中 %2，未命中 %3，失效 %4)")
+                                          .arg(100.0 * geometryStats.hits / geometryLookups, 0, 'f', 1)
+                                          .arg(geometryStats.hits)
+                                          .arg(geometryStats.misses)
+                                          .arg(geometryStats.invalidations));
+    } else {
+        m_geometryCacheLabel->setText("-");
+    }
+    
+    // 更新空间索引统计
+    if (m_scene && m_scene->spatialIndex()) {
+        const SpatialIndex::Stats indexStats = m_scene->spatialIndex()->stats();
+        m_spatialIndexLabel->setText(QString("%1 (树高 %2)")
+                                         .arg(indexStats.shapes)
+                                         .arg(indexStats.treeHeight));
+        if (indexStats.queries > 0) {
+            m_spatialQueryLabel->setText(QString("%1 µs/次 (%2 次，增量更新 %3)")
+                                             .arg(indexStats.totalQueryNs / 1000.0 / indexStats.queries, 0, 'f', 1)
+                                             .arg(indexStats.queries)
+                                             .arg(indexStats.incrementalUpdates));
+        } else {
+            m_spatialQueryLabel->setText("-");
+        }
+    }
+    
     m_frameCount++;
     
     // 定期清理旧数据以避免内存累积过多
     if (m_frameCount % 120 == 0) {  // 每2秒清理一次
         performanceMonitor.cleanupOldData(10);  // 保留最近10秒的数据
     }
-}
\ No newline at end of file
+}
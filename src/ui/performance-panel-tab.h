@@ -35,6 +35,19 @@ private:
     QLabel *m_drawCallsLabel;
     QLabel *m_updateTimeLabel;
     QLabel *m_shapesCountLabel;
+    QLabel *m_pathParseLabel;
+    QLabel *m_undoMemoryLabel;
+    QLabel *m_singlePassLabel;
+    
+    // 缓存策略显示组件
+    QLabel *m_cacheBudgetLabel;
+    QLabel *m_cacheChangesLabel;
+    QLabel *m_cacheDecisionsLabel;
+    QLabel *m_geometryCacheLabel;
+    
+    // 空间索引显示组件
+    QLabel *m_spatialIndexLabel;
+    QLabel *m_spatialQueryLabel;
     
     // 性能统计
     QTimer *m_updateTimer;
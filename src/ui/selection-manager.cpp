@@ -11,7 +11,7 @@
 #include "command-manager.h"
 #include "../core/drawing-shape.h"
 #include "../core/drawing-group.h"
-#include "../core/drawing-shape.h"
+#include "../core/shape-record.h"
 
 SelectionManager::SelectionManager(MainWindow *parent)
     : QObject(parent), m_mainWindow(parent), m_scene(nullptr), m_commandManager(nullptr)
@@ -136,18 +136,12 @@ void SelectionManager::copySelected()
         return;
     }
 
-    // 序列化所有选中的对象到剪贴板
+    // 所有选中的对象连续写入同一个缓冲区，记录自带长度，不需要单独的对象数量
     QByteArray clipboardData;
-    QDataStream stream(&clipboardData, QIODevice::WriteOnly);
-
-    // 写入对象数量
-    stream << shapes.count();
-
-    // 序列化每个对象
+    ShapeRecordWriter writer(&clipboardData);
     for (DrawingShape *shape : shapes)
     {
-        QByteArray shapeData = shape->serialize();
-        stream << shapeData;
+        writer.writeShape(shape);
     }
 
     // 设置到剪贴板
@@ -186,33 +180,17 @@ void SelectionManager::paste()
     qDebug() << "Paste: found vectorqt format in clipboard";
 
     QByteArray clipboardData = mimeData->data("application/x-vectorqt-shapes");
-    QDataStream stream(&clipboardData, QIODevice::ReadOnly);
-
-    int shapeCount;
-    stream >> shapeCount;
-
-    if (shapeCount <= 0)
+    if (clipboardData.isEmpty())
     {
         emit statusMessageChanged("剪贴板数据无效");
         return;
     }
 
-    // 收集所有形状数据
-    QList<QByteArray> shapeDataList;
-
-    // 反序列化每个对象的数据
-    for (int i = 0; i < shapeCount; ++i)
-    {
-        QByteArray shapeData;
-        stream >> shapeData;
-        shapeDataList.append(shapeData);
-    }
-
     // 使用CommandManager执行粘贴操作以支持撤销
     if (m_commandManager)
     {
-        qDebug() << "Paste: pushing PasteCommand with" << shapeDataList.count() << "shapes";
-        m_commandManager->pushCommand(new PasteCommand(m_commandManager, shapeDataList, QPointF(20, 20)));
+        qDebug() << "Paste: pushing PasteCommand with" << clipboardData.size() << "bytes";
+        m_commandManager->pushCommand(new PasteCommand(m_commandManager, clipboardData, QPointF(20, 20)));
         qDebug() << "Paste: PasteCommand pushed successfully";
     }
     else
@@ -1,5 +1,6 @@
 #include <QtMath>
 #include "snap-manager.h"
+#include "snap-point-index.h"
 #include "drawingscene.h"
 #include "../core/drawing-shape.h"
 
@@ -16,11 +17,19 @@ SnapManager::SnapManager(DrawingScene *scene, QObject *parent)
     , m_guideSnapEnabled(true)
     , m_hasActiveSnap(false)
     , m_snapIndicator(nullptr)
+    , m_snapIndex(new SnapPointIndex())
+    , m_snapIndexBuilt(false)
 {
 }
 
 SnapManager::~SnapManager()
 {
+    // 场景可能比吸附管理器存活更久，避免图形析构时访问已删除的管理器
+    if (m_scene && m_scene->snapManager() == this) {
+        m_scene->setSnapManager(nullptr);
+    }
+    delete m_snapIndex;
+    
     if (m_snapIndicator) {
         if (m_scene) {
             m_scene->removeItem(m_snapIndicator);
@@ -63,6 +72,7 @@ void SnapManager::initializeIndicator()
 void SnapManager::setScene(DrawingScene *scene)
 {
     m_scene = scene;
+    invalidateSnapIndex();
 }
 
 DrawingScene* SnapManager::scene() const
@@ -303,17 +313,35 @@ ObjectSnapResult SnapManager::snapToObjects(const QPointF &pos, DrawingShape *ex
 {
     ObjectSnapResult result;
     result.snappedPos = pos;
+    result.snappedToObject = false;
+    result.targetShape = nullptr;
     
-    if (!m_objectSnapEnabled) {
+    if (!m_objectSnapEnabled || !m_scene) {
         return result;
     }
     
     const int tolerance = m_objectSnapTolerance;
     qreal minDistance = tolerance + 1;
     
-    QList<ObjectSnapPoint> snapPoints = getObjectSnapPoints(excludeShape);
+    // 只查询容差范围内的吸附点
+    updateSnapIndex();
+    const QRectF area(pos.x() - tolerance, pos.y() - tolerance, tolerance * 2, tolerance * 2);
+    QList<ObjectSnapPoint> snapPoints = m_snapIndex->query(area, excludeShape);
+    
+    // 候选图形的边界与索引不一致说明有未通知的修改，重新索引后再查询
+    bool stale = false;
+    for (const ObjectSnapPoint &snapPoint : std::as_const(snapPoints)) {
+        if (snapPoint.shape->mapRectToScene(snapPoint.shape->boundingRect())
+            != m_snapIndex->indexedBounds(snapPoint.shape)) {
+            m_snapIndex->updateShape(snapPoint.shape);
+            stale = true;
+        }
+    }
+    if (stale) {
+        snapPoints = m_snapIndex->query(area, excludeShape);
+    }
     
-    for (const ObjectSnapPoint &snapPoint : snapPoints) {
+    for (const ObjectSnapPoint &snapPoint : std::as_const(snapPoints)) {
         qreal distance = QLineF(pos, snapPoint.position).length();
         if (distance < minDistance) {
             minDistance = distance;
@@ -373,44 +401,79 @@ GuideSnapResult SnapManager::snapToGuides(const QPointF &pos)
 
 QList<ObjectSnapPoint> SnapManager::getObjectSnapPoints(DrawingShape *excludeShape) const
 {
-    QList<ObjectSnapPoint> points;
-    
     if (!m_scene) {
-        return points;
+        return QList<ObjectSnapPoint>();
+    }
+    
+    updateSnapIndex();
+    return m_snapIndex->allPoints(excludeShape);
+}
+
+void SnapManager::markShapeDirty(DrawingShape *shape)
+{
+    if (!m_snapIndexBuilt || !shape) {
+        return;
     }
     
-    QList<QGraphicsItem*> allItems = m_scene->items();
+    m_dirtyShapes.insert(shape);
     
-    for (QGraphicsItem *item : allItems) {
-        DrawingShape *shape = qgraphicsitem_cast<DrawingShape*>(item);
-        if (!shape || shape == excludeShape || !shape->isVisible()) {
-            continue;
+    // 组合移动时子对象的场景位置一起变化
+    const QList<QGraphicsItem*> children = shape->childItems();
+    for (QGraphicsItem *child : children) {
+        if (DrawingShape *childShape = dynamic_cast<DrawingShape*>(child)) {
+            markShapeDirty(childShape);
         }
-        
-        QRectF bounds = shape->boundingRect();
-        QPointF center = bounds.center();
-        
-        // 转换为场景坐标
-        QRectF sceneBounds = shape->mapRectToScene(bounds);
-        QPointF sceneCenter = sceneBounds.center();
-        
-        // 添加关键吸附点（使用场景坐标）
-        points.append(ObjectSnapPoint(sceneBounds.topLeft(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneBounds.topRight(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneBounds.bottomLeft(), SnapToCorner, shape));
-        points.append(ObjectSnapPoint(sceneBounds.bottomRight(), SnapToCorner, shape));
-        
-        // 边缘中点
-        points.append(ObjectSnapPoint(QPointF(sceneBounds.center().x(), sceneBounds.top()), SnapToTop, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneBounds.center().x(), sceneBounds.bottom()), SnapToBottom, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneBounds.left(), sceneBounds.center().y()), SnapToLeft, shape));
-        points.append(ObjectSnapPoint(QPointF(sceneBounds.right(), sceneBounds.center().y()), SnapToRight, shape));
-        
-        // 中心点
-        points.append(ObjectSnapPoint(sceneCenter, SnapToCenter, shape));
+    }
+}
+
+void SnapManager::removeShape(DrawingShape *shape)
+{
+    m_dirtyShapes.remove(shape);
+    m_snapIndex->removeShape(shape);
+    
+    const QList<QGraphicsItem*> children = shape->childItems();
+    for (QGraphicsItem *child : children) {
+        if (DrawingShape *childShape = dynamic_cast<DrawingShape*>(child)) {
+            removeShape(childShape);
+        }
+    }
+}
+
+void SnapManager::invalidateSnapIndex()
+{
+    m_snapIndex->clear();
+    m_dirtyShapes.clear();
+    m_snapIndexBuilt = false;
+}
+
+void SnapManager::updateSnapIndex() const
+{
+    if (!m_scene) {
+        return;
+    }
+    
+    if (!m_snapIndexBuilt) {
+        // 首次查询时全量构建，之后只处理标记过的图形。
+        // DrawingShape没有定义Type，qgraphicsitem_cast会把手柄等辅助项也当作图形
+        const QList<QGraphicsItem*> allItems = m_scene->items();
+        for (QGraphicsItem *item : allItems) {
+            if (DrawingShape *shape = dynamic_cast<DrawingShape*>(item)) {
+                m_snapIndex->updateShape(shape);
+            }
+        }
+        m_dirtyShapes.clear();
+        m_snapIndexBuilt = true;
+        return;
     }
     
-    return points;
+    for (DrawingShape *shape : std::as_const(m_dirtyShapes)) {
+        if (shape->scene() == m_scene) {
+            m_snapIndex->updateShape(shape);
+        } else {
+            m_snapIndex->removeShape(shape);
+        }
+    }
+    m_dirtyShapes.clear();
 }
 
 // 吸附指示器显示方法实现
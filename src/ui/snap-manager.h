@@ -7,9 +7,11 @@
 #include <QGraphicsItem>
 #include <QGraphicsLineItem>
 #include <QRectF>
+#include <QSet>
 
 class DrawingScene;
 class DrawingShape;
+class SnapPointIndex;
 
 // 吸附点类型
 enum SnapType {
@@ -98,6 +100,11 @@ public:
     // 获取对象吸附点
     QList<ObjectSnapPoint> getObjectSnapPoints(DrawingShape *excludeShape = nullptr) const;
     
+    // 吸附点索引维护：图形移动、修改或显示状态变化时标记，下次查询前重新索引
+    void markShapeDirty(DrawingShape *shape);
+    void removeShape(DrawingShape *shape);
+    void invalidateSnapIndex();
+    
     // 吸附指示器显示
     void showSnapIndicators(const ObjectSnapResult &snapResult);
     void clearSnapIndicators();
@@ -117,6 +124,9 @@ signals:
     void statusMessageChanged(const QString &message);
 
 private:
+    // 构建或更新吸附点索引
+    void updateSnapIndex() const;
+    
     DrawingScene *m_scene;
     
     // 网格吸附相关属性（保留）
@@ -136,6 +146,11 @@ private:
     bool m_hasActiveSnap;
     ObjectSnapResult m_lastSnapResult;
     QGraphicsLineItem *m_snapIndicator;
+    
+    // 对象吸附点索引（在查询时惰性更新）
+    SnapPointIndex *m_snapIndex;
+    mutable bool m_snapIndexBuilt;
+    mutable QSet<DrawingShape*> m_dirtyShapes;
 };
 
 #endif // SNAP_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <QtMath>
+#include "snap-point-index.h"
+#include "../core/drawing-shape.h"
+
+SnapPointIndex::SnapPointIndex(qreal cellSize)
+    : m_cellSize(cellSize)
+{
+}
+
+quint64 SnapPointIndex::cellKey(int x, int y) const
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+quint64 SnapPointIndex::cellKey(const QPointF &pos) const
+{
+    return cellKey(qFloor(pos.x() / m_cellSize), qFloor(pos.y() / m_cellSize));
+}
+
+void SnapPointIndex::snapPointsForBounds(const QRectF &sceneBounds, DrawingShape *shape,
+                                         ObjectSnapPoint points[9])
+{
+    const QPointF center = sceneBounds.center();
+
+    // 角点
+    points[0] = ObjectSnapPoint(sceneBounds.topLeft(), SnapToCorner, shape);
+    points[1] = ObjectSnapPoint(sceneBounds.topRight(), SnapToCorner, shape);
+    points[2] = ObjectSnapPoint(sceneBounds.bottomLeft(), SnapToCorner, shape);
+    points[3] = ObjectSnapPoint(sceneBounds.bottomRight(), SnapToCorner, shape);
+
+    // 边缘中点
+    points[4] = ObjectSnapPoint(QPointF(center.x(), sceneBounds.top()), SnapToTop, shape);
+    points[5] = ObjectSnapPoint(QPointF(center.x(), sceneBounds.bottom()), SnapToBottom, shape);
+    points[6] = ObjectSnapPoint(QPointF(sceneBounds.left(), center.y()), SnapToLeft, shape);
+    points[7] = ObjectSnapPoint(QPointF(sceneBounds.right(), center.y()), SnapToRight, shape);
+
+    // 中心点
+    points[8] = ObjectSnapPoint(center, SnapToCenter, shape);
+}
+
+void SnapPointIndex::updateShape(DrawingShape *shape)
+{
+    removeShape(shape);
+
+    if (!shape->isVisible()) {
+        return;
+    }
+
+    const QRectF sceneBounds = shape->mapRectToScene(shape->boundingRect());
+    ObjectSnapPoint points[9];
+    snapPointsForBounds(sceneBounds, shape, points);
+    for (const ObjectSnapPoint &point : points) {
+        m_cells[cellKey(point.position)].append(point);
+    }
+    m_shapeBounds.insert(shape, sceneBounds);
+}
+
+void SnapPointIndex::removeShape(DrawingShape *shape)
+{
+    auto it = m_shapeBounds.find(shape);
+    if (it == m_shapeBounds.end()) {
+        return;
+    }
+
+    // 按索引时的边界找到吸附点所在的单元
+    ObjectSnapPoint points[9];
+    snapPointsForBounds(it.value(), shape, points);
+    for (const ObjectSnapPoint &point : points) {
+        auto cell = m_cells.find(cellKey(point.position));
+        if (cell == m_cells.end()) {
+            continue;
+        }
+        cell->removeIf([shape](const ObjectSnapPoint &entry) { return entry.shape == shape; });
+        if (cell->isEmpty()) {
+            m_cells.erase(cell);
+        }
+    }
+
+    m_shapeBounds.erase(it);
+}
+
+void SnapPointIndex::clear()
+{
+    m_cells.clear();
+    m_shapeBounds.clear();
+}
+
+QList<ObjectSnapPoint> SnapPointIndex::query(const QRectF &area, DrawingShape *excludeShape) const
+{
+    QList<ObjectSnapPoint> result;
+
+    const int left = qFloor(area.left() / m_cellSize);
+    const int right = qFloor(area.right() / m_cellSize);
+    const int top = qFloor(area.top() / m_cellSize);
+    const int bottom = qFloor(area.bottom() / m_cellSize);
+
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            auto cell = m_cells.constFind(cellKey(x, y));
+            if (cell == m_cells.constEnd()) {
+                continue;
+            }
+            for (const ObjectSnapPoint &point : *cell) {
+                if (point.shape != excludeShape && area.contains(point.position)) {
+                    result.append(point);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+QList<ObjectSnapPoint> SnapPointIndex::allPoints(DrawingShape *excludeShape) const
+{
+    QList<ObjectSnapPoint> result;
+    result.reserve(m_shapeBounds.size() * 9);
+    for (auto cell = m_cells.constBegin(); cell != m_cells.constEnd(); ++cell) {
+        for (const ObjectSnapPoint &point : cell.value()) {
+            if (point.shape != excludeShape) {
+                result.append(point);
+            }
+        }
+    }
+    return result;
+}
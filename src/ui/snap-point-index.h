@@ -0,0 +1,61 @@
+#ifndef SNAP_POINT_INDEX_H
+#define SNAP_POINT_INDEX_H
+
+#include <QHash>
+#include <QVector>
+#include <QRectF>
+#include "snap-manager.h"
+
+/**
+ * 对象吸附点的网格索引
+ *
+ * 每个图形在场景坐标中的9个吸附点（四角、四边中点、中心）按所在网格单元存放，
+ * 查询只检查容差范围覆盖的几个单元。图形移动或修改时只需重新索引该图形，
+ * 不必每次查询都遍历整个场景
+ */
+class SnapPointIndex
+{
+public:
+    explicit SnapPointIndex(qreal cellSize = 64.0);
+
+    /**
+     * 插入或更新图形的吸附点
+     */
+    void updateShape(DrawingShape *shape);
+    void removeShape(DrawingShape *shape);
+    void clear();
+
+    bool contains(DrawingShape *shape) const { return m_shapeBounds.contains(shape); }
+    int shapeCount() const { return m_shapeBounds.size(); }
+
+    /**
+     * 索引时记录的图形场景边界，用于发现未通知的修改
+     */
+    QRectF indexedBounds(DrawingShape *shape) const { return m_shapeBounds.value(shape); }
+
+    /**
+     * 查询区域内的吸附点
+     */
+    QList<ObjectSnapPoint> query(const QRectF &area, DrawingShape *excludeShape = nullptr) const;
+
+    /**
+     * 所有吸附点
+     */
+    QList<ObjectSnapPoint> allPoints(DrawingShape *excludeShape = nullptr) const;
+
+    /**
+     * 按场景边界计算图形的吸附点
+     */
+    static void snapPointsForBounds(const QRectF &sceneBounds, DrawingShape *shape,
+                                    ObjectSnapPoint points[9]);
+
+private:
+    quint64 cellKey(const QPointF &pos) const;
+    quint64 cellKey(int x, int y) const;
+
+    qreal m_cellSize;
+    QHash<quint64, QVector<ObjectSnapPoint>> m_cells;
+    QHash<DrawingShape*, QRectF> m_shapeBounds;
+};
+
+#endif // SNAP_POINT_INDEX_H
@@ -0,0 +1,323 @@
+#include <QGraphicsScene>
+#include <QGraphicsItem>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtMath>
+#include <cmath>
+#include "tile-render-cache.h"
+#include "../core/drawing-shape.h"
+
+namespace {
+
+// 每倍缩放分成64级，相邻级别的比例差约1%，合成时的缩放误差不可察觉
+const qreal LevelsPerOctave = 64.0;
+// 场景连续变化结束多久后重新请求瓦片
+const int SettleDelayMs = 150;
+// 失效区域向外扩展的设备像素，覆盖抗锯齿和cosmetic描边
+const qreal InvalidateMarginPixels = 4.0;
+// 每批录制瓦片的耗时上限，超出后让出事件循环处理输入
+const qint64 RecordBudgetNs = 8 * 1000 * 1000;
+
+} // namespace
+
+TileRenderCache::TileRenderCache(QObject *parent)
+    : QObject(parent)
+    , m_nextJob(0)
+{
+    // 默认最多缓存约128MB（一个瓦片256KB）
+    m_tiles.setMaxCost(128 * 1024);
+
+    // 主线程还要处理交互，留出一个核心
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(SettleDelayMs);
+    connect(&m_settleTimer, &QTimer::timeout, this, &TileRenderCache::updateRequested);
+
+    m_recordTimer.setSingleShot(true);
+    m_recordTimer.setInterval(0);
+    connect(&m_recordTimer, &QTimer::timeout, this, &TileRenderCache::recordQueuedTiles);
+}
+
+TileRenderCache::~TileRenderCache()
+{
+    // 工作线程会回调this，必须在析构前结束
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void TileRenderCache::setScene(QGraphicsScene *scene)
+{
+    if (m_scene == scene) {
+        return;
+    }
+
+    if (m_scene) {
+        disconnect(m_scene, nullptr, this, nullptr);
+    }
+    m_scene = scene;
+    invalidateAll();
+
+    if (m_scene) {
+        connect(m_scene, &QGraphicsScene::changed, this, &TileRenderCache::onSceneChanged);
+    }
+}
+
+void TileRenderCache::setMaxMemory(int kilobytes)
+{
+    m_tiles.setMaxCost(kilobytes);
+}
+
+int TileRenderCache::zoomLevel(qreal zoom)
+{
+    return qRound(std::log2(qMax(zoom, qreal(1e-6))) * LevelsPerOctave);
+}
+
+qreal TileRenderCache::levelScale(int level)
+{
+    return std::exp2(level / LevelsPerOctave);
+}
+
+bool TileRenderCache::isTileable(const QGraphicsItem *item)
+{
+    // 选中的图形随时可能被拖动，带效果的图形需要场景的效果管线，都每帧直接绘制
+    return dynamic_cast<const DrawingShape*>(item)
+        && item->isVisible()
+        && !item->isSelected()
+        && !item->graphicsEffect();
+}
+
+QRectF TileRenderCache::tileRect(const TileKey &key)
+{
+    const qreal span = TileSize / levelScale(key.level);
+    return QRectF(key.x * span, key.y * span, span, span);
+}
+
+QList<QRectF> TileRenderCache::paint(QPainter *painter, const QTransform &viewTransform,
+                                     const QRectF &exposedRect)
+{
+    QList<QRectF> missing;
+    if (!m_scene) {
+        missing.append(exposedRect);
+        return missing;
+    }
+
+    const int level = zoomLevel(viewTransform.m11());
+    const qreal span = TileSize / levelScale(level);
+    const int left = qFloor(exposedRect.left() / span);
+    const int right = qFloor(exposedRect.right() / span);
+    const int top = qFloor(exposedRect.top() / span);
+    const int bottom = qFloor(exposedRect.bottom() / span);
+    const bool canRequest = !m_settleTimer.isActive();
+
+    // 视口已变化，之前登记但尚未录制的瓦片按本次的可见区域重新登记
+    m_visibleQueue.clear();
+    m_prefetchQueue.clear();
+
+    painter->save();
+    painter->resetTransform();
+
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            const TileKey key{level, x, y};
+            const QRectF sceneRect = tileRect(key);
+
+            if (const QImage *image = m_tiles.object(key)) {
+                if (!image->isNull()) {
+                    // 相邻瓦片共用取整后的边界，避免出现接缝
+                    const QPoint topLeft = viewTransform.map(sceneRect.topLeft()).toPoint();
+                    const QPoint bottomRight = viewTransform.map(sceneRect.bottomRight()).toPoint();
+                    painter->drawImage(QRect(topLeft.x(), topLeft.y(),
+                                             bottomRight.x() - topLeft.x(),
+                                             bottomRight.y() - topLeft.y()),
+                                       *image);
+                }
+                continue;
+            }
+
+            missing.append(sceneRect);
+            if (canRequest) {
+                requestTile(key, false);
+            }
+        }
+    }
+
+    painter->restore();
+
+    // 预取可见区域外一圈瓦片，平移时可以直接使用
+    if (canRequest) {
+        for (int y = top - 1; y <= bottom + 1; ++y) {
+            for (int x = left - 1; x <= right + 1; ++x) {
+                if (y == top - 1 || y == bottom + 1 || x == left - 1 || x == right + 1) {
+                    requestTile(TileKey{level, x, y}, true);
+                }
+            }
+        }
+    }
+
+    return missing;
+}
+
+void TileRenderCache::invalidate(const QRectF &sceneRect)
+{
+    const QList<TileKey> cachedKeys = m_tiles.keys();
+    for (const TileKey &key : cachedKeys) {
+        const qreal margin = InvalidateMarginPixels / levelScale(key.level);
+        if (tileRect(key).intersects(sceneRect.adjusted(-margin, -margin, margin, margin))) {
+            m_tiles.remove(key);
+        }
+    }
+
+    // 正在渲染的瓦片录制的是旧内容，丢弃其结果
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        const qreal margin = InvalidateMarginPixels / levelScale(it.key().level);
+        if (tileRect(it.key()).intersects(sceneRect.adjusted(-margin, -margin, margin, margin))) {
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TileRenderCache::invalidateAll()
+{
+    m_tiles.clear();
+    m_pending.clear();
+    m_visibleQueue.clear();
+    m_prefetchQueue.clear();
+}
+
+void TileRenderCache::onSceneChanged(const QList<QRectF> &region)
+{
+    if (region.isEmpty()) {
+        return;
+    }
+
+    for (const QRectF &rect : region) {
+        // 整个场景的更新（网格、提示等调用update()）不携带具体区域，只能全部失效
+        if (m_scene && rect == m_scene->sceneRect()) {
+            invalidateAll();
+            break;
+        }
+        invalidate(rect);
+    }
+
+    m_settleTimer.start();
+}
+
+QPicture TileRenderCache::recordTile(const QRectF &sceneRect, qreal scale, bool *empty) const
+{
+    QPicture picture;
+    *empty = true;
+
+    // 直接按瓦片像素坐标录制，图形绘制时能得到实际的设备缩放比例（用于细节层次）
+    QPainter painter(&picture);
+    painter.scale(scale, scale);
+    painter.translate(-sceneRect.topLeft());
+    const QTransform tileTransform = painter.transform();
+    QStyleOptionGraphicsItem option;
+
+    const QList<QGraphicsItem*> items = m_scene->items(sceneRect, Qt::IntersectsItemBoundingRect,
+                                                       Qt::AscendingOrder);
+    for (QGraphicsItem *item : items) {
+        if (!isTileable(item)) {
+            continue;
+        }
+
+        painter.save();
+        painter.setTransform(item->sceneTransform() * tileTransform);
+        painter.setOpacity(item->effectiveOpacity());
+        option.exposedRect = item->boundingRect();
+        item->paint(&painter, &option, nullptr);
+        painter.restore();
+        *empty = false;
+    }
+
+    painter.end();
+    return picture;
+}
+
+void TileRenderCache::requestTile(const TileKey &key, bool prefetch)
+{
+    if (!m_scene || m_pending.contains(key) || m_tiles.contains(key)) {
+        return;
+    }
+
+    (prefetch ? m_prefetchQueue : m_visibleQueue).append(key);
+    if (!m_recordTimer.isActive()) {
+        m_recordTimer.start();
+    }
+}
+
+void TileRenderCache::recordQueuedTiles()
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (m_scene && timer.nsecsElapsed() < RecordBudgetNs) {
+        if (!m_visibleQueue.isEmpty()) {
+            startTile(m_visibleQueue.takeFirst());
+        } else if (!m_prefetchQueue.isEmpty()) {
+            startTile(m_prefetchQueue.takeFirst());
+        } else {
+            return;
+        }
+    }
+    if (m_scene && (!m_visibleQueue.isEmpty() || !m_prefetchQueue.isEmpty())) {
+        m_recordTimer.start();
+    }
+}
+
+void TileRenderCache::startTile(const TileKey &key)
+{
+    // 登记后可能已由其他请求完成
+    if (!m_scene || m_pending.contains(key) || m_tiles.contains(key)) {
+        return;
+    }
+
+    // 录制只记录绘制命令，光栅化在工作线程进行；工作线程不接触场景
+    const QRectF sceneRect = tileRect(key);
+    const qreal scale = levelScale(key.level);
+    bool empty = false;
+    const QPicture picture = recordTile(sceneRect, scale, &empty);
+    if (empty) {
+        // 空瓦片用空图像占位，不需要渲染
+        m_tiles.insert(key, new QImage(), 1);
+        return;
+    }
+
+    const quint64 job = ++m_nextJob;
+    m_pending.insert(key, job);
+
+    m_pool.start([this, key, job, picture]() {
+        QImage image(TileSize, TileSize, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        // QPicture按录制时的逻辑DPI保存字体大小，目标图像使用相同的DPI
+        image.setDotsPerMeterX(qRound(picture.logicalDpiX() / 0.0254));
+        image.setDotsPerMeterY(qRound(picture.logicalDpiY() / 0.0254));
+
+        QPainter painter(&image);
+        painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform
+                               | QPainter::TextAntialiasing);
+        painter.drawPicture(0, 0, picture);
+        painter.end();
+
+        QMetaObject::invokeMethod(this, [this, key, job, image]() {
+            onTileRendered(key, job, image);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TileRenderCache::onTileRendered(const TileKey &key, quint64 job, const QImage &image)
+{
+    // 任务已被失效或被更新的任务取代
+    auto it = m_pending.find(key);
+    if (it == m_pending.end() || it.value() != job) {
+        return;
+    }
+    m_pending.erase(it);
+
+    m_tiles.insert(key, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    emit tileReady(tileRect(key));
+}
@@ -0,0 +1,117 @@
+#ifndef TILE_RENDER_CACHE_H
+#define TILE_RENDER_CACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QHashFunctions>
+#include <QImage>
+#include <QPicture>
+#include <QPointer>
+#include <QRectF>
+#include <QThreadPool>
+#include <QTimer>
+#include <QTransform>
+
+class QGraphicsScene;
+class QGraphicsItem;
+class QPainter;
+
+/**
+ * 视图的瓦片渲染缓存
+ *
+ * 场景按量化后的缩放级别切分成TileSize×TileSize像素的瓦片。
+ * 视图绘制时只合成已完成的瓦片并登记缺少的瓦片，不在paintEvent中录制：
+ * 登记的瓦片在事件循环空闲时分批录制成QPicture（只记录绘制命令，不光栅化），
+ * 每批限定耗时，可见瓦片优先于预取的外圈瓦片；录制结果交给工作线程回放到QImage中。
+ * 场景变化时只使变化区域相交的瓦片失效，平移和回到之前的缩放级别都不需要重新光栅化。
+ *
+ * 选中的图形、带图形效果的图形和非DrawingShape的项（手柄、预览等）不进入瓦片，
+ * 由视图每帧直接绘制
+ */
+class TileRenderCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TileSize = 256;
+
+    explicit TileRenderCache(QObject *parent = nullptr);
+    ~TileRenderCache();
+
+    void setScene(QGraphicsScene *scene);
+    QGraphicsScene *scene() const { return m_scene; }
+
+    /**
+     * 缓存的最大内存（KB），超出后按最近最少使用淘汰瓦片
+     */
+    void setMaxMemory(int kilobytes);
+
+    /**
+     * 将缩放比例量化为缓存级别
+     */
+    static int zoomLevel(qreal zoom);
+    static qreal levelScale(int level);
+
+    /**
+     * 判断图形项是否可以绘制到瓦片中
+     */
+    static bool isTileable(const QGraphicsItem *item);
+
+    /**
+     * 合成与exposedRect相交的瓦片
+     * @param painter 视口上的画笔，调用后变换被重置为单位矩阵
+     * @param viewTransform 场景到视口的变换，只支持缩放和平移
+     * @param exposedRect 需要绘制的场景区域
+     * @return 尚未缓存的瓦片区域（场景坐标），调用方需要直接绘制这些区域
+     */
+    QList<QRectF> paint(QPainter *painter, const QTransform &viewTransform, const QRectF &exposedRect);
+
+    void invalidate(const QRectF &sceneRect);
+    void invalidateAll();
+
+signals:
+    // 瓦片完成光栅化，视图需要重绘对应区域
+    void tileReady(const QRectF &sceneRect);
+    // 场景变化平稳后请求重绘，以重新请求失效的瓦片
+    void updateRequested();
+
+private slots:
+    void onSceneChanged(const QList<QRectF> &region);
+
+private:
+    struct TileKey {
+        int level;
+        int x;
+        int y;
+
+        bool operator==(const TileKey &other) const
+        {
+            return level == other.level && x == other.x && y == other.y;
+        }
+
+        friend size_t qHash(const TileKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.level, key.x, key.y);
+        }
+    };
+
+    static QRectF tileRect(const TileKey &key);
+    QPicture recordTile(const QRectF &sceneRect, qreal scale, bool *empty) const;
+    void requestTile(const TileKey &key, bool prefetch);
+    void recordQueuedTiles();
+    void startTile(const TileKey &key);
+    void onTileRendered(const TileKey &key, quint64 job, const QImage &image);
+
+    QPointer<QGraphicsScene> m_scene;
+    QCache<TileKey, QImage> m_tiles;
+    QHash<TileKey, quint64> m_pending;  // 正在渲染的瓦片及其任务号
+    QList<TileKey> m_visibleQueue;      // 等待录制的可见瓦片
+    QList<TileKey> m_prefetchQueue;     // 等待录制的预取瓦片
+    QTimer m_recordTimer;
+    quint64 m_nextJob;
+    QThreadPool m_pool;
+    QTimer m_settleTimer;  // 场景连续变化（如拖动）期间不重新请求瓦片
+};
+
+#endif // TILE_RENDER_CACHE_H